@@ -12,6 +12,8 @@
 using namespace hgl;
 using namespace openal;
 
+constexpr int OPUS_DECODE_RATE=48000;         ///<opusfile 固定以 48kHz 输出（head->input_sample_rate 仅为编码前的原始采样率）
+
 ALenum GetOpusFormat16(const int channels)
 {
     switch(channels)
@@ -77,7 +79,7 @@ ALvoid LoadOpus(ALbyte *memory, ALsizei memory_size,ALenum *format, ALvoid **dat
         out_total_size+=out_size*head->channel_count;
     }
 
-    *freq=head->input_sample_rate;
+    *freq=OPUS_DECODE_RATE;
     *size=out_total_size*2;
     *data=out_buf;
 }
@@ -131,7 +133,7 @@ ALvoid LoadOpusFloat32(ALbyte *memory, ALsizei memory_size,ALenum *format, float
         out_total_size+=out_size*head->channel_count;
     }
 
-    *freq=head->input_sample_rate;
+    *freq=OPUS_DECODE_RATE;
     *size=out_total_size*sizeof(float);
     *data=out_buf;
 }
@@ -141,22 +143,56 @@ void ClearOpusFloat32(ALenum,float *data,ALsizei,ALsizei)
     delete[] data;
 }
 
+/**
+* 外部数据源回调（ver=7 OpenStream 使用，与 AudioDecode.h 中 AudioStreamCallbacks 布局一致）
+*/
+struct AudioStreamCallbacks
+{
+    size_t  (*Read)(void *user,void *buffer,size_t size);
+    int     (*Seek)(void *user,int64 offset,int whence);
+    int64   (*Tell)(void *user);
+};
+
 struct OpusStream
 {
     OggOpusFile *of;
     const OpusHead *head;
+
+    AudioStreamCallbacks io;            ///< 回调数据源（OpenStream，内存模式不使用）
+    void *io_user;
 };
 
-void *OpenOpus(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *freq,double *total_time)
+int OpusIORead(void *ptr,unsigned char *buffer,int size)
 {
-    OggOpusFile *of;
+    OpusStream *os=(OpusStream *)ptr;
 
-    int op_error;
+    return (int)os->io.Read(os->io_user,buffer,size);
+}
 
-    of=op_open_memory((const unsigned char *)memory,memory_size,&op_error);
+int OpusIOSeek(void *ptr,opus_int64 offset,int whence)
+{
+    OpusStream *os=(OpusStream *)ptr;
+
+    return os->io.Seek(os->io_user,offset,whence);
+}
+
+opus_int64 OpusIOTell(void *ptr)
+{
+    OpusStream *os=(OpusStream *)ptr;
 
+    return os->io.Tell(os->io_user);
+}
+
+/**
+* 检查已打开的 OggOpusFile 并填写格式信息，失败时释放 of 与 os
+*/
+void *SetupOpusStream(OpusStream *os,OggOpusFile *of,ALenum *format,ALsizei *freq,double *total_time)
+{
     if(!of)
+    {
+        delete os;
         return(nullptr);
+    }
 
     const OpusHead *head=op_head(of,0);
 
@@ -164,14 +200,15 @@ void *OpenOpus(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *freq,d
     if(!*format)
     {
         op_free(of);
+        delete os;
         return(nullptr);
     }
 
-    *freq=head->input_sample_rate;
+    *freq=OPUS_DECODE_RATE;
 
-    *total_time=double(op_pcm_total(of,-1))/double(head->input_sample_rate);
+    const ogg_int64_t pcm_total=op_pcm_total(of,-1);                //不可定位的流返回错误码
 
-    OpusStream *os=new OpusStream;
+    *total_time=(pcm_total>0)?double(pcm_total)/double(OPUS_DECODE_RATE):0;
 
     os->of=of;
     os->head=head;
@@ -179,6 +216,44 @@ void *OpenOpus(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *freq,d
     return os;
 }
 
+void *OpenOpus(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *freq,double *total_time)
+{
+    int op_error;
+
+    OpusStream *os=new OpusStream;
+
+    OggOpusFile *of=op_open_memory((const unsigned char *)memory,memory_size,&op_error);
+
+    return SetupOpusStream(os,of,format,freq,total_time);
+}
+
+/**
+* 通过回调增量读取数据（不要求整个文件在内存中）
+*/
+void *OpenOpusCallbacks(const AudioStreamCallbacks *io,void *user,ALenum *format,ALsizei *freq,double *total_time)
+{
+    if(!io||!io->Read)
+        return(nullptr);
+
+    int op_error;
+
+    OpusStream *os=new OpusStream;
+
+    os->io=*io;
+    os->io_user=user;
+
+    OpusFileCallbacks cb;
+
+    cb.read =OpusIORead;
+    cb.seek =(io->Seek&&io->Tell)?OpusIOSeek:nullptr;               //seek 为空时 opusfile 按不可定位流处理
+    cb.tell =(io->Seek&&io->Tell)?OpusIOTell:nullptr;
+    cb.close=nullptr;
+
+    OggOpusFile *of=op_open_callbacks(os,&cb,nullptr,0,&op_error);
+
+    return SetupOpusStream(os,of,format,freq,total_time);
+}
+
 void CloseOpus(void *ptr)
 {
     OpusStream *os=(OpusStream *)ptr;
@@ -230,6 +305,37 @@ void RestartOpus(void *ptr)
 
     op_pcm_seek(os->of,0);
 }
+
+bool SeekOpus(void *ptr,int64 frame)
+{
+    OpusStream *os=(OpusStream *)ptr;
+
+    if(frame<0)frame=0;
+
+    const ogg_int64_t total=op_pcm_total(os->of,-1);
+
+    if(total>0&&frame>=total)
+    {
+        // op_pcm_seek 不接受 total 本身：定位到最后一帧再读掉它
+        if(op_pcm_seek(os->of,total-1)!=0)
+            return(false);
+
+        opus_int16 last[OPUS_CHANNEL_COUNT_MAX];
+
+        return op_read(os->of,last,op_channel_count(os->of,-1),nullptr)==1;
+    }
+
+    return op_pcm_seek(os->of,frame)==0;
+}
+
+int64 TellOpus(void *ptr)
+{
+    OpusStream *os=(OpusStream *)ptr;
+
+    const ogg_int64_t pos=op_pcm_tell(os->of);
+
+    return pos<0?-1:pos;
+}
 //--------------------------------------------------------------------------------------------------
 struct OutInterface2
 {
@@ -268,6 +374,28 @@ static OutInterface3 out_interface_3
 
     ReadOpusFloat32
 };
+
+struct OutInterface6
+{
+    bool  (*SeekPCM)(void *,int64);
+    int64 (*TellPCM)(void *);
+};
+
+static OutInterface6 out_interface_6
+{
+    SeekOpus,
+    TellOpus
+};
+
+struct OutInterface7
+{
+    void *(*OpenStream)(const AudioStreamCallbacks *,void *,ALenum *,ALsizei *,double *);
+};
+
+static OutInterface7 out_interface_7
+{
+    OpenOpusCallbacks
+};
 //--------------------------------------------------------------------------------------------------
 // 编码接口（ver=5）：PCM ↔ 压缩包 流式编解码（LibOpus encoder/decoder）
 // 供实时通话链使用；Opus 原生支持 PLC（丢包隐藏）：Decode 传 packet=nullptr 即走 PLC
@@ -373,6 +501,16 @@ bool GetPlugInInterface(uint32 ver,void *data)
     {
         memcpy(data,&out_interface_5,sizeof(OutInterface5));
     }
+    else
+    if(ver==6)
+    {
+        memcpy(data,&out_interface_6,sizeof(OutInterface6));
+    }
+    else
+    if(ver==7)
+    {
+        memcpy(data,&out_interface_7,sizeof(OutInterface7));
+    }
     else
         return(false);
 
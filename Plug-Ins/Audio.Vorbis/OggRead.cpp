@@ -141,32 +141,159 @@ void ClearOGG(ALenum, ALvoid *data, ALsizei, ALsizei)
     if (data)
         delete[] (char *)data;
 }
+
+/**
+* 将 ov_read_float 输出的平面数据交错写入
+*/
+void InterleaveOGGFloat(float *out,float **pcm,const int channels,const long frames)
+{
+    if(channels==1)
+    {
+        memcpy(out,pcm[0],frames*sizeof(float));
+        return;
+    }
+
+    for(long i=0;i<frames;i++)
+        for(int ch=0;ch<channels;ch++)
+            *out++=pcm[ch][i];
+}
+
+ALvoid LoadOGGFloat32(ALbyte *memory, ALsizei memory_size,ALenum *format, float **data, ALsizei *size, ALsizei *freq, ALboolean *loop)
+{
+    ov_callbacks    func;
+    OggVorbis_File  ogg_stream;
+    vorbis_info *   info;
+    int             section;
+
+    ogg_fileread    ogg_memory;
+
+    func.read_func  =VorbisRead;
+    func.close_func =VorbisClose;
+    func.seek_func  =VorbisSeek;
+    func.tell_func  =VorbisTell;
+
+    ogg_memory.data=(unsigned char *)memory;
+    ogg_memory.pos=0;
+    ogg_memory.size=memory_size;
+
+    *size=0;
+    *format=0;
+    *data=nullptr;
+    *freq=0;
+
+    if(ov_open_callbacks(&ogg_memory,&ogg_stream,NULL,0,func)!=0)
+        return;
+
+    info    =ov_info(&ogg_stream,-1);
+
+    if(info->channels<1||info->channels>2)
+    {
+        ov_clear(&ogg_stream);
+        return;
+    }
+
+    if(info->channels==1)*format=AL_FORMAT_MONO_FLOAT32;
+                    else *format=AL_FORMAT_STEREO_FLOAT32;
+
+    const int channels=info->channels;
+    const long pcm_total_frames=(long)ov_pcm_total(&ogg_stream,-1);
+
+    if(pcm_total_frames<=0)
+    {
+        *format=0;
+        ov_clear(&ogg_stream);
+        return;
+    }
+
+    float *ptr=new float[pcm_total_frames*channels];
+    long out_frames=0;
+    float **pcm;
+
+    while(out_frames<pcm_total_frames)
+    {
+        const long result=ov_read_float(&ogg_stream,&pcm,int(pcm_total_frames-out_frames),&section);
+
+        if(result<=0)break;
+
+        InterleaveOGGFloat(ptr+out_frames*channels,pcm,channels,result);
+
+        out_frames+=result;
+    }
+
+    *freq=info->rate;
+    *size=out_frames*channels*sizeof(float);
+    *data=ptr;
+
+    ov_clear(&ogg_stream);
+}
+
+void ClearOGGFloat32(ALenum,float *data,ALsizei,ALsizei)
+{
+    delete[] data;
+}
 //--------------------------------------------------------------------------------------------------
+/**
+* 外部数据源回调（ver=7 OpenStream 使用，与 AudioDecode.h 中 AudioStreamCallbacks 布局一致）
+*/
+struct AudioStreamCallbacks
+{
+    size_t  (*Read)(void *user,void *buffer,size_t size);
+    int     (*Seek)(void *user,int64 offset,int whence);
+    int64   (*Tell)(void *user);
+};
+
 struct OggStream
 {
     ov_callbacks    func;
 
-    ogg_fileread    ogg_memory;
+    ogg_fileread    ogg_memory;             ///< 内存数据源（Open）
+    AudioStreamCallbacks io;                ///< 回调数据源（OpenStream）
+    void *          io_user;
+
     OggVorbis_File    ogg_stream;
+
+    int             channels;
 };
 
-void *OpenOGG(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *rate,double *total_time)
+size_t VorbisIORead(void *buffer,size_t size,size_t count,void *ptr)
 {
-    vorbis_info *info;
+    OggStream *obj=(OggStream *)ptr;
 
-    OggStream *ptr=new OggStream;
+    if(size==0)return(0);
 
-    ptr->func.read_func  =VorbisRead;
-    ptr->func.close_func =VorbisClose;
-    ptr->func.seek_func  =VorbisSeek;
-    ptr->func.tell_func  =VorbisTell;
+    return obj->io.Read(obj->io_user,buffer,size*count)/size;
+}
 
-    ptr->ogg_memory.data=(unsigned char *)memory;
-    ptr->ogg_memory.pos=0;
-    ptr->ogg_memory.size=memory_size;
+int VorbisIOSeek(void *ptr,ogg_int64_t offset,int whence)
+{
+    OggStream *obj=(OggStream *)ptr;
+
+    if(!obj->io.Seek)return(-1);        //不可定位：vorbisfile 按非 seekable 流处理
+
+    return obj->io.Seek(obj->io_user,offset,whence);
+}
+
+long VorbisIOTell(void *ptr)
+{
+    OggStream *obj=(OggStream *)ptr;
+
+    if(!obj->io.Tell)return(-1);
 
-    if(ov_open_callbacks(&(ptr->ogg_memory),&(ptr->ogg_stream),NULL,0,ptr->func)!=0)
+    return (long)obj->io.Tell(obj->io_user);
+}
+
+/**
+* 以 ptr->func 与 datasource 打开，成功后填写格式信息；失败时释放 ptr
+*/
+void *OpenOGGStream(OggStream *ptr,void *datasource,ALenum *format,ALsizei *rate,double *total_time)
+{
+    vorbis_info *info;
+
+    if(ov_open_callbacks(datasource,&(ptr->ogg_stream),NULL,0,ptr->func)!=0)
+    {
+        delete ptr;
         return(nullptr);
+    }
 
     info    =ov_info(&(ptr->ogg_stream),-1);
 
@@ -180,13 +307,54 @@ void *OpenOGG(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *rate,do
     if(info->channels==1)*format=AL_FORMAT_MONO16;
                     else *format=AL_FORMAT_STEREO16;
 
+    ptr->channels=info->channels;
+
     *rate=info->rate;
 
     *total_time=ov_time_total(&(ptr->ogg_stream),-1);
 
+    if(*total_time<0)*total_time=0;             //不可定位的流无法得知总时长
+
     return(ptr);
 }
 
+void *OpenOGG(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *rate,double *total_time)
+{
+    OggStream *ptr=new OggStream;
+
+    ptr->func.read_func  =VorbisRead;
+    ptr->func.close_func =VorbisClose;
+    ptr->func.seek_func  =VorbisSeek;
+    ptr->func.tell_func  =VorbisTell;
+
+    ptr->ogg_memory.data=(unsigned char *)memory;
+    ptr->ogg_memory.pos=0;
+    ptr->ogg_memory.size=memory_size;
+
+    return OpenOGGStream(ptr,&(ptr->ogg_memory),format,rate,total_time);
+}
+
+/**
+* 通过回调增量读取数据（不要求整个文件在内存中）
+*/
+void *OpenOGGCallbacks(const AudioStreamCallbacks *io,void *user,ALenum *format,ALsizei *rate,double *total_time)
+{
+    if(!io||!io->Read)
+        return(nullptr);
+
+    OggStream *ptr=new OggStream;
+
+    ptr->io=*io;
+    ptr->io_user=user;
+
+    ptr->func.read_func  =VorbisIORead;
+    ptr->func.close_func =VorbisClose;
+    ptr->func.seek_func  =VorbisIOSeek;
+    ptr->func.tell_func  =VorbisIOTell;
+
+    return OpenOGGStream(ptr,ptr,format,rate,total_time);
+}
+
 void CloseOGG(void *ptr)
 {
     OggStream *obj=(OggStream *)ptr;
@@ -216,12 +384,59 @@ uint ReadOGG(void *ptr,char *data,uint buf_max)
     return(size);
 }
 
+uint ReadOGGFloat32(void *ptr,float *data,uint buf_max)
+{
+    OggStream *obj=(OggStream *)ptr;
+    int section;
+    float **pcm;
+
+    const int channels=obj->channels;
+    const long max_frames=long(buf_max/sizeof(float))/channels;      //buf_max 为字节数
+    long frames=0;
+
+    while(frames<max_frames)
+    {
+        const long result=ov_read_float(&(obj->ogg_stream),&pcm,int(max_frames-frames),&section);
+
+        if(result<0)return(0);
+        if(result==0)break;
+
+        InterleaveOGGFloat(data+frames*channels,pcm,channels,result);
+
+        frames+=result;
+    }
+
+    return(frames*channels*sizeof(float));
+}
+
 void RestartOGG(void *ptr)
 {
     OggStream *obj=(OggStream *)ptr;
 
     ov_pcm_seek(&(obj->ogg_stream),0);
 }
+
+bool SeekOGG(void *ptr,int64 frame)
+{
+    OggStream *obj=(OggStream *)ptr;
+
+    if(frame<0)frame=0;
+
+    const ogg_int64_t total=ov_pcm_total(&(obj->ogg_stream),-1);
+
+    if(total>=0&&frame>total)frame=total;
+
+    return ov_pcm_seek(&(obj->ogg_stream),frame)==0;
+}
+
+int64 TellOGG(void *ptr)
+{
+    OggStream *obj=(OggStream *)ptr;
+
+    const ogg_int64_t pos=ov_pcm_tell(&(obj->ogg_stream));
+
+    return pos<0?-1:pos;
+}
 //--------------------------------------------------------------------------------------------------
 struct OutInterface
 {
@@ -244,6 +459,44 @@ static OutInterface out_interface=
     ReadOGG,
     RestartOGG
 };
+
+struct OutInterface3
+{
+    void (*Load)(ALbyte *,ALsizei,ALenum *,float **,ALsizei *,ALsizei *,ALboolean *);
+    void (*Clear)(ALenum,float *,ALsizei,ALsizei);
+
+    uint (*Read)(void *,float *,uint);
+};
+
+static OutInterface3 out_interface_3=
+{
+    LoadOGGFloat32,
+    ClearOGGFloat32,
+
+    ReadOGGFloat32
+};
+
+struct OutInterface6
+{
+    bool  (*SeekPCM)(void *,int64);
+    int64 (*TellPCM)(void *);
+};
+
+static OutInterface6 out_interface_6=
+{
+    SeekOGG,
+    TellOGG
+};
+
+struct OutInterface7
+{
+    void *(*OpenStream)(const AudioStreamCallbacks *,void *,ALenum *,ALsizei *,double *);
+};
+
+static OutInterface7 out_interface_7=
+{
+    OpenOGGCallbacks
+};
 //--------------------------------------------------------------------------------------------------
 #if HGL_OS != HGL_OS_Windows
 const u16char plugin_intro[]=U16_TEXT("Vorbis OGG 音频文件解码(使用操作系统内置解码器,2016-09-16)");
@@ -268,6 +521,21 @@ bool GetPlugInInterface(uint32 ver,void *data)
     {
         memcpy(data,&out_interface,sizeof(OutInterface));
     }
+    else
+    if(ver==3)
+    {
+        memcpy(data,&out_interface_3,sizeof(OutInterface3));
+    }
+    else
+    if(ver==6)
+    {
+        memcpy(data,&out_interface_6,sizeof(OutInterface6));
+    }
+    else
+    if(ver==7)
+    {
+        memcpy(data,&out_interface_7,sizeof(OutInterface7));
+    }
     else
         return(false);
 
@@ -3,92 +3,162 @@
 #include<hgl/plugin/PlugIn.h>
 #include<hgl/plugin/PlugInInterface.h>
 #include<string.h>
+#include<stddef.h>
+#include<stdint.h>
 #include<malloc.h>
 #include<hgl/al/al.h>
+#include<hgl/audio/WAVParser.h>
 
 using namespace hgl;
+using namespace hgl::audio;
 using namespace openal;
 
-typedef struct                                  /* WAV File-header */
+/**
+* WAV 数据块解析结果，pcm 直接指向调用方传入的文件内存（不复制）
+*/
+struct WAVDataView
 {
-    ALubyte  Id[4]            ;
-    ALsizei  Size                ;
-    ALubyte  Type[4]            ;
+    const ALubyte *pcm;         ///< data 块起始
+    ALsizei size;               ///< PCM 字节数（已截到整帧）
+    ALsizei freq;               ///< 采样率
+    int channels;               ///< 声道数
+    int bits;                   ///< 源位深 8/16/24/32
+    bool is_float;              ///< 是否 IEEE float（仅 32 位）
+    ALboolean loop;             ///< smpl 块是否带循环
+};
+
+ALenum GetWAVFormat(const ALushort channels,const ALushort bits)
+{
+    switch(channels)
+    {
+        case 1: return(bits==8?AL_FORMAT_MONO8:AL_FORMAT_MONO16);
+        case 2: return(bits==8?AL_FORMAT_STEREO8:AL_FORMAT_STEREO16);
+        case 4: return(bits==8?AL_FORMAT_QUAD8:AL_FORMAT_QUAD16);
+        case 6: return(bits==8?AL_FORMAT_51CHN8:AL_FORMAT_51CHN16);
+        case 7: return(bits==8?AL_FORMAT_61CHN8:AL_FORMAT_61CHN16);
+        case 8: return(bits==8?AL_FORMAT_71CHN8:AL_FORMAT_71CHN16);
+        default: return(0);
+    }
 }
-WAVFileHdr_Struct;
 
-typedef struct                                  /* WAV Fmt-header */
+ALenum GetWAVFormatFloat32(const int channels)
 {
-    ALushort Format            ;
-    ALushort Channels            ;
-    ALuint   SamplesPerSec    ;
-    ALuint   BytesPerSec        ;
-    ALushort BlockAlign        ;
-    ALushort BitsPerSample    ;
+    switch(channels)
+    {
+        case 1: return(AL_FORMAT_MONO_FLOAT32);
+        case 2: return(AL_FORMAT_STEREO_FLOAT32);
+        default: return(0);
+    }
 }
-WAVFmtHdr_Struct;
 
-typedef struct                                    /* WAV FmtEx-header */
+/**
+* 原地解析 RIFF/WAVE（解析规则见 hgl/audio/WAVParser.h，与主程序的 ParseWAVData 相同）
+*/
+bool ParseWAVMemory(const ALbyte *memory,ALsizei memory_size,WAVDataView *view)
 {
-    ALushort Size                ;
-    ALushort SamplesPerBlock    ;
+    memset(view,0,sizeof(WAVDataView));
+
+    if(!memory||memory_size<=0)
+        return(false);
+
+    RIFFWAVEInfo info;
+
+    if(!ParseRIFFWAVE(memory,uint64(memory_size),info))
+        return(false);
+
+    if(!GetWAVFormat(info.channels,16))
+        return(false);
+
+    view->pcm       =info.pcm;
+    view->size      =(ALsizei)info.pcm_size;
+    view->freq      =(ALsizei)info.sample_rate;
+    view->channels  =info.channels;
+    view->bits      =info.bits;
+    view->is_float  =info.is_float;
+    view->loop      =(info.loop?AL_TRUE:AL_FALSE);
+
+    return(view->freq>0);
 }
-WAVFmtExHdr_Struct;
 
-typedef struct                                  /* WAV Smpl-header */
+/**
+* 是否可以直接按原格式交给 OpenAL（8/16 位整数）
+*/
+bool IsWAVNativeFormat(const WAVDataView &view)
 {
-    ALuint   Manufacturer        ;
-    ALuint   Product            ;
-    ALuint   SamplePeriod        ;
-    ALuint   Note                ;
-    ALuint   FineTune            ;
-    ALuint   SMPTEFormat        ;
-    ALuint   SMPTEOffest        ;
-    ALuint   Loops            ;
-    ALuint   SamplerData        ;
+    return !view.is_float&&(view.bits==8||view.bits==16);
+}
 
-    struct
+float WAVSampleToFloat(const ALubyte *p,const int bits,const bool is_float)
+{
+    switch(bits)
     {
-        ALuint Identifier        ;
-        ALuint Type                ;
-        ALuint Start            ;
-        ALuint End                ;
-        ALuint Fraction            ;
-        ALuint Count            ;
+        case 8: return float(int(p[0])-128)/128.0f;                                     //8 位 WAV 为无符号
+        case 16:return float(int16_t(p[0]|(p[1]<<8)))/32768.0f;
+        case 24:return float(int32_t((uint32_t(p[0])<<8)|(uint32_t(p[1])<<16)|(uint32_t(p[2])<<24))>>8)/8388608.0f;
+        case 32:
+        {
+            if(is_float)
+            {
+                float f;
+                memcpy(&f,p,sizeof(float));
+                return f;
+            }
+
+            int32_t v;
+            memcpy(&v,p,sizeof(int32_t));
+            return float(v)/2147483648.0f;
+        }
+        default:return 0;
     }
-    Loop[1]            ;
 }
-WAVSmplHdr_Struct;
 
-typedef struct                                  /* WAV Chunk-header */
+int16_t WAVFloatToInt16(float f)
 {
-    ALubyte  Id[4]            ;
-    ALuint   Size                ;
+    if(f>1.0f)f=1.0f;else
+    if(f<-1.0f)f=-1.0f;
+
+    return int16_t(f*32767.0f);
 }
-WAVChunkHdr_Struct;
 
-ALenum GetWAVFormat(const ALushort channels,const ALushort bits)
+/**
+* 将 sample_count 个源采样转换为 int16
+*/
+void ConvertWAVToInt16(const WAVDataView &view,const ALubyte *src,int16_t *dst,uint sample_count)
 {
-    switch(channels)
+    const int bytes=view.bits/8;
+
+    if(view.bits==24&&!view.is_float)       //常见情况：直接取高 16 位
     {
-        case 1: return(bits==8?AL_FORMAT_MONO8:AL_FORMAT_MONO16);
-        case 2: return(bits==8?AL_FORMAT_STEREO8:AL_FORMAT_STEREO16);
-        case 4: return(bits==8?AL_FORMAT_QUAD8:AL_FORMAT_QUAD16);
-        case 6: return(bits==8?AL_FORMAT_51CHN8:AL_FORMAT_51CHN16);
-        case 7: return(bits==8?AL_FORMAT_61CHN8:AL_FORMAT_61CHN16);
-        case 8: return(bits==8?AL_FORMAT_71CHN8:AL_FORMAT_71CHN16);
-        default: return(0);
+        for(uint i=0;i<sample_count;i++,src+=3)
+            dst[i]=int16_t(src[1]|(src[2]<<8));
+
+        return;
+    }
+
+    for(uint i=0;i<sample_count;i++,src+=bytes)
+        dst[i]=WAVFloatToInt16(WAVSampleToFloat(src,view.bits,view.is_float));
+}
+
+/**
+* 将 sample_count 个源采样转换为 float
+*/
+void ConvertWAVToFloat(const WAVDataView &view,const ALubyte *src,float *dst,uint sample_count)
+{
+    if(view.is_float)
+    {
+        memcpy(dst,src,sample_count*sizeof(float));
+        return;
     }
+
+    const int bytes=view.bits/8;
+
+    for(uint i=0;i<sample_count;i++,src+=bytes)
+        dst[i]=WAVSampleToFloat(src,view.bits,false);
 }
 
 ALvoid alutLoadWAVMemory(ALbyte *memory, ALsizei memory_size,ALenum *format, ALvoid **data, ALsizei *size, ALsizei *freq, ALboolean *loop)
 {
-    WAVChunkHdr_Struct ChunkHdr;
-    WAVFmtExHdr_Struct FmtExHdr;
-    WAVFileHdr_Struct FileHdr;
-    WAVSmplHdr_Struct SmplHdr;
-    WAVFmtHdr_Struct FmtHdr;
-    ALbyte *Stream;
+    WAVDataView view;
 
     *format=0;
     *data=NULL;
@@ -96,65 +166,30 @@ ALvoid alutLoadWAVMemory(ALbyte *memory, ALsizei memory_size,ALenum *format, ALv
     *freq=0;
     *loop=AL_FALSE;
 
-    if (memory)
-    {
-        Stream=memory;
+    if(!ParseWAVMemory(memory,memory_size,&view))
+        return;
 
-        if (Stream)
-        {
-            memcpy(&FileHdr, Stream, sizeof(WAVFileHdr_Struct));
-            Stream+=sizeof(WAVFileHdr_Struct);
-            FileHdr.Size=((FileHdr.Size+1)&~1)-4;
-            while ((FileHdr.Size!=0)&&(memcpy(&ChunkHdr, Stream, sizeof(WAVChunkHdr_Struct))))
-            {
-                Stream+=sizeof(WAVChunkHdr_Struct);
-                if (!memcmp(ChunkHdr.Id, "fmt ", 4))
-                {
-                    memcpy(&FmtHdr, Stream, sizeof(WAVFmtHdr_Struct));
-                    if (FmtHdr.Format==0x0001)
-                    {
-                        *format=GetWAVFormat(FmtHdr.Channels,FmtHdr.BitsPerSample);
-                        *freq=FmtHdr.SamplesPerSec;
-                        Stream+=ChunkHdr.Size;
-                    }
-                    else
-                    {
-                        memcpy(&FmtExHdr, Stream, sizeof(WAVFmtExHdr_Struct));
-                        Stream+=ChunkHdr.Size;
-                    }
-                }
-                else if (!memcmp(ChunkHdr.Id, "data", 4))
-                {
-                    if (FmtHdr.Format==0x0001)
-                    {
-                        *size=ChunkHdr.Size;
-                        *data=malloc(ChunkHdr.Size+31);
-                        if (*data) memcpy(*data, Stream, ChunkHdr.Size);
-                        memset(((char *)*data)+ChunkHdr.Size, 0, 31);
-                        Stream+=ChunkHdr.Size;
-                    }
-                    else if (FmtHdr.Format==0x0011)
-                    {
-                        //IMA ADPCM
-                    }
-                    else if (FmtHdr.Format==0x0055)
-                    {
-                        //MP3 WAVE
-                    }
-                }
-                else if (!memcmp(ChunkHdr.Id, "smpl", 4))
-                {
-                    memcpy(&SmplHdr, Stream, sizeof(WAVSmplHdr_Struct));
-                    *loop = (SmplHdr.Loops ? AL_TRUE : AL_FALSE);
-                    Stream+=ChunkHdr.Size;
-                }
-                else
-                    Stream+=ChunkHdr.Size;
-                Stream+=ChunkHdr.Size&1;
-                FileHdr.Size-=(((ChunkHdr.Size+1)&~1)+8);
-            }
-        }
-    }
+    ALsizei out_size;
+
+    if(IsWAVNativeFormat(view))
+        out_size=view.size;
+    else
+        out_size=view.size/(view.bits/8)*2;            //24/32 位整数与 float 转为 16 位
+
+    *data=malloc(out_size+31);
+    if(!*data)return;
+
+    if(IsWAVNativeFormat(view))
+        memcpy(*data,view.pcm,view.size);
+    else
+        ConvertWAVToInt16(view,view.pcm,(int16_t *)*data,out_size/2);
+
+    memset(((char *)*data)+out_size,0,31);
+
+    *format=GetWAVFormat(view.channels,IsWAVNativeFormat(view)?view.bits:16);
+    *size=out_size;
+    *freq=view.freq;
+    *loop=view.loop;
 }
 
 ALvoid alutUnloadWAV(ALenum, ALvoid *data, ALsizei, ALsizei)
@@ -163,51 +198,76 @@ ALvoid alutUnloadWAV(ALenum, ALvoid *data, ALsizei, ALsizei)
         free(data);
 }
 
+/**
+* 浮点整段解码：仅对 24/32 位整数与 float 源（单/双声道）生效，
+* 8/16 位源返回 format=0 由调用方回退到 16 位接口，避免无意义地放大一倍内存
+*/
+ALvoid LoadWAVFloat32(ALbyte *memory, ALsizei memory_size,ALenum *format, float **data, ALsizei *size, ALsizei *freq, ALboolean *loop)
+{
+    WAVDataView view;
+
+    *format=0;
+    *data=nullptr;
+    *size=0;
+    *freq=0;
+    *loop=AL_FALSE;
+
+    if(!ParseWAVMemory(memory,memory_size,&view))
+        return;
+
+    if(IsWAVNativeFormat(view)||!GetWAVFormatFloat32(view.channels))
+        return;
+
+    const uint sample_count=view.size/(view.bits/8);
+
+    float *out=new float[sample_count];
+
+    ConvertWAVToFloat(view,view.pcm,out,sample_count);
+
+    *format=GetWAVFormatFloat32(view.channels);
+    *data=out;
+    *size=sample_count*sizeof(float);
+    *freq=view.freq;
+    *loop=view.loop;
+}
+
+void ClearWAVFloat32(ALenum,float *data,ALsizei,ALsizei)
+{
+    delete[] data;
+}
+
 //--------------------------------------------------------------------------------------------------
-// 流式接口（Open/Read/Restart/Close）：Open 时整文件解码到内存，Read 按块输出
-// （AudioPlayer 三缓冲播放管线使用；修复 Open 为 NULL 导致的段错误）
+// 流式接口（Open/Read/Restart/Close）：原地解析，Read 直接从调用方传入的文件内存按块输出
+// 调用方（AudioPlayer）保证 Open~Close 期间文件内存有效（可以是内存映射），因此不再复制整段 PCM
+// 8/16 位源原样输出；24/32 位整数与 float 源在 Read 时逐块转换为 16 位（或经浮点接口输出 float）
 //--------------------------------------------------------------------------------------------------
 struct WAVStream
 {
-    ALbyte *data;           ///< 解码后 PCM 数据
-    ALsizei size;           ///< PCM 字节数
-    ALsizei pos;            ///< 读取游标
-    ALsizei freq;           ///< 采样率
+    WAVDataView view;       ///< 源数据（指向文件内存）
+    ALsizei pos;            ///< 读取游标（源字节）
+    ALsizei frame_bytes;    ///< 源每帧字节数（声道数×每样本字节）
 };
 
 void *OpenWAV(ALbyte *memory,ALsizei memory_size,ALenum *format,ALsizei *freq,double *total_time)
 {
-    if(!memory||memory_size<=0)
+    WAVDataView view;
+
+    if(!ParseWAVMemory(memory,memory_size,&view))
         return(nullptr);
 
     WAVStream *s=(WAVStream *)malloc(sizeof(WAVStream));
     if(!s)return(nullptr);
 
-    ALvoid *pcm=nullptr;
-    ALsizei pcm_size=0;
-    ALboolean loop=AL_FALSE;
-
-    alutLoadWAVMemory(memory,memory_size,format,&pcm,&pcm_size,freq,&loop);
-
-    if(!pcm||pcm_size<=0)
-    {
-        free(s);
-        return(nullptr);
-    }
-
-    s->data=(ALbyte *)pcm;
-    s->size=pcm_size;
+    s->view=view;
     s->pos=0;
-    s->freq=*freq;
+    s->frame_bytes=view.channels*view.bits/8;
 
-    // 总时长（秒）= PCM 字节 / (采样率 × 每样本字节)
-    if(total_time)
-    {
-        const int channels=(*format==AL_FORMAT_STEREO16||*format==AL_FORMAT_QUAD16)?2:1;
-        const int bytes_per_sample=channels*2;      // 16bit
+    *format=GetWAVFormat(view.channels,IsWAVNativeFormat(view)?view.bits:16);
+    *freq=view.freq;
 
-        *total_time=(s->size)/(double)(s->freq*bytes_per_sample);
-    }
+    // 总时长（秒）= PCM 字节 / (采样率 × 每帧字节)
+    if(total_time)
+        *total_time=(view.size)/(double)(view.freq*s->frame_bytes);
 
     return(s);
 }
@@ -216,10 +276,23 @@ void CloseWAV(void *ptr)
 {
     if(!ptr)return;
 
-    WAVStream *s=(WAVStream *)ptr;
+    free(ptr);
+}
 
-    free(s->data);
-    free(s);
+/**
+* 计算本次可读取的帧数
+* @param out_frame_bytes 输出每帧字节数
+*/
+int GetWAVReadFrames(const WAVStream *s,uint max_bytes,int out_frame_bytes)
+{
+    const int remain=(s->view.size-s->pos)/s->frame_bytes;
+
+    if(remain<=0)
+        return(0);
+
+    const int frames=int(max_bytes/out_frame_bytes);
+
+    return (remain<frames)?remain:frames;
 }
 
 uint ReadWAV(void *ptr,char *buffer,uint max_bytes)
@@ -229,17 +302,43 @@ uint ReadWAV(void *ptr,char *buffer,uint max_bytes)
 
     WAVStream *s=(WAVStream *)ptr;
 
-    const int remain=s->size-s->pos;
+    const bool native=IsWAVNativeFormat(s->view);
+    const int out_frame_bytes=native?s->frame_bytes:s->view.channels*2;
+    const int frames=GetWAVReadFrames(s,max_bytes,out_frame_bytes);
 
-    if(remain<=0)
+    if(frames<=0)
+        return(0);
+
+    const ALubyte *src=s->view.pcm+s->pos;
+
+    if(native)
+        memcpy(buffer,src,frames*out_frame_bytes);
+    else
+        ConvertWAVToInt16(s->view,src,(int16_t *)buffer,frames*s->view.channels);
+
+    s->pos+=frames*s->frame_bytes;
+
+    return((uint)(frames*out_frame_bytes));
+}
+
+uint ReadWAVFloat32(void *ptr,float *buffer,uint max_bytes)
+{
+    if(!ptr||!buffer||max_bytes==0)
+        return(0);
+
+    WAVStream *s=(WAVStream *)ptr;
+
+    const int out_frame_bytes=s->view.channels*sizeof(float);
+    const int frames=GetWAVReadFrames(s,max_bytes,out_frame_bytes);
+
+    if(frames<=0)
         return(0);
 
-    const int n=(remain<(int)max_bytes)?remain:(int)max_bytes;
+    ConvertWAVToFloat(s->view,s->view.pcm+s->pos,buffer,frames*s->view.channels);
 
-    memcpy(buffer,s->data+s->pos,n);
-    s->pos+=n;
+    s->pos+=frames*s->frame_bytes;
 
-    return((uint)n);
+    return((uint)(frames*out_frame_bytes));
 }
 
 void RestartWAV(void *ptr)
@@ -251,6 +350,31 @@ void RestartWAV(void *ptr)
     s->pos=0;
 }
 
+bool SeekWAV(void *ptr,int64 frame)
+{
+    if(!ptr)return(false);
+
+    WAVStream *s=(WAVStream *)ptr;
+
+    if(frame<0)frame=0;
+
+    const int64 total=s->view.size/s->frame_bytes;
+
+    if(frame>total)frame=total;
+
+    s->pos=(ALsizei)(frame*s->frame_bytes);
+    return(true);
+}
+
+int64 TellWAV(void *ptr)
+{
+    if(!ptr)return(-1);
+
+    WAVStream *s=(WAVStream *)ptr;
+
+    return s->pos/s->frame_bytes;
+}
+
 //--------------------------------------------------------------------------------------------------
 struct OutInterface
 {
@@ -273,6 +397,34 @@ static OutInterface out_interface=
     ReadWAV,
     RestartWAV
 };
+
+struct OutInterface3
+{
+    void (*Load)(ALbyte *,ALsizei,ALenum *,float **,ALsizei *,ALsizei *,ALboolean *);
+    void (*Clear)(ALenum,float *,ALsizei,ALsizei);
+
+    uint (*Read)(void *,float *,uint);
+};
+
+static OutInterface3 out_interface_3=
+{
+    LoadWAVFloat32,
+    ClearWAVFloat32,
+
+    ReadWAVFloat32
+};
+
+struct OutInterface6
+{
+    bool  (*SeekPCM)(void *,int64);
+    int64 (*TellPCM)(void *);
+};
+
+static OutInterface6 out_interface_6=
+{
+    SeekWAV,
+    TellWAV
+};
 //--------------------------------------------------------------------------------------------------
 const u16char plugin_intro[]=U16_TEXT("WAV音频文件解码(2014-04-09,代码源自ALUT)");
 
@@ -293,6 +445,16 @@ bool GetPlugInInterface(uint32 ver,void *data)
     {
         memcpy(data,&out_interface,sizeof(OutInterface));
     }
+    else
+    if(ver==3)
+    {
+        memcpy(data,&out_interface_3,sizeof(OutInterface3));
+    }
+    else
+    if(ver==6)
+    {
+        memcpy(data,&out_interface_6,sizeof(OutInterface6));
+    }
     else
         return(false);
 
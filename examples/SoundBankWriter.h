@@ -0,0 +1,214 @@
+﻿// Simple Sound Bank Writer Utility
+// Packs WAV (PCM) / OGG Vorbis / Opus files into one memory-mappable sound bank (see hgl/audio/SoundBank.h)
+// Shared by sound_bank_builder and the asset manager test
+#pragma once
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <iostream>
+#include <hgl/audio/SoundBank.h>
+#include <hgl/audio/AudioEvent.h>
+#include "WavReader.h"
+
+namespace hgl
+{
+    namespace audio
+    {
+        /**
+         * Sound bank writer
+         * WAV is stored as raw PCM ready for alBufferData; .ogg/.opus are stored as-is and decoded at load time.
+         */
+        class SoundBankWriter
+        {
+        public:
+
+            struct Item
+            {
+                std::string name;               // asset name (the name passed to AudioAssetManager::Acquire)
+                std::string filename;
+                SoundBankEntry entry;
+                std::vector<char> payload;
+            };
+
+        private:
+
+            static bool EndsWith(const std::string &str,const char *ext)
+            {
+                const size_t len=strlen(ext);
+
+                if(str.size()<len)return false;
+
+                for(size_t i=0;i<len;i++)
+                    if(tolower((unsigned char)str[str.size()-len+i])!=ext[i])
+                        return false;
+
+                return true;
+            }
+
+            static bool ReadWholeFile(const std::string &filename,std::vector<char> &data)
+            {
+                FILE *fp=fopen(filename.c_str(),"rb");
+                if(!fp)return false;
+
+                fseek(fp,0,SEEK_END);
+                const long size=ftell(fp);
+                fseek(fp,0,SEEK_SET);
+
+                if(size<=0)
+                {
+                    fclose(fp);
+                    return false;
+                }
+
+                data.resize(size);
+
+                const size_t read=fread(data.data(),1,size,fp);
+                fclose(fp);
+
+                return read==(size_t)size;
+            }
+
+            static uint64 AlignUp(uint64 value,uint64 alignment)
+            {
+                return (value+alignment-1)/alignment*alignment;
+            }
+
+        public:
+
+            /**
+             * Load item.filename into item.payload and fill item.entry
+             * @return false if the file can't be read or its type is not supported
+             */
+            static bool LoadItem(Item &item)
+            {
+                memset(&item.entry,0,sizeof(SoundBankEntry));
+
+                if(EndsWith(item.filename,".wav"))
+                {
+                    openal::ALenum format=0;
+                    void *data=nullptr;
+                    uint32_t size=0;
+                    uint32_t sample_rate=0;
+
+                    if(!WavReader::Load(item.filename.c_str(),&format,&data,&size,&sample_rate))
+                        return false;
+
+                    item.payload.assign((char *)data,(char *)data+size);
+                    free(data);
+
+                    item.entry.payload_type=uint32(SoundBankPayload::PCM);
+                    item.entry.format=uint32(format);
+                    item.entry.sample_rate=sample_rate;
+                }
+                else if(EndsWith(item.filename,".ogg"))
+                {
+                    if(!ReadWholeFile(item.filename,item.payload))return false;
+
+                    item.entry.payload_type=uint32(SoundBankPayload::Vorbis);
+                }
+                else if(EndsWith(item.filename,".opus"))
+                {
+                    if(!ReadWholeFile(item.filename,item.payload))return false;
+
+                    item.entry.payload_type=uint32(SoundBankPayload::Opus);
+                }
+                else
+                {
+                    std::cerr << "Unsupported file type: " << item.filename << "\n";
+                    return false;
+                }
+
+                item.entry.name_hash=SoundBankNameHash(item.name.c_str());
+                item.entry.cue_hash=CueNameHash(item.name.c_str());
+                item.entry.size=item.payload.size();
+
+                return true;
+            }
+
+            /**
+             * Write the bank (items are sorted by name_hash in place)
+             * @param alignment payload alignment, a power of two >= 8
+             * @return false on a duplicate name/hash or a write error
+             */
+            static bool Write(const char *filename,std::vector<Item> &items,uint32 alignment=SOUND_BANK_DEFAULT_ALIGNMENT)
+            {
+                // index is sorted by name_hash for binary search
+                std::sort(items.begin(),items.end(),[](const Item &a,const Item &b){return a.entry.name_hash<b.entry.name_hash;});
+
+                for(size_t i=1;i<items.size();i++)
+                {
+                    if(items[i-1].entry.name_hash==items[i].entry.name_hash)
+                    {
+                        std::cerr << "Duplicate asset name (or hash collision): \"" << items[i-1].name << "\" / \"" << items[i].name << "\"\n";
+                        return false;
+                    }
+                }
+
+                SoundBankHeader header;
+
+                memset(&header,0,sizeof(header));
+
+                header.magic=SOUND_BANK_MAGIC;
+                header.version=SOUND_BANK_VERSION;
+                header.entry_count=uint32(items.size());
+                header.alignment=alignment;
+                header.index_offset=sizeof(SoundBankHeader);
+                header.names_offset=header.index_offset+uint64(items.size())*sizeof(SoundBankEntry);
+
+                std::vector<char> names;
+
+                for(Item &item:items)
+                {
+                    item.entry.name_offset=uint32(names.size());
+                    names.insert(names.end(),item.name.begin(),item.name.end());
+                    names.push_back(0);
+                }
+
+                uint64 offset=AlignUp(header.names_offset+names.size(),alignment);
+
+                for(Item &item:items)
+                {
+                    item.entry.offset=offset;
+                    offset=AlignUp(offset+item.entry.size,alignment);
+                }
+
+                FILE *fp=fopen(filename,"wb");
+
+                if(!fp)
+                {
+                    std::cerr << "Failed to create: " << filename << "\n";
+                    return false;
+                }
+
+                bool ok=fwrite(&header,sizeof(header),1,fp)==1;
+
+                for(const Item &item:items)
+                    ok=ok&&fwrite(&item.entry,sizeof(SoundBankEntry),1,fp)==1;
+
+                ok=ok&&(names.empty()||fwrite(names.data(),names.size(),1,fp)==1);
+
+                for(const Item &item:items)
+                {
+                    const long pad=long(item.entry.offset)-ftell(fp);
+
+                    for(long i=0;ok&&i<pad;i++)
+                        ok=fputc(0,fp)!=EOF;
+
+                    ok=ok&&fwrite(item.payload.data(),item.payload.size(),1,fp)==1;
+                }
+
+                fclose(fp);
+
+                if(!ok)
+                    std::cerr << "Failed to write: " << filename << "\n";
+
+                return ok;
+            }
+        };//class SoundBankWriter
+    }//namespace audio
+}//namespace hgl
@@ -1,9 +1,21 @@
 ﻿// AudioAssetManager Test
-// 验证资源缓存去重、引用计数、全量/流式决策（纯逻辑：用 Register 注入空 buffer，绕开 OpenAL 设备与文件加载）
+// 验证资源缓存去重、引用计数、全量/流式决策（纯逻辑：用 Register 注入空 buffer，绕开 OpenAL 设备与文件加载），
+// 以及用 sound_bank_builder 的写包代码生成声音包、挂载后取 PCM/压缩负载，损坏的包拒绝挂载
+// 用法: asset_manager_test [Vorbis/Opus 文件]（给出时额外验证声音包中压缩负载的 Acquire/AcquireAsync 解码，需要对应插件）
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
 #include <hgl/platform/Platform.h>
 #include <hgl/audio/AudioAssetManager.h>
 #include <hgl/audio/AudioBuffer.h>
+#include <hgl/audio/SoundBank.h>
+#include <hgl/audio/OpenAL.h>
+#include <hgl/time/Time.h>
+#include <hgl/type/StdString.h>
+#include "SoundBankWriter.h"
+#include "WavWriter.h"
 
 using namespace hgl;
 using namespace hgl::audio;
@@ -16,7 +28,240 @@ static void Check(const char *name, bool cond)
     if(!cond) ++failed;
 }
 
-int main()
+static const uint BANK_SAMPLE_RATE = 22050;
+static const int  BANK_FRAMES      = 1001;
+
+static short BankSample(int i){ return short((i * 37) % 30000 - 15000); }
+
+static bool WriteFile(const char *filename, const std::vector<char> &data, size_t size)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+    file.write(data.data(), size);
+    return bool(file);
+}
+
+static std::vector<char> ReadFile(const char *filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * 轮询 Update 直到异步加载完成（最多 5 秒）
+ */
+static void WaitAsync(AudioAssetManager &am)
+{
+    for(int i = 0; i < 500 && am.IsLoading(); i++)
+    {
+        am.Update();
+        hgl::SleepSecond(0.01);
+    }
+
+    am.Update();
+}
+
+/**
+ * 声音包：生成 WAV 与伪压缩文件，用 SoundBankWriter（sound_bank_builder 同一代码）写包
+ */
+static void TestSoundBank(const char *compressed_file)
+{
+    std::cout << std::endl << "[声音包]" << std::endl;
+
+    std::vector<short> pcm(BANK_FRAMES);
+
+    for(int i = 0; i < BANK_FRAMES; i++)
+        pcm[i] = BankSample(i);
+
+    {
+        WavWriter writer;
+
+        Check("生成 bank_tone.wav", writer.Open("bank_tone.wav", AL_FORMAT_MONO16, BANK_SAMPLE_RATE));
+        writer.Write(pcm.data(), BANK_FRAMES * sizeof(short));
+        writer.Close();
+    }
+
+    // 压缩负载原样入包、AcquireCompressed 原样返回，不需要能解码
+    std::vector<char> fake_ogg(777);
+
+    memcpy(fake_ogg.data(), "OggS", 4);
+    for(size_t i = 4; i < fake_ogg.size(); i++)
+        fake_ogg[i] = char(i * 29 + 1);
+
+    Check("生成 bank_fake.ogg", WriteFile("bank_fake.ogg", fake_ogg, fake_ogg.size()));
+
+    std::vector<SoundBankWriter::Item> items(2);
+
+    items[0].name = "ui/tone";      items[0].filename = "bank_tone.wav";
+    items[1].name = "music/fake";   items[1].filename = "bank_fake.ogg";
+
+    if(compressed_file)
+    {
+        items.emplace_back();
+        items.back().name = "music/real";
+        items.back().filename = compressed_file;
+    }
+
+    bool loaded = true;
+    for(SoundBankWriter::Item &item : items)
+        loaded = SoundBankWriter::LoadItem(item) && loaded;
+
+    Check("LoadItem 全部成功", loaded);
+    Check("写包 test.bank", loaded && SoundBankWriter::Write("test.bank", items));
+
+    // 1. SoundBank 直接读取
+    {
+        SoundBank bank;
+
+        Check("SoundBank::Open", bank.Open(OS_TEXT("test.bank")));
+        Check("项数一致", bank.GetCount() == items.size());
+
+        const SoundBankEntry *tone = bank.Find(OSString(OS_TEXT("ui/tone")));
+        const SoundBankEntry *fake = bank.Find(OSString(OS_TEXT("music/fake")));
+
+        Check("Find(ui/tone)", tone != nullptr);
+        Check("Find(music/fake)", fake != nullptr);
+        Check("Find 不存在的名称 -> nullptr", bank.Find(OSString(OS_TEXT("ui/none"))) == nullptr);
+
+        if(tone)
+        {
+            Check("PCM 负载：格式/采样率", tone->payload_type == uint32(SoundBankPayload::PCM)
+                                           && tone->format == uint32(AL_FORMAT_MONO16)
+                                           && tone->sample_rate == BANK_SAMPLE_RATE);
+            Check("PCM 负载与 WAV 采样一致", tone->size == BANK_FRAMES * sizeof(short)
+                                              && memcmp(bank.GetPayload(tone), pcm.data(), tone->size) == 0);
+            Check("负载按默认对齐", tone->offset % SOUND_BANK_DEFAULT_ALIGNMENT == 0);
+            Check("名称表", bank.GetName(tone) && strcmp(bank.GetName(tone), "ui/tone") == 0);
+        }
+
+        if(fake)
+            Check("压缩负载原样保存", fake->payload_type == uint32(SoundBankPayload::Vorbis)
+                                      && fake->size == fake_ogg.size()
+                                      && memcmp(bank.GetPayload(fake), fake_ogg.data(), fake_ogg.size()) == 0);
+    }
+
+    // 2. 损坏的包拒绝挂载
+    {
+        const std::vector<char> good = ReadFile("test.bank");
+
+        std::vector<char> bad_magic(good);
+        bad_magic[0] ^= 0x5A;
+        WriteFile("bad_magic.bank", bad_magic, bad_magic.size());
+
+        // 索引只写到一半
+        WriteFile("truncated.bank", good, sizeof(SoundBankHeader) + sizeof(SoundBankEntry) * items.size() / 2);
+
+        // 索引完整，最后一项负载被截断
+        WriteFile("short_payload.bank", good, good.size() - 1);
+
+        SoundBank bank;
+        Check("magic 错误 -> Open 失败", !bank.Open(OS_TEXT("bad_magic.bank")));
+        Check("索引被截断 -> Open 失败", !bank.Open(OS_TEXT("truncated.bank")));
+        Check("负载被截断 -> Open 失败", !bank.Open(OS_TEXT("short_payload.bank")));
+
+        AudioAssetManager am;
+        Check("magic 错误 -> MountBank 失败", !am.MountBank(OS_TEXT("bad_magic.bank")));
+        Check("索引被截断 -> MountBank 失败", !am.MountBank(OS_TEXT("truncated.bank")));
+        Check("失败的包不挂载", am.GetBankCount() == 0);
+    }
+
+    // 3. 挂载后经管理器取负载
+    AudioAssetManager am;
+
+    Check("MountBank(test.bank)", am.MountBank(OS_TEXT("test.bank")));
+    Check("GetBankCount == 1", am.GetBankCount() == 1);
+
+    {
+        AudioCompressedData *cd = am.AcquireCompressed(OS_TEXT("music/fake"));
+
+        Check("AcquireCompressed 命中声音包", cd != nullptr);
+
+        if(cd)
+        {
+            Check("压缩数据与源文件一致（指向映射内存）", !cd->owned
+                                                         && cd->size == int64(fake_ogg.size())
+                                                         && memcmp(cd->data, fake_ogg.data(), fake_ogg.size()) == 0);
+            Check("类型 Vorbis", cd->file_type == AudioFileType::Vorbis);
+            am.ReleaseCompressed(cd);
+        }
+
+        Check("PCM 负载不能压缩常驻", am.AcquireCompressed(OS_TEXT("ui/tone")) == nullptr);
+    }
+
+    bool al_ready = openal::InitOpenAL(nullptr, "null", false, false);
+
+    if(!al_ready)
+        al_ready = openal::InitOpenAL(nullptr, nullptr, false, false);
+
+    if(!al_ready)
+    {
+        std::cout << "  [SKIP] Acquire/AcquireAsync（OpenAL 初始化失败）" << std::endl;
+        return;
+    }
+
+    {
+        AudioBuffer *buf = am.Acquire(OS_TEXT("ui/tone"));
+
+        Check("Acquire(ui/tone) 从声音包加载", buf != nullptr && buf->IsLoaded());
+
+        if(buf)
+        {
+            Check("PCM 字节数一致", buf->GetSize() == BANK_FRAMES * sizeof(short));
+            Check("采样率一致", buf->GetFreq() == BANK_SAMPLE_RATE);
+            am.Release(buf);
+        }
+
+        am.Clear();
+
+        Check("AcquireAsync(ui/tone) PCM 负载无需解码", am.AcquireAsync(OS_TEXT("ui/tone")) && am.GetPendingCount() == 0);
+
+        buf = am.Acquire(OS_TEXT("ui/tone"));
+
+        Check("AcquireAsync 后 Acquire 得到同样的 PCM", buf != nullptr
+                                                        && buf->GetSize() == BANK_FRAMES * sizeof(short)
+                                                        && buf->GetFreq() == BANK_SAMPLE_RATE);
+        if(buf)
+            am.Release(buf);
+    }
+
+    if(compressed_file)
+    {
+        // 与直接从文件解码的结果比较
+        AudioBuffer direct(ToOSString(std::string(compressed_file)).c_str());
+
+        Check("直接解码压缩文件", direct.IsLoaded());
+
+        AudioBuffer *buf = am.Acquire(OS_TEXT("music/real"));
+
+        Check("Acquire(music/real) 从声音包解码", buf != nullptr);
+
+        if(buf)
+        {
+            Check("解码字节数与直接解码一致", buf->GetSize() == direct.GetSize());
+            Check("采样率与直接解码一致", buf->GetFreq() == direct.GetFreq());
+            am.Release(buf);
+        }
+
+        am.Clear();
+
+        Check("AcquireAsync(music/real) 提交", am.AcquireAsync(OS_TEXT("music/real")));
+        WaitAsync(am);
+
+        Check("异步解码完成并登记", !am.IsLoading() && am.Contains(OS_TEXT("music/real")));
+
+        buf = am.Acquire(OS_TEXT("music/real"));
+
+        Check("异步解码字节数与直接解码一致", buf != nullptr && buf->GetSize() == direct.GetSize());
+        if(buf)
+            am.Release(buf);
+    }
+
+    am.Clear();
+    openal::CloseOpenAL();
+}
+
+int main(int argc, char **argv)
 {
     std::cout << "AudioAssetManager Test" << std::endl;
     std::cout << "======================" << std::endl;
@@ -29,6 +274,14 @@ int main()
     Check("16MB -> Stream",           SuggestAudioLoadMode(16*1024*1024) == AudioLoadMode::Stream);
     Check("负值(未知大小) -> Stream", SuggestAudioLoadMode(-1) == AudioLoadMode::Stream);
 
+    // 按格式 + 时长决策：压缩格式中等时长压缩常驻
+    Check("Opus 3s -> Full",          SuggestAudioLoadMode(AudioFileType::Opus, 3.0) == AudioLoadMode::Full);
+    Check("Opus 12s -> Compressed",   SuggestAudioLoadMode(AudioFileType::Opus, 12.0) == AudioLoadMode::Compressed);
+    Check("Vorbis 30s -> Compressed", SuggestAudioLoadMode(AudioFileType::Vorbis, 30.0) == AudioLoadMode::Compressed);
+    Check("Vorbis 180s -> Stream",    SuggestAudioLoadMode(AudioFileType::Vorbis, 180.0) == AudioLoadMode::Stream);
+    Check("Wav 12s 按大小 -> Stream", SuggestAudioLoadMode(AudioFileType::Wav, 12.0, 2*1024*1024) == AudioLoadMode::Stream);
+    Check("时长未知按大小 -> Full",   SuggestAudioLoadMode(AudioFileType::Opus, 0, 200*1024) == AudioLoadMode::Full);
+
     // 2. 登记 / 查找 / 计数
     AudioAssetManager am;
 
@@ -97,6 +350,42 @@ int main()
     Check("命中不启动线程 -> GetPendingCount == 0", am.GetPendingCount() == 0);
     am.Clear();
 
+    // 9. 驻留策略：启用预算后归零不卸载，进入 LRU；Pin 的资源不进入 LRU
+    am.ResetResidencyCounters();
+    am.SetResidentBudget(1024*1024);
+    Check("GetResidentBudget == 1MB",   am.GetResidentBudget() == 1024*1024);
+
+    AudioBuffer *b5 = new AudioBuffer();
+    am.Register(OS_TEXT("retain"), b5);
+    am.Release(OS_TEXT("retain"));
+    Check("启用预算：归零后仍 Contains", am.Contains(OS_TEXT("retain")));
+    Check("归零后 idle_count == 1",     am.GetResidencyStats().idle_count == 1);
+
+    Check("再次 Acquire 命中保留的 buffer", am.Acquire(OS_TEXT("retain")) == b5);
+    Check("hit_count == 1",             am.GetResidencyStats().hit_count == 1);
+    Check("命中后移出 LRU",             am.GetResidencyStats().idle_count == 0);
+
+    Check("Pin(retain) 成功",           am.Pin(OS_TEXT("retain")));
+    Check("Pin 不存在的键失败",         !am.Pin(OS_TEXT("nonexistent")));
+    am.Release(b5);
+    Check("固定资源归零不进入 LRU",     am.IsPinned(OS_TEXT("retain")) && am.GetResidencyStats().idle_count == 0);
+
+    am.SetResidentBudget(0);            // 关闭驻留：固定资源不受影响
+    Check("关闭预算后固定资源仍在",     am.Contains(OS_TEXT("retain")));
+
+    am.Unpin(OS_TEXT("retain"));        // 无引用且未启用预算 -> 立即卸载
+    Check("Unpin 后卸载",               !am.Contains(OS_TEXT("retain")));
+    am.Clear();
+
+    // 10. 声音包：挂载失败不影响管理器；名称哈希与 CueNameHash 同源（UTF-8 字节）
+    Check("MountBank 不存在的文件 -> false", !am.MountBank(OS_TEXT("nonexistent.bank")));
+    Check("GetBankCount == 0",          am.GetBankCount() == 0);
+    Check("SoundBankNameHash(OSString) == (UTF-8)", SoundBankNameHash(OSString(OS_TEXT("ui/click"))) == SoundBankNameHash("ui/click"));
+    Check("不同名称哈希不同",           SoundBankNameHash("ui/click") != SoundBankNameHash("ui/clack"));
+
+    // 11. 生成并挂载声音包
+    TestSoundBank(argc > 1 ? argv[1] : nullptr);
+
     std::cout << std::endl;
     if(failed == 0)
     {
@@ -1,12 +1,17 @@
 ﻿// Async Load Test
-// 端到端验证异步加载：OpenAL null 设备 + 生成 wav + 后台解码 + 主线程上传 + 缓存登记
+// 端到端验证异步加载：OpenAL null 设备 + 生成 wav + 后台解码 + 主线程上传 + 缓存登记，
+// 以及单线程解码池在暂停状态下排队时的优先级顺序、SetAsyncPriority 重排与 CancelAsync
 #include <iostream>
 #include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
 #include <hgl/platform/Platform.h>
 #include <hgl/audio/AudioAssetManager.h>
 #include <hgl/audio/AudioBuffer.h>
 #include <hgl/audio/OpenAL.h>
 #include <hgl/time/Time.h>
+#include <hgl/type/StdString.h>
 #include "WavWriter.h"
 
 using namespace hgl;
@@ -92,6 +97,11 @@ int main()
     Check("缓存已登记 Contains", am.Contains(OS_TEXT("test_async.wav")));
     Check("GetCount == 1", am.GetCount() == 1);
 
+    const AudioUploadStats stats = am.GetUploadStats();
+    Check("上传统计 total_count == 1", stats.total_count == 1);
+    Check("上传统计 total_bytes == 1s 16bit 单声道", stats.total_bytes == 44100 * 2);
+    Check("无待上传积压", stats.backlog_count == 0 && stats.backlog_bytes == 0);
+
     // 5. Acquire 命中缓存（去重 + 引用计数）
     AudioBuffer *buf = am.Acquire(OS_TEXT("test_async.wav"));
 
@@ -119,6 +129,81 @@ int main()
     Check("释放全部引用后 GetCount == 0", am.GetCount() == 0);
 
     am.Clear();
+
+    // 8. 解码顺序：1 个工作线程、暂停状态下排队，恢复后完成顺序只由优先级决定（同优先级按提交顺序）
+    {
+        const char *names[] = { "test_order_a.wav", "test_order_b.wav", "test_order_c.wav",
+                                "test_order_d.wav", "test_order_e.wav", "test_order_f.wav" };
+
+        bool generated = true;
+        for(const char *name : names)
+            generated = generated && GenerateTestWav(name);
+
+        Check("生成排序测试 wav", generated);
+
+        AudioAssetManager pool;
+
+        Check("SetDecodeWorkerCount(1)", pool.SetDecodeWorkerCount(1));
+
+        pool.PauseAsync();                                          // 解码池以暂停状态启动
+
+        Check("提交 a(0)", pool.AcquireAsync(OS_TEXT("test_order_a.wav"), 0));
+        Check("提交 b(5)", pool.AcquireAsync(OS_TEXT("test_order_b.wav"), 5));
+        Check("提交 c(1)", pool.AcquireAsync(OS_TEXT("test_order_c.wav"), 1));
+        Check("提交 d(3)", pool.AcquireAsync(OS_TEXT("test_order_d.wav"), 3));
+        Check("提交 e(2)", pool.AcquireAsync(OS_TEXT("test_order_e.wav"), 2));
+        Check("提交 f(1)", pool.AcquireAsync(OS_TEXT("test_order_f.wav"), 1));
+
+        Check("SetAsyncPriority a → 10（升）", pool.SetAsyncPriority(OS_TEXT("test_order_a.wav"), 10));
+        Check("SetAsyncPriority b → -1（降）", pool.SetAsyncPriority(OS_TEXT("test_order_b.wav"), -1));
+        Check("CancelAsync d", pool.CancelAsync(OS_TEXT("test_order_d.wav")));
+        Check("重复 CancelAsync d 返回 false", !pool.CancelAsync(OS_TEXT("test_order_d.wav")));
+        Check("SetAsyncPriority 已取消的 d 返回 false", !pool.SetAsyncPriority(OS_TEXT("test_order_d.wav"), 7));
+
+        hgl::SleepSecond(0.05);
+
+        Check("暂停中不开始解码", pool.GetUploadStats().backlog_count == 0);
+        Check("暂停中在途任务 == 5", pool.GetPendingCount() == 5);
+
+        pool.ResumeAsync();
+
+        int wait_iters = 500;
+        while(pool.GetUploadStats().backlog_count < 5 && wait_iters-- > 0)
+            hgl::SleepSecond(0.01);
+
+        Check("恢复后 5 个任务全部解码", pool.GetUploadStats().backlog_count == 5);
+
+        // 每次 Update 只上传一项（字节预算 1），完成队列按解码完成顺序排列
+        std::vector<std::string> order;
+        bool one_per_update = true;
+
+        for(int i = 0; i < 5; i++)
+        {
+            if(pool.Update(0, 1) != 1)
+                one_per_update = false;
+
+            for(const char *name : names)
+                if(std::find(order.begin(), order.end(), name) == order.end()
+                 && pool.Contains(ToOSString(std::string(name)).c_str()))
+                    order.push_back(name);
+        }
+
+        Check("Update 每次上传一项", one_per_update);
+
+        const std::vector<std::string> expected = { "test_order_a.wav", "test_order_e.wav", "test_order_c.wav",
+                                                    "test_order_f.wav", "test_order_b.wav" };
+
+        std::cout << "    完成顺序:";
+        for(const std::string &o : order)
+            std::cout << " " << o;
+        std::cout << std::endl;
+
+        Check("完成顺序 a(10) e(2) c(1) f(1) b(-1)", order == expected);
+        Check("已取消的 d 未加载", !pool.Contains(OS_TEXT("test_order_d.wav")));
+        Check("全部完成 !IsLoading", !pool.IsLoading());
+
+        pool.Clear();
+    }
     openal::CloseOpenAL();
 
     std::cout << std::endl;
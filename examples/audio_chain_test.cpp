@@ -0,0 +1,173 @@
+﻿// Audio Chain Test
+// 验证 AudioPlayer 的无缝接续：两个长度不是缓冲区整数倍的 wav，QueueNext 后逐块渲染，
+// 输出总帧数等于两文件之和，接续点无静音、无重复帧；交叉淡化时淡化区之外两端数据原样保留
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <hgl/audio/AudioPlayer.h>
+#include <hgl/audio/OpenAL.h>
+#include "WavWriter.h"
+
+using namespace hgl;
+using namespace hgl::audio;
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+/**
+ * 不启动播放线程，直接调用渲染流程取出送往 OpenAL 的数据
+ */
+class ChainProbe:public AudioPlayer
+{
+public:
+
+    using AudioPlayer::RenderBlock;
+    using AudioPlayer::al_format;
+    using AudioPlayer::audio_buffer;
+};//class ChainProbe
+
+static const uint SAMPLE_RATE = 22050;
+static const int  FRAMES_A    = 10007;         // 均不是缓冲区帧数的整数倍
+static const int  FRAMES_B    = 7919;
+
+// 两个文件取值互不相交，相邻采样差值大于浮点回读误差，错位一帧即可发现
+static short SampleA(int i){ return short((i * 7) % 20000); }
+static short SampleB(int i){ return short(-((i * 11) % 20000) - 1); }
+
+static bool GenerateWav(const char *filename, int frames, short (*sample)(int))
+{
+    std::vector<short> data(frames);
+
+    for(int i = 0; i < frames; i++)
+        data[i] = sample(i);
+
+    WavWriter writer;
+
+    if(!writer.Open(filename, AL_FORMAT_MONO16, SAMPLE_RATE))
+        return false;
+
+    writer.Write(data.data(), frames * sizeof(short));
+    writer.Close();
+    return true;
+}
+
+/**
+ * 渲染到结束，输出统一转换为 int16（设备支持浮点时播放器解码为 float）
+ */
+static std::vector<int> RenderAll(ChainProbe &player)
+{
+    std::vector<int> output;
+
+    const bool is_float = (player.al_format == AL_FORMAT_MONO_FLOAT32);
+
+    for(int guard = 0; guard < 100000; guard++)
+    {
+        const uint size = player.RenderBlock(player.audio_buffer);
+
+        if(!size)break;
+
+        if(is_float)
+        {
+            const float *p = (const float *)player.audio_buffer;
+
+            for(uint i = 0; i < size / sizeof(float); i++)
+                output.push_back(int(std::lround(p[i] * 32768.0f)));
+        }
+        else
+        {
+            const short *p = (const short *)player.audio_buffer;
+
+            for(uint i = 0; i < size / sizeof(short); i++)
+                output.push_back(p[i]);
+        }
+    }
+
+    return output;
+}
+
+static bool SameAs(const std::vector<int> &output, int offset, int count, int first, short (*sample)(int))
+{
+    if(offset < 0 || offset + count > int(output.size()))
+        return false;
+
+    for(int i = 0; i < count; i++)
+        if(output[offset + i] != sample(first + i))
+            return false;
+
+    return true;
+}
+
+int main()
+{
+    std::cout << "Audio Chain Test" << std::endl;
+    std::cout << "================" << std::endl;
+
+    bool al_ready = openal::InitOpenAL(nullptr, "null", false, false);
+
+    if(!al_ready)
+    {
+        std::cout << "  (null 设备失败，回退默认设备)" << std::endl;
+        al_ready = openal::InitOpenAL(nullptr, nullptr, false, false);
+    }
+
+    Check("InitOpenAL 成功", al_ready);
+
+    if(!al_ready)
+    {
+        std::cout << std::endl << "OpenAL 初始化失败，无法继续接续测试" << std::endl;
+        return 1;
+    }
+
+    Check("生成 wav A", GenerateWav("test_chain_a.wav", FRAMES_A, SampleA));
+    Check("生成 wav B", GenerateWav("test_chain_b.wav", FRAMES_B, SampleB));
+
+    // 1. 无淡化接续：A 最后一帧之后紧接 B 第一帧
+    {
+        ChainProbe player;
+
+        Check("Load A", player.Load(OS_TEXT("test_chain_a.wav")));
+        Check("QueueNext B", player.QueueNext(OS_TEXT("test_chain_b.wav")));
+
+        const std::vector<int> output = RenderAll(player);
+
+        Check("总帧数 == A + B", int(output.size()) == FRAMES_A + FRAMES_B);
+        Check("前段与 A 完全相同", SameAs(output, 0, FRAMES_A, 0, SampleA));
+        Check("后段与 B 完全相同（无静音、无重复）", SameAs(output, FRAMES_A, FRAMES_B, 0, SampleB));
+        Check("接续次数 == 1", player.GetTransitionCount() == 1);
+        Check("接续后无待接续文件", !player.HasNext());
+    }
+
+    // 2. 交叉淡化 0.1 秒：淡化从 A 结尾前 fade 帧开始，总长缩短 fade 帧
+    {
+        const int fade = int(0.1 * SAMPLE_RATE + 0.5);
+
+        ChainProbe player;
+
+        Check("Load A（淡化）", player.Load(OS_TEXT("test_chain_a.wav")));
+        Check("QueueNext B 0.1s", player.QueueNext(OS_TEXT("test_chain_b.wav"), 0.1));
+
+        const std::vector<int> output = RenderAll(player);
+
+        Check("总帧数 == A + B - fade", int(output.size()) == FRAMES_A + FRAMES_B - fade);
+        Check("淡化前与 A 完全相同", SameAs(output, 0, FRAMES_A - fade, 0, SampleA));
+        Check("淡化后与 B 剩余部分完全相同", SameAs(output, FRAMES_A, FRAMES_B - fade, fade, SampleB));
+        Check("接续次数 == 1（淡化）", player.GetTransitionCount() == 1);
+    }
+
+    openal::CloseOpenAL();
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
@@ -0,0 +1,151 @@
+﻿// Crossfade Test
+// 验证等功率交叉淡化内核：逐个强制 SampleConvertPath，SIMD 路径与标量内核输出一致，
+// 淡化两端增益约为 1/0，全程 a²+b²≈1（纯 CPU，无需 OpenAL）
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <hgl/audio/AudioCrossfade.h>
+#include <hgl/audio/SampleConvert.h>
+
+using namespace hgl;
+using namespace hgl::audio;
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+static const SampleConvertPath paths[] = { SampleConvertPath::Scalar, SampleConvertPath::SSE2,
+                                           SampleConvertPath::AVX2, SampleConvertPath::NEON };
+static const char *path_names[] = { "Scalar", "SSE2", "AVX2", "NEON" };
+
+/**
+ * 用常数 1/0 输入取出每帧的两路增益：from=1,to=0 得 a，from=0,to=1 得 b
+ */
+static void MeasureGains(uint frames, uint channels, float start, float step, std::vector<float> &a, std::vector<float> &b)
+{
+    const size_t samples = (size_t)frames * channels;
+
+    const std::vector<float> ones(samples, 1.0f);
+    const std::vector<float> zeros(samples, 0.0f);
+
+    a.assign(samples, 0.0f);
+    b.assign(samples, 0.0f);
+
+    CrossfadeEqualPower(ones.data(), zeros.data(), a.data(), frames, channels, start, step);
+    CrossfadeEqualPower(zeros.data(), ones.data(), b.data(), frames, channels, start, step);
+}
+
+int main()
+{
+    std::cout << "Crossfade Test" << std::endl;
+    std::cout << "==============" << std::endl;
+
+    const SampleConvertPath original = GetSampleConvertPath();
+
+    // 帧数取非向量宽度整数倍，且超过内核每次展开的 256 采样，覆盖分块与尾部标量处理
+    const uint frames = 1001;
+    const uint channels_list[] = { 1, 2, 6 };
+
+    for(uint channels : channels_list)
+    {
+        const size_t samples = (size_t)frames * channels;
+        const float step = 1.0f / float(frames);
+        const float start = step;                       // 与 AudioPlayer 相同：最后一帧正好全部是下一文件
+
+        std::vector<float> from(samples), to(samples);
+
+        for(size_t i = 0; i < samples; i++)
+        {
+            from[i] = 0.8f * std::sin(0.013f * float(i));
+            to[i]   = 0.6f * std::cos(0.029f * float(i));
+        }
+
+        std::vector<float> reference(samples);
+
+        Check("强制标量路径", SetSampleConvertPath(SampleConvertPath::Scalar));
+        CrossfadeEqualPower(from.data(), to.data(), reference.data(), frames, channels, start, step);
+
+        for(int p = 0; p < 4; p++)
+        {
+            if(!SetSampleConvertPath(paths[p]))
+            {
+                std::cout << "  (" << path_names[p] << " 不可用，跳过)" << std::endl;
+                continue;
+            }
+
+            const std::string prefix = std::string(path_names[p]) + " " + std::to_string(channels) + " 声道";
+
+            std::vector<float> output(samples);
+            CrossfadeEqualPower(from.data(), to.data(), output.data(), frames, channels, start, step);
+
+            float max_diff = 0;
+            for(size_t i = 0; i < samples; i++)
+                max_diff = std::fmax(max_diff, std::fabs(output[i] - reference[i]));
+
+            Check((prefix + " 与标量内核一致（误差 < 1e-6）").c_str(), max_diff < 1e-6f);
+
+            // 原地输出（output 与 from 相同）
+            std::vector<float> in_place(from);
+            CrossfadeEqualPower(in_place.data(), to.data(), in_place.data(), frames, channels, start, step);
+
+            bool same = true;
+            for(size_t i = 0; i < samples; i++)
+                if(std::fabs(in_place[i] - output[i]) > 1e-7f) same = false;
+
+            Check((prefix + " 原地输出与独立输出一致").c_str(), same);
+
+            // 增益曲线
+            std::vector<float> a, b;
+            MeasureGains(frames, channels, 0.0f, 1.0f / float(frames - 1), a, b);
+
+            const size_t last = samples - channels;
+
+            Check((prefix + " 起点 a≈1 b≈0").c_str(), std::fabs(a[0] - 1.0f) < 1e-5f && std::fabs(b[0]) < 1e-5f);
+            Check((prefix + " 终点 a≈0 b≈1").c_str(), std::fabs(a[last]) < 1e-5f && std::fabs(b[last] - 1.0f) < 1e-5f);
+
+            float max_power_error = 0;
+            bool monotonic = true;
+            bool same_per_channel = true;
+
+            for(uint f = 0; f < frames; f++)
+            {
+                const size_t i = (size_t)f * channels;
+
+                max_power_error = std::fmax(max_power_error, std::fabs(a[i] * a[i] + b[i] * b[i] - 1.0f));
+
+                if(f > 0 && (a[i] > a[i - channels] + 1e-7f || b[i] < b[i - channels] - 1e-7f))
+                    monotonic = false;
+
+                for(uint ch = 1; ch < channels; ch++)
+                    if(a[i + ch] != a[i] || b[i + ch] != b[i])
+                        same_per_channel = false;
+            }
+
+            Check((prefix + " 全程 a²+b²≈1（误差 < 1e-4）").c_str(), max_power_error < 1e-4f);
+            Check((prefix + " a 单调减、b 单调增").c_str(), monotonic);
+            Check((prefix + " 同一帧各声道增益相同").c_str(), same_per_channel);
+
+            // 位置钳位：start<0 与超出 1 的部分分别停在 0 与 1
+            MeasureGains(8, channels, -1.0f, 0.5f, a, b);
+
+            Check((prefix + " 位置 <0 钳位为全部 from").c_str(), std::fabs(a[0] - 1.0f) < 1e-5f && std::fabs(b[0]) < 1e-6f);
+            Check((prefix + " 位置 >1 钳位为全部 to").c_str(), std::fabs(a[7 * channels]) < 1e-6f && std::fabs(b[7 * channels] - 1.0f) < 1e-5f);
+        }
+    }
+
+    SetSampleConvertPath(original);
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
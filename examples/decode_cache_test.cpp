@@ -0,0 +1,216 @@
+﻿// Decode Cache Test
+// 验证解码结果磁盘缓存：写入后命中且数据一致；源数据内容/大小、外部设置、浮点输出改变后不再命中；
+// 缓存文件头被截断或损坏时拒绝使用
+// 直接调用内部缓存入口（src/AudioDecode.h），不需要解码插件与 OpenAL 设备
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <vector>
+#include <hgl/audio/AudioDecodeCache.h>
+#include "../src/AudioDecode.h"
+
+using namespace hgl;
+using namespace hgl::audio;
+
+namespace fs = std::filesystem;
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+static const fs::path cache_dir("decode_cache_test_dir");
+
+static const os_char *plugin_name = OS_TEXT("Audio.Vorbis");
+
+static bool MakeKey(const std::vector<char> &source, bool use_float, AudioDecodeCacheKey *key)
+{
+    return MakeAudioDecodeCacheKey(AudioFileType::Vorbis, plugin_name, source.data(), (int)source.size(), use_float, key);
+}
+
+/**
+ * 查缓存，命中时与 pcm 逐字节比较后解除映射
+ */
+static bool Lookup(const AudioDecodeCacheKey &key, const std::vector<char> &pcm, bool *same = nullptr)
+{
+    DecodedAudio decoded;
+
+    if(!LoadAudioDecodeCache(key, &decoded))
+        return false;
+
+    if(same)
+        *same = decoded.mapped != nullptr
+             && decoded.format == AL_FORMAT_MONO16
+             && decoded.freq == 22050
+             && decoded.size == (ALsizei)pcm.size()
+             && std::memcmp(decoded.data, pcm.data(), pcm.size()) == 0;
+
+    decoded.Release();
+    return true;
+}
+
+static void Store(const AudioDecodeCacheKey &key, std::vector<char> &pcm)
+{
+    DecodedAudio decoded;
+
+    decoded.format = AL_FORMAT_MONO16;
+    decoded.data   = pcm.data();
+    decoded.size   = (ALsizei)pcm.size();
+    decoded.freq   = 22050;
+
+    StoreAudioDecodeCache(key, &decoded);
+
+    decoded.data = nullptr;                     // 数据属于 pcm，不经 Release 释放
+}
+
+static std::vector<fs::path> ListCacheFiles(const char *extension)
+{
+    std::vector<fs::path> files;
+
+    for(const fs::directory_entry &entry : fs::directory_iterator(cache_dir))
+        if(entry.path().extension() == extension)
+            files.push_back(entry.path());
+
+    return files;
+}
+
+static std::vector<char> ReadAll(const fs::path &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void WriteAll(const fs::path &filename, const std::vector<char> &data, size_t size)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+    file.write(data.data(), size);
+}
+
+int main()
+{
+    std::cout << "Decode Cache Test" << std::endl;
+    std::cout << "=================" << std::endl;
+
+    std::error_code ec;
+    fs::remove_all(cache_dir, ec);
+
+    // 伪造的“压缩”源数据与其解码结果（缓存不关心内容，只按键存取）
+    std::vector<char> source(4001);
+    std::vector<char> pcm(22050 * 2);
+
+    for(size_t i = 0; i < source.size(); i++)
+        source[i] = char(i * 131 + 7);
+
+    for(size_t i = 0; i < pcm.size(); i++)
+        pcm[i] = char(i * 17 + 3);
+
+    AudioDecodeCacheKey key;
+
+    // 1. 启用前不生成键
+    Check("未启用时 MakeAudioDecodeCacheKey 返回 false", !MakeKey(source, false, &key));
+
+    Check("EnableAudioDecodeCache", EnableAudioDecodeCache(cache_dir.native().c_str(), 64 * 1024 * 1024));
+    Check("IsAudioDecodeCacheEnabled", IsAudioDecodeCacheEnabled());
+
+    Check("WAV 不缓存", !MakeAudioDecodeCacheKey(AudioFileType::Wav, plugin_name, source.data(), (int)source.size(), false, &key));
+    Check("生成缓存键", MakeKey(source, false, &key));
+
+    // 2. 写入前未命中，写入后命中且数据一致
+    const AudioDecodeCacheStats before = GetAudioDecodeCacheStats();
+
+    Check("写入前未命中", !Lookup(key, pcm));
+
+    Store(key, pcm);
+
+    Check("写入后生成 1 个缓存文件", ListCacheFiles(".pcm").size() == 1);
+    Check("无残留临时文件", ListCacheFiles(".tmp").empty());
+
+    bool same = false;
+    Check("写入后命中", Lookup(key, pcm, &same));
+    Check("命中数据与格式一致", same);
+
+    const AudioDecodeCacheStats after = GetAudioDecodeCacheStats();
+
+    Check("统计 miss +1", after.miss_count == before.miss_count + 1);
+    Check("统计 hit +1", after.hit_count == before.hit_count + 1);
+    Check("统计 store +1", after.store_count == before.store_count + 1);
+
+    // 3. 源数据或设置改变后不再命中
+    {
+        std::vector<char> changed(source);
+        changed[changed.size() / 2] ^= 1;
+
+        AudioDecodeCacheKey changed_key;
+        Check("源数据内容改变 → 未命中", MakeKey(changed, false, &changed_key) && !Lookup(changed_key, pcm));
+
+        std::vector<char> longer(source);
+        longer.push_back(0);
+
+        Check("源数据大小改变 → 未命中", MakeKey(longer, false, &changed_key) && !Lookup(changed_key, pcm));
+
+        Check("浮点输出改变 → 未命中", MakeKey(source, true, &changed_key) && !Lookup(changed_key, pcm));
+
+        SetAudioDecodeCacheSettingsKey("soundfont=b.sf2");
+        Check("外部设置改变 → 未命中", MakeKey(source, false, &changed_key) && !Lookup(changed_key, pcm));
+        SetAudioDecodeCacheSettingsKey(nullptr);
+
+        Check("恢复原设置后仍命中原缓存", MakeKey(source, false, &changed_key) && Lookup(changed_key, pcm));
+    }
+
+    // 4. 截断或损坏的缓存文件被拒绝
+    {
+        const fs::path cache_file = ListCacheFiles(".pcm").front();
+        const std::vector<char> good = ReadAll(cache_file);
+
+        Check("缓存文件大小 = 文件头 + PCM", good.size() > pcm.size());
+
+        const size_t header_size = good.size() - pcm.size();
+
+        WriteAll(cache_file, good, header_size / 2);
+        Check("文件头被截断 → 拒绝", !Lookup(key, pcm));
+
+        WriteAll(cache_file, good, header_size + pcm.size() / 2);
+        Check("PCM 数据被截断 → 拒绝", !Lookup(key, pcm));
+
+        std::vector<char> bad_magic(good);
+        bad_magic[0] ^= 0x5A;
+        WriteAll(cache_file, bad_magic, bad_magic.size());
+        Check("magic 损坏 → 拒绝", !Lookup(key, pcm));
+
+        std::vector<char> bad_version(good);
+        bad_version[4] ^= 0x5A;
+        WriteAll(cache_file, bad_version, bad_version.size());
+        Check("版本号损坏 → 拒绝", !Lookup(key, pcm));
+
+        std::vector<char> bad_key(good);
+        bad_key[8] ^= 0x5A;                     // 源数据哈希：文件名碰撞时靠完整键区分
+        WriteAll(cache_file, bad_key, bad_key.size());
+        Check("文件头中的键不符 → 拒绝", !Lookup(key, pcm));
+
+        Store(key, pcm);                        // 重新写入即恢复
+        same = false;
+        Check("重新写入后再次命中", Lookup(key, pcm, &same) && same);
+    }
+
+    // 5. 停用后不再查缓存
+    DisableAudioDecodeCache();
+    Check("停用后不命中", !Lookup(key, pcm));
+
+    fs::remove_all(cache_dir, ec);
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
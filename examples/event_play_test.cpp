@@ -1,13 +1,15 @@
 ﻿// Event Play Test (T5)
 // 验证事件指令 → 真实播放映射：
-// Play（Cue 查表→AudioPlayer 播放→PlayStarted）、播完 PlayFinished、
-// Stop→Stopped、未知 Cue→Error、SetBusVolume、Snapshot
+// Play（Cue 查表→常驻音源播放→PlayStarted）、播完 PlayFinished、
+// Stop→Stopped、未知 Cue→Error、SetBusVolume、Snapshot、
+// LoadCue→LoadComplete、音源用尽时抢占最早实例、UnloadCue 停止该 Cue 实例、流式音源用尽→Error 4
 // 需要 OpenAL32.dll + fmt.dll 在运行目录（null 后端也可）
 #include <iostream>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <vector>
+#include <algorithm>
 #include <hgl/audio/AudioEngineThread.h>
 #include <hgl/audio/EventTransport.h>
 #include <hgl/time/Time.h>
@@ -115,8 +117,18 @@ int main()
         snap.SetGain(AudioBusType::Music,-6.0f);
         snap.SetGain(AudioBusType::SFX,-3.0f);
         cues.AddSnapshot(OS_TEXT("menu"),snap);
+
+        // 流式 Cue（循环，不会自然结束）
+        SoundEventConfig stream_tone;
+        stream_tone.files.Add(OS_TEXT("test_tone.wav"));
+        stream_tone.bus_type=AudioBusType::SFX;
+        stream_tone.stream=true;
+        stream_tone.loop=true;
+        cues.AddEvent(OS_TEXT("stream_tone"),stream_tone);
     }
 
+    t.SetVoiceCount(2,1);               // 常驻音源 2 个、流式音源 1 个，便于测试抢占与用尽
+
     Check("Start 成功", t.Start());
 
     // ---- 1. Play → PlayStarted + 实例活跃 ----
@@ -189,11 +201,16 @@ int main()
 
         AudioEventResult r;
         bool got_error=false;
+        uint32 error_code=0;
         while(q.PollResult(r))
             if(r.type==uint32(AudioEventResultType::Error))
+            {
                 got_error=true;
+                error_code=r.error_code;
+            }
 
         Check("收到 Error", got_error);
+        Check("error_code == 1（未知 Cue）", error_code==1);
     }
 
     // ---- 3. Stop → Stopped ----
@@ -246,6 +263,151 @@ int main()
         Check("Music 快照生效 0.5", std::fabs(music_gain-0.5f)<0.01f);
     }
 
+    // ---- 5. LoadCue → LoadComplete ----
+    std::cout << "[5] LoadCue → LoadComplete" << std::endl;
+    {
+        AudioEvent load(AudioEventType::LoadCue, CueNameHash("test_tone"), 0, 7);
+        q.Send(load);
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        AudioEventResult r;
+        bool complete=false;
+        while(q.PollResult(r))
+            if(r.type==uint32(AudioEventResultType::LoadComplete)&&r.error_code==0&&r.seq==7)
+                complete=true;
+
+        Check("收到 LoadComplete", complete);
+
+        AudioEvent unknown(AudioEventType::LoadCue, CueNameHash("nonexistent_cue"), 0, 8);
+        q.Send(unknown);
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        uint32 error_code=0;
+        while(q.PollResult(r))
+            if(r.type==uint32(AudioEventResultType::Error))
+                error_code=r.error_code;
+
+        Check("LoadCue 未知 Cue → error_code 1", error_code==1);
+    }
+
+    // ---- 6. 常驻音源用尽 → 抢占最早的实例 ----
+    std::cout << "[6] 音源抢占" << std::endl;
+    std::vector<uint32> live;
+    {
+        for(uint32 seq=10;seq<13;seq++)
+        {
+            AudioEvent ev(AudioEventType::Play, CueNameHash("test_tone"), 0, seq);
+            q.Send(ev);
+        }
+
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        AudioEventResult r;
+        std::vector<uint32> started;
+        std::vector<uint32> stopped;
+        while(q.PollResult(r))
+        {
+            if(r.type==uint32(AudioEventResultType::PlayStarted)&&r.error_code==0)
+                started.push_back(r.instance_id);
+            else
+            if(r.type==uint32(AudioEventResultType::Stopped))
+                stopped.push_back(r.instance_id);
+        }
+
+        Check("3 次 Play 都收到 PlayStarted", started.size()==3);
+        Check("收到 1 个 Stopped", stopped.size()==1);
+        Check("被抢占的是最早的实例", started.size()==3&&stopped.size()==1&&stopped[0]==started[0]);
+        Check("实例活跃 2（音源数）", t.GetActiveInstanceCount()==2);
+
+        if(started.size()==3)
+            live.assign(started.begin()+1,started.end());
+    }
+
+    // ---- 7. UnloadCue → 停止该 Cue 的实例 ----
+    std::cout << "[7] UnloadCue 停止实例" << std::endl;
+    {
+        AudioEvent unload(AudioEventType::UnloadCue, CueNameHash("test_tone"), 0, 14);
+        q.Send(unload);
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        AudioEventResult r;
+        std::vector<uint32> stopped;
+        while(q.PollResult(r))
+            if(r.type==uint32(AudioEventResultType::Stopped))
+                stopped.push_back(r.instance_id);
+
+        bool all_stopped=(stopped.size()==live.size())&&!live.empty();
+        for(uint32 id : live)
+            if(std::find(stopped.begin(),stopped.end(),id)==stopped.end())
+                all_stopped=false;
+
+        Check("仍在播放的实例都收到 Stopped", all_stopped);
+        Check("实例已清理", t.GetActiveInstanceCount()==0);
+
+        // 卸载后再次 Play 重新取得资源
+        AudioEvent ev(AudioEventType::Play, CueNameHash("test_tone"), 0, 15);
+        q.Send(ev);
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        uint32 inst=0;
+        while(q.PollResult(r))
+            if(r.type==uint32(AudioEventResultType::PlayStarted)&&r.error_code==0)
+                inst=r.instance_id;
+
+        Check("卸载后再次 Play 成功", inst!=0);
+
+        AudioEvent stop(AudioEventType::Stop, 0, inst, 16);
+        q.Send(stop);
+        t.WaitIdle(3000);
+        while(q.PollResult(r)){}
+    }
+
+    // ---- 8. 流式音源用尽 → Error 4 ----
+    std::cout << "[8] 流式音源用尽" << std::endl;
+    {
+        AudioEvent first(AudioEventType::Play, CueNameHash("stream_tone"), 0, 17);
+        q.Send(first);
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        AudioEventResult r;
+        uint32 inst=0;
+        while(q.PollResult(r))
+            if(r.type==uint32(AudioEventResultType::PlayStarted)&&r.error_code==0)
+                inst=r.instance_id;
+
+        Check("流式 Cue PlayStarted", inst!=0);
+
+        AudioEvent second(AudioEventType::Play, CueNameHash("stream_tone"), 0, 18);
+        q.Send(second);
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        uint32 error_code=0;
+        bool started=false;
+        while(q.PollResult(r))
+        {
+            if(r.type==uint32(AudioEventResultType::Error))
+                error_code=r.error_code;
+            if(r.type==uint32(AudioEventResultType::PlayStarted))
+                started=true;
+        }
+
+        Check("第 2 个流式实例 → error_code 4", error_code==4);
+        Check("第 2 个流式实例未开始", !started);
+        Check("流式实例未被抢占，活跃 1", t.GetActiveInstanceCount()==1);
+
+        AudioEvent stop(AudioEventType::Stop, 0, inst, 19);
+        q.Send(stop);
+        Check("WaitIdle", t.WaitIdle(3000));
+
+        bool stopped=false;
+        while(q.PollResult(r))
+            if(r.type==uint32(AudioEventResultType::Stopped)&&r.instance_id==inst)
+                stopped=true;
+
+        Check("流式实例 Stop → Stopped", stopped);
+        Check("实例已清理", t.GetActiveInstanceCount()==0);
+    }
+
     t.WaitExit(1.0);
 
     std::cout << "== 结果: " << (failed ? "FAILED" : "ALL PASSED") << " (" << failed << " failures) ==" << std::endl;
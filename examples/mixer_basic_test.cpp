@@ -1,6 +1,7 @@
 ﻿// AudioMixer Basic Test
 // Reads a single WAV file, creates multiple tracks with variations, and outputs mixed WAV
 #include <iostream>
+#include <vector>
 #include <hgl/audio/AudioMixer.h>
 #include "WavReader.h"
 #include "WavWriter.h"
@@ -98,6 +99,165 @@ int main(int argc, char** argv)
     writer.Close();
 
     std::cout << "Output written to: " << outputFile << std::endl;
+
+    // Streaming mix: same tracks rendered block by block into a fixed-size buffer,
+    // compared sample for sample against Mix() with the same settings.
+    // Peak normalization needs the whole mix and is not available when streaming, so both sides run without it;
+    // float32 output keeps the comparison free of quantization.
+    const char* streamFile = "output_mixer_stream.wav";
+    const uint blockFrames = 1024;
+
+    std::cout << std::endl << "Streaming mix (" << blockFrames << " frames per block)..." << std::endl;
+
+    MixerConfig streamConfig = mixer.GetConfig();
+    streamConfig.normalize = false;
+    mixer.SetConfig(streamConfig);
+
+    AudioDataInfo floatFormat;
+    floatFormat.channels = mixer.GetOutputInfo().channels;
+    floatFormat.bits_per_sample = 32;
+    floatFormat.is_float = true;
+    mixer.SetOutputFormat(floatFormat);
+
+    void* referenceData;
+    uint referenceSize;
+
+    if (!mixer.Mix(&referenceData, &referenceSize, 5.0f))
+    {
+        std::cerr << "Error: Failed to mix reference for streaming comparison" << std::endl;
+        delete[] (char*)outputData;
+        free(data);
+        return 1;
+    }
+
+    if (!mixer.BeginMix(5.0f))
+    {
+        std::cerr << "Error: BeginMix failed" << std::endl;
+        delete[] (char*)referenceData;
+        delete[] (char*)outputData;
+        free(data);
+        return 1;
+    }
+
+    const uint channels = floatFormat.channels;
+    const float* reference = (const float*)referenceData;
+    const uint referenceSamples = referenceSize / sizeof(float);
+
+    std::vector<float> block(blockFrames * channels);
+    std::vector<int16_t> block16(blockFrames * channels);
+
+    AudioDataInfo int16Format;
+    int16Format.channels = channels;
+    int16Format.bits_per_sample = 16;
+
+    uint streamedSamples = 0;
+    uint mismatches = 0;
+    uint blocks = 0;
+    uint frames;
+
+    const bool writeStream = writer.Open(streamFile, AL_FORMAT_MONO16, sample_rate);
+
+    while ((frames = mixer.MixBlock(block.data(), blockFrames)) > 0)
+    {
+        const uint count = frames * channels;
+
+        for (uint i = 0; i < count; i++)
+        {
+            const uint index = streamedSamples + i;
+
+            if (index >= referenceSamples || block[i] != reference[index])
+            {
+                if (mismatches == 0)
+                    std::cerr << "First mismatch at sample " << index << std::endl;
+
+                ++mismatches;
+            }
+        }
+
+        if (writeStream)
+        {
+            FloatToSample(block.data(), block16.data(), count, int16Format);
+            writer.Write(block16.data(), count * sizeof(int16_t));
+        }
+
+        streamedSamples += count;
+        ++blocks;
+    }
+
+    mixer.EndMix();
+
+    if (writeStream)
+        writer.Close();
+
+    delete[] (char*)referenceData;
+
+    std::cout << "Streamed " << blocks << " blocks (" << streamedSamples << " samples, Mix() produced " << referenceSamples << ")" << std::endl;
+
+    if (streamedSamples != referenceSamples || mismatches > 0)
+    {
+        std::cerr << "Error: streaming mix differs from Mix(): " << mismatches << " mismatched samples" << std::endl;
+        delete[] (char*)outputData;
+        free(data);
+        return 1;
+    }
+
+    std::cout << "Streaming mix matches Mix() sample for sample" << std::endl;
+
+    // Multi-threaded mix: renditions and accumulation split across threads must give the same samples as one thread.
+    // The rendition cache is cleared before each run so that both runs rebuild every (source,pitch) rendition.
+    const uint threadCounts[2] = { 1, 4 };
+    void* threadData[2] = { nullptr, nullptr };
+    uint threadSize[2] = { 0, 0 };
+
+    std::cout << std::endl << "Mixing with " << threadCounts[0] << " and " << threadCounts[1] << " threads..." << std::endl;
+
+    for (int i = 0; i < 2; i++)
+    {
+        MixerConfig threadConfig = mixer.GetConfig();
+        threadConfig.thread_count = threadCounts[i];
+        mixer.SetConfig(threadConfig);
+        mixer.ClearRenditionCache();
+
+        if (!mixer.Mix(&threadData[i], &threadSize[i], 5.0f))
+        {
+            std::cerr << "Error: Failed to mix with " << threadCounts[i] << " threads" << std::endl;
+            delete[] (char*)threadData[0];
+            delete[] (char*)outputData;
+            free(data);
+            return 1;
+        }
+    }
+
+    uint threadMismatches = 0;
+
+    if (threadSize[0] == threadSize[1])
+    {
+        const float* single = (const float*)threadData[0];
+        const float* multi = (const float*)threadData[1];
+        const uint count = threadSize[0] / sizeof(float);
+
+        for (uint i = 0; i < count; i++)
+            if (single[i] != multi[i])
+                ++threadMismatches;
+    }
+
+    const bool threadsMatch = (threadSize[0] == threadSize[1] && threadMismatches == 0);
+
+    delete[] (char*)threadData[0];
+    delete[] (char*)threadData[1];
+
+    if (!threadsMatch)
+    {
+        std::cerr << "Error: multi-threaded mix differs from single-threaded mix: "
+                  << threadSize[0] << " vs " << threadSize[1] << " bytes, "
+                  << threadMismatches << " mismatched samples" << std::endl;
+        delete[] (char*)outputData;
+        free(data);
+        return 1;
+    }
+
+    std::cout << "Multi-threaded mix matches single-threaded mix sample for sample" << std::endl;
+
     std::cout << std::endl << "Test completed successfully!" << std::endl;
 
     // Cleanup
@@ -0,0 +1,180 @@
+﻿// Parallel Decode Test
+// 比较长 Vorbis/Opus 文件并行分段解码与顺序解码的输出：
+//   Vorbis 逐采样一致；Opus 解码器状态由预滚重建，第一段一致，其余段只有极小的有界残差
+// 用法: parallel_decode_test <Vorbis 文件> [Opus 文件]（文件至少 20 秒才会分段；需要 CMP.Audio.Vorbis/Opus 插件在运行目录）
+// 直接调用内部解码入口（src/AudioDecode.h），不需要 OpenAL 设备
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <hgl/audio/AudioParallelDecode.h>
+#include <hgl/type/StdString.h>
+#include "../src/AudioDecode.h"
+
+using namespace hgl;
+using namespace hgl::audio;
+
+namespace hgl::audio
+{
+    const os_char *GetAudioDecodeName(const AudioFileType file_type);
+}
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+static bool ReadFile(const char *filename, std::vector<char> &data)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    if(!file)
+        return false;
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !data.empty();
+}
+
+static void DeleteDecoded(DecodedAudio *decoded)
+{
+    if(!decoded)return;
+
+    decoded->Release();
+    delete decoded;
+}
+
+static void TestFile(const char *filename)
+{
+    std::cout << std::endl << filename << std::endl;
+
+    std::vector<char> data;
+
+    if(!ReadFile(filename, data))
+    {
+        Check("读取文件", false);
+        return;
+    }
+
+    const AudioFileType file_type = CheckAudioFileType(ToOSString(std::string(filename)).c_str());
+    const os_char *plugin_name = GetAudioDecodeName(file_type);
+
+    Check("Vorbis/Opus 文件", file_type == AudioFileType::Vorbis || file_type == AudioFileType::Opus);
+
+    if(!plugin_name)
+        return;
+
+    // 顺序解码（不允许分段）
+    DecodedAudio *sequential = DecodeAudio(file_type, data.data(), (int)data.size(), false);
+
+    Check("顺序解码成功", sequential != nullptr);
+
+    if(!sequential)
+        return;
+
+    // 并行分段解码：直接调用分段入口，确认确实走了分段路径
+    DecodedAudio *parallel = new DecodedAudio;
+
+    const bool parallel_ok = GetAudioInterface(plugin_name, &parallel->decode, &parallel->decode_float)
+                          && DecodeAudioParallel(plugin_name, parallel, data.data(), (int)data.size(), sequential->use_float,
+                                                 file_type == AudioFileType::Opus ? AUDIO_PARALLEL_DECODE_OPUS_PREROLL_SECONDS : 0);
+
+    Check("并行分段解码成功（文件至少 20 秒）", parallel_ok);
+
+    if(!parallel_ok)
+    {
+        delete parallel;
+        DeleteDecoded(sequential);
+        return;
+    }
+
+    Check("格式相同", parallel->format == sequential->format && parallel->freq == sequential->freq);
+    Check("长度相同", parallel->size == sequential->size);
+
+    AudioDataInfo info;
+
+    if(parallel->size == sequential->size && openal::FromOpenALFormat(sequential->format, info) && !info.is_float && info.bits_per_sample == 16)
+    {
+        const int16_t *a = (const int16_t *)sequential->data;
+        const int16_t *b = (const int16_t *)parallel->data;
+        const size_t count = (size_t)sequential->size / sizeof(int16_t);
+
+        if(file_type == AudioFileType::Vorbis)
+        {
+            Check("Vorbis 与顺序解码逐采样一致", std::memcmp(a, b, sequential->size) == 0);
+        }
+        else
+        {
+            // 与 DecodeAudioParallel 相同的分段规则：第一段从文件开头解码，应与顺序解码一致
+            const size_t frames = count / info.channels;
+            size_t segments = frames / (size_t)(sequential->freq * AUDIO_PARALLEL_DECODE_SEGMENT_SECONDS);
+            if(segments > GetParallelDecodeSegments())
+                segments = GetParallelDecodeSegments();
+
+            const size_t first_segment = (frames / segments) * info.channels;
+
+            Check("Opus 第一段与顺序解码逐采样一致", std::memcmp(a, b, first_segment * sizeof(int16_t)) == 0);
+
+            double signal = 0, error = 0;
+            int max_diff = 0;
+
+            for(size_t i = 0; i < count; i++)
+            {
+                const int diff = std::abs((int)a[i] - (int)b[i]);
+
+                if(diff > max_diff)
+                    max_diff = diff;
+
+                signal += (double)a[i] * a[i];
+                error += (double)diff * diff;
+            }
+
+            const double snr = (error > 0) ? 10.0 * std::log10(signal / error) : 999.0;
+
+            std::cout << "    最大差异 " << max_diff << "，信噪比 " << snr << " dB" << std::endl;
+
+            // 只靠 op_pcm_seek 自带的 80ms 预滚时段首误差可达满幅的 4%，额外预滚后应只剩极小残差
+            Check("Opus 最大差异 < 1/128 满幅", max_diff < 256);
+            Check("Opus 差异能量低于信号 55dB", snr > 55.0);
+        }
+    }
+    else
+    {
+        Check("16 位整数输出", false);
+    }
+
+    DeleteDecoded(parallel);
+    DeleteDecoded(sequential);
+}
+
+int main(int argc, char **argv)
+{
+    std::cout << "Parallel Decode Test" << std::endl;
+    std::cout << "====================" << std::endl;
+
+    if(argc < 2)
+    {
+        std::cout << "用法: parallel_decode_test <Vorbis 文件> [Opus 文件]" << std::endl;
+        return 0;
+    }
+
+    SetParallelDecodeSegments(4);
+    SetParallelDecodeMinSeconds(0);
+
+    for(int i = 1; i < argc; i++)
+        TestFile(argv[i]);
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
@@ -13,11 +13,17 @@ int main()
     fflush(stderr);
 
     AudioPlayer *p=new AudioPlayer;
+    p->SetPrerollOnLoad(true);
     fprintf(stderr,"Load: %s total=%f\n", p->Load(OS_TEXT("test_tone.wav"))?"OK":"FAIL", p->GetTotalTime());
     fflush(stderr);
 
     p->Play(false);
-    fprintf(stderr,"Play called loop=%d\n", p->IsLoop()?1:0);
+    {
+        const AudioPlayerStartStats st=p->GetStartStats();
+
+        fprintf(stderr,"Play called loop=%d start_latency=%.3fms preroll=%u/%u\n", p->IsLoop()?1:0,
+                st.last_latency*1000.0,st.preroll_count,st.start_count);
+    }
     fflush(stderr);
 
     for(int i=0;i<15;i++)
@@ -0,0 +1,206 @@
+﻿// Read Ahead Stream Test
+// 验证流式解码数据源 AudioReadAheadStream：跨预读块边界的小步读取、末尾不足量读取与 EOF、
+// 大块直读、缓冲区内/外定位后读到的是新位置的数据（预读缓冲失效），以及插件回调接口
+// 直接调用内部数据源（src/AudioDecode.h），不需要解码插件与 OpenAL 设备
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <hgl/io/FileInputStream.h>
+#include "../src/AudioDecode.h"
+
+using namespace hgl;
+using namespace hgl::audio;
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+static const char *test_file = "test_read_ahead.bin";
+
+static const int64 BLOCK     = AudioReadAheadStream::READ_AHEAD_SIZE;
+static const int64 FILE_SIZE = BLOCK * 3 + 12345;      // 不是预读块的整数倍
+
+// 与位置相关且不以预读块长度为周期，读到旧缓冲区的数据即可发现
+static char Byte(int64 i){ return char(uint32(i * 2654435761u) >> 24); }
+
+static bool SameAt(const std::vector<char> &data, int64 position, size_t size)
+{
+    if(data.size() < size)
+        return false;
+
+    for(size_t i = 0; i < size; i++)
+        if(data[i] != Byte(position + int64(i)))
+            return false;
+
+    return true;
+}
+
+/**
+ * 从当前位置读 size 字节并与文件内容比较
+ */
+static bool ReadAt(AudioReadAheadStream &ras, size_t size, size_t expect)
+{
+    const int64 position = ras.Tell();
+
+    std::vector<char> data(size);
+
+    const size_t got = ras.Read(data.data(), size);
+
+    return got == expect && SameAt(data, position, got) && ras.Tell() == position + int64(got);
+}
+
+static io::FileInputStream *OpenTestFile()
+{
+    io::FileInputStream *fis = new io::FileInputStream;
+
+    if(!fis->Open(OS_TEXT("test_read_ahead.bin")))
+    {
+        delete fis;
+        return nullptr;
+    }
+
+    return fis;
+}
+
+int main()
+{
+    std::cout << "Read Ahead Stream Test" << std::endl;
+    std::cout << "======================" << std::endl;
+
+    {
+        std::vector<char> content(FILE_SIZE);
+
+        for(int64 i = 0; i < FILE_SIZE; i++)
+            content[i] = Byte(i);
+
+        std::ofstream file(test_file, std::ios::binary | std::ios::trunc);
+
+        file.write(content.data(), FILE_SIZE);
+        Check("生成测试文件", bool(file));
+    }
+
+    // 1. 小步顺序读取：跨越预读块边界，最后一次不足量，之后 EOF
+    std::cout << "[1] 顺序读取" << std::endl;
+    {
+        io::FileInputStream *fis = OpenTestFile();
+        Check("打开测试文件", fis != nullptr);
+        if(!fis)return 1;
+
+        AudioReadAheadStream ras(fis, true);
+
+        Check("可定位", ras.CanSeek());
+        Check("初始 Tell == 0", ras.Tell() == 0);
+
+        const size_t step = 1000;               // 不整除预读块长度，每个块边界都有一次跨块读取
+        bool all_same = true;
+        int64 total = 0;
+
+        while(total + int64(step) <= FILE_SIZE)
+        {
+            if(!ReadAt(ras, step, step))
+                all_same = false;
+
+            total += step;
+        }
+
+        Check("逐块读取数据一致（含跨预读块）", all_same);
+
+        const size_t rest = size_t(FILE_SIZE - total);
+
+        Check("末尾不足量读取返回剩余字节", ReadAt(ras, step, rest));
+        Check("Tell == 文件长度", ras.Tell() == FILE_SIZE);
+
+        char tail[16];
+        Check("EOF 后 Read 返回 0", ras.Read(tail, sizeof(tail)) == 0);
+        Check("EOF 后 Tell 不变", ras.Tell() == FILE_SIZE);
+    }
+
+    // 2. 大块直读（不经预读缓冲）与缓冲区中剩余数据衔接
+    std::cout << "[2] 大块读取" << std::endl;
+    {
+        AudioReadAheadStream ras(OpenTestFile(), true);
+
+        Check("先读 10 字节", ReadAt(ras, 10, 10));
+        Check("跨缓冲区剩余部分与之后数据的大块读取", ReadAt(ras, size_t(BLOCK * 2), size_t(BLOCK * 2)));
+        Check("大块读取后继续小步读取", ReadAt(ras, 333, 333));
+        Check("超过剩余长度的大块读取只返回剩余部分", ReadAt(ras, size_t(FILE_SIZE), size_t(FILE_SIZE - ras.Tell())));
+    }
+
+    // 3. 定位：缓冲区内、缓冲区外（向前/向后）、末尾
+    std::cout << "[3] 定位" << std::endl;
+    {
+        AudioReadAheadStream ras(OpenTestFile(), true);
+
+        Check("读 5000 字节", ReadAt(ras, 5000, 5000));
+
+        Check("SEEK_CUR -3000（缓冲区内）", ras.Seek(-3000, SEEK_CUR) == 0 && ras.Tell() == 2000);
+        Check("缓冲区内定位后读取", ReadAt(ras, 100, 100));
+
+        Check("SEEK_SET 到缓冲区外（向后）", ras.Seek(BLOCK * 2 + 7, SEEK_SET) == 0 && ras.Tell() == BLOCK * 2 + 7);
+        Check("读到新位置的数据，不是旧缓冲区", ReadAt(ras, 4096, 4096));
+
+        Check("SEEK_SET 回到开头（缓冲区外，向前）", ras.Seek(3, SEEK_SET) == 0 && ras.Tell() == 3);
+        Check("读到开头的数据", ReadAt(ras, 100, 100));
+
+        // 从位置 3 预读了一整块：正好定位到已缓冲数据的末尾，下一次读取从流中续读
+        Check("定位到缓冲区末尾", ras.Seek(BLOCK + 3, SEEK_SET) == 0 && ras.Tell() == BLOCK + 3);
+        Check("缓冲区末尾续读", ReadAt(ras, 2000, 2000));
+
+        Check("SEEK_END -10", ras.Seek(-10, SEEK_END) == 0 && ras.Tell() == FILE_SIZE - 10);
+        Check("读最后 10 字节", ReadAt(ras, 64, 10));
+
+        char tail[16];
+        Check("末尾之后 Read 返回 0", ras.Read(tail, sizeof(tail)) == 0);
+
+        Check("定位到负位置失败", ras.Seek(-1, SEEK_SET) == -1);
+        Check("未知 whence 失败", ras.Seek(0, 12345) == -1);
+
+        Check("失败后可再次定位并读取", ras.Seek(BLOCK - 5, SEEK_SET) == 0 && ReadAt(ras, 10, 10));
+    }
+
+    // 4. 插件回调接口
+    std::cout << "[4] 回调接口" << std::endl;
+    {
+        AudioReadAheadStream ras(OpenTestFile(), true);
+
+        const AudioStreamCallbacks *cb = AudioReadAheadStream::GetCallbacks();
+
+        Check("GetCallbacks 完整", cb && cb->Read && cb->Seek && cb->Tell);
+
+        if(cb)
+        {
+            std::vector<char> data(777);
+
+            Check("回调 Seek", cb->Seek(&ras, 12345, SEEK_SET) == 0);
+            Check("回调 Read", cb->Read(&ras, data.data(), data.size()) == data.size() && SameAt(data, 12345, data.size()));
+            Check("回调 Tell", cb->Tell(&ras) == 12345 + 777);
+        }
+    }
+
+    // 5. 空数据源
+    {
+        AudioReadAheadStream ras(nullptr, false);
+
+        char data[16];
+        Check("无数据源 Read 返回 0", ras.Read(data, sizeof(data)) == 0);
+        Check("无数据源不可定位", !ras.CanSeek() && ras.Seek(0, SEEK_SET) == -1);
+    }
+
+    std::remove(test_file);
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
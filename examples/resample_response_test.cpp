@@ -0,0 +1,262 @@
+﻿// Resample Response Test
+// 扫频比较多相 FIR 路径（Resample() 对小整数比自动选用）与 libsamplerate（StreamResampler）的频率响应：
+// 通带内多相路径增益平坦且不低于 libsamplerate，阻带（下采样时 Nyquist 以上）衰减不弱于 libsamplerate（纯 CPU，无需 OpenAL）
+// 另检查同采样率直接拷贝、超限比率退回 libsamplerate 以及滤波器组缓存上限
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <hgl/audio/AudioResampler.h>
+#include <hgl/audio/PolyphaseResampler.h>
+
+using namespace hgl;
+using namespace hgl::audio;
+
+static const double PI = 3.14159265358979323846;
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+static void MakeSine(std::vector<float> &signal, double freq, uint rate)
+{
+    signal.resize(rate / 2);                    // 0.5 秒
+
+    for(size_t i = 0; i < signal.size(); i++)
+        signal[i] = (float)(0.5 * std::sin(2.0 * PI * freq * i / rate));
+}
+
+/**
+ * 输出中间一半（避开首尾的滤波器暂态）的有效值，换算成相对输入正弦幅度 0.5 的 dB
+ */
+static double GainDB(const std::vector<float> &output)
+{
+    const size_t begin = output.size() / 4;
+    const size_t end = output.size() * 3 / 4;
+
+    double sum = 0;
+    for(size_t i = begin; i < end; i++)
+        sum += (double)output[i] * output[i];
+
+    const double rms = std::sqrt(sum / (double)(end - begin));
+
+    return 20.0 * std::log10(rms * std::sqrt(2.0) / 0.5 + 1e-20);
+}
+
+static double PolyphaseGain(double freq, uint in_rate, uint out_rate, ResampleQuality quality)
+{
+    std::vector<float> input;
+    MakeSine(input, freq, in_rate);
+
+    AudioDataInfo info;
+    info.sample_rate = in_rate;
+    info.channels = 1;
+    info.bits_per_sample = 32;
+    info.is_float = true;
+
+    void *out_data = nullptr;
+    uint out_size = 0;
+
+    if(!Resample(input.data(), (uint)(input.size() * sizeof(float)), info, out_rate, info, quality, &out_data, &out_size))
+        return 0;
+
+    const float *samples = (const float *)out_data;
+    const std::vector<float> output(samples, samples + out_size / sizeof(float));
+
+    delete[] (uint8_t *)out_data;
+
+    return GainDB(output);
+}
+
+static double LibSampleRateGain(double freq, uint in_rate, uint out_rate, ResampleQuality quality)
+{
+    std::vector<float> input;
+    MakeSine(input, freq, in_rate);
+
+    StreamResampler rs;
+
+    if(!rs.Init(1, in_rate, out_rate, quality))
+        return 0;
+
+    std::vector<float> output(rs.GetMaxOutputFrames((uint)input.size()));
+
+    uint used, generated;
+
+    if(!rs.Process(input.data(), (uint)input.size(), output.data(), (uint)output.size(), &used, &generated, true))
+        return 0;
+
+    output.resize(generated);
+    return GainDB(output);
+}
+
+/**
+ * 同采样率直接拷贝/只转换格式；超出多相上限的比率退回 libsamplerate；滤波器组缓存有上限
+ */
+static void TestLimits()
+{
+    std::cout << "[limits]" << std::endl;
+
+    std::vector<float> input;
+    MakeSine(input, 1000.0, 48000);
+
+    AudioDataInfo info;
+    info.sample_rate = 48000;
+    info.channels = 1;
+    info.bits_per_sample = 32;
+    info.is_float = true;
+
+    void *out_data = nullptr;
+    uint out_size = 0;
+
+    const bool same = Resample(input.data(), (uint)(input.size() * sizeof(float)), info, 48000, info, ResampleQuality::SincBest, &out_data, &out_size);
+    Check("同采样率同格式：逐字节相同", same && out_size == input.size() * sizeof(float)
+                                      && memcmp(out_data, input.data(), out_size) == 0);
+    delete[] (uint8_t *)out_data;
+
+    AudioDataInfo info16 = info;
+    info16.bits_per_sample = 16;
+    info16.is_float = false;
+
+    out_data = nullptr;
+    const bool convert = Resample(input.data(), (uint)(input.size() * sizeof(float)), info, 48000, info16, ResampleQuality::SincBest, &out_data, &out_size);
+    bool converted = convert && out_size == input.size() * sizeof(int16_t);
+    for(size_t i = 0; converted && i < input.size(); i++)
+        if(std::fabs(((const int16_t *)out_data)[i] / 32768.0 - input[i]) > 1.0 / 16384)
+            converted = false;
+    Check("同采样率不同格式：只做格式转换", converted);
+    delete[] (uint8_t *)out_data;
+
+    // 96000->8000 SincBest 每相位约 6800 系数，仍在上限内；L/M 超过 640 或系数超限的比率不走多相
+    Check("96000->8000 SincBest 走多相路径", IsPolyphaseResampleSupported(96000, 8000, ResampleQuality::SincBest));
+    Check("96000->11025（M=1280）不走多相路径", !IsPolyphaseResampleSupported(96000, 11025, ResampleQuality::SincMedium));
+    Check("192000->8000（每相位系数超限）不走多相路径", !IsPolyphaseResampleSupported(192000, 8000, ResampleQuality::SincBest));
+    Check("超限滤波器组拒绝创建", AcquirePolyphaseFilterBank(1, 24, ResampleQuality::SincBest) == nullptr);
+
+    out_data = nullptr;
+    const bool fallback = Resample(input.data(), (uint)(input.size() * sizeof(float)), info, 7999, info, ResampleQuality::SincMedium, &out_data, &out_size);
+    Check("超限比率退回 libsamplerate 仍可重采样", fallback && out_size > 0);
+    delete[] (uint8_t *)out_data;
+
+    // 缓存淘汰：占满容量后最早的一组被替换，但调用者持有的仍然有效
+    const auto first = AcquirePolyphaseFilterBank(2, 1, ResampleQuality::SincFastest);
+    Check("同参数复用缓存", first && AcquirePolyphaseFilterBank(2, 1, ResampleQuality::SincFastest) == first);
+
+    for(uint i = 0; i < POLYPHASE_CACHE_CAPACITY; i++)
+        AcquirePolyphaseFilterBank(3 + i, 1, ResampleQuality::SincFastest);
+
+    const auto again = AcquirePolyphaseFilterBank(2, 1, ResampleQuality::SincFastest);
+    Check("超出容量后最久未用的一组被淘汰", again && again != first);
+    Check("被淘汰的滤波器组仍可使用", first->up == 2 && first->coefficients.size() == (size_t)first->up * first->taps);
+}
+
+int main()
+{
+    std::cout << "Resample Response Test" << std::endl;
+    std::cout << "======================" << std::endl;
+
+    struct QualityCase
+    {
+        ResampleQuality quality;
+        const char *name;
+        double passband;                        ///< 通带边界（占较低采样率 Nyquist 的比例），与 SRC_SINC_* 的带宽一致
+        double stopband_db;                     ///< 阻带至少衰减
+    };
+
+    const QualityCase qualities[] =
+    {
+        { ResampleQuality::SincFastest, "SincFastest", 0.80, 90.0  },
+        { ResampleQuality::SincMedium,  "SincMedium",  0.90, 100.0 },
+        { ResampleQuality::SincBest,    "SincBest",    0.97, 120.0 },
+    };
+
+    struct RateCase
+    {
+        uint in_rate;
+        uint out_rate;
+    };
+
+    const RateCase rates[] = { { 44100, 48000 }, { 48000, 44100 }, { 48000, 16000 } };
+
+    TestLimits();
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    for(const QualityCase &qc : qualities)
+    {
+        for(const RateCase &rc : rates)
+        {
+            const std::string prefix = std::string(qc.name) + " " + std::to_string(rc.in_rate) + "->" + std::to_string(rc.out_rate);
+
+            Check((prefix + " 走多相路径").c_str(), IsPolyphaseResampleSupported(rc.in_rate, rc.out_rate, qc.quality));
+
+            const double nyquist = (rc.in_rate < rc.out_rate ? rc.in_rate : rc.out_rate) * 0.5;
+
+            // 通带：1kHz 起每 1/20 Nyquist 一点直到通带边界
+            bool flat = true;
+            bool not_worse = true;
+
+            for(int step = 0; ; step++)
+            {
+                double freq = 1000.0 + nyquist * 0.05 * step;
+                if(freq > nyquist * qc.passband)
+                    freq = nyquist * qc.passband;
+
+                const double poly = PolyphaseGain(freq, rc.in_rate, rc.out_rate, qc.quality);
+                const double src = LibSampleRateGain(freq, rc.in_rate, rc.out_rate, qc.quality);
+
+                if(std::fabs(poly) > 0.1 || poly < src - 0.1)
+                {
+                    std::cout << "    " << freq << "Hz: 多相 " << poly << "dB, libsamplerate " << src << "dB" << std::endl;
+
+                    if(std::fabs(poly) > 0.1)   flat = false;
+                    if(poly < src - 0.1)        not_worse = false;
+                }
+
+                if(freq >= nyquist * qc.passband)
+                    break;
+            }
+
+            Check((prefix + " 通带内增益偏差 < 0.1dB").c_str(), flat);
+            Check((prefix + " 通带内增益不低于 libsamplerate").c_str(), not_worse);
+
+            // 阻带：仅下采样时输入含较低采样率 Nyquist 以上的频率，从 Nyquist 扫到输入 Nyquist 的 95%
+            if(rc.out_rate < rc.in_rate)
+            {
+                bool attenuated = true;
+
+                for(double ratio = 1.0; ratio * nyquist < rc.in_rate * 0.5 * 0.95; ratio += 0.05)
+                {
+                    const double freq = ratio * nyquist;
+
+                    const double poly = PolyphaseGain(freq, rc.in_rate, rc.out_rate, qc.quality);
+                    const double src = LibSampleRateGain(freq, rc.in_rate, rc.out_rate, qc.quality);
+
+                    // 达到设计衰减，或不弱于 libsamplerate
+                    if(poly > -qc.stopband_db && poly > src + 1.0)
+                    {
+                        std::cout << "    " << freq << "Hz: 多相 " << poly << "dB, libsamplerate " << src << "dB" << std::endl;
+                        attenuated = false;
+                    }
+                }
+
+                Check((prefix + " 阻带衰减不弱于 libsamplerate").c_str(), attenuated);
+            }
+        }
+    }
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
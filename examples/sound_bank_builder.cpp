@@ -0,0 +1,83 @@
+﻿// Sound Bank Builder
+// Packs WAV (PCM) / OGG Vorbis / Opus files into one memory-mappable sound bank (see hgl/audio/SoundBank.h)
+//
+// Usage: sound_bank_builder <output.bank> [-align N] <name=file | file> ...
+//   name=file   store file under the given asset name (the name passed to AudioAssetManager::Acquire)
+//   file        the file path itself is the asset name
+//
+// WAV is stored as raw PCM ready for alBufferData; .ogg/.opus are stored as-is and decoded at load time.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include "SoundBankWriter.h"
+
+using namespace hgl;
+using namespace hgl::audio;
+
+int main(int argc,char **argv)
+{
+    if(argc<3)
+    {
+        std::cout << "Usage: sound_bank_builder <output.bank> [-align N] <name=file | file> ...\n";
+        return 1;
+    }
+
+    uint32 alignment=SOUND_BANK_DEFAULT_ALIGNMENT;
+    std::vector<SoundBankWriter::Item> items;
+
+    for(int i=2;i<argc;i++)
+    {
+        const std::string arg=argv[i];
+
+        if(arg=="-align"&&i+1<argc)
+        {
+            alignment=uint32(std::atoi(argv[++i]));
+
+            if(alignment<8||(alignment&(alignment-1))!=0)
+            {
+                std::cerr << "Alignment must be a power of two >= 8\n";
+                return 1;
+            }
+
+            continue;
+        }
+
+        SoundBankWriter::Item item;
+
+        const size_t eq=arg.find('=');
+
+        if(eq!=std::string::npos)
+        {
+            item.name=arg.substr(0,eq);
+            item.filename=arg.substr(eq+1);
+        }
+        else
+        {
+            item.name=arg;
+            item.filename=arg;
+        }
+
+        if(item.name.empty()||!SoundBankWriter::LoadItem(item))
+        {
+            std::cerr << "Failed to load: " << item.filename << "\n";
+            return 1;
+        }
+
+        std::cout << "  " << item.name << " <- " << item.filename << " (" << item.entry.size << " bytes)\n";
+
+        items.push_back(std::move(item));
+    }
+
+    if(items.empty())
+    {
+        std::cerr << "No input files\n";
+        return 1;
+    }
+
+    if(!SoundBankWriter::Write(argv[1],items,alignment))
+        return 1;
+
+    std::cout << "Wrote " << items.size() << " assets to " << argv[1] << "\n";
+    return 0;
+}
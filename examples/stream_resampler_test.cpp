@@ -0,0 +1,240 @@
+﻿// StreamResampler Test
+// 验证流式重采样：同一信号一次送入与小块分批送入输出逐位一致（float/int16、各品质），
+// 以及 SetRatio(...,false) 渐变后状态跨块保持（纯 CPU，无需 OpenAL）
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <hgl/audio/AudioResampler.h>
+
+using namespace hgl;
+using namespace hgl::audio;
+
+static const double PI = 3.14159265358979323846;
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+/**
+ * 把 input 按 in_chunk 帧一块送入 rs（每次输出缓冲 out_chunk 帧），结尾排空，输出追加到 output
+ * 未被消耗的输入在下一次调用中重新提交
+ */
+template<typename T>
+static bool Feed(StreamResampler &rs, const std::vector<T> &input, uint in_chunk, uint out_chunk, bool end_of_input, std::vector<T> &output)
+{
+    const uint channels = rs.GetChannels();
+    const uint frames = (uint)(input.size() / channels);
+
+    std::vector<T> block((size_t)out_chunk * channels);
+
+    uint pos = 0;
+
+    while(pos < frames)
+    {
+        const uint count = (frames - pos < in_chunk) ? frames - pos : in_chunk;
+        const bool last = end_of_input && (pos + count == frames);
+
+        uint used, generated;
+
+        if(!rs.Process(input.data() + (size_t)pos * channels, count, block.data(), out_chunk, &used, &generated, last))
+            return false;
+
+        if(used == 0 && generated == 0)
+            return false;           // 既不消耗也不产出：调用方式有误
+
+        output.insert(output.end(), block.begin(), block.begin() + (size_t)generated * channels);
+        pos += used;
+    }
+
+    if(!end_of_input)
+        return true;
+
+    // 排空尾部
+    for(;;)
+    {
+        uint used, generated;
+
+        if(!rs.Process((const T *)nullptr, 0, block.data(), out_chunk, &used, &generated, true))
+            return false;
+
+        if(generated == 0)
+            return true;
+
+        output.insert(output.end(), block.begin(), block.begin() + (size_t)generated * channels);
+    }
+}
+
+template<typename T>
+static bool Equal(const std::vector<T> &a, const std::vector<T> &b)
+{
+    if(a.size() != b.size())
+    {
+        std::cout << "    长度不同: " << a.size() << " vs " << b.size() << std::endl;
+        return false;
+    }
+
+    for(size_t i = 0; i < a.size(); i++)
+    {
+        if(a[i] != b[i])
+        {
+            std::cout << "    第 " << i << " 个采样不同: " << a[i] << " vs " << b[i] << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void MakeSignal(std::vector<float> &signal, uint frames, uint channels, uint rate)
+{
+    signal.resize((size_t)frames * channels);
+
+    for(uint i = 0; i < frames; i++)
+        for(uint ch = 0; ch < channels; ch++)
+            signal[(size_t)i * channels + ch] = (float)(0.4 * std::sin(2.0 * PI * (440.0 + 550.0 * ch) * i / rate)
+                                                      + 0.2 * std::sin(2.0 * PI * 3100.0 * i / rate));
+}
+
+int main()
+{
+    std::cout << "StreamResampler Test" << std::endl;
+    std::cout << "====================" << std::endl;
+
+    // 1. float 立体声 44100→48000：一次送入 vs 64 帧输入/50 帧输出小块（输出缓冲小于输入，迫使部分消耗与重新提交）
+    {
+        const uint channels = 2;
+        const uint frames = 44100;
+
+        std::vector<float> signal;
+        MakeSignal(signal, frames, channels, 44100);
+
+        const ResampleQuality qualities[] = { ResampleQuality::Linear, ResampleQuality::SincFastest,
+                                              ResampleQuality::SincMedium, ResampleQuality::SincBest };
+        const char *names[] = { "Linear", "SincFastest", "SincMedium", "SincBest" };
+
+        for(int q = 0; q < 4; q++)
+        {
+            StreamResampler whole, chunked;
+
+            std::vector<float> a, b;
+
+            const bool ok = whole.Init(channels, 44100, 48000, qualities[q])
+                         && chunked.Init(channels, 44100, 48000, qualities[q])
+                         && Feed(whole, signal, frames, whole.GetMaxOutputFrames(frames), true, a)
+                         && Feed(chunked, signal, 64, 50, true, b);
+
+            const std::string name = std::string("float ") + names[q];
+
+            Check((name + " 处理成功").c_str(), ok);
+            Check((name + " 输出帧数≈输入×48000/44100").c_str(), std::fabs((double)a.size() / channels - frames * 48000.0 / 44100.0) <= 2.0);
+            Check((name + " 分块输出与一次输出逐位一致").c_str(), Equal(a, b));
+        }
+    }
+
+    // 2. int16 单声道 48000→16000：一次送入 vs 100 帧输入/40 帧输出
+    {
+        const uint frames = 48000;
+
+        std::vector<float> signal;
+        MakeSignal(signal, frames, 1, 48000);
+
+        std::vector<int16_t> pcm(frames);
+        for(uint i = 0; i < frames; i++)
+            pcm[i] = (int16_t)(signal[i] * 32767.0f);
+
+        StreamResampler whole, chunked;
+
+        std::vector<int16_t> a, b;
+
+        const bool ok = whole.Init(1, 48000, 16000)
+                     && chunked.Init(1, 48000, 16000)
+                     && Feed(whole, pcm, frames, whole.GetMaxOutputFrames(frames), true, a)
+                     && Feed(chunked, pcm, 100, 40, true, b);
+
+        Check("int16 处理成功", ok);
+        Check("int16 分块输出与一次输出逐位一致", Equal(a, b));
+    }
+
+    // 3. 渐变：比率 1.0 → 1.5（SetRatio(...,false)）
+    //    libsamplerate 在下一次调用的输出区间内从旧比率线性过渡到新比率，过渡本身与调用的输出缓冲大小相关，
+    //    因此两路用完全相同的调用完成渐变，之后一路一次送入、一路小块送入，比较全部输出
+    {
+        const uint frames = 44100;
+        const uint head = 4410;             // 渐变前的输入帧数
+        const uint ramp = 4410;             // 渐变调用的输入帧数
+        const double r1 = 1.0;
+        const double r2 = 1.5;
+
+        std::vector<float> signal;
+        MakeSignal(signal, frames, 1, 44100);
+
+        const std::vector<float> head_input(signal.begin(), signal.begin() + head);
+        const std::vector<float> ramp_input(signal.begin() + head, signal.begin() + head + ramp);
+        const std::vector<float> tail_input(signal.begin() + head + ramp, signal.end());
+
+        StreamResampler rs[2];
+        std::vector<float> out[2];
+        uint ramp_generated[2] = { 0, 0 };
+        bool ok = true;
+
+        for(int i = 0; i < 2; i++)
+        {
+            ok = ok && rs[i].Init(1, r1) && Feed(rs[i], head_input, head, head + 64, false, out[i]);
+            ok = ok && rs[i].SetRatio(r2, false);
+
+            const size_t before = out[i].size();
+            ok = ok && Feed(rs[i], ramp_input, ramp, rs[i].GetMaxOutputFrames(ramp), false, out[i]);
+            ramp_generated[i] = (uint)(out[i].size() - before);
+
+            ok = ok && rs[i].SetRatio(r2, true);            // 固定在新比率（丢弃未走完的渐变余量）
+        }
+
+        const size_t tail_begin = out[0].size();
+
+        ok = ok && Feed(rs[0], tail_input, (uint)tail_input.size(), rs[0].GetMaxOutputFrames((uint)tail_input.size()), true, out[0]);
+        ok = ok && Feed(rs[1], tail_input, 37, 29, true, out[1]);
+
+        Check("渐变处理成功", ok);
+        Check("渐变调用输出帧数介于新旧比率之间",
+              ramp_generated[0] > ramp * r1 * 1.02 && ramp_generated[0] < ramp * r2 * 0.98);
+        Check("渐变后分块输出与一次输出逐位一致", Equal(out[0], out[1]));
+
+        // 渐变后的剩余部分按新比率输出
+        const double tail_ratio = (double)(out[0].size() - tail_begin) / tail_input.size();
+        Check("渐变后比率 ≈ 1.5", std::fabs(tail_ratio - r2) < 0.01);
+
+        // 渐变过程平滑：相邻采样差不超过无渐变时的最大斜率（尾部排空的余振除外）
+        float max_step = 0;
+        for(size_t i = 1; i + 256 < out[0].size(); i++)
+        {
+            const float step = std::fabs(out[0][i] - out[0][i - 1]);
+            if(step > max_step)
+                max_step = step;
+        }
+
+        float input_step = 0;
+        for(size_t i = 1; i < signal.size(); i++)
+        {
+            const float step = std::fabs(signal[i] - signal[i - 1]);
+            if(step > input_step)
+                input_step = step;
+        }
+
+        Check("渐变输出无跳变", max_step <= input_step * 1.1f);
+    }
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
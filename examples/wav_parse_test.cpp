@@ -0,0 +1,281 @@
+﻿// WAV Parse Test
+// 验证主程序与 WAV 解码插件共用的 RIFF/WAVE 解析（hgl/audio/WAVParser.h）：
+// 奇数长度块的填充字节、缺少 data 块、data 在 fmt 之前、WAVE_FORMAT_EXTENSIBLE、截断文件、smpl 循环标记
+// 纯内存构造 WAV，不需要 OpenAL 设备
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <hgl/audio/WAVParser.h>
+#include "../src/MappedWAV.h"
+
+using namespace hgl;
+using namespace hgl::audio;
+
+static int failed = 0;
+
+static void Check(const char *name, bool cond)
+{
+    std::cout << (cond ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if(!cond) ++failed;
+}
+
+/**
+ * 按块拼出 RIFF/WAVE 文件
+ */
+class WAVBuilder
+{
+    std::vector<uint8> bytes;
+
+    void U16(uint16 v){ bytes.push_back(uint8(v)); bytes.push_back(uint8(v >> 8)); }
+    void U32(uint32 v){ U16(uint16(v)); U16(uint16(v >> 16)); }
+
+public:
+
+    WAVBuilder()
+    {
+        bytes.insert(bytes.end(), {'R','I','F','F', 0,0,0,0, 'W','A','V','E'});
+    }
+
+    /**
+     * 添加一个块，奇数长度时补 1 字节填充（pad=false 模拟不规范的文件）
+     * @param declared_size 写入块头的长度（<0 为实际长度），用于构造截断文件
+     */
+    size_t Chunk(const char *id, const std::vector<uint8> &body, bool pad = true, int64 declared_size = -1)
+    {
+        bytes.insert(bytes.end(), id, id + 4);
+        U32(uint32(declared_size < 0 ? int64(body.size()) : declared_size));
+
+        const size_t offset = bytes.size();
+
+        bytes.insert(bytes.end(), body.begin(), body.end());
+
+        if(pad && (body.size() & 1))
+            bytes.push_back(0);
+
+        return offset;
+    }
+
+    static std::vector<uint8> Fmt(uint16 tag, uint16 channels, uint32 rate, uint16 bits)
+    {
+        WAVBuilder b;
+        b.bytes.clear();
+        b.U16(tag);
+        b.U16(channels);
+        b.U32(rate);
+        b.U32(rate * channels * bits / 8);
+        b.U16(uint16(channels * bits / 8));
+        b.U16(bits);
+        return b.bytes;
+    }
+
+    static std::vector<uint8> FmtExtensible(uint16 sub_format, uint16 channels, uint32 rate, uint16 bits, bool complete = true)
+    {
+        WAVBuilder b;
+        b.bytes = Fmt(WAVE_FORMAT_EXTENSIBLE, channels, rate, bits);
+        b.U16(22);                              // cbSize
+        b.U16(bits);                            // ValidBitsPerSample
+        b.U32(channels == 2 ? 3 : 4);           // ChannelMask
+
+        if(complete)
+        {
+            b.U16(sub_format);                  // SubFormat GUID 前 2 字节
+            b.bytes.insert(b.bytes.end(), {0x00,0x00,0x00,0x00,0x10,0x00,0x80,0x00,0x00,0xAA,0x00,0x38,0x9B,0x71});
+        }
+
+        return b.bytes;
+    }
+
+    static std::vector<uint8> Smpl(uint32 loops)
+    {
+        WAVBuilder b;
+        b.bytes.clear();
+        for(int i = 0; i < 7; i++)b.U32(0);
+        b.U32(loops);
+        b.U32(0);
+        return b.bytes;
+    }
+
+    const uint8 *Data()const{ return bytes.data(); }
+    uint64 Size()const{ return bytes.size(); }
+
+    const std::vector<uint8> &Finish()
+    {
+        const uint32 riff_size = uint32(bytes.size() - 8);
+        memcpy(bytes.data() + 4, &riff_size, 4);
+        return bytes;
+    }
+
+    void Truncate(size_t size){ bytes.resize(size); }
+};//class WAVBuilder
+
+static std::vector<uint8> Samples(size_t count)
+{
+    std::vector<uint8> body(count);
+
+    for(size_t i = 0; i < count; i++)
+        body[i] = uint8(i * 7 + 1);
+
+    return body;
+}
+
+/**
+ * 共用解析器与主程序 ParseWAVData 的结果必须一致
+ */
+static bool Parse(WAVBuilder &wav, RIFFWAVEInfo &info)
+{
+    wav.Finish();
+
+    const bool result = ParseRIFFWAVE(wav.Data(), wav.Size(), info);
+
+    WAVDataView view;
+    const bool host = ParseWAVData(wav.Data(), wav.Size(), view);
+
+    if(host != result)
+        Check("ParseWAVData 与 ParseRIFFWAVE 一致", false);
+    else if(result && (view.pcm != info.pcm || view.info.data_size != info.pcm_size
+                    || view.info.channels != info.channels || view.info.sample_rate != info.sample_rate
+                    || view.info.bits_per_sample != info.bits || view.info.is_float != info.is_float))
+        Check("ParseWAVData 与 ParseRIFFWAVE 一致", false);
+
+    return result;
+}
+
+int main()
+{
+    std::cout << "WAV Parse Test" << std::endl;
+    std::cout << "==============" << std::endl;
+
+    RIFFWAVEInfo info;
+
+    // 1. 基本 PCM
+    {
+        WAVBuilder wav;
+        wav.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 1, 44100, 16));
+        const size_t offset = wav.Chunk("data", Samples(200));
+
+        Check("PCM16 单声道", Parse(wav, info));
+        Check("格式字段", info.channels == 1 && info.sample_rate == 44100 && info.bits == 16 && !info.is_float);
+        Check("pcm 指向 data 块", info.pcm == wav.Data() + offset && info.pcm_size == 200);
+        Check("无 smpl 不循环", !info.loop);
+    }
+
+    // 2. 奇数长度块：按填充字节跳过，之后的块位置正确
+    {
+        WAVBuilder wav;
+        wav.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 1, 22050, 8));
+        wav.Chunk("LIST", Samples(5));
+        wav.Chunk("junk", Samples(1));
+        const size_t offset = wav.Chunk("data", Samples(7));
+        wav.Chunk("smpl", WAVBuilder::Smpl(1));
+
+        Check("奇数长度块之后仍能找到 data", Parse(wav, info));
+        Check("data 位置正确", info.pcm == wav.Data() + offset);
+        Check("奇数长度 data（8 位单声道）保留全部 7 字节", info.pcm_size == 7);
+        Check("奇数长度 data 之后的 smpl 循环标记", info.loop);
+    }
+
+    // 3. 奇数长度块缺少填充字节且位于文件末尾（不规范文件）
+    {
+        WAVBuilder wav;
+        wav.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 1, 8000, 8));
+        wav.Chunk("data", Samples(9), false);
+
+        Check("末尾缺少填充字节仍可解析", Parse(wav, info) && info.pcm_size == 9);
+    }
+
+    // 4. 缺少 data / data 在 fmt 之前 / 缺少 fmt
+    {
+        WAVBuilder no_data;
+        no_data.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 2, 44100, 16));
+        no_data.Chunk("LIST", Samples(11));
+        Check("缺少 data 块 -> false", !Parse(no_data, info));
+
+        WAVBuilder data_first;
+        data_first.Chunk("data", Samples(64));
+        data_first.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 2, 44100, 16));
+        Check("data 在 fmt 之前 -> false", !Parse(data_first, info));
+
+        WAVBuilder no_fmt;
+        no_fmt.Chunk("data", Samples(64));
+        Check("缺少 fmt 块 -> false", !Parse(no_fmt, info));
+
+        WAVBuilder empty_data;
+        empty_data.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 2, 44100, 16));
+        empty_data.Chunk("data", Samples(3));
+        Check("data 不足一帧 -> false", !Parse(empty_data, info));
+    }
+
+    // 5. WAVE_FORMAT_EXTENSIBLE
+    {
+        WAVBuilder pcm24;
+        pcm24.Chunk("fmt ", WAVBuilder::FmtExtensible(WAVE_FORMAT_PCM, 2, 48000, 24));
+        pcm24.Chunk("data", Samples(6 * 10 + 4));
+
+        Check("EXTENSIBLE 子格式 PCM 24 位立体声", Parse(pcm24, info));
+        Check("24 位字段", info.bits == 24 && info.channels == 2 && info.sample_rate == 48000 && !info.is_float);
+        Check("PCM 长度截到整帧", info.pcm_size == 60);
+
+        WAVBuilder flt;
+        flt.Chunk("fmt ", WAVBuilder::FmtExtensible(WAVE_FORMAT_IEEE_FLOAT, 2, 48000, 32));
+        flt.Chunk("data", Samples(8 * 4));
+        Check("EXTENSIBLE 子格式 float", Parse(flt, info) && info.is_float && info.bits == 32);
+
+        WAVBuilder adpcm;
+        adpcm.Chunk("fmt ", WAVBuilder::FmtExtensible(0x0011, 1, 22050, 4));
+        adpcm.Chunk("data", Samples(64));
+        Check("EXTENSIBLE 子格式 ADPCM -> false", !Parse(adpcm, info));
+
+        WAVBuilder short_fmt;
+        short_fmt.Chunk("fmt ", WAVBuilder::FmtExtensible(WAVE_FORMAT_PCM, 2, 48000, 16, false));
+        short_fmt.Chunk("data", Samples(64));
+        Check("EXTENSIBLE fmt 块不足 40 字节 -> false", !Parse(short_fmt, info));
+    }
+
+    // 6. 截断的文件：data 声明长度超出文件，按实际长度并截到整帧
+    {
+        WAVBuilder wav;
+        wav.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 2, 44100, 16));
+        wav.Chunk("data", Samples(103), false, 100000);
+
+        Check("截断的 data 按实际长度解析", Parse(wav, info) && info.pcm_size == 100);
+    }
+
+    // 7. 不支持的格式与非 WAV 数据
+    {
+        WAVBuilder adpcm;
+        adpcm.Chunk("fmt ", WAVBuilder::Fmt(0x0011, 1, 22050, 4));
+        adpcm.Chunk("data", Samples(64));
+        Check("IMA ADPCM -> false", !Parse(adpcm, info));
+
+        WAVBuilder float16;
+        float16.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_IEEE_FLOAT, 1, 22050, 16));
+        float16.Chunk("data", Samples(64));
+        Check("16 位 float -> false", !Parse(float16, info));
+
+        WAVBuilder pcm12;
+        pcm12.Chunk("fmt ", WAVBuilder::Fmt(WAVE_FORMAT_PCM, 1, 22050, 12));
+        pcm12.Chunk("data", Samples(64));
+        Check("12 位 PCM -> false", !Parse(pcm12, info));
+
+        WAVBuilder short_fmt;
+        short_fmt.Chunk("fmt ", Samples(14));
+        short_fmt.Chunk("data", Samples(64));
+        Check("fmt 块不足 16 字节 -> false", !Parse(short_fmt, info));
+
+        const char not_wav[] = "RIFF\0\0\0\0AVI LIST";
+        Check("非 WAVE 的 RIFF -> false", !ParseRIFFWAVE(not_wav, sizeof(not_wav), info));
+        Check("不足 12 字节 -> false", !ParseRIFFWAVE("RIFF", 4, info));
+        Check("空指针 -> false", !ParseRIFFWAVE(nullptr, 100, info));
+    }
+
+    std::cout << std::endl;
+    if(failed == 0)
+    {
+        std::cout << "全部通过" << std::endl;
+        return 0;
+    }
+
+    std::cout << failed << " 项失败" << std::endl;
+    return 1;
+}
@@ -0,0 +1,22 @@
+﻿#ifndef HGL_AL_EVENTS_INCLUDE
+#define HGL_AL_EVENTS_INCLUDE
+
+#include<hgl/al/al.h>
+namespace openal
+{
+    // AL_SOFT_events（OpenAL Soft 1.23+）：由 OpenAL 内部线程回调通知缓冲区播完/音源状态变化
+
+    #define AL_EVENT_CALLBACK_FUNCTION_SOFT          0x19A2
+    #define AL_EVENT_CALLBACK_USER_PARAM_SOFT        0x19A3
+    #define AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT      0x19A4
+    #define AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT  0x19A5
+    #define AL_EVENT_TYPE_DISCONNECTED_SOFT          0x19A6
+
+    typedef void (AL_APIENTRY *ALEVENTPROCSOFT)(ALenum event_type,ALuint object,ALuint param,ALsizei length,const ALchar *message,void *user_param);
+    typedef void (AL_APIENTRY *LPALEVENTCONTROLSOFT)(ALsizei count,const ALenum *types,ALboolean enable);
+    typedef void (AL_APIENTRY *LPALEVENTCALLBACKSOFT)(ALEVENTPROCSOFT callback,void *user_param);
+
+    extern LPALEVENTCONTROLSOFT alEventControlSOFT;
+    extern LPALEVENTCALLBACKSOFT alEventCallbackSOFT;
+}//namespace openal
+#endif//HGL_AL_EVENTS_INCLUDE
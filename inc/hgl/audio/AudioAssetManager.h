@@ -3,12 +3,19 @@
 #include<hgl/type/String.h>
 #include<hgl/type/UnorderedMap.h>
 #include<hgl/thread/ThreadMutex.h>
+#include<hgl/audio/AudioFileType.h>
 #include<hgl/CoreType.h>
+#include<list>
+#include<vector>
 
 namespace hgl::audio
 {
     class AudioBuffer;
-    class AudioLoadThread;                                  ///< 后台解码线程（实现于 .cpp，懒启动）
+    class AudioLoadPool;                                    ///< 后台解码池（实现于 .cpp，懒启动）
+    class SoundBank;
+    struct SoundBankEntry;
+
+    constexpr uint AUDIO_DECODE_MAX_WORKERS=16;             ///< 解码池线程数上限
 
     /**
     * 音频资源加载模式
@@ -16,7 +23,8 @@ namespace hgl::audio
     enum class AudioLoadMode
     {
         Full=0,      ///<全量加载（AudioBuffer，适合短音效）
-        Stream       ///<流式加载（AudioPlayer，适合长音乐/BGM）
+        Stream,      ///<流式加载（AudioPlayer，适合长音乐/BGM）
+        Compressed   ///<压缩常驻（Opus/Vorbis 原始字节常驻内存，播放时按需解码，适合 5~30 秒的语音/台词）
     };
 
     /**
@@ -28,19 +36,119 @@ namespace hgl::audio
     */
     AudioLoadMode SuggestAudioLoadMode(int64 file_size,int64 full_load_threshold=1*1024*1024);
 
+    constexpr double AUDIO_FULL_LOAD_MAX_SECONDS        =5.0;   ///< 压缩格式全量解码常驻的时长上限
+    constexpr double AUDIO_COMPRESSED_LOAD_MAX_SECONDS  =30.0;  ///< 压缩常驻的时长上限，更长的走流式
+
+    /**
+    * 根据格式与时长给出建议的加载模式
+    * - Opus/Vorbis：短于 AUDIO_FULL_LOAD_MAX_SECONDS 全量，不超过 AUDIO_COMPRESSED_LOAD_MAX_SECONDS 压缩常驻，更长流式
+    * - WAV/MIDI 等（本身已是 PCM 或需合成）：压缩常驻无收益，按文件大小决策
+    * @param file_type 音频文件格式
+    * @param duration 时长（秒），<=0 表示未知，按文件大小决策
+    * @param file_size 文件字节数（-1 表示未知）
+    */
+    AudioLoadMode SuggestAudioLoadMode(AudioFileType file_type,double duration,int64 file_size=-1);
+
+    /**
+    * 常驻内存的压缩音频数据（Opus/Vorbis 文件原始字节）
+    * 由 AudioAssetManager 按文件名去重、按引用计数管理；解码流只读访问，多个播放实例可同时打开同一份数据
+    */
+    struct AudioCompressedData
+    {
+        OSString        name;
+        AudioFileType   file_type;
+        char *          data;
+        int64           size;
+        uint            ref_count;                          ///< 由 AudioAssetManager 在锁内维护
+        bool            owned;                              ///< false 表示 data 指向已挂载声音包的映射内存（不释放）
+    };//struct AudioCompressedData
+
+    /**
+    * 异步加载上传统计（Update() 把已解码 PCM 上传到 OpenAL 的情况）
+    */
+    struct AudioUploadStats
+    {
+        uint64  total_count;                                ///< 累计上传个数（含解码失败项）
+        uint64  total_bytes;                                ///< 累计上传字节数
+        uint    last_count;                                 ///< 最近一次有上传的 Update() 处理个数
+        uint64  last_bytes;                                 ///< 最近一次有上传的 Update() 上传字节数
+
+        int     backlog_count;                              ///< 已解码、等待上传的个数
+        uint64  backlog_bytes;                              ///< 已解码、等待上传的字节数
+    };//struct AudioUploadStats
+
+    /**
+    * 资源驻留统计（无引用缓冲的 LRU 保留）
+    */
+    struct AudioResidencyStats
+    {
+        uint64  budget;                                     ///< 驻留字节预算（0=未启用，归零即卸载）
+        uint64  resident_bytes;                             ///< 全部缓存缓冲的 PCM 字节数
+        uint64  idle_bytes;                                 ///< 其中无引用、可被淘汰的字节数
+        int     resident_count;                             ///< 缓存条目数
+        int     idle_count;                                 ///< 无引用、可被淘汰的条目数
+
+        uint64  compressed_bytes;                           ///< 压缩常驻数据字节数
+        int     compressed_count;                           ///< 压缩常驻条目数
+
+        uint64  hit_count;                                  ///< Acquire/AcquireCompressed 命中缓存次数
+        uint64  miss_count;                                 ///< Acquire/AcquireCompressed 未命中（同步加载）次数
+        uint64  eviction_count;                             ///< 因超出预算被淘汰的次数
+    };//struct AudioResidencyStats
+
     /**
     * 音频资源管理器：缓存去重 + 引用计数（P0-2）
     *
     * - 同一文件（按 filename 字符串去重）只加载一次，多次 Acquire 共享同一 AudioBuffer
     * - 引用计数归零时自动卸载；外部可通过 Clear() 强制清空
+    * - 设置驻留预算后，归零的缓冲进入 LRU 继续常驻，总量超出预算时淘汰最久未用的；Pin() 的资源永不淘汰
     * - 线程安全：所有缓存操作在内部互斥锁保护下进行
     */
     class AudioAssetManager
     {
-        UnorderedMap<OSString, AudioBuffer *> assets;       ///< 文件名 → 缓冲区缓存
+        struct AssetEntry
+        {
+            AudioBuffer *buffer;
+            bool pinned;                                    ///< 固定常驻，不进入 LRU
+            bool idle;                                      ///< 无引用，在 idle_list 中
+            std::list<OSString>::iterator lru_it;           ///< idle_list 中的位置（idle 时有效）
+        };
+
+        UnorderedMap<OSString, AssetEntry> assets;          ///< 文件名 → 缓冲区缓存
+        std::list<OSString> idle_list;                      ///< 无引用缓冲 LRU（头部最久未用）
+        UnorderedMap<OSString, AudioCompressedData *> compressed_assets;    ///< 文件名 → 压缩常驻数据
+        uint64 compressed_bytes;
         mutable ThreadMutex lock;
 
-        AudioLoadThread *load_thread;                       ///< 后台解码线程（懒启动，nullptr=未创建）
+        uint64 resident_budget;                             ///< 驻留字节预算（0=未启用）
+        uint64 resident_bytes;
+        uint64 idle_bytes;
+        uint64 hit_count;
+        uint64 miss_count;
+        uint64 eviction_count;
+
+        AudioLoadPool *load_pool;                           ///< 后台解码池（懒启动，nullptr=未创建；在 lock 内创建与读取，创建后直到析构不变）
+        uint decode_worker_count;                           ///< 解码线程数（0=按 CPU 核数自动）
+        bool decode_paused;                                 ///< 解码池暂停取新任务
+
+        AudioUploadStats upload_stats;                      ///< 上传统计（backlog 字段在查询时填充）
+
+        std::vector<SoundBank *> banks;                     ///< 已挂载声音包（后挂载的优先），析构时卸载
+
+    private: //以下均需在 lock 内调用
+
+        bool AddEntry(const OSString &,AudioBuffer *);
+        void MarkIdle(const OSString &,AssetEntry *);
+        void MarkActive(AssetEntry *);
+        void Unload(const OSString &);
+        void EvictToBudget();
+        void ReleaseEntry(const OSString &,AssetEntry *);
+        const SoundBankEntry *FindInBanks(const OSString &,SoundBank **)const;
+        AudioLoadPool *CreateLoadPool();                    ///< 取得解码池，未创建时创建
+
+    private:
+
+        AudioLoadPool *GetLoadPool()const;                  ///< 在 lock 内读取解码池（nullptr=未创建）
 
     public:
 
@@ -49,7 +157,7 @@ namespace hgl::audio
 
         /**
         * 取得（或加载）一个音频缓冲区
-        * 命中缓存则引用计数+1；未命中则同步加载并登记（引用计数=1）
+        * 命中缓存则引用计数+1；未命中则同步加载（优先从已挂载的声音包）并登记（引用计数=1）
         * @param filename 音频文件名（作为缓存键，需保持一致才能命中）
         * @return 缓冲区指针，加载失败返回 nullptr
         */
@@ -65,7 +173,7 @@ namespace hgl::audio
         bool Register(const os_char *name,AudioBuffer *buffer);
 
         /**
-        * 释放一次引用，引用计数归零时卸载并从缓存移除
+        * 释放一次引用，引用计数归零时卸载并从缓存移除（启用驻留预算时改为进入 LRU）
         */
         void Release(AudioBuffer *buffer);
         void Release(const os_char *name);
@@ -79,23 +187,104 @@ namespace hgl::audio
         bool Contains(const os_char *name)const;            ///< 是否已缓存
 
         int  GetCount()const;                               ///< 缓存条目数
-        void Clear();                                       ///< 清空全部缓存（无视引用计数）
+        void Clear();                                       ///< 清空全部缓存（无视引用计数与固定）
+
+    public: //声音包
+
+        /**
+        * 挂载一个声音包（内存映射，见 SoundBank.h）
+        * 之后 Acquire()/AcquireCompressed()/AcquireAsync() 未命中缓存时先按名称在已挂载的包中二分查找：
+        * PCM 负载直接从映射内存上传，压缩负载从映射内存解码，不再逐项打开文件
+        * 包内找不到的名称仍按文件名从磁盘加载；多个包含同名资源时后挂载的优先
+        * 声音包在管理器析构前保持映射，不支持单独卸载
+        * @param filename 声音包文件名
+        * @return 是否挂载成功
+        */
+        bool MountBank(const os_char *filename);
+        int  GetBankCount()const;                           ///< 已挂载的声音包数量
+
+    public: //压缩常驻（AudioLoadMode::Compressed）
+
+        /**
+        * 取得（或读入）一个文件的压缩数据，引用计数+1
+        * 只读入原始字节，不解码；由 AudioStreamVoicePool 等在播放时按需解码
+        * @param filename 音频文件名（缓存键）
+        * @param file_type 文件格式（None=按扩展名识别）
+        * @return 压缩数据，读取失败返回 nullptr
+        */
+        AudioCompressedData *AcquireCompressed(const os_char *filename,AudioFileType file_type=AudioFileType::None);
+
+        void    ReleaseCompressed(AudioCompressedData *data);   ///< 释放一次引用，归零时释放内存
+        uint64  GetCompressedBytes()const;                  ///< 压缩常驻数据总字节数
+
+    public: //驻留策略
+
+        /**
+        * 设置驻留字节预算：引用归零的缓冲保留在 LRU 中，全部缓存超出预算时从最久未用的开始淘汰
+        * 有引用或已固定的缓冲不会被淘汰，因此实际驻留量可能超出预算
+        * @param bytes 预算字节数，0 表示关闭（立即卸载 LRU 中全部缓冲，之后归零即卸载）
+        */
+        void   SetResidentBudget(uint64 bytes);
+        uint64 GetResidentBudget()const;
+        uint64 GetResidentBytes()const;                     ///< 全部缓存缓冲的 PCM 字节数
+
+        bool Pin(const os_char *name);                      ///< 固定已缓存的资源，引用归零也不卸载/淘汰
+        bool Unpin(const os_char *name);                    ///< 取消固定，无引用时按驻留策略进入 LRU 或卸载
+        bool IsPinned(const os_char *name)const;
+
+        AudioResidencyStats GetResidencyStats()const;
+        void ResetResidencyCounters();                      ///< 清零命中/未命中/淘汰计数
 
     public: //异步加载（P0-2）
 
+        /**
+        * 设置解码池线程数，须在首次 AcquireAsync() 前调用（解码池已启动返回 false）
+        * @param count 线程数，0 表示自动（CPU 核数-1，至少 1）
+        */
+        bool SetDecodeWorkerCount(uint count);
+        uint GetDecodeWorkerCount()const;                   ///< 实际（或将要使用的）解码线程数
+
         /**
         * 异步加载：提交后台解码任务，解码完成后在 Update() 中上传并登记缓存
         * 调用方之后用 Acquire() 命中缓存取得缓冲区（零成本）
+        * 同一文件重复提交不会重复解码，优先级取较高者
         * @param filename 音频文件名
-        * @return 是否已提交（已缓存命中或无法识别类型返回 false）
+        * @param priority 优先级，越大越先解码（同优先级按提交顺序）
+        * @return 是否已提交（已缓存命中也返回 true，无法识别类型返回 false）
+        */
+        bool AcquireAsync(const os_char *filename,int priority=0);
+
+        /**
+        * 修改尚未开始解码的任务的优先级（可升可降）
+        * @return 任务不存在或已在解码中返回 false
         */
-        bool AcquireAsync(const os_char *filename);
+        bool SetAsyncPriority(const os_char *filename,int priority);
+
+        /**
+        * 取消异步加载：未开始的任务直接移除，解码中的任务完成后丢弃结果
+        * 已解码完成、等待 Update() 上传的任务不受影响
+        * @return 是否找到并取消了任务
+        */
+        bool CancelAsync(const os_char *filename);
+
+        /**
+        * 暂停后台解码：正在解码的任务照常完成，之后不再开始新任务，提交/改优先级/取消仍然有效
+        * 可在首次 AcquireAsync() 之前调用（解码池以暂停状态启动），用于加载关键期把 CPU/IO 留给主线程
+        */
+        void PauseAsync();
+        void ResumeAsync();                                 ///< 恢复后台解码，按优先级继续
+        bool IsAsyncPaused()const;
 
         /**
         * 主线程每帧调用：上传已完成解码的缓冲到 OpenAL 并登记缓存
+        * 超出预算时剩余项留在队列中，下次调用继续（每次至少处理一项，单项不拆分）
+        * @param max_ms 本次耗时预算（毫秒），0 表示不限
+        * @param max_bytes 本次上传字节预算，0 表示不限
         * @return 本次完成上传/处理的任务数
         */
-        int  Update();
+        int  Update(double max_ms=0,uint64 max_bytes=0);
+
+        AudioUploadStats GetUploadStats()const;             ///< 上传统计与待上传积压
 
         bool IsLoading()const;                              ///< 是否有后台任务在途
         int  GetPendingCount()const;                        ///< 在途任务数（待解码 + 待上传）
@@ -21,6 +21,7 @@ namespace hgl::audio
         bool loaded;
 
         void InitPrivate();
+        bool LoadMappedWAV(const os_char *);                                                        ///<内存映射方式加载 PCM WAV
 
     private:
 
@@ -0,0 +1,22 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+
+namespace hgl::audio
+{
+    /**
+    * 等功率交叉淡化两段交错 float 采样：output = from×cos(θ) + to×sin(θ)，θ = t×π/2
+    *
+    * 第 i 帧的位置 t = start + i×step（钳位到 [0,1]，0=全部 from，1=全部 to），同一帧各声道使用相同增益。
+    * cos/sin 用 [0,π/2] 上的奇次多项式在 SIMD 内核中逐采样计算（误差约 4e-6），不查表、不调用 libm。
+    * 内核跟随 GetSampleConvertPath()（标量/SSE2/AVX2/NEON）；output 可以与 from 或 to 相同。
+    * @param from       淡出的采样
+    * @param to         淡入的采样
+    * @param output     输出采样
+    * @param frames     帧数
+    * @param channels   声道数
+    * @param start      第 0 帧的淡化位置
+    * @param step       每帧位置增量（= 1/淡化总帧数）
+    */
+    void CrossfadeEqualPower(const float *from,const float *to,float *output,uint frames,uint channels,float start,float step);
+}//namespace hgl::audio
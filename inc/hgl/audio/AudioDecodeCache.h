@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+#include<hgl/type/String.h>
+
+namespace hgl::audio
+{
+    constexpr uint64 AUDIO_DECODE_CACHE_DEFAULT_MAX_BYTES=512*1024*1024;   ///< 默认磁盘缓存上限
+
+    /**
+    * 解码结果磁盘缓存统计（本进程）
+    */
+    struct AudioDecodeCacheStats
+    {
+        uint64  hit_count;                      ///< 命中（映射缓存文件，跳过解码）次数
+        uint64  miss_count;                     ///< 未命中（实际解码）次数
+        uint64  store_count;                    ///< 写入缓存文件次数
+        uint64  eviction_count;                 ///< 超出上限被删除的缓存文件数
+        uint64  cache_bytes;                    ///< 缓存目录总字节数（估算，其它进程的写入在下次清理时计入）
+    };//struct AudioDecodeCacheStats
+
+    /**
+    * 启用解码结果磁盘缓存
+    *
+    * DecodeAudio() 解码 Vorbis/Opus/MIDI 后把 PCM 写入缓存目录，下次（含下次启动）遇到相同输入时直接内存映射缓存文件，
+    * 不再调用插件解码。缓存键为源数据内容哈希 + 插件名/版本 + 浮点输出与否 + SetAudioDecodeCacheSettingsKey() 设置的外部设置。
+    *
+    * - 写入先写临时文件再原子改名，多个进程可共享同一目录；
+    * - 命中时刷新文件修改时间，总大小超出上限时按修改时间从最久未用的开始删除；
+    * - WAV 本身即 PCM，不缓存。
+    * @param path 缓存目录（不存在则创建）
+    * @param max_bytes 缓存目录总字节数上限
+    * @return 是否启用成功
+    */
+    bool EnableAudioDecodeCache(const os_char *path,uint64 max_bytes=AUDIO_DECODE_CACHE_DEFAULT_MAX_BYTES);
+    void DisableAudioDecodeCache();                 ///< 停用（不删除已有缓存文件）
+    bool IsAudioDecodeCacheEnabled();
+
+    /**
+    * 设置影响解码输出、但无法从源数据得知的外部设置（如 MIDI 音色库路径、合成采样率），参与缓存键
+    * 设置改变后旧缓存自然失效（不再命中，由 LRU 清理）
+    */
+    void SetAudioDecodeCacheSettingsKey(const char *key);
+
+    void TrimAudioDecodeCache();                    ///< 立即扫描缓存目录并按上限清理
+    AudioDecodeCacheStats GetAudioDecodeCacheStats();
+}//namespace hgl::audio
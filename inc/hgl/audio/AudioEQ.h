@@ -9,8 +9,9 @@ namespace hgl::audio
     /**
     * 对 PCM 数据原地应用参数化 EQ（P2 实时兜底：EFX 不可用时的 CPU 路径）
     *
-    * 支持 int16 / float32 交错数据，逐声道处理（每个声道独立滤波、独立 Reset）。
-    * 其它格式（8bit/int24 等）返回 false 且不修改数据。
+    * 支持 int16 / int24 / int32 / float32 交错数据，逐声道处理（每个声道独立滤波、独立 Reset）。
+    * 整数格式经共享 SIMD 转换内核（SampleConvert）分块转 float 处理后再量化回原格式，不按数据长度分配内存；
+    * 其它格式（含 OpenAL 的无符号 8 位）返回 false 且不修改数据。
     *
     * @param data PCM 数据（原地修改）
     * @param size 数据字节数
@@ -28,6 +28,9 @@ namespace hgl::audio
 
         AudioAssetManager *asset_manager;               ///< 资源管理（引擎持有）
 
+        double asset_upload_ms;                         ///< 每帧异步资源上传耗时预算（毫秒，0=不限）
+        uint64 asset_upload_bytes;                      ///< 每帧异步资源上传字节预算（0=不限）
+
         UnorderedSet<SpatialAudioWorld *> worlds;       ///< 注册的空间音频世界（引擎不持有）
 
     public:
@@ -50,7 +53,15 @@ namespace hgl::audio
         AudioBuffer *Acquire(const os_char *filename);          ///< 取得（或加载）音频缓冲区（缓存去重）
         void         Release(AudioBuffer *buffer);              ///< 释放一次引用
         void         Release(const os_char *filename);          ///< 按文件名释放一次引用
-        bool         AcquireAsync(const os_char *filename);     ///< 异步预加载（后台解码）
+        bool         AcquireAsync(const os_char *filename,int priority=0);  ///< 异步预加载（后台解码池，priority 越大越先解码）
+
+        /**
+        * 设置每帧异步资源上传预算（Update() 中使用，超出部分顺延到下一帧）
+        * 默认 2ms / 2MB，避免关卡流式加载时单帧上传过多 PCM 拖慢事件分发
+        * @param max_ms 耗时预算（毫秒），0 表示不限
+        * @param max_bytes 字节预算，0 表示不限
+        */
+        void SetAssetUploadBudget(double max_ms,uint64 max_bytes){asset_upload_ms=max_ms;asset_upload_bytes=max_bytes;}
 
     public: //空间音频世界注册
 
@@ -62,7 +73,7 @@ namespace hgl::audio
 
         /**
         * 统一驱动：主线程每帧调用
-        * 依次：资源管理（上传已完成解码的异步缓冲）→ 各空间音频世界刷新
+        * 依次：资源管理（按上传预算上传已完成解码的异步缓冲）→ 各空间音频世界刷新
         * @param ct 当前时间（秒），0 表示由各子系统自行取时间
         */
         void Update(const double &ct=0);
@@ -6,18 +6,25 @@
 #include<hgl/audio/EventTransport.h>
 #include<hgl/audio/SoundEventManager.h>
 #include<hgl/audio/AudioEngine.h>
-#include<hgl/audio/AudioPlayer.h>
+#include<hgl/audio/AudioSource.h>
 #include<vector>
+#include<unordered_map>
 
 namespace hgl::audio
 {
+    class AudioStreamVoicePool;
+    struct AudioCompressedData;
+
+    constexpr uint AUDIO_ENGINE_DEFAULT_VOICES          =32;    ///< 常驻音源池默认大小
+    constexpr uint AUDIO_ENGINE_DEFAULT_STREAM_VOICES   =4;     ///< 流式音源池默认大小
+
     /**
     * 音频引擎线程（T4/T5）：事件驱动主循环
     *
     * 音频引擎隔离侧的核心：独立线程运行，主循环 =
     *   1. 批量消费事件队列（Send 的事件，一次清空，帧内一致）
-    *   2. 分发执行（Play/Stop/SetParam/总线/快照 → SoundEventManager + AudioEngine + AudioPlayer）
-    *   3. engine.Update(now)（驱动总线/资源/空间音频）
+    *   2. 分发执行（Play/Stop/SetParam/总线/快照 → SoundEventManager + AudioEngine + 音源池）
+    *   3. engine.Update(now)（驱动总线/资源/空间音频）+ 流式音源池补充缓冲
     *   4. 回传处理（PlayStarted/PlayFinished/Stopped/Error）
     *   5. SleepSecond(帧间隔)
     *
@@ -26,8 +33,15 @@ namespace hgl::audio
     * - 调用方只碰 EventTransport（无锁队列），不共享任何引擎状态
     * - 状态查询走 WaitIdle + 原子计数
     *
+    * 播放实例不再逐个创建 AudioPlayer：
+    * - 普通 Cue：文件经 AudioAssetManager 整段加载为 AudioBuffer，挂到线程启动时预先创建的常驻音源上播放
+    * - stream=true 的 Cue：压缩数据常驻，由 AudioStreamVoicePool 的流式音源边解码边播放
+    * - Cue 的资源在 LoadCue 或首次 Play 时取得并由本线程持有引用，之后的 Play 不读文件，普通 Cue 只取空闲音源挂 buffer，无内存分配
+    * - 常驻音源用尽时抢占最早开始的非循环实例（回传 Stopped），流式音源用尽时回传 Error
+    *
     * 事件参数约定（T5）：
     * - Play：cue_id=Cue 名哈希
+    * - LoadCue/UnloadCue：cue_id=Cue 名哈希（预先取得/释放该 Cue 全部文件的资源引用，LoadCue 回传 LoadComplete）
     * - Stop：instance_id=目标实例
     * - SetParam：instance_id=实例，cue_id=参数名哈希，params[0]=value
     * - SetBusVolume：params[0]=gain，params[1]=总线索引(AudioBusType)
@@ -39,16 +53,34 @@ namespace hgl::audio
         struct ActiveInstance
         {
             uint32      instance_id;    ///< 实例 ID（回传用）
-            OSString    cue_name;       ///< Cue 名（RTPC 查表）
-            AudioPlayer *player;        ///< 播放器
+            uint32      cue_id;         ///< Cue 名哈希（UnloadCue 时停止该 Cue 的实例）
+            int         voice;          ///< 音源编号（stream=false 为常驻音源池，true 为流式音源池）
+            bool        stream;         ///< 是否流式实例
             bool        loop;           ///< 是否循环（播完清理判断）
         };
 
+        /**
+        * 一个 Cue 的常驻资源（本线程持有一次引用）
+        * 下标与 Cue 的 sequence（有轮播时）或 files 一一对应，加载失败的项为 nullptr
+        */
+        struct CueAssets
+        {
+            std::vector<AudioBuffer *>          buffers;        ///< 普通 Cue
+            std::vector<AudioCompressedData *>  compressed;     ///< stream Cue
+        };
+
         EventTransport     *transport;      ///< 事件通道（外部持有）
         AudioEngine         engine;         ///< 音频引擎（总线/资源/空间音频）
         SoundEventManager   cues;           ///< Cue 表（事件名 → 配置）
 
-        std::vector<ActiveInstance> instances;  ///< 活跃播放实例
+        std::vector<ActiveInstance> instances;  ///< 活跃播放实例（容量按音源总数预留）
+        std::unordered_map<uint32,CueAssets> cue_assets;    ///< Cue 名哈希 → 常驻资源
+
+        uint voice_count;                       ///< 常驻音源数量
+        uint stream_voice_count;                ///< 流式音源数量
+        std::vector<AudioSource *> voices;      ///< 常驻音源池（线程启动时创建）
+        std::vector<int> free_voices;           ///< 空闲常驻音源编号
+        AudioStreamVoicePool *stream_pool;      ///< 流式音源池（线程启动时创建）
         uint32 next_instance;                   ///< 实例 ID 分配器
         uint32 seq_counter;                     ///< sequence 轮播计数器
 
@@ -79,6 +111,17 @@ namespace hgl::audio
 
         void SetFrameInterval(double sec){frame_interval=sec;}   ///< 帧间隔（默认 0.01）
 
+        /**
+        * 设置音源池大小，须在 Start() 前调用
+        * @param count 常驻音源数量（普通 Cue 同时播放上限）
+        * @param stream_count 流式音源数量（stream Cue 同时播放上限）
+        */
+        void SetVoiceCount(uint count,uint stream_count=AUDIO_ENGINE_DEFAULT_STREAM_VOICES)
+        {
+            voice_count=count;
+            stream_voice_count=stream_count;
+        }
+
         /**
         * 等待队列排空且本帧处理完成（测试/工具同步点）
         * @param timeout_ms 超时毫秒（0=无限等待）
@@ -90,6 +133,13 @@ namespace hgl::audio
 
         AudioBus *GetBus(AudioBusType type);        ///< 总线类型 → 引擎总线
         void Dispatch(const AudioEvent &ev);    ///< 分发单个事件
+        void PlayCue(const AudioEvent &ev);     ///< 处理 Play 事件
+        CueAssets *LoadCue(uint32 cue_id,const SoundEventConfig *cfg);  ///< 取得 Cue 的常驻资源（已取得直接返回）
+        void UnloadCue(uint32 cue_id);          ///< 停止该 Cue 的实例并释放其资源引用
+        void UnloadAllCues();
+        AudioSource *GetSource(const ActiveInstance &inst);     ///< 实例所用音源
+        void StopInstance(const ActiveInstance &inst);          ///< 停止实例并归还音源（不回传、不移出列表）
+        void PostResult(AudioEventResultType type,uint32 instance_id,uint32 error_code,uint32 seq);
         void ConsumeEvents();                   ///< 批量消费事件队列
         void FlushResults();                    ///< 处理回传（播完检测 → PlayFinished）
     };//class AudioEngineThread
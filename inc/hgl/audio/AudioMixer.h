@@ -4,8 +4,15 @@
 #include<hgl/audio/AudioMemoryPool.h>
 #include<hgl/audio/OpenAL.h>
 #include<hgl/audio/ParametricEQ.h>
+#include<hgl/audio/SampleConvert.h>
 #include<hgl/type/ValueArray.h>
 #include<hgl/log/Log.h>
+#include<vector>
+#include<map>
+#include<memory>
+#include<tuple>
+
+struct SRC_STATE_tag;                           ///< libsamplerate 流式状态（前置声明，避免头文件依赖 samplerate.h）
 
 namespace hgl::audio
 {
@@ -13,7 +20,9 @@ namespace hgl::audio
      * 音频混音器
      * 用于将多个音轨叠加混音成一个新的音频数据
      * 支持单声道及多声道音频，支持时间偏移、音量调整、音调变化等变换
-     * 多个音源必须统一格式与采样率，不在此处进行重采样
+     * 多个音源须声道数一致，采样率/位深可以不同：
+     * 采样率转换与音调合并为一次 libsamplerate 处理（比率 = 混音采样率/音源采样率/pitch）
+     * MixerConfig::thread_count>1 时 Mix() 并行生成演绎数据、按输出区间并行累加，结果与串行逐位一致
      */
     class AudioMixer
     {
@@ -47,20 +56,74 @@ namespace hgl::audio
         ValueArray<MixingTrack> tracks;         ///< 混音轨道列表
         MixerConfig config;                     ///< 混音器配置
 
-        AudioDataInfo common_info;               ///< 统一音频格式信息
+        AudioDataInfo common_info;               ///< 首个音源的格式信息（声道数为统一标准）
         bool has_common_info;                     ///< 是否已设置统一格式
         AudioDataInfo output_format;             ///< 输出格式
 
         ParametricEQ eq;                        ///< 参数化均衡器（P2：混音输出前应用）
 
+        TPDFDither dither;                      ///< float→int16 抖动噪声源（8 路 xorshift，SIMD 生成）
+
+        /**
+            * 音源演绎（rendition）：某个音源转 float 后以某个音调重采样到某个采样率的结果
+            * 同一 (source,sample_rate,pitch) 的多个轨道、多次 Mix() 共享同一份数据
+            * 音源原采样率 + 原始音调的演绎即原始 float 数据，是变调/流式混音的输入
+            */
+        struct Rendition
+        {
+            std::vector<float> samples;         ///< 交错 float 采样
+            uint frame_count = 0;               ///< 帧数
+        };
+
+        struct RenditionKey
+        {
+            uint source_index;                  ///< 音源索引
+            uint sample_rate;                   ///< 演绎输出采样率
+            uint32_t pitch_bits;                ///< 规整后 pitch 的位模式
+
+            bool operator<(const RenditionKey& other) const
+            {
+                return std::tie(source_index, sample_rate, pitch_bits) <
+                       std::tie(other.source_index, other.sample_rate, other.pitch_bits);
+            }
+        };
+
+        std::map<RenditionKey,Rendition> renditions;    ///< 演绎缓存
+
+        std::vector<const Rendition*> track_renditions;     ///< Mix() 中每个轨道对应的演绎数据（与 tracks 同序）
+
+        /**
+            * 流式混音（BeginMix/MixBlock）中单个轨道的状态
+            * 变调使用 libsamplerate 流式 src_process，滤波器状态跨块保持
+            */
+        struct TrackStream
+        {
+            const Rendition* base = nullptr;    ///< 音源原采样率、原始音调的 float 数据（来自演绎缓存）
+            SRC_STATE_tag* src = nullptr;       ///< 流式重采样状态（比率为 1 时为 nullptr，直接拷贝）
+            double ratio = 1.0;                 ///< 重采样比率 = 混音采样率/音源采样率/pitch
+            uint start_frame = 0;               ///< 在输出中的起始帧
+            uint read_frame = 0;                ///< 已消耗的输入帧
+            float gain = 1.0f;                  ///< track.volume × master_volume
+            bool finished = false;              ///< 是否已输出完毕
+        };
+
+        std::vector<TrackStream> streams;       ///< 流式混音轨道状态
+        bool streaming;                         ///< 是否处于 BeginMix() 之后的流式混音中
+        uint stream_frame_count;                ///< 流式混音总帧数
+        uint stream_position;                   ///< 流式混音已输出帧数
+
         // 内存池 - 避免频繁分配/释放
         AudioMemoryPool<float> pool_buffer;      ///< 主混音缓冲池
         AudioMemoryPool<float> temp_buffer;      ///< 临时格式转换缓冲池
+        AudioMemoryPool<float> block_buffer;     ///< 流式块混音缓冲池（大小 = 块帧数 × 声道数）
+        AudioMemoryPool<float> track_buffer;     ///< 流式单轨变调输出缓冲池
+
+        std::vector<std::unique_ptr<AudioMemoryPool<float>>> worker_buffers;   ///< 并行混音时每个工作线程独占的格式转换缓冲池
 
         /**
-            * 将整数采样转换为浮点 (-1.0 到 1.0)
+            * 将整数采样转换为浮点 (-1.0 到 1.0)，结果位于 pool 中
             */
-        void ConvertToFloat(const void* input, uint inputSize, float** output, uint* outputCount, const AudioDataInfo& info);
+        void ConvertToFloat(const void* input, uint inputSize, float** output, uint* outputCount, const AudioDataInfo& info, AudioMemoryPool<float>& pool);
 
         /**
             * 将浮点采样转换为目标格式
@@ -68,11 +131,74 @@ namespace hgl::audio
         void ConvertFromFloat(const float* input, uint sampleCount, void** output, uint* outputSize, const AudioDataInfo& outputInfo);
 
         /**
-            * 应用音调变化(libsamplerate 高质量重采样) - float版本
-            * 按帧处理，pitch>1 升调(变快/变短)，pitch<1 降调(变慢/变长)
+            * 将浮点采样转换为目标格式，写入调用方提供的缓冲区
+            */
+        void ConvertFromFloatTo(const float* input, uint sampleCount, void* output, const AudioDataInfo& outputInfo);
+
+        /**
+            * 计算混音总时长（所有轨道结束时间的最大值），同时检查轨道音源索引
+            */
+        bool ComputeMixLength(float* loopLength);
+
+        /**
+            * 流式渲染单个轨道的下一段（最多 frames 帧）
+            * @return 实际输出帧数，小于 frames 表示轨道已结束
+            */
+        uint RenderTrackBlock(TrackStream& ts, float* output, uint frames, uint channels);
+
+        /**
+            * 释放流式混音状态
+            */
+        void ReleaseStreams();
+
+        /**
+            * 重采样(libsamplerate 高质量) - float版本，采样率转换与变调共用
+            * 按帧处理，ratio = 输出帧数/输入帧数，为 1.0 时直接复制
+            */
+        void ApplyResample(const float* input, uint inputFrameCount, uint channels,
+                           std::vector<float>& output, uint* outputFrameCount, double ratio);
+
+        /**
+            * 计算音源渲染到目标采样率的合并重采样比率 = dst_rate/src_rate/pitch
+            * pitch>1 升调(变快/变短)，pitch<1 降调(变慢/变长)；采样率相同且原始音调时恰为 1.0
+            */
+        static double GetRenderRatio(uint src_rate, uint dst_rate, float pitch);
+
+        /**
+            * 规整音调值：越界回退为原始音调，接近 1.0 视为原始音调（保证缓存键稳定）
+            */
+        static float NormalizePitch(float pitch);
+
+        static RenditionKey MakeRenditionKey(uint source_index, uint sample_rate, float pitch);
+
+        /**
+            * 取得 (source_index,sample_rate,pitch) 的演绎数据，未命中时转换+重采样并存入缓存
+            * @return 演绎数据，source_index 越界返回 nullptr
+            */
+        const Rendition* GetRendition(uint source_index, uint sample_rate, float pitch);
+
+        /**
+            * 生成演绎数据：音源转 float（使用 scratch 作为转换缓冲）后一次重采样到 sample_rate 并变调，写入 r
+            * 只读访问音源列表，不同 r 之间可并行调用
+            */
+        void BuildRendition(uint source_index, uint sample_rate, float pitch, AudioMemoryPool<float>& scratch, Rendition& r);
+
+        /**
+            * 计算本次 Mix() 实际使用的线程数（不超过 jobs）
+            */
+        uint GetWorkerCount(uint jobs) const;
+
+        /**
+            * 为全部轨道准备演绎数据并填写 track_renditions
+            * 缓存未命中的 (source,pitch) 先串行占位，再按 config.thread_count 并行生成
+            */
+        bool PrepareRenditions();
+
+        /**
+            * 将所有轨道按 tracks 顺序累加到 mixBuffer 的 [beginSample,endSample) 区间
+            * 各区间互不重叠，每个采样的累加顺序与串行完全相同
             */
-        void ApplyPitchShift(const float* input, uint inputFrameCount, uint channels,
-                            float** output, uint* outputFrameCount, float pitch);
+        void AccumulateTracks(float* mixBuffer, uint beginSample, uint endSample, uint outputSampleCount, uint channels, uint sampleRate);
 
         /**
             * 软削波函数 - 使用tanh提供平滑的削波效果
@@ -89,21 +215,13 @@ namespace hgl::audio
             */
         static void ApplySoftClipping(float* buffer, uint count);
 
-        /**
-            * 生成TPDF抖动噪声 (Triangular Probability Density Function)
-            * TPDF抖动是音频处理中最常用的抖动类型，提供平滑自然的量化噪声掩蔽
-            * 使用 Mersenne Twister 高质量随机源（替代低质量 C rand()）
-            * @return 范围在[-1.0, 1.0]的随机噪声值
-            */
-        static float GenerateTPDFDither();
-
     public:
 
         AudioMixer();
         virtual ~AudioMixer();
 
         /**
-         * 添加音源数据
+         * 添加音源数据（声道数须与首个音源一致，采样率与位深不限）
          * @param info 音频数据信息（声道数、位深、是否浮点、采样率、数据大小）
          * @param data 音频数据指针
          * @return 音源索引，失败返回 -1
@@ -121,10 +239,32 @@ namespace hgl::audio
         int AddSourceAudio(const void *data,uint size,uint format,uint sample_rate);
 
         /**
-            * 清除所有音源
+            * 清除所有音源（同时清空演绎缓存）
             */
         void ClearSources();
 
+        /**
+            * 清空演绎缓存（音源数据被外部改写后需调用）
+            */
+        void ClearRenditionCache() { ReleaseStreams(); renditions.clear(); }
+
+        /**
+            * 获取演绎缓存条目数
+            */
+        int GetRenditionCount() const { return (int)renditions.size(); }
+
+        /**
+            * 渲染单个音源在指定音调下、混音采样率(GetMixSampleRate)的 float 数据（不进入演绎缓存）
+            * 用于音调随机、几乎不会重复的场合（如 AudioMixerScene 的随机实例），
+            * 只复用缓存中的原始 float 转换结果，采样率转换+变调一次完成，结果写入调用方的 vector
+            * @param source_index 音源索引
+            * @param pitch 音调(0.5-2.0)
+            * @param output 输出交错 float 采样（容量可跨调用复用）
+            * @param frame_count 输出帧数
+            * @return 是否成功
+            */
+        bool RenderSource(uint source_index, float pitch, std::vector<float>& output, uint* frame_count);
+
         /**
             * 获取音源数量
             */
@@ -167,7 +307,7 @@ namespace hgl::audio
 
         /**
          * 设置输出格式
-         * @param info 输出格式信息（声道数、位深、是否浮点）
+         * @param info 输出格式信息（声道数、位深、是否浮点；sample_rate 为 0 时沿用首个音源的采样率）
          * @return 是否成功
          */
         bool SetOutputFormat(const AudioDataInfo &info) { output_format=info; return true; }
@@ -191,6 +331,11 @@ namespace hgl::audio
          */
         const AudioDataInfo &GetOutputFormat() const { return output_format; }
 
+        /**
+         * 获取混音采样率（输出格式指定的采样率，未指定时为首个音源的采样率）
+         */
+        uint GetMixSampleRate() const { return output_format.sample_rate ? output_format.sample_rate : common_info.sample_rate; }
+
         /**
          * 取得参数化均衡器（可直接 AddBand/SetBand 配置频段，Mix() 输出前应用）
          */
@@ -211,8 +356,36 @@ namespace hgl::audio
             */
         bool Mix(void** outputData, uint* outputSize, float loopLength = 0.0f);
 
+    public: //流式混音
+
+        /**
+            * 开始流式混音：为每个轨道建立流式变调状态，之后用 MixBlock() 逐块取数据
+            * 内存占用只与块大小相关（另加原始音调的音源 float 缓存），首块即可开始播放/上传
+            * 注意：峰值归一化需要全部数据，流式模式下不执行（可开启 use_soft_clipper，否则转换时硬削波）
+            * @param loopLength 混音总长度(秒), 如果为0则自动计算
+            * @return 是否成功
+            */
+        bool BeginMix(float loopLength = 0.0f);
+
+        /**
+            * 渲染下一块到调用方缓冲区（格式为 GetOutputFormat()）
+            * @param dst 输出缓冲区，至少 frames × 声道数 × 位深/8 字节
+            * @param frames 请求帧数
+            * @return 实际写入帧数，为 0 表示混音已结束（最后一块可能不足 frames）
+            */
+        uint MixBlock(void* dst, uint frames);
+
+        /**
+            * 结束流式混音，释放各轨道流式状态
+            */
+        void EndMix() { ReleaseStreams(); }
+
+        bool IsMixing() const { return streaming; }                      ///< 是否处于流式混音中
+        uint GetMixFrameCount() const { return stream_frame_count; }     ///< 流式混音总帧数
+        uint GetMixPosition() const { return stream_position; }          ///< 流式混音已输出帧数
+
         /**
-            * 获取输出音频信息
+            * 获取统一音频信息（首个音源的格式，混音采样率见 GetMixSampleRate()）
             */
         const AudioDataInfo& GetOutputInfo() const { return common_info; }
     };
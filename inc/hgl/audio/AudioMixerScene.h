@@ -6,6 +6,7 @@
 #include<hgl/type/UnorderedMap.h>
 #include<hgl/log/Log.h>
 #include<random>
+#include<vector>
 
 namespace hgl::audio
 {
@@ -23,15 +24,18 @@ namespace hgl::audio
         UnorderedMap<OSString,AudioMixerSourceConfig> sources;    ///< 音频源字典
         MixerConfig global_config;               ///< 全局混音配置
 
-        AudioDataInfo source_format;             ///< 所有音源的统一格式(首个添加的音源决定)
+        AudioDataInfo source_format;             ///< 首个添加的音源格式(声道数为统一标准，采样率/位深可不同)
         AudioDataInfo output_format;             ///< 输出音频格式
 
         std::random_device random_device;
         std::mt19937 rng;
 
         // 内存池 - 避免频繁分配/释放
-        AudioMemoryPool<char> pool_buffer;       ///< 输出场景缓冲池
-        AudioMemoryPool<char> temp_buffer;       ///< 临时实例混音缓冲池
+        AudioMemoryPool<char> pool_buffer;       ///< 场景 float 累加缓冲池
+        AudioMemoryPool<char> temp_buffer;       ///< 输出格式转换缓冲池
+
+        AudioMixer renderer;                     ///< 实例渲染器（复用音源 float 转换与变调）
+        std::vector<float> instance_buffer;      ///< 单个实例的渲染缓冲（仅覆盖实例自身时长）
 
         /**
             * 生成随机浮点数
@@ -43,12 +47,13 @@ namespace hgl::audio
             */
         uint RandomUInt(uint min, uint max);
 
-        bool HasAnyEffects() const;
         AudioFilterConfig BuildRandomFilterConfig(const AudioMixerSourceConfig& config);
         void ApplyLowpass(float* samples, uint count, uint channels, float alpha);
         void ApplyHighpass(float* samples, uint count, uint channels, float alpha);
         void ApplyFilter(float* samples, uint count, uint channels, const AudioFilterConfig& config);
         void ApplySimpleReverb(float* samples, uint count, uint channels, uint sample_rate, const AudioMixerSourceConfig::SimpleReverbConfig& config);
+        uint GetReverbTailFrames(uint sample_rate, const AudioMixerSourceConfig::SimpleReverbConfig& config);
+        void ApplyGlobalConfig(float* samples, uint count);
         bool ConvertFloatToOutput(const float* input, uint sampleCount, void** outputData, uint* outputSize);
 
     public:
@@ -57,7 +62,7 @@ namespace hgl::audio
         virtual ~AudioMixerScene();
 
         /**
-            * 添加音频源
+            * 添加音频源（声道数须一致，采样率可与输出不同，渲染实例时一并转换）
             * @param name 音频源名称(如"小轿车"、"SUV"、"喇叭"等)
             * @param config 音频源配置
             */
@@ -49,6 +49,7 @@ namespace hgl::audio
         float master_volume;     ///< 主音量(0.0-1.0)
         bool use_soft_clipper;    ///< 是否使用软削波器（Soft Clipper）处理越界的float32数据
         bool use_dither;         ///< 是否在float32→int16转换时使用抖动（Dither）减少量化噪声
+        uint thread_count;       ///< Mix() 并行线程数：1=串行，0=按 CPU 核心数；结果与串行逐位一致
 
         MixerConfig()
         {
@@ -56,6 +57,7 @@ namespace hgl::audio
             master_volume = 1.0f;
             use_soft_clipper = false;  // 默认关闭，使用硬削波
             use_dither = false;       // 默认关闭抖动
+            thread_count = 1;         // 默认串行
         }
     };
 
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+
+namespace hgl::audio
+{
+    constexpr uint   AUDIO_PARALLEL_DECODE_MAX_SEGMENTS     =8;     ///< 自动模式下的最大分段数
+    constexpr double AUDIO_PARALLEL_DECODE_MIN_SECONDS      =30.0;  ///< 默认：时长达到此值的文件才分段并行解码
+    constexpr double AUDIO_PARALLEL_DECODE_SEGMENT_SECONDS  =10.0;  ///< 每段至少的时长（抵消各段打开/定位的开销）
+    constexpr double AUDIO_PARALLEL_DECODE_OPUS_PREROLL_SECONDS=0.2;///< Opus 各段提前解码并丢弃的时长（op_pcm_seek 自带的 80ms 预滚之外）
+
+    /**
+    * 设置整段解码（AudioBuffer 加载、AudioAssetManager 全量加载）的并行分段数
+    *
+    * 较长的 Vorbis/Opus 文件按 PCM 帧位置切成若干段，每段在同一份内存上各自打开一个解码句柄、
+    * 定位到段首后由独立线程解码，直接写入最终缓冲区中该段的偏移处。
+    * Vorbis 拼接结果与顺序解码逐采样一致；Opus 各段的解码器状态由预滚重建，与顺序解码不完全相同，
+    * 第一段之后有极小的有界残差（实测约 -66dB，int16 下最大十几个 LSB）。
+    * 要求插件提供 ver=2 Open/Read/Close 与 ver=6 SeekPCM/TellPCM，否则仍按原方式顺序解码。
+    * AudioAssetManager 异步加载池的工作线程内不分段（工作线程之间已并行）。
+    * @param count 0=自动（CPU 核数，至多 AUDIO_PARALLEL_DECODE_MAX_SEGMENTS），1=关闭
+    */
+    void SetParallelDecodeSegments(uint count);
+    uint GetParallelDecodeSegments();               ///< 返回实际使用的最大分段数（自动模式已换算）
+
+    /**
+    * 设置启用并行分段解码的最短时长（秒），更短的文件顺序解码
+    */
+    void SetParallelDecodeMinSeconds(double seconds);
+    double GetParallelDecodeMinSeconds();
+}//namespace hgl::audio
@@ -6,6 +6,7 @@
 #include<hgl/audio/OpenAL.h>
 #include<hgl/audio/AudioSource.h>
 #include<hgl/audio/GainEnvelope.h>
+#include<hgl/audio/AudioStreamService.h>
 #include<hgl/math/Vector.h>
 #include<hgl/time/Time.h>
 
@@ -18,7 +19,30 @@ namespace hgl::audio
     using math::Vector3f;
 
     struct AudioPlugInInterface;
+    struct AudioFloatPlugInInterface;
+    struct AudioSeekPlugInInterface;
     class CaptureSource;                    ///< 实时捕获源（前向声明，P0）
+    class MappedFile;
+    class AudioReadAheadStream;
+    struct AudioChainStream;
+    enum class AudioLoadMode;
+
+    constexpr uint   AUDIO_PLAYER_DEFAULT_BUFFERS       =3;         ///< 默认轮转缓冲区数量
+    constexpr uint   AUDIO_PLAYER_MAX_BUFFERS           =16;        ///< 最大轮转缓冲区数量
+    constexpr double AUDIO_PLAYER_DEFAULT_BUFFER_TIME   =0.1;       ///< 默认每个缓冲区时长（秒）
+    constexpr double AUDIO_PLAYER_MIN_BUFFER_TIME       =0.005;     ///< 最短每个缓冲区时长（秒）
+
+    /**
+    * 播放器启动统计（Play/PlayFrom 调用到 alSourcePlay 完成的耗时）
+    */
+    struct AudioPlayerStartStats
+    {
+        uint    start_count;                    ///< 累计启动次数（循环重播、Seek、Resume 不计）
+        uint    preroll_count;                  ///< 其中直接使用预解码缓冲区的次数
+        double  last_latency;                   ///< 最近一次启动延迟（秒）
+        double  max_latency;                    ///< 最大启动延迟（秒）
+        double  total_latency;                  ///< 累计启动延迟（秒），除以 start_count 即平均值
+    };//struct AudioPlayerStartStats
 
     enum class PlayState        //播放器状态
     {
@@ -30,9 +54,9 @@ namespace hgl::audio
 
     /**
     * 使用AudioPlayer创建的音频播放器类，一般用于背景音乐等独占的音频处理。
-    * 这个音频播放器将使用一个单独的线程，在播放器被删除时线程也会被关闭。
+    * 共享流式服务（StartAudioStreamService）运行时由服务线程驱动；否则使用一个单独的线程，在播放器被删除时线程也会被关闭。
     */
-    class AudioPlayer:public Thread                                                                 ///音频播放器基类
+    class AudioPlayer:public Thread,public AudioStreamClient                                        ///音频播放器基类
     {
         OBJECT_LOGGER
 
@@ -42,6 +66,8 @@ namespace hgl::audio
 
         ALbyte *audio_data;
         int audio_data_size;
+        MappedFile *mapped_file;                                                                        ///<从文件加载时audio_data指向此映射（否则为nullptr，audio_data为new分配）
+        AudioReadAheadStream *input_stream;                                                             ///<流式加载的数据源（此时audio_data为nullptr）
 
         void *audio_ptr;                                                                                ///<音频数据指针
 
@@ -50,6 +76,8 @@ namespace hgl::audio
         uint audio_buffer_count;                                                                        ///<播放数据计数
 
         AudioPlugInInterface *decoder;
+        AudioFloatPlugInInterface *float_decoder;                                                       ///<浮点解码接口（设备支持AL_EXT_FLOAT32且插件支持时使用，否则为nullptr）
+        AudioSeekPlugInInterface *seeker;                                                               ///<解码定位接口（插件不支持时为nullptr）
 
         CaptureSource *capture;             ///< 实时捕获源（录音伪装解码器，P0）
         bool realtime_source;               ///< 是否实时源模式（捕获伪装）
@@ -59,19 +87,44 @@ namespace hgl::audio
 
         GainRamp gain_ramp;                                                                      ///<自动增益(增益过渡斜坡)
 
+        uint DecodeBlock(char *,uint);          ///< 从当前文件尽量解码满指定字节数，返回字节数
+        uint RenderBlock(char *);               ///< 输出一个缓冲区长度的数据（含接续与交叉淡化），返回字节数
+        void RenderCrossfade(char *,uint);      ///< 当前文件与下一文件等功率混合指定帧数
+        void ChainNext(uint);                   ///< 切换到下一文件（在当前文件结尾或淡化结束处），参数为切换点在本块中的帧位置
+        void ApplyHandoff();                    ///< 切换被听到：总时长改为新文件的，此后不再淡入
+        void ClearNext();                       ///< 丢弃下一文件
+        void InitChainBuffer();                 ///< 分配接续/淡化用的解码与混合缓冲
+        bool SetNext(AudioChainStream *,double,bool);
         bool ReadData(ALuint);
         bool UpdateBuffer();
         void ClearBuffer();
 
-        bool Playback();
+        double SeekDecoder(double);
+        bool Playback(double start_offset=0,bool paused=false);
 
         bool DeletedAfterExit()const override{return false;}
         bool ProcStartThread()override;         ///< 播放线程启动：绑定 OpenAL context（per-thread 语义）
         bool Execute() override;
 
+        bool UpdatePlayState();                 ///< 按播放状态处理一次（需持有 lock），返回 false 表示本次播放结束
+        void WaitRefill();                      ///< 自己的线程模式：等待下一次处理（缓冲区播完事件或轮询间隔）
+        void InitStreamBuffer();                ///< 按 buffer_time 分配解码缓冲并设置轮询间隔
+        bool PrerollBuffers();                  ///< 从头预解码前 buffer_count 个缓冲区（调用方保证未在播放）
+        uint UploadPreroll();                   ///< 把预解码数据上传到 al_buffers，返回个数
+        void StartService();                    ///< 加入共享流式服务，服务未运行时启动自己的线程
+
+    public: //流式服务
+
+        bool ServiceStream() override;
+        bool GetStreamTiming(PreciseTime &refill,PreciseTime &underrun) override;
+
+    protected:
+
         void InitPrivate();
         bool Load(AudioFileType);
 
+        bool HasSource()const{return audio_data||input_stream||realtime_source;}                      ///<是否已加载数据源
+
     protected:
 
         atom<bool> loop;
@@ -79,7 +132,10 @@ namespace hgl::audio
 
         AudioSource audiosource;
         ALuint source_id;
-        ALuint al_buffers[3];
+        ALuint al_buffers[AUDIO_PLAYER_MAX_BUFFERS];
+        uint buffer_count;                                                                              ///<使用的轮转缓冲区数量
+        double buffer_time;                                                                             ///<每个缓冲区时长(秒)
+        AudioRefillMode refill_mode;
         atom<double> total_time;
         PreciseTime wait_time;
 
@@ -90,14 +146,65 @@ namespace hgl::audio
         PreciseTime fade_in_time;
         PreciseTime fade_out_time;
 
+        char *preroll_data;                                                                             ///<预解码数据（buffer_count 个缓冲区长度，保存在内存中，Load 可在无 OpenAL context 的线程调用）
+        uint preroll_sizes[AUDIO_PLAYER_MAX_BUFFERS];
+        uint preroll_count;                                                                             ///<已预解码的缓冲区数，0=无（解码器位置在预解码数据之后）
+        bool preroll_on_load;
+
+        AudioPlayerStartStats start_stats;
+
+        AudioChainStream *next_stream;                                                                  ///<接续/交叉淡化的下一个文件（nullptr=无）
+        int64 decode_frame;                                                                             ///<当前文件已解码到的帧位置
+        int64 next_start_frame;                                                                         ///<当前文件解码到此帧时开始交叉淡化（-1=解码到结尾后无缝接续）
+        int64 next_decode_frame;                                                                        ///<下一文件已解码的帧数（淡化中）
+        uint fade_frames;                                                                               ///<交叉淡化帧数
+        uint fade_pos;                                                                                  ///<已淡化帧数
+        bool fading;
+        char *next_block;                                                                               ///<下一文件的解码缓冲（audio_buffer_size）
+        float *mix_buffer;                                                                              ///<整数格式淡化时两段的 float 缓冲
+        uint transition_count;
+
+        int64 render_block;                                                                             ///<本轮播放已输出的缓冲区数（SeekDecoder 时清零，预解码的缓冲区也计入）
+        int64 played_block;                                                                             ///<本轮播放已播完的缓冲区数（Playback 时清零）
+        int64 handoff_block;                                                                            ///<含切换点的缓冲区序号（-1=无待生效的切换）
+        int64 handoff_base;                                                                             ///<该缓冲区起点对应的新文件字节位置（切换点在块内时为负）
+        double handoff_total_time;                                                                      ///<新文件总时长，切换被听到时才生效
+        bool chained;                                                                                   ///<当前播放的是接续得到的文件（不再淡入）
+
     public: //属性
 
                             uint        GetIndex()const{return audiosource.GetIndex();}                      ///<获取音源索引
 
                             double      GetTotalTime()const{return total_time.load();}                         ///<获取音频总时长
 
+                            bool        CanSeek()const{return seeker!=nullptr;}                           ///<解码插件是否支持定位
+
                             PlayState   GetPlayState()const{return play_state.load();}                                 ///<获取播放器状态
 
+                            uint        GetStreamBufferCount()const{return buffer_count;}               ///<获取轮转缓冲区数量
+                            double      GetStreamBufferTime()const{return buffer_time;}                 ///<获取每个缓冲区时长(秒)
+
+                            /**
+                            * 设置轮转缓冲区数量与每个缓冲区时长（未播放时有效，已加载时立即重新分配）
+                            * 默认 3×0.1 秒；语音、录音监听等低延迟流可用 4×0.01 秒配合 AudioRefillMode::Event
+                            */
+                            bool        SetStreamBuffers(uint count,double seconds);
+
+                            AudioRefillMode GetRefillMode()const{return refill_mode;}                   ///<获取补充缓冲区的方式
+                            void        SetRefillMode(AudioRefillMode);                                 ///<设置补充缓冲区的方式（默认 Event）
+                            bool        IsEventRefill()const{return IsSourceEventsRegistered();}        ///<是否实际使用事件驱动（设备支持 AL_SOFT_events）
+
+                            /**
+                            * 加载后是否自动预解码开头的缓冲区（默认 false）
+                            * 预解码后从头 Play() 只需上传、排队、开始播放，解码不在启动路径上
+                            */
+                            void        SetPrerollOnLoad(bool p){preroll_on_load=p;}
+                            bool        IsPrerollOnLoad()const{return preroll_on_load;}
+                            bool        IsPrerolled()const{return preroll_count>0;}                     ///<是否有可直接使用的预解码缓冲区
+
+                            AudioPlayerStartStats GetStartStats();                                      ///<取得启动延迟统计
+                            void        ResetStartStats();                                              ///<清零启动延迟统计
+
                             int         GetSourceState()const{return audiosource.GetState();}           ///<获取音源索引
 
                             bool        IsLoop();                                                       ///<是否循环播放
@@ -139,6 +246,29 @@ namespace hgl::audio
         void        SetBus(AudioBus *b){audiosource.SetBus(b);}          ///< 挂载/切换总线
         AudioBus *  GetBus()const{return audiosource.GetBus();}          ///< 取得所属总线
 
+    public: //接续与交叉淡化
+
+        /**
+        * 排队下一个文件：当前文件解码到最后一个采样后，在同一组缓冲区中紧接着输出下一个文件（无缝接续）
+        * crossfade>0 时改为在当前文件结束前 crossfade 秒开始等功率交叉淡化（当前文件时长未知时按无缝接续）
+        * 两个文件须采样率、声道数相同，否则返回 false（此时应改用另一个播放器）
+        * 接续后下一个文件成为当前文件，SetLoop 的循环作用于它；尚未开始淡化的排队可被再次调用替换
+        * @param filename 文件名（在调用线程中打开并映射）
+        * @param crossfade 交叉淡化时长（秒）
+        */
+        bool QueueNext(const os_char *filename,double crossfade=0,AudioFileType aft=AudioFileType::None);
+
+        /**
+        * 从当前解码位置开始等功率交叉淡化到另一个文件，两个解码流在同一个音源的缓冲区中逐采样混合
+        * 已排队的缓冲区仍按原样播放，因此淡化实际在约 buffer_count×buffer_time 之后被听到
+        * 淡化进行中返回 false；PlayFrom/Seek 会取消进行中的淡化
+        */
+        bool CrossfadeTo(const os_char *filename,double seconds,AudioFileType aft=AudioFileType::None);
+
+        bool HasNext();                                                                             ///<是否有排队中/淡化中的下一文件
+        void CancelNext();                                                                          ///<取消尚未完成的接续/淡化
+        uint GetTransitionCount()const{return transition_count;}                                   ///<已完成的接续/淡化次数
+
     public: //方法
 
         AudioPlayer();
@@ -149,6 +279,16 @@ namespace hgl::audio
 
         virtual bool Load(io::InputStream *,int,AudioFileType);                                     ///<从流中加载一个音频文件
         virtual bool Load(const os_char *,AudioFileType=AudioFileType::None);                       ///<加载一个音频文件
+        virtual bool Load(const os_char *,AudioFileType,AudioLoadMode);                             ///<按加载模式加载一个音频文件（Stream=边读边解码）
+
+        /**
+        * 流式加载：解码插件通过回调从流中按 64KB 预读块增量读取压缩数据，不把整个文件读入内存
+        * 需要解码插件支持 ver=7 流式打开接口（Vorbis/Opus）
+        * @param stream 数据流，Clear()/重新加载前必须保持有效；不可定位的流无法 Seek/循环
+        * @param aft 音频文件类型
+        * @param owned 是否由播放器负责删除 stream（失败时同样删除）
+        */
+        virtual bool LoadStream(io::InputStream *stream,AudioFileType aft,bool owned=false);        ///<流式加载（边读边解码）
 
         /**
         * 实时源模式（P0）：把录音捕获伪装成解码器，复用三缓冲流式播放管线
@@ -160,7 +300,15 @@ namespace hgl::audio
         virtual bool LoadCapture(uint sample_rate=16000,uint frame_ms=20,bool use_mock=false);         ///<实时源模式：录音捕获伪装成解码器（P0）
 //      virtual bool Load(HAC *,const os_char *,AudioFileType=AudioFileType::None);                 ///<从HAC包中加载一个音频文件
 
+        /**
+        * 立即从头预解码前几个缓冲区，供下一次从头 Play() 使用（播放/暂停中、实时源返回 false）
+        * 任何从非开头位置的播放、Seek、循环重播都会使预解码失效；播放结束或 Stop() 后可再次调用
+        */
+        virtual bool Preroll();
+
         virtual void Play(bool=true);                                                               ///<播放音频
+        virtual void PlayFrom(double,bool=true);                                                    ///<从指定时间(秒)开始播放音频
+        virtual bool Seek(double);                                                                  ///<跳转到指定时间(秒)，仅播放/暂停中有效
         virtual void Stop();                                                                        ///<停止播放
         virtual void Pause();                                                                       ///<暂停播放
         virtual void Resume();                                                                      ///<继续播放
@@ -0,0 +1,21 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+
+namespace hgl::audio
+{
+    /**
+    * 启用音频插件能力清单（扩展名→插件名映射的持久化缓存）
+    *
+    * 按扩展名选择解码插件时需要知道各插件上报的 FileExtensions，未启用清单时首次查询会加载（dlopen）全部音频插件探测一遍，
+    * 其中 FluidSynth/Timidity/ADLMIDI/OPNMIDI/WildMIDI 等 MIDI 合成器依赖的库很大。
+    * 启用清单后探测结果连同插件文件的大小/修改时间写入清单文件，之后的运行中插件文件未变化时直接由清单建立映射，
+    * 不加载任何插件，插件在首次真正使用时才加载；插件被删除时只移除对应记录，有新增或改动时重新探测并重写清单。
+    *
+    * 须在首次按扩展名查询插件（首次加载音频）之前调用。
+    * @param manifest_filename 清单文件名（不存在时在首次查询后创建；写入为临时文件 + 原子改名）
+    * @param plugin_path 插件目录（nullptr 表示当前目录下的 Plug-Ins），用于比对插件文件是否变化
+    * @return 是否设置成功（映射已建立后返回 false）
+    */
+    bool SetAudioPlugInManifest(const os_char *manifest_filename,const os_char *plugin_path=nullptr);
+}//namespace hgl::audio
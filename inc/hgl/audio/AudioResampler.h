@@ -2,6 +2,10 @@
 
 #include<hgl/CoreType.h>
 #include<hgl/audio/AudioMixerTypes.h>
+#include<hgl/audio/AudioMemoryPool.h>
+#include<cstdint>
+
+struct SRC_STATE_tag;                           ///< libsamplerate streaming state (forward declared, keeps samplerate.h out of the header)
 
 namespace hgl::audio
 {
@@ -15,9 +19,15 @@ namespace hgl::audio
 
     /**
      * Resample raw interleaved audio data to a new sample rate and/or format.
-     * - Uses libsamplerate for resampling.
-     * - Supports mono, stereo, quad, 5.1, 6.1 and 7.1 layouts (8/16/32-bit
-     *   integer and float32 samples).
+     * - Equal input/output sample rates skip filtering: the data is copied,
+     *   or only converted when the output sample format differs.
+     * - Sinc qualities with a small rational ratio L/M (both <= 640, e.g.
+     *   44100<->48000, 22050->16000) run on cached polyphase FIR filter
+     *   banks (see PolyphaseResampler.h); everything else, and Linear, uses
+     *   libsamplerate.
+     * - Supports mono, stereo, quad, 5.1, 6.1 and 7.1 layouts (8/16/24/32-bit
+     *   integer and float32 samples; 24-bit is packed 3-byte little endian).
+     *   Sample format conversion goes through the shared SampleConvert kernels.
      * - Input and output channel counts must match (resampling does not
      *   remap channel layouts).
      * - If outputInfo.sample_rate is 0, the input sample rate is preserved;
@@ -44,4 +54,100 @@ namespace hgl::audio
                       ResampleQuality quality,
                       void** outputData,
                       uint* outputSize);
-}
+
+    /**
+     * Streaming resampler keeping a persistent libsamplerate state.
+     * - Wraps src_new/src_process/src_reset; filter history is carried across
+     *   calls, so feeding audio in small chunks (capture, network packets)
+     *   produces no edge artifacts at chunk boundaries.
+     * - Input and output are caller-provided interleaved buffers, measured in
+     *   frames. A call may consume less input than offered when the output
+     *   is full; the caller resubmits the remainder (see input_used).
+     * - The ratio (output rate / input rate) may change between calls:
+     *   SetRatio() ramps smoothly over the next call, SetRatio(r,true) steps.
+     * - int16/float and other SampleConvert formats are accepted through the
+     *   shared conversion kernels; conversion scratch is pooled, so once the
+     *   chunk size is stable Process() performs no heap allocation.
+     */
+    class StreamResampler
+    {
+        SRC_STATE_tag *state;
+        uint channels;
+        ResampleQuality quality;
+        double ratio;
+        double last_ratio;                      ///< ratio of the previous call (libsamplerate ramps from it)
+
+        AudioMemoryPool<float> input_buffer;    ///< input converted to float
+        AudioMemoryPool<float> output_buffer;   ///< float output before conversion
+
+    public:
+
+        StreamResampler();
+        ~StreamResampler();
+
+        StreamResampler(const StreamResampler &)=delete;
+        StreamResampler &operator=(const StreamResampler &)=delete;
+
+        /**
+         * Create the libsamplerate state (an existing state is closed first).
+         * @param channels  interleaved channel count
+         * @param ratio     output rate / input rate
+         */
+        bool Init(uint channels,double ratio,ResampleQuality quality=ResampleQuality::SincMedium);
+        bool Init(uint channels,uint input_rate,uint output_rate,ResampleQuality quality=ResampleQuality::SincMedium);
+
+        void Close();
+        bool IsOpen()const{return state!=nullptr;}
+
+        /**
+         * Clear filter history (e.g. after a seek or stream discontinuity).
+         */
+        bool Reset();
+
+        /**
+         * Change the ratio for the following Process() calls.
+         * @param step false: libsamplerate ramps from the old ratio across the next call; true: switch immediately
+         */
+        bool SetRatio(double new_ratio,bool step=false);
+        bool SetRates(uint input_rate,uint output_rate,bool step=false);
+
+        double GetRatio()const{return ratio;}
+        uint GetChannels()const{return channels;}
+        ResampleQuality GetQuality()const{return quality;}
+
+        /**
+         * Output frames needed to hold everything generated from input_frames at the current ratio.
+         */
+        uint GetMaxOutputFrames(uint input_frames)const;
+
+        /**
+         * Resample interleaved float frames.
+         * @param input             input frames (may be nullptr when input_frames is 0, e.g. to drain)
+         * @param output            output buffer, output_frames frames
+         * @param input_used        [out] input frames consumed
+         * @param output_generated  [out] output frames written
+         * @param end_of_input      true on the last call; keep calling with no input until nothing is generated to drain the tail
+         */
+        bool Process(const float *input,uint input_frames,
+                     float *output,uint output_frames,
+                     uint *input_used,uint *output_generated,
+                     bool end_of_input=false);
+
+        /**
+         * Resample interleaved int16 frames (converted through the shared kernels).
+         */
+        bool Process(const int16_t *input,uint input_frames,
+                     int16_t *output,uint output_frames,
+                     uint *input_used,uint *output_generated,
+                     bool end_of_input=false);
+
+        /**
+         * Resample between any SampleConvert formats; only bits_per_sample/is_float of the infos are used,
+         * channel counts must equal GetChannels().
+         */
+        bool Process(const void *input,const AudioDataInfo &input_info,uint input_frames,
+                     void *output,const AudioDataInfo &output_info,uint output_frames,
+                     uint *input_used,uint *output_generated,
+                     bool end_of_input=false);
+    };//class StreamResampler
+}//namespace hgl::audio
@@ -0,0 +1,119 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+#include<hgl/thread/Atomic.h>
+#include<hgl/time/Time.h>
+#include<mutex>
+#include<condition_variable>
+
+namespace hgl::audio
+{
+    constexpr uint   AUDIO_STREAM_SERVICE_MAX_WORKERS   =4;         ///< 自动模式下的最大服务线程数
+    constexpr double AUDIO_STREAM_SERVICE_MAX_SLEEP     =0.005;     ///< 服务线程最长休眠（秒），新加入/被唤醒的播放器最迟在此时间内得到处理
+
+    class AudioStreamService;
+
+    /**
+    * 流式播放器补充缓冲区的时机
+    */
+    enum class AudioRefillMode
+    {
+        Polling=0,          ///< 按固定间隔休眠，醒来后查询 AL_BUFFERS_PROCESSED
+        Event,              ///< 等待缓冲区播完事件（AL_SOFT_events），设备不支持时自动回退到 Polling
+    };
+
+    /**
+    * 可由共享流式服务驱动的流式播放器（AudioPlayer、MIDIPlayer）
+    *
+    * 服务运行中时，播放器 Play/Resume 不再启动自己的线程，而是加入服务，由服务线程调用 ServiceStream() 补充缓冲；
+    * 服务未运行时仍使用播放器自己的线程（原行为）。
+    */
+    class AudioStreamClient
+    {
+        friend class AudioStreamService;
+
+        AudioStreamService *stream_service;                 ///< 最近一次加入的服务
+
+        std::mutex event_mutex;
+        std::condition_variable event_cond;
+        bool event_signaled;                                ///< 自己线程模式下的唤醒标记
+        uint event_source;                                  ///< 已注册事件的音源（0=未注册）
+
+        void OnStreamEvent();                               ///< 音源事件到达（OpenAL 事件线程中调用）
+
+        friend void OnAudioSourceEvent(uint source);
+
+        atom<bool> stream_registered;                       ///< 是否在服务的播放器列表中（只由服务在其锁内置位/清除）
+
+    protected:
+
+        bool AttachStreamService();                         ///< 加入服务（已加入则唤醒），服务未运行返回 false
+        void WakeStreamService();                           ///< 请求服务线程尽快处理一次（暂停/停止等状态变化）
+        void DetachStreamService();                         ///< 仍在服务中时等待服务线程处理完退出状态并移除，返回后服务不再访问本对象（Stop 与析构须调用）
+
+        /**
+        * 注册音源的缓冲区播完/状态变化事件：事件到达时唤醒服务（已加入时）或自己的线程（WaitStreamEvent）
+        * @return 设备是否支持事件（AL_SOFT_events），不支持时不注册
+        */
+        bool RegisterSourceEvents(uint source);
+        void UnregisterSourceEvents();                      ///< 返回后事件回调不再访问本对象
+        bool IsSourceEventsRegistered()const{return event_source!=0;}
+
+        void WaitStreamEvent(PreciseTime timeout);          ///< 自己线程模式：等待事件或超时
+        void SignalStreamEvent();                           ///< 唤醒 WaitStreamEvent
+
+    public:
+
+        AudioStreamClient(){stream_service=nullptr;stream_registered=false;event_signaled=false;event_source=0;}
+        virtual ~AudioStreamClient(){UnregisterSourceEvents();}
+
+        bool IsStreamAttached()const{return stream_registered.load();}
+
+        /**
+        * 执行一次流式处理（补充已播完的缓冲区、处理暂停/退出），由服务线程调用
+        * @return 是否继续服务；返回 false 后（期间没有重新 Play/Resume 时）服务将其移除，不再访问本对象
+        */
+        virtual bool ServiceStream()=0;
+
+        /**
+        * 取得调度时间，由服务线程在 ServiceStream() 之后调用
+        * @param refill 距离下一次需要处理（有缓冲区播完）的时间（秒）
+        * @param underrun 距离已排队数据全部播完（断流）的时间（秒）
+        * @return 是否正在播放（否则 underrun 无意义）
+        */
+        virtual bool GetStreamTiming(PreciseTime &refill,PreciseTime &underrun)=0;
+
+        virtual void Stop()=0;                              ///< 停止播放（StopAudioStreamService 使用）
+    };//class AudioStreamClient
+
+    /**
+    * 流式服务统计
+    */
+    struct AudioStreamServiceStats
+    {
+        uint    worker_count;                   ///< 服务线程数（0=未运行）
+        uint    voice_count;                    ///< 当前由服务驱动的播放器数
+        uint64  service_count;                  ///< 累计处理次数
+        uint64  late_count;                     ///< 处理时已超过预计断流时间的次数（服务线程不足或缓冲过小）
+    };//struct AudioStreamServiceStats
+
+    /**
+    * 启动共享流式服务
+    *
+    * 以少量固定的服务线程代替每个播放器一个线程：每个服务线程只绑定一次 OpenAL context，
+    * 每次从全部播放器中挑选距离断流最近、且已有缓冲区播完的一个处理，已播完的缓冲区一次解除、补充后一次重新排队。
+    * 启动后新 Play/Resume 的 AudioPlayer、MIDIPlayer 加入服务；此前已在自己线程中播放的不受影响。
+    * @param worker_count 服务线程数，0=自动（CPU 核数的一半，1 到 AUDIO_STREAM_SERVICE_MAX_WORKERS）
+    * @return 是否启动成功（已在运行返回 false）
+    */
+    bool StartAudioStreamService(uint worker_count=0);
+
+    /**
+    * 停止共享流式服务：停止所有由服务驱动的播放器（同 Stop()）后结束服务线程
+    * 调用期间不要在其它线程删除这些播放器
+    */
+    void StopAudioStreamService();
+
+    bool IsAudioStreamServiceRunning();
+    AudioStreamServiceStats GetAudioStreamServiceStats();
+}//namespace hgl::audio
@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include<hgl/audio/AudioSource.h>
+#include<hgl/audio/AudioMemoryPool.h>
+#include<hgl/audio/OpenAL.h>
+#include<vector>
+
+namespace hgl::audio
+{
+    class AudioAssetManager;
+    struct AudioCompressedData;
+    struct AudioPlugInInterface;
+
+    constexpr uint AUDIO_STREAM_VOICE_BUFFERS=3;            ///< 每个音源轮转使用的 OpenAL 缓冲区数量
+
+    /**
+    * 压缩常驻音频的流式音源池（AudioLoadMode::Compressed 的播放端）
+    *
+    * - 压缩数据由 AudioAssetManager::AcquireCompressed 常驻内存，播放期间本池持有其引用
+    * - 每个音源预先创建固定数量的 OpenAL 缓冲区，播放时按需解码轮转填充，播放结束后音源与缓冲区留给下一次播放复用
+    * - 不为每个音源开线程：由调用方（主线程/引擎线程）每帧调用 Update() 统一补充缓冲，所有音源共用一块解码缓冲
+    * - 非线程安全，须在持有 OpenAL context 的同一线程中使用
+    */
+    class AudioStreamVoicePool
+    {
+        struct Voice
+        {
+            AudioSource source;
+            openal::ALuint buffers[AUDIO_STREAM_VOICE_BUFFERS];
+
+            AudioCompressedData *data;                      ///< 正在播放的压缩数据（nullptr=空闲）
+            AudioPlugInInterface *decoder;
+            void *stream;                                   ///< 解码流句柄
+
+            openal::ALenum format;
+            openal::ALsizei rate;
+            uint chunk_size;                                ///< 每个缓冲区的解码字节数（整帧对齐）
+
+            bool loop;
+            bool ended;                                     ///< 已解码到结尾，等待已排队缓冲播完
+
+            Voice();
+            ~Voice();
+        };//struct Voice
+
+        AudioAssetManager *manager;
+        std::vector<Voice *> voices;
+
+        AudioMemoryPool<char> decode_buffer;                ///< 全部音源共用的解码缓冲（Update 中串行解码）
+        double buffer_time;                                 ///< 每个缓冲区的时长（秒）
+
+        AudioBus *bus;
+
+        bool Fill(Voice *,openal::ALuint);
+        void Finish(Voice *);
+
+    public:
+
+        /**
+        * @param am 资源管理器（提供压缩常驻数据）
+        * @param voice_count 音源数量（同时播放上限）
+        * @param buffer_seconds 每个缓冲区的时长（秒），三缓冲轮转，默认 0.1
+        */
+        AudioStreamVoicePool(AudioAssetManager *am,uint voice_count=8,double buffer_seconds=0.1);
+        ~AudioStreamVoicePool();
+
+        /**
+        * 播放一个文件：从资源管理器取得（或读入）压缩数据，占用一个空闲音源边解码边播放
+        * @param filename 音频文件名
+        * @param gain 音量
+        * @param loop 是否循环
+        * @return 音源编号，无空闲音源或打开失败返回 -1
+        */
+        int  Play(const os_char *filename,float gain=1,bool loop=false);
+
+        void Stop(int voice);                               ///< 停止指定音源并释放其压缩数据引用
+        void StopAll();
+
+        bool IsPlaying(int voice)const;                     ///< 音源是否正在使用（含已解码完、尾部缓冲未播完）
+        AudioSource *GetSource(int voice);                  ///< 取得音源（设置 3D 位置等），编号无效返回 nullptr
+
+        /**
+        * 每帧调用：为各音源补充已播完的缓冲区，回收播放结束的音源
+        * @return 仍在播放的音源数量
+        */
+        int  Update();
+
+        uint GetVoiceCount()const{return (uint)voices.size();}
+        uint GetActiveCount()const;
+
+        void SetBus(AudioBus *b);                           ///< 将池中所有音源挂载到指定总线
+    };//class AudioStreamVoicePool
+}//namespace hgl::audio
@@ -6,6 +6,7 @@
 #include<hgl/audio/OpenAL.h>
 #include<hgl/audio/AudioSource.h>
 #include<hgl/audio/GainEnvelope.h>
+#include<hgl/audio/AudioStreamService.h>
 #include<hgl/math/Vector.h>
 #include<hgl/time/Time.h>
 #include"AudioDecode.h"
@@ -41,7 +42,7 @@ namespace hgl::audio
     * - 音色库/音色选择
     * - 多通道分离解码
     * - 通道信息查询
-    * - 独立的播放线程
+    * - 独立的播放线程（共享流式服务运行时由服务线程驱动）
     * 
     * 使用场景：
     * - 音乐制作和混音
@@ -50,7 +51,7 @@ namespace hgl::audio
     * - 游戏背景音乐（动态混音）
     * - MIDI文件多轨导出
     */
-    class MIDIPlayer:public Thread                                                                  ///专业MIDI播放器类
+    class MIDIPlayer:public Thread,public AudioStreamClient                                         ///专业MIDI播放器类
     {
         OBJECT_LOGGER
 
@@ -93,6 +94,16 @@ namespace hgl::audio
         bool DeletedAfterExit()const override{return false;}    
         bool Execute() override;
 
+        bool UpdatePlayState();                                 ///< 按播放状态处理一次（需持有 lock），返回 false 表示本次播放结束
+        void StartService();                                    ///< 加入共享流式服务，服务未运行时启动自己的线程
+
+    public: //流式服务
+
+        bool ServiceStream() override;
+        bool GetStreamTiming(PreciseTime &refill,PreciseTime &underrun) override;
+
+    protected:
+
         void InitPrivate();
         bool LoadMIDI(const os_char *filename);
         bool LoadMIDI(io::InputStream *stream,int size);
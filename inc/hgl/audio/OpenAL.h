@@ -87,6 +87,7 @@ namespace openal
     int GetChannelCount(ALenum);                                                                    ///<获取音频格式的通道数
 
     bool IsSupportFloatAudioData();                                                                 ///<是否支持浮点音频数据
+    bool IsSupportSourceEvents();                                                                   ///<是否支持音源事件回调(AL_SOFT_events，缓冲区播完通知)
 
     // #define AL_INVERSE_DISTANCE                      0xD001  //倒数距离
     // #define AL_INVERSE_DISTANCE_CLAMPED              0xD002  //钳位倒数距离
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+#include<hgl/audio/AudioResampler.h>
+#include<memory>
+#include<vector>
+
+namespace hgl::audio
+{
+    /**
+    * 多相滤波器组（定比率 L/M 重采样用）
+    *
+    * 原型低通为 Kaiser 窗 sinc，长度 L×taps，按相位拆成 L 组、每组 taps 个系数（反序存放，便于与输入做连续点积）。
+    * taps 补齐到 8 的倍数（补 0），SIMD 内核无需尾部处理。
+    * 同一 (L,M,quality) 的滤波器组全进程共享，由 AcquirePolyphaseFilterBank() 创建并缓存，创建后只读。
+    * 缓存最多保留 POLYPHASE_CACHE_CAPACITY 组，超出时淘汰最久未使用的一组（仍被持有的滤波器组不受影响）。
+    */
+    struct PolyphaseFilterBank
+    {
+        uint up;                                ///< L：插值倍数（= 相位数）
+        uint down;                              ///< M：抽取倍数
+        ResampleQuality quality;
+        uint taps;                              ///< 每相位系数个数（已补齐到 8 的倍数）
+        uint center;                            ///< 原型滤波器中心位置（上采样域）
+        std::vector<float> coefficients;        ///< [相位][taps]
+
+        const float *GetPhase(uint phase)const{return coefficients.data()+(size_t)phase*taps;}
+    };//struct PolyphaseFilterBank
+
+    constexpr uint POLYPHASE_MAX_UP             =640;       ///< 支持的最大 L（11025/22050 → 48000/96000 为 640/147）
+    constexpr uint POLYPHASE_MAX_DOWN           =640;       ///< 支持的最大 M
+    constexpr uint POLYPHASE_MAX_TAPS           =8192;      ///< 每相位系数上限（决定每个输出采样的计算量）
+    constexpr uint POLYPHASE_MAX_COEFFICIENTS   =1<<19;     ///< 单个滤波器组系数总数上限（L×taps，2MB）
+    constexpr uint POLYPHASE_CACHE_CAPACITY     =16;        ///< 缓存的滤波器组个数上限
+
+    /**
+    * 将采样率比约分为 L/M（output_rate/input_rate），L、M 都不超过上限时返回 true
+    * 常用采样率 8000/11025/16000/22050/32000/44100/48000/96000 之间的转换均满足
+    */
+    bool GetPolyphaseRatio(uint input_rate,uint output_rate,uint *up,uint *down);
+
+    /**
+    * 是否可以（且应该）使用多相重采样：比率为小整数比、滤波器组不超过 POLYPHASE_MAX_TAPS/POLYPHASE_MAX_COEFFICIENTS，
+    * 且品质为 Sinc*（Linear 与超出上限的比率仍走 libsamplerate）
+    */
+    bool IsPolyphaseResampleSupported(uint input_rate,uint output_rate,ResampleQuality quality);
+
+    /**
+    * 取得 (L,M,quality) 的滤波器组，首次调用时计算并存入全进程缓存（线程安全）
+    * @return 参数非法或滤波器组超出大小上限时返回 nullptr
+    */
+    std::shared_ptr<const PolyphaseFilterBank> AcquirePolyphaseFilterBank(uint up,uint down,ResampleQuality quality);
+
+    /**
+    * 多相重采样整段交错 float 数据（首尾按 0 延拓）
+    * 点积内核跟随 GetSampleConvertPath()（标量/SSE2/AVX2/NEON）
+    * @param input          输入交错采样
+    * @param input_frames   输入帧数
+    * @param channels       声道数
+    * @param output         输出交错采样，至少 GetPolyphaseOutputFrames() 帧
+    * @return 输出帧数，失败返回 0
+    */
+    uint PolyphaseResample(const PolyphaseFilterBank &bank,const float *input,uint input_frames,uint channels,float *output);
+
+    /**
+    * 输出帧数 = ceil(input_frames×L/M)
+    */
+    uint GetPolyphaseOutputFrames(const PolyphaseFilterBank &bank,uint input_frames);
+}//namespace hgl::audio
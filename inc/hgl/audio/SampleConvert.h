@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+#include<hgl/audio/AudioMixerTypes.h>
+#include<cstdint>
+
+namespace hgl::audio
+{
+    /**
+    * 采样格式转换内核路径
+    */
+    enum class SampleConvertPath
+    {
+        Scalar=0,       ///<标量（所有平台可用）
+        SSE2,           ///<x86 SSE2
+        AVX2,           ///<x86 AVX2（运行时检测）
+        NEON            ///<ARM NEON
+    };
+
+    /**
+    * 取得当前使用的转换内核路径（首次调用时按 CPU 能力自动选择最快路径）
+    */
+    SampleConvertPath GetSampleConvertPath();
+
+    /**
+    * 强制指定转换内核路径（用于对比测试/排查），CPU 不支持时返回 false 且不改变
+    */
+    bool SetSampleConvertPath(SampleConvertPath path);
+
+    const os_char *GetSampleConvertPathName(SampleConvertPath path);
+
+    /**
+    * 是否为转换内核支持的采样格式
+    * 支持：int8 / int16 / int24(3字节紧凑) / int32 / float32
+    */
+    bool IsSampleFormatSupported(const AudioDataInfo &info);
+
+    /**
+    * 整数/浮点采样 → float (-1.0 到 1.0)
+    * 缩放系数与原各模块一致：int8/128、int16/32768、int24/8388608、int32/2147483648
+    * @param input  输入交错采样
+    * @param output 输出 float
+    * @param count  采样数（帧数×声道数）
+    * @param info   输入格式（bits_per_sample/is_float）
+    */
+    void SampleToFloat(const void *input,float *output,uint count,const AudioDataInfo &info);
+
+    /**
+    * float → 目标格式，先钳位到 [-1,1] 再按 127/32767/8388607/2147483647 缩放截断
+    * float32 输出为直接拷贝（不钳位）
+    */
+    void FloatToSample(const float *input,void *output,uint count,const AudioDataInfo &info);
+
+    class TPDFDither;
+
+    /**
+    * float → int16，叠加约 1 LSB 的 TPDF 抖动（钳位后加噪，再次钳位后量化）
+    */
+    void FloatToInt16Dither(const float *input,int16_t *output,uint count,TPDFDither &dither);
+
+    /**
+    * TPDF 抖动噪声源（Triangular Probability Density Function）
+    *
+    * 8 路并行 xorshift32，每个采样由两个均匀分布相加得到三角形分布。
+    * 第 i 个采样固定使用第 i%8 路，因此各内核路径（标量/SSE2/AVX2/NEON）输出逐位一致。
+    */
+    class TPDFDither
+    {
+        uint32_t state[8];
+
+        friend void FloatToInt16Dither(const float *,int16_t *,uint,TPDFDither &);
+
+    public:
+
+        TPDFDither(uint32_t seed=0x9E3779B9u){Seed(seed);}
+
+        void Seed(uint32_t seed);
+
+        /**
+        * 生成 count 个 [-scale,scale] 范围内的 TPDF 噪声
+        */
+        void Generate(float *output,uint count,float scale=1.0f);
+    };//class TPDFDither
+}//namespace hgl::audio
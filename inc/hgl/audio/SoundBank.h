@@ -0,0 +1,110 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+#include<hgl/type/String.h>
+#include<hgl/audio/AudioFileType.h>
+
+namespace hgl::audio
+{
+    class MappedFile;
+
+    /**
+    * 声音包（Sound Bank）文件格式，全部字段小端序
+    *
+    *   [SoundBankHeader]
+    *   [SoundBankEntry × entry_count]      按 name_hash 升序，二分查找
+    *   [名称表]                            UTF-8，'\0' 结尾，供列表/调试（可选）
+    *   [负载 × entry_count]                起始偏移按 alignment 对齐
+    *
+    * 负载为可直接交给 alBufferData 的 PCM，或原样保存的 Vorbis/Opus 文件。
+    * 整个文件内存映射后直接使用，不逐项打开文件、不复制索引。
+    */
+    constexpr uint32 SOUND_BANK_MAGIC               =0x42534D43;    ///< "CMSB"
+    constexpr uint32 SOUND_BANK_VERSION             =1;
+    constexpr uint32 SOUND_BANK_DEFAULT_ALIGNMENT   =64;
+
+    /**
+    * 负载类型（值写入文件，保持稳定）
+    */
+    enum class SoundBankPayload:uint32
+    {
+        PCM=0,          ///<原始 PCM（format/sample_rate 有效）
+        Vorbis,         ///<Vorbis OGG 文件
+        Opus,           ///<Opus OGG 文件
+    };//enum class SoundBankPayload
+
+    struct SoundBankHeader
+    {
+        uint32  magic;                  ///< SOUND_BANK_MAGIC
+        uint32  version;                ///< SOUND_BANK_VERSION
+        uint32  entry_count;
+        uint32  alignment;              ///< 负载对齐字节数
+        uint64  index_offset;           ///< SoundBankEntry 数组偏移
+        uint64  names_offset;           ///< 名称表偏移（0=无）
+    };//struct SoundBankHeader
+
+    struct SoundBankEntry
+    {
+        uint64  name_hash;              ///< SoundBankNameHash(名称)，索引按此升序
+        uint32  cue_hash;               ///< CueNameHash(名称)，与事件系统的 cue_id 一致
+        uint32  payload_type;           ///< SoundBankPayload
+        uint64  offset;                 ///< 负载偏移（自文件头起）
+        uint64  size;                   ///< 负载字节数
+        uint32  format;                 ///< PCM：OpenAL 格式（AL_FORMAT_*）
+        uint32  sample_rate;            ///< PCM：采样率
+        uint32  name_offset;            ///< 名称在名称表中的偏移
+        uint32  reserved;
+    };//struct SoundBankEntry
+
+    static_assert(sizeof(SoundBankHeader)==32,"SoundBankHeader layout");
+    static_assert(sizeof(SoundBankEntry)==48,"SoundBankEntry layout");
+
+    /**
+    * 声音包名称哈希：64 位 FNV-1a，输入与 CueNameHash 相同（UTF-8 名称字节），仅位宽不同
+    */
+    uint64 SoundBankNameHash(const char *u8_name);
+    uint64 SoundBankNameHash(const OSString &name);
+
+    AudioFileType ToAudioFileType(SoundBankPayload payload);   ///< PCM 返回 AudioFileType::None
+
+    /**
+    * 只读声音包（内存映射）
+    */
+    class SoundBank
+    {
+        MappedFile *mapped;
+
+        const SoundBankHeader *header;
+        const SoundBankEntry *entries;
+        const char *names;
+        uint64 names_size;
+
+        OSString filename;
+
+    public:
+
+        SoundBank();
+        ~SoundBank();
+
+        SoundBank(const SoundBank &)=delete;
+        SoundBank &operator=(const SoundBank &)=delete;
+
+        /**
+        * 映射并校验声音包（头、索引范围、排序、负载范围）
+        */
+        bool Open(const os_char *filename);
+        void Close();
+
+        bool IsOpen()const{return header!=nullptr;}
+        const OSString &GetFilename()const{return filename;}
+
+        uint GetCount()const{return header?header->entry_count:0;}
+        const SoundBankEntry *GetEntry(uint index)const{return (header&&index<header->entry_count)?entries+index:nullptr;}
+
+        const SoundBankEntry *Find(uint64 name_hash)const;                     ///< 二分查找，未命中返回 nullptr
+        const SoundBankEntry *Find(const OSString &name)const{return Find(SoundBankNameHash(name));}
+
+        const void *GetPayload(const SoundBankEntry *entry)const;              ///< 负载指针（指向映射内存）
+        const char *GetName(const SoundBankEntry *entry)const;                 ///< UTF-8 名称，无名称表时返回 nullptr
+    };//class SoundBank
+}//namespace hgl::audio
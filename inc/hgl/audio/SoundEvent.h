@@ -104,6 +104,7 @@ namespace hgl::audio
         float rolloff_factor=1.0f;              ///< 距离衰减系数
 
         bool  loop=false;                       ///< 是否循环
+        bool  stream=false;                     ///< 流式播放（长音频：压缩常驻 + 边解码边播放，不整段解码）
         AudioBusType bus_type=AudioBusType::SFX;///< 分组
 
         std::vector<RTPCConfig> rtpc;           ///< 实时参数映射表（T2）
@@ -124,6 +125,7 @@ namespace hgl::audio
         float   RandomGain()const;              ///< 在 [min_gain,max_gain] 随机取音量
         float   RandomPitch()const;             ///< 在 [min_pitch,max_pitch] 随机取音高
         const OSString *RandomFile()const;      ///< 随机选一个文件变体；无文件返回 nullptr
+        int     RandomFileIndex()const;         ///< 随机选一个文件变体的序号；无文件返回 -1
 
         /**
         * 按序取轮播文件（T2）：第 index 次播放取 sequence[index % count]
@@ -155,6 +157,7 @@ namespace hgl::audio
             max_distance=other.max_distance;
             rolloff_factor=other.rolloff_factor;
             loop=other.loop;
+            stream=other.stream;
             bus_type=other.bus_type;
             rtpc=other.rtpc;
         }
@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+#include<cstring>
+
+namespace hgl::audio
+{
+    constexpr uint16 WAVE_FORMAT_PCM        =0x0001;
+    constexpr uint16 WAVE_FORMAT_IEEE_FLOAT =0x0003;
+    constexpr uint16 WAVE_FORMAT_EXTENSIBLE =0xFFFE;
+
+    /**
+    * RIFF/WAVE 原地解析结果，pcm 直接指向传入的文件内存（不复制）
+    */
+    struct RIFFWAVEInfo
+    {
+        uint16          channels;
+        uint32          sample_rate;
+        uint16          bits;                   ///< 源位深 8/16/24/32
+        bool            is_float;               ///< 是否 IEEE float（仅 32 位）
+        const uint8 *   pcm;                    ///< data 块起始
+        uint64          pcm_size;               ///< PCM 字节数（已截到整帧）
+        bool            loop;                   ///< smpl 块是否带循环
+    };//struct RIFFWAVEInfo
+
+    /**
+    * 原地解析 RIFF/WAVE 文件的 fmt / data / smpl 块（主程序 ParseWAVData 与 WAV 解码插件共用）
+    *
+    * - 支持 PCM(8/16/24/32 位)、IEEE float(32 位)与 WAVE_FORMAT_EXTENSIBLE（子格式为 PCM/float），ADPCM 等压缩格式返回 false
+    * - 奇数长度的块后有 1 字节填充；块长度超出文件时按实际长度处理（截断的文件）
+    * - fmt 必须在 data 之前；data 之后的块（如 smpl）仍会读取
+    * @param data 文件数据
+    * @param size 文件字节数
+    * @param info 解析结果
+    * @return 是否为支持的 WAV 格式且有非空 PCM 数据
+    */
+    inline bool ParseRIFFWAVE(const void *data,uint64 size,RIFFWAVEInfo &info)
+    {
+        auto ReadU16=[](const uint8 *p){uint16 v;memcpy(&v,p,sizeof(v));return v;};
+        auto ReadU32=[](const uint8 *p){uint32 v;memcpy(&v,p,sizeof(v));return v;};
+
+        memset(&info,0,sizeof(RIFFWAVEInfo));
+
+        if(!data||size<12)
+            return(false);
+
+        const uint8 *file=(const uint8 *)data;
+
+        if(memcmp(file,"RIFF",4)||memcmp(file+8,"WAVE",4))
+            return(false);
+
+        uint16 tag=0;
+        bool has_fmt=false;
+        uint64 pos=12;
+
+        while(size-pos>=8)
+        {
+            const uint8 *id=file+pos;
+            uint64 chunk_size=ReadU32(file+pos+4);
+
+            pos+=8;
+
+            if(chunk_size>size-pos)chunk_size=size-pos;             //截断的文件按实际长度处理
+
+            const uint8 *p=file+pos;
+
+            if(!memcmp(id,"fmt ",4))
+            {
+                if(chunk_size<16)
+                    return(false);
+
+                tag             =ReadU16(p);
+                info.channels   =ReadU16(p+2);
+                info.sample_rate=ReadU32(p+4);
+                info.bits       =ReadU16(p+14);
+
+                if(tag==WAVE_FORMAT_EXTENSIBLE)
+                {
+                    // cbSize(2) ValidBits(2) ChannelMask(4) SubFormat GUID(16)，GUID 前 2 字节即实际格式
+                    if(chunk_size<40)
+                        return(false);
+
+                    tag=ReadU16(p+24);
+                }
+
+                has_fmt=true;
+            }
+            else if(!memcmp(id,"data",4))
+            {
+                if(!has_fmt)
+                    return(false);
+
+                if(!info.pcm)
+                {
+                    info.pcm=p;
+                    info.pcm_size=chunk_size;
+                }
+            }
+            else if(!memcmp(id,"smpl",4))
+            {
+                // Manufacturer Product SamplePeriod Note FineTune SMPTEFormat SMPTEOffset 之后为循环数
+                if(chunk_size>=32)
+                    info.loop=(ReadU32(p+28)!=0);
+            }
+
+            pos+=chunk_size;
+
+            if(chunk_size&1)
+            {
+                if(pos>=size)break;
+
+                ++pos;
+            }
+        }
+
+        if(!has_fmt||!info.pcm||info.channels==0||info.sample_rate==0)
+            return(false);
+
+        if(tag==WAVE_FORMAT_PCM)
+        {
+            if(info.bits!=8&&info.bits!=16&&info.bits!=24&&info.bits!=32)
+                return(false);
+        }
+        else if(tag==WAVE_FORMAT_IEEE_FLOAT)
+        {
+            if(info.bits!=32)
+                return(false);
+
+            info.is_float=true;
+        }
+        else
+            return(false);                          //ADPCM 等压缩格式交给其它解码插件
+
+        const uint frame_bytes=uint(info.channels)*info.bits/8;
+
+        info.pcm_size-=info.pcm_size%frame_bytes;
+
+        return(info.pcm_size>0);
+    }
+}//namespace hgl::audio
@@ -0,0 +1,54 @@
+﻿#include<hgl/al/events.h>
+#include<hgl/CoreType.h>
+
+namespace hgl::audio
+{
+    void OnAudioSourceEvent(uint source);           ///< AudioStreamService.cpp：唤醒注册了该音源的流式客户端
+}
+
+namespace openal
+{
+    LPALEVENTCONTROLSOFT alEventControlSOFT = 0;
+    LPALEVENTCALLBACKSOFT alEventCallbackSOFT = 0;
+}
+
+namespace openal
+{
+    namespace
+    {
+        void AL_APIENTRY SourceEventCallback(ALenum type,ALuint object,ALuint,ALsizei,const ALchar *,void *)
+        {
+            if(type==AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT
+             ||type==AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT)
+                hgl::audio::OnAudioSourceEvent(object);
+        }
+    }//namespace
+
+    void ClearSourceEvents()
+    {
+        alEventControlSOFT = 0;
+        alEventCallbackSOFT = 0;
+    }
+
+    bool CheckSourceEvents()
+    {
+        if(!alIsExtensionPresent||!alIsExtensionPresent("AL_SOFT_events"))
+            return(false);
+
+        alEventControlSOFT  =(LPALEVENTCONTROLSOFT )alGetProcAddress("alEventControlSOFT");
+        alEventCallbackSOFT =(LPALEVENTCALLBACKSOFT)alGetProcAddress("alEventCallbackSOFT");
+
+        if(alEventControlSOFT&&alEventCallbackSOFT)
+        {
+            // 回调与事件开关属于当前 context：每次创建 context（InitOpenAL，包括 AudioEngineThread 自己的 context）都在此安装
+            const ALenum types[]={AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT,AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT};
+
+            alEventCallbackSOFT(SourceEventCallback,nullptr);
+            alEventControlSOFT(2,types,AL_TRUE);
+            return(true);
+        }
+
+        ClearSourceEvents();
+        return(false);
+    }
+}//namespace openal
@@ -1,6 +1,7 @@
 ﻿#include<hgl/audio/AudioAssetManager.h>
 #include<hgl/audio/AudioBuffer.h>
 #include<hgl/audio/AudioFileType.h>
+#include<hgl/audio/SoundBank.h>
 #include<hgl/io/FileInputStream.h>
 #include<hgl/type/Queue.h>
 #include<hgl/thread/Thread.h>
@@ -8,6 +9,11 @@
 #include<hgl/time/Time.h>
 #include<hgl/log/Log.h>
 #include"AudioDecode.h"
+#include<set>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
 
 namespace hgl::audio
 {
@@ -23,16 +29,46 @@ namespace hgl::audio
                 : AudioLoadMode::Stream;
     }
 
+    AudioLoadMode SuggestAudioLoadMode(AudioFileType file_type,double duration,int64 file_size)
+    {
+        const bool compressed_format=(file_type==AudioFileType::Vorbis||file_type==AudioFileType::Opus);
+
+        if(!compressed_format||duration<=0)
+            return SuggestAudioLoadMode(file_size);
+
+        if(duration<=AUDIO_FULL_LOAD_MAX_SECONDS)       return AudioLoadMode::Full;         // 短音效：PCM 常驻，播放零开销
+        if(duration<=AUDIO_COMPRESSED_LOAD_MAX_SECONDS) return AudioLoadMode::Compressed;   // 语音/台词：PCM 约为压缩数据的 10 倍
+
+        return AudioLoadMode::Stream;
+    }
+
     // ====================================================================
-    // 后台解码线程（内部实现，仅在本文件可见）
+    // 后台解码池（内部实现，仅在本文件可见）
     // 职责：读文件 + 插件解码（纯 CPU/IO，不碰 OpenAL），产出 DecodedAudio
-    // 主线程在 Update() 中消费结果并上传到 OpenAL buffer
+    // N 个工作线程共享一个按优先级排序的待解码集合，主线程在 Update() 中消费结果并上传到 OpenAL buffer
     // ====================================================================
 
     struct AudioLoadTask
     {
         OSString      filename;
         AudioFileType file_type;
+        int           priority;         // 越大越先解码
+        uint64        sequence;         // 同优先级按提交顺序（FIFO）
+        bool          decoding;         // 已被工作线程取走
+        bool          cancelled;        // 解码中被取消，完成后直接丢弃
+        const void *  memory;           // 非空时直接解码这段内存（已挂载声音包中的负载），不读文件
+        int64         memory_size;
+    };
+
+    struct AudioLoadTaskOrder
+    {
+        bool operator()(const AudioLoadTask *a,const AudioLoadTask *b)const
+        {
+            if(a->priority!=b->priority)
+                return a->priority>b->priority;
+
+            return a->sequence<b->sequence;
+        }
     };
 
     struct CompletedLoad
@@ -41,53 +77,289 @@ namespace hgl::audio
         DecodedAudio *decoded;          // nullptr 表示解码失败
     };
 
-    class AudioLoadThread:public Thread
+    namespace
+    {
+        uint64 GetDecodedBytes(const CompletedLoad *item)
+        {
+            return (item->decoded&&item->decoded->size>0)?(uint64)item->decoded->size:0;
+        }
+
+        DecodedAudio *DecodeAudioFile(const OSString &filename,AudioFileType file_type)
+        {
+            OpenFileInputStream file_stream(filename);
+
+            if(!file_stream)
+            {
+                GLogError(OS_TEXT("AudioAssetManager: 打开文件失败 ")+filename);
+                return nullptr;
+            }
+
+            const int64 file_size=file_stream->Available();
+
+            if(file_size<=0)
+            {
+                GLogError(OS_TEXT("AudioAssetManager: 文件为空 ")+filename);
+                return nullptr;
+            }
+
+            char *memory=new char[file_size];
+
+            DecodedAudio *decoded=nullptr;
+
+            const int64 read_size=file_stream->Read(memory,file_size);
+
+            if(read_size>0)
+                decoded=DecodeAudio(file_type,memory,(int)read_size,false);
+
+            delete[] memory;
+
+            return decoded;
+        }
+
+        void DeleteDecodedAudio(DecodedAudio *decoded)
+        {
+            if(!decoded)return;
+
+            decoded->Release();
+            delete decoded;
+        }
+
+        uint GetDefaultDecodeWorkerCount()
+        {
+            // 留一个核给主线程/OpenAL 线程，至少 1 个，过多线程对磁盘 IO 无益
+            uint count=std::thread::hardware_concurrency();
+
+            count=(count>1)?count-1:1;
+
+            return count>AUDIO_DECODE_MAX_WORKERS?AUDIO_DECODE_MAX_WORKERS:count;
+        }
+    }//namespace
+
+    class AudioLoadPool;
+
+    class AudioLoadWorker:public Thread
+    {
+        AudioLoadPool *pool;
+
+    public:
+
+        AudioLoadWorker(AudioLoadPool *p):pool(p){}
+
+        bool DeletedAfterExit()const override{return false;}
+
+        bool Execute() override;
+    };//class AudioLoadWorker
+
+    class AudioLoadPool
     {
-        Queue<AudioLoadTask *> pending;         // 待解码任务
-        Queue<CompletedLoad *> done;            // 已解码（主线程消费）
+        std::set<AudioLoadTask *,AudioLoadTaskOrder> pending;  // 待解码任务（优先级高者在前）
+        UnorderedMap<OSString,AudioLoadTask *> tasks;           // 文件名 → 任务（待解码 + 解码中），去重/改优先级/取消用
+        Queue<CompletedLoad *> done;                            // 已解码（主线程消费）
 
-        mutable ThreadMutex queue_lock;         // 保护 pending/done
+        mutable ThreadMutex queue_lock;                         // 保护 pending/tasks/done
+
+        uint64 next_sequence;
+
+        int    done_count;                                      // done 中的个数（待上传积压）
+        uint64 done_bytes;                                      // done 中的 PCM 字节数
 
         atom<int> task_count;                   // 在途任务数（含解码中+待上传），原子，避免队列空窗导致轮询提前结束
 
+        std::vector<AudioLoadWorker *> workers;
+
+        std::mutex wake_mutex;                  // 空闲工作线程在此等待，Submit/SetPriority/退出时唤醒
+        std::condition_variable wake_cond;
+        uint wake_pending;                      // 未被工作线程取走的唤醒次数
+        bool exiting;
+        atom<bool> paused;                      // 暂停取新任务（解码中的任务照常完成）
+
+        void NotifyWorker()
+        {
+            {
+                std::lock_guard<std::mutex> wake_guard(wake_mutex);
+                ++wake_pending;
+            }
+
+            wake_cond.notify_one();
+        }
+
     public:
 
-        AudioLoadThread():task_count(0){}
+        AudioLoadPool(uint worker_count,bool start_paused):next_sequence(0),done_count(0),done_bytes(0),task_count(0),wake_pending(0),exiting(false),paused(start_paused)
+        {
+            if(worker_count==0)worker_count=1;
+
+            workers.reserve(worker_count);
 
-        ~AudioLoadThread()
+            for(uint i=0;i<worker_count;i++)
+            {
+                AudioLoadWorker *worker=new AudioLoadWorker(this);
+
+                worker->Start();
+                workers.push_back(worker);
+            }
+        }
+
+        ~AudioLoadPool()
         {
-            AudioLoadTask *task;
+            {
+                std::lock_guard<std::mutex> wake_guard(wake_mutex);
+                exiting=true;
+            }
+
+            wake_cond.notify_all();
 
-            while(pending.Pop(task))delete task;
+            for(AudioLoadWorker *worker:workers)        // 先停全部线程，之后队列不再被并发访问
+            {
+                worker->WaitExit();
+                delete worker;
+            }
+
+            workers.clear();
+
+            for(AudioLoadTask *task:pending)
+                delete task;
+
+            pending.clear();
+            tasks.Clear();                              // 解码中的任务已由各线程在退出前处理完
 
             CompletedLoad *item;
 
             while(done.Pop(item))
             {
-                if(item->decoded)
-                {
-                    item->decoded->Release();
-                    delete item->decoded;
-                }
-
+                DeleteDecodedAudio(item->decoded);
                 delete item;
             }
         }
 
-        bool DeletedAfterExit()const override{return false;}
+        uint GetWorkerCount()const{return (uint)workers.size();}
+
+        void Pause()
+        {
+            paused=true;
+        }
+
+        void Resume()
+        {
+            {
+                std::lock_guard<std::mutex> wake_guard(wake_mutex);
+
+                paused=false;
+                wake_pending+=(uint)workers.size();
+            }
+
+            wake_cond.notify_all();
+        }
+
+        /**
+        * 提交任务；同名任务已在途时不重复提交，仅把优先级提升到较高者（解码中被取消的任务恢复）
+        */
+        void Submit(const os_char *filename,AudioFileType file_type,int priority,const void *memory=nullptr,int64 memory_size=0)
+        {
+            const OSString key(filename);
+
+            {
+                ThreadMutexLock lock_guard(&queue_lock);
+
+                if(!AddTask(key,file_type,priority,memory,memory_size))
+                    return;
+            }
+
+            NotifyWorker();
+        }
 
-        void Submit(const os_char *filename,AudioFileType file_type)
+        /**
+        * 登记任务（queue_lock 内调用），同名任务已在途时返回 false
+        */
+        bool AddTask(const OSString &key,AudioFileType file_type,int priority,const void *memory,int64 memory_size)
         {
-            AudioLoadTask *task=new AudioLoadTask;
+            AudioLoadTask *task=nullptr;
+
+            if(tasks.Get(key,task))
+            {
+                if(task->decoding)
+                {
+                    task->cancelled=false;
+                }
+                else if(priority>task->priority)
+                {
+                    pending.erase(task);
+                    task->priority=priority;
+                    pending.insert(task);
+                }
+
+                return false;
+            }
 
-            task->filename=filename;
+            task=new AudioLoadTask;
+
+            task->filename=key;
             task->file_type=file_type;
+            task->priority=priority;
+            task->sequence=next_sequence++;
+            task->decoding=false;
+            task->cancelled=false;
+            task->memory=memory;
+            task->memory_size=memory_size;
 
-            queue_lock.Lock();
-            pending.Push(task);
-            queue_lock.Unlock();
+            pending.insert(task);
+            tasks.Add(key,task);
 
             task_count.fetch_add(1);            // 在途 +1
+            return true;
+        }
+
+        /**
+        * 修改待解码任务的优先级（可升可降），解码中或不存在返回 false
+        */
+        bool SetPriority(const os_char *filename,int priority)
+        {
+            {
+                ThreadMutexLock lock_guard(&queue_lock);
+
+                AudioLoadTask *task=nullptr;
+
+                if(!tasks.Get(OSString(filename),task))return false;
+                if(task->decoding)return false;
+
+                if(task->priority==priority)
+                    return true;
+
+                pending.erase(task);
+                task->priority=priority;
+                pending.insert(task);
+            }
+
+            NotifyWorker();
+            return true;
+        }
+
+        /**
+        * 取消任务：待解码的直接移除；解码中的打上标记，完成后丢弃结果
+        * 已解码、等待 Update() 上传的任务不受影响（返回 false）
+        */
+        bool Cancel(const os_char *filename)
+        {
+            const OSString key(filename);
+
+            ThreadMutexLock lock_guard(&queue_lock);
+
+            AudioLoadTask *task=nullptr;
+
+            if(!tasks.Get(key,task))return false;
+
+            if(task->decoding)
+            {
+                task->cancelled=true;
+                return true;
+            }
+
+            pending.erase(task);
+            tasks.DeleteByKey(key);
+            delete task;
+
+            task_count.fetch_sub(1);            // 未开始即取消，在途 -1
+            return true;
         }
 
         CompletedLoad *PopDone()
@@ -97,13 +369,26 @@ namespace hgl::audio
             queue_lock.Lock();
 
             if(done.Pop(item))
+            {
+                --done_count;
+                done_bytes-=GetDecodedBytes(item);
+
                 task_count.fetch_sub(1);        // 取走一个完成项，在途 -1
+            }
 
             queue_lock.Unlock();
 
             return item;
         }
 
+        void GetBacklog(int &count,uint64 &bytes)const
+        {
+            ThreadMutexLock lock_guard(&queue_lock);
+
+            count=done_count;
+            bytes=done_bytes;
+        }
+
         bool HasWork()const
         {
             return task_count.load()>0;
@@ -114,64 +399,84 @@ namespace hgl::audio
             return task_count.load();
         }
 
-        bool Execute() override
+        /**
+        * 工作线程主体：取最高优先级任务解码一次
+        */
+        bool Process()
         {
             AudioLoadTask *task=nullptr;
 
             queue_lock.Lock();
-            pending.Pop(task);
+
+            if(!paused&&!pending.empty())
+            {
+                auto it=pending.begin();
+
+                task=*it;
+                pending.erase(it);
+
+                task->decoding=true;
+            }
+
             queue_lock.Unlock();
 
             if(!task)
             {
-                SleepSecond(0.001);     // 队列空，让出 CPU；退出由 exit_lock 检测
+                // 队列空或已暂停：等到 Submit/SetPriority/Resume 唤醒；析构时唤醒全部线程退出
+                std::unique_lock<std::mutex> wake_guard(wake_mutex);
+
+                wake_cond.wait(wake_guard,[this]{return (wake_pending>0&&!paused)||exiting;});
+
+                if(exiting)
+                    return false;
+
+                --wake_pending;
                 return true;
             }
 
-            // 读文件 + 解码（纯 CPU/IO，不碰 OpenAL，线程安全）
-            DecodedAudio *decoded=nullptr;
+            // 读文件 + 解码（纯 CPU/IO，不碰 OpenAL，线程安全）；插件只读访问内存，声音包映射可直接交给解码器
+            // 多个工作线程本身已并行，不再分段解码（否则每个工作线程还会再开至多 AUDIO_PARALLEL_DECODE_MAX_SEGMENTS 个线程）
+            DecodedAudio *decoded=task->memory
+                                 ?DecodeAudio(task->file_type,const_cast<void *>(task->memory),(int)task->memory_size,false)
+                                 :DecodeAudioFile(task->filename,task->file_type);
+
+            queue_lock.Lock();
 
-            OpenFileInputStream file_stream(task->filename);
+            tasks.DeleteByKey(task->filename);
 
-            if(!file_stream)
+            if(task->cancelled)                 // 解码期间被取消：丢弃结果
             {
-                GLogError(OS_TEXT("AudioAssetManager: 打开文件失败 ")+task->filename);
+                queue_lock.Unlock();
+
+                DeleteDecodedAudio(decoded);
+
+                task_count.fetch_sub(1);        // 在途 -1
             }
             else
             {
-                const int64 file_size=file_stream->Available();
+                CompletedLoad *item=new CompletedLoad;
 
-                if(file_size<=0)
-                {
-                    GLogError(OS_TEXT("AudioAssetManager: 文件为空 ")+task->filename);
-                }
-                else
-                {
-                    char *memory=new char[file_size];
+                item->filename=task->filename;
+                item->decoded=decoded;          // nullptr 表示失败
 
-                    const int64 read_size=file_stream->Read(memory,file_size);
+                done.Push(item);
 
-                    if(read_size>0)
-                        decoded=DecodeAudio(task->file_type,memory,(int)read_size);
+                ++done_count;
+                done_bytes+=GetDecodedBytes(item);
 
-                    delete[] memory;
-                }
+                queue_lock.Unlock();
             }
 
-            CompletedLoad *item=new CompletedLoad;
-
-            item->filename=task->filename;
-            item->decoded=decoded;              // nullptr 表示失败
-
-            queue_lock.Lock();
-            done.Push(item);
-            queue_lock.Unlock();
-
             delete task;
 
             return true;
         }
-    };//class AudioLoadThread
+    };//class AudioLoadPool
+
+    bool AudioLoadWorker::Execute()
+    {
+        return pool->Process();
+    }
 
     // ====================================================================
     // AudioAssetManager
@@ -179,19 +484,134 @@ namespace hgl::audio
 
     AudioAssetManager::AudioAssetManager()
     {
-        load_thread=nullptr;
+        load_pool=nullptr;
+        decode_worker_count=0;
+        decode_paused=false;
+
+        upload_stats={};
+
+        compressed_bytes=0;
+
+        resident_budget=0;
+        resident_bytes=0;
+        idle_bytes=0;
+        hit_count=0;
+        miss_count=0;
+        eviction_count=0;
     }
 
     AudioAssetManager::~AudioAssetManager()
     {
-        if(load_thread)
+        SAFE_CLEAR(load_pool);
+
+        Clear();
+
+        for(SoundBank *bank:banks)          // 缓存已清空，不再有指向映射内存的数据
+            delete bank;
+    }
+
+    const SoundBankEntry *AudioAssetManager::FindInBanks(const OSString &key,SoundBank **bank)const
+    {
+        if(banks.empty())return nullptr;
+
+        const uint64 hash=SoundBankNameHash(key);
+
+        for(auto it=banks.rbegin();it!=banks.rend();++it)           // 后挂载的优先（补丁包覆盖）
         {
-            load_thread->WaitExit();
-            delete load_thread;
-            load_thread=nullptr;
+            const SoundBankEntry *entry=(*it)->Find(hash);
+
+            if(entry)
+            {
+                if(bank)*bank=*it;
+                return entry;
+            }
         }
 
-        Clear();
+        return nullptr;
+    }
+
+    void AudioAssetManager::MarkIdle(const OSString &key,AssetEntry *entry)
+    {
+        if(entry->idle||entry->pinned)return;
+
+        entry->lru_it=idle_list.insert(idle_list.end(),key);     // 最近释放的放在末尾
+        entry->idle=true;
+
+        idle_bytes+=entry->buffer->GetSize();
+    }
+
+    void AudioAssetManager::MarkActive(AssetEntry *entry)
+    {
+        if(!entry->idle)return;
+
+        idle_list.erase(entry->lru_it);
+        entry->idle=false;
+
+        idle_bytes-=entry->buffer->GetSize();
+    }
+
+    bool AudioAssetManager::AddEntry(const OSString &key,AudioBuffer *buffer)
+    {
+        AssetEntry entry;
+
+        entry.buffer=buffer;
+        entry.pinned=false;
+        entry.idle=false;
+
+        if(!assets.Add(key,entry))return false;
+
+        resident_bytes+=buffer->GetSize();
+        return true;
+    }
+
+    void AudioAssetManager::Unload(const OSString &key)
+    {
+        AssetEntry *entry=assets.GetValuePointer(key);
+
+        if(!entry)return;
+
+        MarkActive(entry);
+
+        resident_bytes-=entry->buffer->GetSize();
+
+        delete entry->buffer;
+        assets.DeleteByKey(key);
+    }
+
+    void AudioAssetManager::EvictToBudget()
+    {
+        if(resident_budget==0)return;                               // 未启用驻留预算
+
+        // 只淘汰无引用、未固定的缓冲（都在 idle_list 中），从最久未用的开始
+        while(resident_bytes>resident_budget&&!idle_list.empty())
+        {
+            const OSString key=idle_list.front();
+
+            Unload(key);
+            ++eviction_count;
+        }
+    }
+
+    void AudioAssetManager::ReleaseEntry(const OSString &key,AssetEntry *entry)
+    {
+        const uint rc=entry->buffer->GetRefCount();
+
+        if(rc==0)return;                    // 无引用（如异步预加载后未 Acquire 的 buffer），忽略
+
+        entry->buffer->DecRef();            // rc>=1 → rc-1
+
+        if(rc>1)return;                     // 仍有其他引用，保留
+
+        if(entry->pinned)return;            // 固定资源归零也常驻
+
+        if(resident_budget==0)              // 未启用驻留预算：归零即卸载
+        {
+            Unload(key);
+            return;
+        }
+
+        MarkIdle(key,entry);                // 进入 LRU，超出预算时淘汰最久未用的
+        EvictToBudget();
     }
 
     AudioBuffer *AudioAssetManager::Acquire(const os_char *filename)
@@ -202,16 +622,38 @@ namespace hgl::audio
 
         const OSString key(filename);
 
-        AudioBuffer *buffer=nullptr;
+        AssetEntry *entry=assets.GetValuePointer(key);
 
-        if(assets.Get(key,buffer))          // 命中缓存
+        if(entry)                           // 命中缓存（含 LRU 中保留的无引用缓冲）
         {
-            buffer->IncRef();
-            return buffer;
+            MarkActive(entry);
+
+            entry->buffer->IncRef();
+            ++hit_count;
+            return entry->buffer;
         }
 
+        ++miss_count;
+
         // 未命中：同步加载（在锁内进行，保证同一文件的并发 Acquire 不会重复加载）
-        buffer=new AudioBuffer(filename);
+        AudioBuffer *buffer=nullptr;
+
+        SoundBank *bank=nullptr;
+        const SoundBankEntry *bank_entry=FindInBanks(key,&bank);
+
+        if(bank_entry)                      // 声音包：负载在映射内存中，无文件 IO
+        {
+            void *payload=const_cast<void *>(bank->GetPayload(bank_entry));
+
+            buffer=new AudioBuffer;
+
+            if(bank_entry->payload_type==uint32(SoundBankPayload::PCM))
+                buffer->SetData(bank_entry->format,payload,uint(bank_entry->size),bank_entry->sample_rate);
+            else
+                buffer->Load(payload,int(bank_entry->size),ToAudioFileType(SoundBankPayload(bank_entry->payload_type)));
+        }
+        else
+            buffer=new AudioBuffer(filename);
 
         if(!buffer->IsLoaded())
         {
@@ -221,7 +663,8 @@ namespace hgl::audio
 
         buffer->IncRef();                   // 引用计数 = 1（登记到缓存）
 
-        assets.Add(key,buffer);
+        AddEntry(key,buffer);
+        EvictToBudget();
 
         return buffer;
     }
@@ -238,7 +681,10 @@ namespace hgl::audio
 
         buffer->IncRef();                   // 引用计数 = 1（登记到缓存）
 
-        return assets.Add(key,buffer);
+        if(!AddEntry(key,buffer))return false;
+
+        EvictToBudget();
+        return true;
     }
 
     void AudioAssetManager::Release(AudioBuffer *buffer)
@@ -247,25 +693,17 @@ namespace hgl::audio
 
         ThreadMutexLock lock_guard(&lock);
 
-        const uint rc=buffer->GetRefCount();
-
-        if(rc==0)return;                    // 无引用（如异步预加载后未 Acquire 的 buffer），忽略
-
-        buffer->DecRef();                   // rc>=1 → rc-1
-
-        if(rc>1)return;                     // 仍有其他引用，保留
-
-        // 归零：按指针反查 key 并从缓存移除
+        // 按指针反查 key
         for(auto it=assets.begin();it!=assets.end();++it)
         {
-            if(it->second==buffer)
+            if(it->second.buffer==buffer)
             {
-                assets.DeleteByKey(it->first);
-                break;
+                const OSString key=it->first;
+
+                ReleaseEntry(key,&it->second);
+                return;
             }
         }
-
-        delete buffer;
     }
 
     void AudioAssetManager::Release(const os_char *name)
@@ -276,36 +714,25 @@ namespace hgl::audio
 
         const OSString key(name);
 
-        AudioBuffer *buffer=nullptr;
-
-        if(!assets.Get(key,buffer))return;
-
-        const uint rc=buffer->GetRefCount();
+        AssetEntry *entry=assets.GetValuePointer(key);
 
-        if(rc==0)return;                    // 无引用（如异步预加载后未 Acquire 的 buffer），忽略
-
-        buffer->DecRef();                   // rc>=1 → rc-1
-
-        if(rc>1)return;                     // 仍有其他引用，保留
+        if(!entry)return;
 
-        assets.DeleteByKey(key);
-
-        delete buffer;
+        ReleaseEntry(key,entry);
     }
 
     AudioBuffer *AudioAssetManager::Find(const os_char *name)const
     {
         if(!name||!(*name))return nullptr;
 
-        lock.Lock();
-
-        AudioBuffer *buffer=nullptr;
+        ThreadMutexLock lock_guard(&lock);
 
-        assets.Get(OSString(name),buffer);
+        AssetEntry entry;
 
-        lock.Unlock();
+        if(!assets.Get(OSString(name),entry))
+            return nullptr;
 
-        return buffer;
+        return entry.buffer;
     }
 
     bool AudioAssetManager::Contains(const os_char *name)const
@@ -337,47 +764,434 @@ namespace hgl::audio
         ThreadMutexLock lock_guard(&lock);
 
         for(auto &kv : assets)
-            delete kv.second;
+            delete kv.second.buffer;
 
         assets.Clear();
+        idle_list.clear();
+
+        for(auto &kv : compressed_assets)
+        {
+            if(kv.second->owned)
+                delete[] kv.second->data;
+
+            delete kv.second;
+        }
+
+        compressed_assets.Clear();
+
+        resident_bytes=0;
+        idle_bytes=0;
+        compressed_bytes=0;
+    }
+
+    bool AudioAssetManager::MountBank(const os_char *filename)
+    {
+        if(!filename||!(*filename))return false;
+
+        SoundBank *bank=new SoundBank;
+
+        if(!bank->Open(filename))           // 映射与索引校验在锁外进行
+        {
+            delete bank;
+            return false;
+        }
+
+        ThreadMutexLock lock_guard(&lock);
+
+        banks.push_back(bank);
+
+        GLogInfo(OS_TEXT("AudioAssetManager: 挂载声音包 ")+bank->GetFilename()+OS_TEXT("，")+OSString::numberOf(bank->GetCount())+OS_TEXT(" 项"));
+
+        return true;
+    }
+
+    int AudioAssetManager::GetBankCount()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        return int(banks.size());
+    }
+
+    AudioCompressedData *AudioAssetManager::AcquireCompressed(const os_char *filename,AudioFileType file_type)
+    {
+        if(!filename||!(*filename))return nullptr;
+
+        ThreadMutexLock lock_guard(&lock);
+
+        const OSString key(filename);
+
+        AudioCompressedData *cd=nullptr;
+
+        if(compressed_assets.Get(key,cd))
+        {
+            ++cd->ref_count;
+            ++hit_count;
+            return cd;
+        }
+
+        ++miss_count;
+
+        SoundBank *bank=nullptr;
+        const SoundBankEntry *bank_entry=FindInBanks(key,&bank);
+
+        if(bank_entry)                                              // 声音包中的压缩负载：直接引用映射内存，不复制
+        {
+            if(bank_entry->payload_type==uint32(SoundBankPayload::PCM))
+            {
+                GLogError(OS_TEXT("AudioAssetManager: 声音包中为 PCM 负载，不能压缩常驻 ")+key);
+                return nullptr;
+            }
+
+            cd=new AudioCompressedData;
+
+            cd->name=key;
+            cd->file_type=ToAudioFileType(SoundBankPayload(bank_entry->payload_type));
+            cd->data=(char *)bank->GetPayload(bank_entry);
+            cd->size=int64(bank_entry->size);
+            cd->ref_count=1;
+            cd->owned=false;
+
+            compressed_assets.Add(key,cd);
+            compressed_bytes+=cd->size;
+
+            return cd;
+        }
+
+        if(!RangeCheck(file_type))                                  // 包内名称可以没有扩展名，磁盘文件才需要按扩展名识别
+            file_type=CheckAudioFileType(filename);
+
+        if(!RangeCheck(file_type))return nullptr;
+
+        OpenFileInputStream file_stream(key);
+
+        if(!file_stream)
+        {
+            GLogError(OS_TEXT("AudioAssetManager: 打开文件失败 ")+key);
+            return nullptr;
+        }
+
+        const int64 file_size=file_stream->Available();
+
+        if(file_size<=0)
+        {
+            GLogError(OS_TEXT("AudioAssetManager: 文件为空 ")+key);
+            return nullptr;
+        }
+
+        char *data=new char[file_size];
+
+        if(file_stream->Read(data,file_size)!=file_size)
+        {
+            GLogError(OS_TEXT("AudioAssetManager: 读取文件失败 ")+key);
+            delete[] data;
+            return nullptr;
+        }
+
+        cd=new AudioCompressedData;
+
+        cd->name=key;
+        cd->file_type=file_type;
+        cd->data=data;
+        cd->size=file_size;
+        cd->ref_count=1;
+        cd->owned=true;
+
+        compressed_assets.Add(key,cd);
+        compressed_bytes+=file_size;
+
+        return cd;
+    }
+
+    void AudioAssetManager::ReleaseCompressed(AudioCompressedData *cd)
+    {
+        if(!cd)return;
+
+        ThreadMutexLock lock_guard(&lock);
+
+        if(cd->ref_count==0)return;
+
+        if(--cd->ref_count>0)return;
+
+        compressed_assets.DeleteByKey(cd->name);
+        compressed_bytes-=cd->size;
+
+        if(cd->owned)
+            delete[] cd->data;
+
+        delete cd;
+    }
+
+    uint64 AudioAssetManager::GetCompressedBytes()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        return compressed_bytes;
+    }
+
+    void AudioAssetManager::SetResidentBudget(uint64 bytes)
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        resident_budget=bytes;
+
+        if(resident_budget==0)              // 关闭驻留：LRU 中的无引用缓冲全部卸载，恢复归零即卸载
+        {
+            while(!idle_list.empty())
+            {
+                const OSString key=idle_list.front();
+
+                Unload(key);
+                ++eviction_count;
+            }
+        }
+        else
+        {
+            EvictToBudget();
+        }
+    }
+
+    uint64 AudioAssetManager::GetResidentBudget()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        return resident_budget;
+    }
+
+    uint64 AudioAssetManager::GetResidentBytes()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        return resident_bytes;
+    }
+
+    bool AudioAssetManager::Pin(const os_char *name)
+    {
+        if(!name||!(*name))return false;
+
+        ThreadMutexLock lock_guard(&lock);
+
+        AssetEntry *entry=assets.GetValuePointer(OSString(name));
+
+        if(!entry)return false;
+
+        MarkActive(entry);                  // 移出 LRU
+        entry->pinned=true;
+        return true;
+    }
+
+    bool AudioAssetManager::Unpin(const os_char *name)
+    {
+        if(!name||!(*name))return false;
+
+        ThreadMutexLock lock_guard(&lock);
+
+        const OSString key(name);
+
+        AssetEntry *entry=assets.GetValuePointer(key);
+
+        if(!entry||!entry->pinned)return false;
+
+        entry->pinned=false;
+
+        if(entry->buffer->GetRefCount()>0)return true;
+
+        if(resident_budget==0)              // 无引用且未启用驻留预算：立即卸载
+        {
+            Unload(key);
+            return true;
+        }
+
+        MarkIdle(key,entry);
+        EvictToBudget();
+        return true;
+    }
+
+    bool AudioAssetManager::IsPinned(const os_char *name)const
+    {
+        if(!name||!(*name))return false;
+
+        ThreadMutexLock lock_guard(&lock);
+
+        AssetEntry entry;
+
+        return assets.Get(OSString(name),entry)&&entry.pinned;
+    }
+
+    AudioResidencyStats AudioAssetManager::GetResidencyStats()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        AudioResidencyStats stats;
+
+        stats.budget        =resident_budget;
+        stats.resident_bytes=resident_bytes;
+        stats.idle_bytes    =idle_bytes;
+        stats.resident_count=assets.GetCount();
+        stats.idle_count    =(int)idle_list.size();
+        stats.compressed_bytes=compressed_bytes;
+        stats.compressed_count=compressed_assets.GetCount();
+        stats.hit_count     =hit_count;
+        stats.miss_count    =miss_count;
+        stats.eviction_count=eviction_count;
+
+        return stats;
+    }
+
+    void AudioAssetManager::ResetResidencyCounters()
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        hit_count=0;
+        miss_count=0;
+        eviction_count=0;
+    }
+
+    bool AudioAssetManager::SetDecodeWorkerCount(uint count)
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        if(load_pool)return false;                                  // 解码池已启动
+
+        decode_worker_count=count>AUDIO_DECODE_MAX_WORKERS?AUDIO_DECODE_MAX_WORKERS:count;
+        return true;
+    }
+
+    uint AudioAssetManager::GetDecodeWorkerCount()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        if(load_pool)return load_pool->GetWorkerCount();
+
+        return decode_worker_count?decode_worker_count:GetDefaultDecodeWorkerCount();
+    }
+
+    AudioLoadPool *AudioAssetManager::CreateLoadPool()
+    {
+        if(!load_pool)                                              // 懒启动解码池
+            load_pool=new AudioLoadPool(decode_worker_count?decode_worker_count:GetDefaultDecodeWorkerCount(),decode_paused);
+
+        return load_pool;
+    }
+
+    void AudioAssetManager::PauseAsync()
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        decode_paused=true;
+
+        if(load_pool)
+            load_pool->Pause();
+    }
+
+    void AudioAssetManager::ResumeAsync()
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        decode_paused=false;
+
+        if(load_pool)
+            load_pool->Resume();
+    }
+
+    bool AudioAssetManager::IsAsyncPaused()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        return decode_paused;
+    }
+
+    AudioLoadPool *AudioAssetManager::GetLoadPool()const
+    {
+        ThreadMutexLock lock_guard(&lock);
+
+        return load_pool;
     }
 
-    bool AudioAssetManager::AcquireAsync(const os_char *filename)
+    bool AudioAssetManager::AcquireAsync(const os_char *filename,int priority)
     {
         if(!filename||!(*filename))return false;
 
         {
             ThreadMutexLock lock_guard(&lock);
 
-            if(assets.ContainsKey(OSString(filename)))return true;   // 已缓存，无需异步
+            AssetEntry *entry=assets.GetValuePointer(OSString(filename));
+
+            if(entry)                                               // 已缓存，无需异步
+            {
+                if(entry->idle)                                     // 刷新 LRU 位置，近期即将使用
+                    idle_list.splice(idle_list.end(),idle_list,entry->lru_it);
+
+                return true;
+            }
+
+            SoundBank *bank=nullptr;
+            const SoundBankEntry *bank_entry=FindInBanks(OSString(filename),&bank);
+
+            if(bank_entry)
+            {
+                // PCM 负载无需解码，Acquire() 时直接从映射内存上传；压缩负载交给解码池从映射内存解码
+                if(bank_entry->payload_type==uint32(SoundBankPayload::PCM))
+                    return true;
+
+                CreateLoadPool()->Submit(filename,ToAudioFileType(SoundBankPayload(bank_entry->payload_type)),priority,
+                                  bank->GetPayload(bank_entry),int64(bank_entry->size));
+                return true;
+            }
         }
 
         const AudioFileType file_type=CheckAudioFileType(filename);
 
         if(!RangeCheck(file_type))return false;                     // 无法识别类型
 
-        if(!load_thread)                                            // 懒启动后台线程
+        AudioLoadPool *pool;
+
         {
-            load_thread=new AudioLoadThread;
-            load_thread->Start();
+            ThreadMutexLock lock_guard(&lock);
+
+            pool=CreateLoadPool();
         }
 
-        load_thread->Submit(filename,file_type);
+        pool->Submit(filename,file_type,priority);                  // 解码池创建后直到析构不变，提交不占用缓存锁
 
         return true;
     }
 
-    int AudioAssetManager::Update()
+    bool AudioAssetManager::SetAsyncPriority(const os_char *filename,int priority)
+    {
+        if(!filename||!(*filename))return false;
+
+        AudioLoadPool *pool=GetLoadPool();
+
+        return pool&&pool->SetPriority(filename,priority);
+    }
+
+    bool AudioAssetManager::CancelAsync(const os_char *filename)
+    {
+        if(!filename||!(*filename))return false;
+
+        AudioLoadPool *pool=GetLoadPool();
+
+        return pool&&pool->Cancel(filename);
+    }
+
+    int AudioAssetManager::Update(double max_ms,uint64 max_bytes)
     {
-        if(!load_thread)return 0;
+        AudioLoadPool *pool=GetLoadPool();
+
+        if(!pool)return 0;
+
+        const double start_time=(max_ms>0)?GetTimeSec():0;
 
         int completed=0;
+        uint64 frame_bytes=0;
 
         CompletedLoad *item;
 
-        while((item=load_thread->PopDone())!=nullptr)
+        // 每次至少处理一项，保证预算再小也有进展；超出预算的剩余项留到下一帧
+        while((item=pool->PopDone())!=nullptr)
         {
             ++completed;
+            frame_bytes+=GetDecodedBytes(item);
 
             AudioBuffer *buffer=nullptr;
 
@@ -402,31 +1216,67 @@ namespace hgl::audio
             {
                 ThreadMutexLock lock_guard(&lock);
 
-                AudioBuffer *existing=nullptr;
-
-                if(assets.Get(item->filename,existing))             // 同步路径已抢先加载
+                if(assets.ContainsKey(item->filename))              // 同步路径已抢先加载
                 {
                     delete buffer;                                  // 丢弃重复加载
                 }
-                else
+                else if(AddEntry(item->filename,buffer))            // ref=0（预加载，无外部引用，Acquire 时 +1）
                 {
-                    assets.Add(item->filename,buffer);              // ref=0（预加载，无外部引用，Acquire 时 +1）
+                    MarkIdle(item->filename,assets.GetValuePointer(item->filename));
+                    EvictToBudget();
                 }
             }
 
             delete item;
+
+            if(max_bytes>0&&frame_bytes>=max_bytes)break;
+            if(max_ms>0&&(GetTimeSec()-start_time)*1000.0>=max_ms)break;
+        }
+
+        if(completed>0)
+        {
+            ThreadMutexLock lock_guard(&lock);
+
+            upload_stats.total_count+=completed;
+            upload_stats.total_bytes+=frame_bytes;
+            upload_stats.last_count=completed;
+            upload_stats.last_bytes=frame_bytes;
         }
 
         return completed;
     }
 
+    AudioUploadStats AudioAssetManager::GetUploadStats()const
+    {
+        AudioUploadStats stats;
+
+        lock.Lock();
+        stats=upload_stats;
+        AudioLoadPool *pool=load_pool;
+        lock.Unlock();
+
+        if(pool)
+            pool->GetBacklog(stats.backlog_count,stats.backlog_bytes);
+        else
+        {
+            stats.backlog_count=0;
+            stats.backlog_bytes=0;
+        }
+
+        return stats;
+    }
+
     bool AudioAssetManager::IsLoading()const
     {
-        return load_thread && load_thread->HasWork();
+        AudioLoadPool *pool=GetLoadPool();
+
+        return pool && pool->HasWork();
     }
 
     int AudioAssetManager::GetPendingCount()const
     {
-        return load_thread?load_thread->GetTaskCount():0;
+        AudioLoadPool *pool=GetLoadPool();
+
+        return pool?pool->GetTaskCount():0;
     }
 }//namespace hgl::audio
@@ -3,10 +3,13 @@
 #include<hgl/audio/OpenAL.h>
 #include<hgl/audio/AudioBuffer.h>
 #include<hgl/audio/AudioEQ.h>
+#include<hgl/audio/SampleConvert.h>
+#include<hgl/audio/AudioParallelDecode.h>
 #include<hgl/io/FileInputStream.h>
 #include<hgl/io/MemoryInputStream.h>
 #include<hgl/plugin/PlugIn.h>
 #include"AudioDecode.h"
+#include"MappedWAV.h"
 
 #include<vector>
 #include<cstring>
@@ -19,7 +22,7 @@ namespace hgl::audio
 
     const os_char *GetAudioDecodeName(const AudioFileType file_type);
 
-    DecodedAudio *DecodeAudio(AudioFileType file_type,void *memory,int memory_size)
+    DecodedAudio *DecodeAudio(AudioFileType file_type,void *memory,int memory_size,bool allow_parallel)
     {
         const os_char *plugin_name=GetAudioDecodeName(file_type);
 
@@ -37,23 +40,40 @@ namespace hgl::audio
 
         result->use_float=use_float_data;
 
+        // 磁盘缓存：相同源数据 + 插件/设置已解码过时直接映射缓存文件
+        AudioDecodeCacheKey cache_key;
+
+        const bool cacheable=MakeAudioDecodeCacheKey(file_type,plugin_name,memory,memory_size,use_float_data,&cache_key);
+
+        if(cacheable&&LoadAudioDecodeCache(cache_key,result))
+            return result;
+
         ALboolean loop;
 
-        if(use_float_data)
+        // 长 Vorbis/Opus 文件：多线程分段解码，失败时继续走下面的整段顺序解码
+        const bool parallel=allow_parallel
+                          &&(file_type==AudioFileType::Vorbis||file_type==AudioFileType::Opus)
+                          &&DecodeAudioParallel(plugin_name,result,memory,memory_size,use_float_data,
+                                                file_type==AudioFileType::Opus?AUDIO_PARALLEL_DECODE_OPUS_PREROLL_SECONDS:0);
+
+        if(!parallel)
         {
-            result->decode_float.Load((ALbyte *)memory,memory_size,&result->format,(float **)&result->data,&result->size,&result->freq,&loop);
+            if(use_float_data)
+            {
+                result->decode_float.Load((ALbyte *)memory,memory_size,&result->format,(float **)&result->data,&result->size,&result->freq,&loop);
 
-            // 浮点解码失败(例如多声道浮点格式不受OpenAL支持)时，回退到16位解码
-            if(result->format==0||result->data==nullptr||result->size<=0)
+                // 浮点解码失败(例如多声道浮点格式不受OpenAL支持)时，回退到16位解码
+                if(result->format==0||result->data==nullptr||result->size<=0)
+                {
+                    result->use_float=false;
+                    result->decode.Load((ALbyte *)memory,memory_size,&result->format,&result->data,&result->size,&result->freq,&loop);
+                }
+            }
+            else
             {
-                result->use_float=false;
                 result->decode.Load((ALbyte *)memory,memory_size,&result->format,&result->data,&result->size,&result->freq,&loop);
             }
         }
-        else
-        {
-            result->decode.Load((ALbyte *)memory,memory_size,&result->format,&result->data,&result->size,&result->freq,&loop);
-        }
 
         if(result->format==0||result->data==nullptr||result->size<=0)
         {
@@ -64,6 +84,9 @@ namespace hgl::audio
 
         result->duration=AudioDataTime(result->size,result->format,result->freq);
 
+        if(cacheable)
+            StoreAudioDecodeCache(cache_key,result);
+
         return result;
     }
 
@@ -71,6 +94,20 @@ namespace hgl::audio
     {
         if(!data)return;
 
+        if(mapped)                          // 磁盘缓存映射：解除映射即可
+        {
+            SAFE_CLEAR(mapped);
+            data=nullptr;
+            return;
+        }
+
+        if(host_owned)                      // 并行分段解码的输出由本模块分配
+        {
+            delete[] (char *)data;
+            data=nullptr;
+            return;
+        }
+
         if(use_float)
             decode_float.Clear(format,data,size,freq);
         else
@@ -235,6 +272,8 @@ namespace hgl::audio
             const double dec_duration=decoded->duration;
 
             // 应用 buffer 级 EQ（P2：解码后、上传前，EFX 缺失兜底）
+            std::vector<char> eq_data;
+
             if(eq.GetBandCount() > 0)
             {
                 AudioDataInfo eq_info;
@@ -244,6 +283,12 @@ namespace hgl::audio
                     eq_info.sample_rate = decoded->freq;
                     eq_info.data_size   = decoded->size;
 
+                    if(decoded->mapped)     // 磁盘缓存映射为只读，复制后处理（Release 只解除映射，不释放 data）
+                    {
+                        eq_data.assign((char *)decoded->data, (char *)decoded->data + decoded->size);
+                        decoded->data = eq_data.data();
+                    }
+
                     ApplyEQToPCM(decoded->data, decoded->size, eq_info, eq);
                 }
             }
@@ -317,11 +362,76 @@ namespace hgl::audio
             RETURN_FALSE;
         }
 
+        if(file_type==AudioFileType::Wav&&LoadMappedWAV(filename))       //PCM WAV 走内存映射，不支持的格式回退到解码插件
+            return(true);
+
         OpenFileInputStream file_stream(filename);
 
         RETURN_BOOL(Load(file_stream,file_stream->Available(),file_type));
     }
 
+    /**
+    * 以内存映射方式加载 PCM WAV
+    * 原地解析 fmt/data 块：8/16 位整数（及设备支持 AL_EXT_FLOAT32 时的单/双声道 float）直接把映射内的指针交给 alBufferData，
+    * 24/32 位整数转换到一份 float（或 int16）缓冲区后上传，加载期间最多只有一份 PCM 副本
+    * @param filename 音频文件名称
+    * @return 是否加载成功（格式不支持时返回 false，由调用方回退到解码插件）
+    */
+    bool AudioBuffer::LoadMappedWAV(const os_char *filename)
+    {
+        MappedFile file;
+
+        if(!file.Open(filename))
+            return(false);
+
+        WAVDataView wav;
+
+        if(!ParseWAVData(file.GetData(),file.GetSize(),wav))
+            return(false);
+
+        const AudioDataInfo &src=wav.info;
+        const bool float_out=IsSupportFloatAudioData()&&src.channels<=2;
+
+        if((!src.is_float&&src.bits_per_sample<=16)||(src.is_float&&float_out))
+            return SetData(src,wav.pcm);                                    //零拷贝：直接从映射上传
+
+        AudioDataInfo dst=src;
+
+        dst.bits_per_sample=float_out?32:16;
+        dst.is_float=float_out;
+
+        const uint sample_count=src.data_size/(src.bits_per_sample/8);
+
+        dst.data_size=sample_count*(dst.bits_per_sample/8);
+
+        std::vector<char> converted(dst.data_size);
+
+        if(float_out)
+        {
+            SampleToFloat(wav.pcm,(float *)converted.data(),sample_count,src);
+        }
+        else
+        {
+            constexpr uint CONVERT_CHUNK_SAMPLES=16384;
+
+            std::vector<float> scratch(CONVERT_CHUNK_SAMPLES);
+
+            const uint8 *in=(const uint8 *)wav.pcm;
+            int16 *out=(int16 *)converted.data();
+            const uint src_bytes=src.bits_per_sample/8;
+
+            for(uint pos=0;pos<sample_count;pos+=CONVERT_CHUNK_SAMPLES)
+            {
+                const uint count=(sample_count-pos<CONVERT_CHUNK_SAMPLES)?sample_count-pos:CONVERT_CHUNK_SAMPLES;
+
+                SampleToFloat(in+size_t(pos)*src_bytes,scratch.data(),count,src);
+                FloatToSample(scratch.data(),out+pos,count,dst);
+            }
+        }
+
+        return SetData(dst,converted.data());
+    }
+
 //     /**
 //     * 加载一个音频文件到当前缓冲区，仅支持OGG和WAV。注：由于这个函数会一次性将音频数据载入内存，所以较长的音乐请使用CreateAudioPlayer，以免占用太多的内存。
 //     * @param filename 音频文件名称
@@ -0,0 +1,91 @@
+﻿#include"AudioChainStream.h"
+#include<hgl/log/Log.h>
+#include"MappedWAV.h"
+
+namespace hgl::audio
+{
+    const os_char *GetAudioDecodeName(const AudioFileType aft);
+
+    bool AudioChainStream::Open(const os_char *filename,AudioFileType aft,bool use_float)
+    {
+        Close();
+
+        if(!filename||!(*filename))return(false);
+
+        if(!RangeCheck(aft))
+            aft=CheckAudioFileType(filename);
+
+        const os_char *plugin_name=GetAudioDecodeName(aft);
+
+        if(!plugin_name)return(false);
+
+        if(!MapAudioFile(filename,&mapped_file,&audio_data,&audio_data_size)
+         &&!ReadAudioFile(filename,&audio_data,&audio_data_size))
+            return(false);
+
+        if(!CreateAudioDecoder(plugin_name,use_float,&decoder,&float_decoder,&seeker)
+         ||(use_float&&!float_decoder))                         //输出格式须与播放器一致
+        {
+            LogError(OS_TEXT("无法加载接续用的音频解码插件：")+OSString(plugin_name));
+
+            Close();
+            return(false);
+        }
+
+        audio_ptr=decoder->Open(audio_data,audio_data_size,&al_format,&sample_rate,&total_time);
+
+        if(!audio_ptr)
+        {
+            LogError(OS_TEXT("音频解码插件无法打开数据：")+OSString(filename));
+
+            Close();
+            return(false);
+        }
+
+        if(use_float)
+        {
+            al_format=GetFloatDecodeFormat(al_format);
+
+            if(!al_format)
+            {
+                Close();
+                return(false);
+            }
+        }
+
+        return(true);
+    }
+
+    void AudioChainStream::Close()
+    {
+        if(decoder&&audio_ptr)
+            decoder->Close(audio_ptr);
+
+        audio_ptr=nullptr;
+
+        SAFE_CLEAR(input_stream);           //解码器关闭后才能释放数据源
+
+        if(mapped_file)
+        {
+            SAFE_CLEAR(mapped_file);
+            audio_data=nullptr;
+        }
+        else
+            SAFE_CLEAR_ARRAY(audio_data);
+
+        audio_data_size=0;
+
+        SAFE_CLEAR(decoder);
+        SAFE_CLEAR(float_decoder);
+        SAFE_CLEAR(seeker);
+
+        al_format=0;
+        sample_rate=0;
+        total_time=0;
+    }
+
+    uint AudioChainStream::Read(char *data,uint size)
+    {
+        return ReadAudioDecoder(decoder,float_decoder,audio_ptr,data,size);
+    }
+}//namespace hgl::audio
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include"AudioDecode.h"
+
+namespace hgl::audio
+{
+    /**
+    * AudioPlayer 接续/交叉淡化用的第二路解码流
+    *
+    * 字段与 AudioPlayer 自身的数据源一一对应：接续时两者整体交换，再由本对象关闭原来的数据源。
+    * Open() 在调用线程完成文件映射与插件打开，播放线程只调用 Read()。
+    */
+    struct AudioChainStream
+    {
+        ALbyte *audio_data=nullptr;
+        int audio_data_size=0;
+        MappedFile *mapped_file=nullptr;                    ///<非空时 audio_data 指向此映射
+        AudioReadAheadStream *input_stream=nullptr;         ///<仅在与流式加载的播放器交换后非空
+
+        void *audio_ptr=nullptr;
+
+        AudioPlugInInterface *decoder=nullptr;
+        AudioFloatPlugInInterface *float_decoder=nullptr;
+        AudioSeekPlugInInterface *seeker=nullptr;
+
+        ALenum al_format=0;
+        ALsizei sample_rate=0;
+        double total_time=0;
+
+    public:
+
+        AudioChainStream()=default;
+        ~AudioChainStream(){Close();}
+
+        AudioChainStream(const AudioChainStream &)=delete;
+        AudioChainStream &operator=(const AudioChainStream &)=delete;
+
+        /**
+        * 打开一个音频文件
+        * @param filename 文件名
+        * @param aft 文件类型（None=按扩展名识别）
+        * @param use_float 是否按 float32 输出（须与播放器一致，插件不支持浮点读取时失败）
+        */
+        bool Open(const os_char *filename,AudioFileType aft,bool use_float);
+        void Close();
+
+        uint Read(char *data,uint size);                    ///<尽量读满 size 字节，返回实际字节数，0 为结束
+    };//struct AudioChainStream
+}//namespace hgl::audio
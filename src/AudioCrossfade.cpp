@@ -0,0 +1,202 @@
+﻿#include<hgl/audio/AudioCrossfade.h>
+#include<hgl/audio/SampleConvert.h>
+
+#if defined(_M_X64)||defined(__x86_64__)||defined(_M_IX86)||defined(__i386__)
+    #define HGL_CROSSFADE_X86
+    #include<immintrin.h>
+#elif defined(__ARM_NEON)||defined(__ARM_NEON__)||defined(_M_ARM64)
+    #define HGL_CROSSFADE_NEON
+    #include<arm_neon.h>
+#endif
+
+// 与 SampleConvert.cpp 相同：GCC/Clang 按函数开启指令集
+#if defined(__GNUC__)||defined(__clang__)
+    #define HGL_TARGET_SSE2 __attribute__((target("sse2")))
+    #define HGL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define HGL_TARGET_SSE2
+    #define HGL_TARGET_AVX2
+#endif
+
+namespace hgl::audio
+{
+    namespace
+    {
+        constexpr float HALF_PI=1.57079632679489661923f;
+
+        // sin(x) 在 [0,π/2] 上的泰勒展开到 x^9：x×(1+x²×(S3+x²×(S5+x²×(S7+x²×S9))))
+        constexpr float S3=-1.0f/6.0f;
+        constexpr float S5= 1.0f/120.0f;
+        constexpr float S7=-1.0f/5040.0f;
+        constexpr float S9= 1.0f/362880.0f;
+
+        constexpr uint CHUNK_SAMPLES=256;           ///<每次展开淡化位置的采样数
+
+        inline float SinQuarter(float x)
+        {
+            const float x2=x*x;
+
+            return x*(1.0f+x2*(S3+x2*(S5+x2*(S7+x2*S9))));
+        }
+
+        //--------------------------------------------------------------------------------------------------
+        // 混合内核：pos 为逐采样的淡化位置（已钳位），count 为采样数
+        //--------------------------------------------------------------------------------------------------
+
+        void MixScalar(const float *from,const float *to,const float *pos,float *out,uint count)
+        {
+            for(uint i=0;i<count;i++)
+            {
+                const float a=SinQuarter((1.0f-pos[i])*HALF_PI);
+                const float b=SinQuarter(pos[i]*HALF_PI);
+
+                out[i]=from[i]*a+to[i]*b;
+            }
+        }
+
+#ifdef HGL_CROSSFADE_X86
+        HGL_TARGET_SSE2 inline __m128 SinQuarterSSE2(__m128 x)
+        {
+            const __m128 x2=_mm_mul_ps(x,x);
+
+            __m128 p=_mm_add_ps(_mm_set1_ps(S7),_mm_mul_ps(x2,_mm_set1_ps(S9)));
+            p=_mm_add_ps(_mm_set1_ps(S5),_mm_mul_ps(x2,p));
+            p=_mm_add_ps(_mm_set1_ps(S3),_mm_mul_ps(x2,p));
+            p=_mm_add_ps(_mm_set1_ps(1.0f),_mm_mul_ps(x2,p));
+
+            return _mm_mul_ps(x,p);
+        }
+
+        HGL_TARGET_SSE2 void MixSSE2(const float *from,const float *to,const float *pos,float *out,uint count)
+        {
+            const __m128 one=_mm_set1_ps(1.0f);
+            const __m128 k=_mm_set1_ps(HALF_PI);
+            uint i=0;
+
+            for(;i+4<=count;i+=4)
+            {
+                const __m128 t=_mm_loadu_ps(pos+i);
+                const __m128 a=SinQuarterSSE2(_mm_mul_ps(_mm_sub_ps(one,t),k));
+                const __m128 b=SinQuarterSSE2(_mm_mul_ps(t,k));
+
+                _mm_storeu_ps(out+i,_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(from+i),a),_mm_mul_ps(_mm_loadu_ps(to+i),b)));
+            }
+
+            MixScalar(from+i,to+i,pos+i,out+i,count-i);
+        }
+
+        HGL_TARGET_AVX2 inline __m256 SinQuarterAVX2(__m256 x)
+        {
+            const __m256 x2=_mm256_mul_ps(x,x);
+
+            __m256 p=_mm256_add_ps(_mm256_set1_ps(S7),_mm256_mul_ps(x2,_mm256_set1_ps(S9)));
+            p=_mm256_add_ps(_mm256_set1_ps(S5),_mm256_mul_ps(x2,p));
+            p=_mm256_add_ps(_mm256_set1_ps(S3),_mm256_mul_ps(x2,p));
+            p=_mm256_add_ps(_mm256_set1_ps(1.0f),_mm256_mul_ps(x2,p));
+
+            return _mm256_mul_ps(x,p);
+        }
+
+        HGL_TARGET_AVX2 void MixAVX2(const float *from,const float *to,const float *pos,float *out,uint count)
+        {
+            const __m256 one=_mm256_set1_ps(1.0f);
+            const __m256 k=_mm256_set1_ps(HALF_PI);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                const __m256 t=_mm256_loadu_ps(pos+i);
+                const __m256 a=SinQuarterAVX2(_mm256_mul_ps(_mm256_sub_ps(one,t),k));
+                const __m256 b=SinQuarterAVX2(_mm256_mul_ps(t,k));
+
+                _mm256_storeu_ps(out+i,_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(from+i),a),_mm256_mul_ps(_mm256_loadu_ps(to+i),b)));
+            }
+
+            MixScalar(from+i,to+i,pos+i,out+i,count-i);
+        }
+#endif//HGL_CROSSFADE_X86
+
+#ifdef HGL_CROSSFADE_NEON
+        inline float32x4_t SinQuarterNEON(float32x4_t x)
+        {
+            const float32x4_t x2=vmulq_f32(x,x);
+
+            float32x4_t p=vmlaq_f32(vdupq_n_f32(S7),x2,vdupq_n_f32(S9));
+            p=vmlaq_f32(vdupq_n_f32(S5),x2,p);
+            p=vmlaq_f32(vdupq_n_f32(S3),x2,p);
+            p=vmlaq_f32(vdupq_n_f32(1.0f),x2,p);
+
+            return vmulq_f32(x,p);
+        }
+
+        void MixNEON(const float *from,const float *to,const float *pos,float *out,uint count)
+        {
+            const float32x4_t one=vdupq_n_f32(1.0f);
+            const float32x4_t k=vdupq_n_f32(HALF_PI);
+            uint i=0;
+
+            for(;i+4<=count;i+=4)
+            {
+                const float32x4_t t=vld1q_f32(pos+i);
+                const float32x4_t a=SinQuarterNEON(vmulq_f32(vsubq_f32(one,t),k));
+                const float32x4_t b=SinQuarterNEON(vmulq_f32(t,k));
+
+                vst1q_f32(out+i,vmlaq_f32(vmulq_f32(vld1q_f32(from+i),a),vld1q_f32(to+i),b));
+            }
+
+            MixScalar(from+i,to+i,pos+i,out+i,count-i);
+        }
+#endif//HGL_CROSSFADE_NEON
+
+        using MixFunc=void(*)(const float *,const float *,const float *,float *,uint);
+
+        MixFunc GetMixKernel()
+        {
+            switch(GetSampleConvertPath())                  // 与采样格式转换共用 CPU 检测/强制路径
+            {
+#ifdef HGL_CROSSFADE_X86
+                case SampleConvertPath::SSE2:   return MixSSE2;
+                case SampleConvertPath::AVX2:   return MixAVX2;
+#endif//HGL_CROSSFADE_X86
+#ifdef HGL_CROSSFADE_NEON
+                case SampleConvertPath::NEON:   return MixNEON;
+#endif//HGL_CROSSFADE_NEON
+                default:                        return MixScalar;
+            }
+        }
+    }//namespace
+
+    void CrossfadeEqualPower(const float *from,const float *to,float *output,uint frames,uint channels,float start,float step)
+    {
+        if(!from||!to||!output||frames==0||channels==0||channels>CHUNK_SAMPLES)
+            return;
+
+        const MixFunc mix=GetMixKernel();
+        const uint chunk_frames=CHUNK_SAMPLES/channels;
+
+        float pos[CHUNK_SAMPLES];
+
+        for(uint frame=0;frame<frames;)
+        {
+            const uint count=(frames-frame<chunk_frames)?frames-frame:chunk_frames;
+
+            // 逐帧位置展开到各声道，之后的 cos/sin 与混合全部按采样向量化
+            for(uint i=0;i<count;i++)
+            {
+                float t=start+float(frame+i)*step;
+
+                if(t<0.0f)t=0.0f;
+                if(t>1.0f)t=1.0f;
+
+                for(uint ch=0;ch<channels;ch++)
+                    pos[i*channels+ch]=t;
+            }
+
+            const size_t offset=size_t(frame)*channels;
+
+            mix(from+offset,to+offset,pos,output+offset,count*channels);
+
+            frame+=count;
+        }
+    }
+}//namespace hgl::audio
@@ -3,6 +3,22 @@
 #include<hgl/plugin/PlugInInterface.h>
 #include<hgl/filesystem/FileSystem.h>
 #include<hgl/type/UnorderedMap.h>
+#include<hgl/io/InputStream.h>
+#include<hgl/thread/ThreadMutex.h>
+#include<hgl/type/StdString.h>
+#include<hgl/audio/AudioPlugInManifest.h>
+#include<hgl/io/FileInputStream.h>
+#include<hgl/utf.h>
+#include"MappedWAV.h"
+#include<climits>
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<algorithm>
+#include<filesystem>
+#include<fstream>
+#include<sstream>
+#include<string>
 
 using namespace openal;
 namespace hgl::audio
@@ -13,25 +29,296 @@ namespace hgl::audio
 
         UnorderedMap<AnsiString,OSString> audio_ext_map;       ///<扩展名(小写)→插件名 动态映射缓存
         bool audio_ext_map_built=false;
+        ThreadMutex audio_ext_map_lock;                         ///<解码池多个线程可能同时首次查询
+
+        OSString plugin_manifest_filename;                      ///<插件能力清单文件（空=不使用清单）
+        OSString plugin_manifest_path;                          ///<插件目录
+
+        constexpr int AUDIO_PLUGIN_MANIFEST_VERSION=1;
+
+        /**
+        * 插件文件指纹
+        */
+        struct PlugInFileStamp
+        {
+            std::string file;                                   ///<文件名（UTF-8，不含路径）
+            uint64 size;
+            int64 mtime;
+        };
+
+        /**
+        * 清单中的一个插件：插件名 + 对应文件指纹 + 上报的扩展名
+        */
+        struct PlugInManifestRecord
+        {
+            std::string name;                                   ///<插件名（UTF-8）
+            PlugInFileStamp stamp;                              ///<file 为空表示未能对应到插件文件
+            std::vector<std::string> extensions;
+        };
+
+        std::string ToUTF8(const OSString &str)
+        {
+            const U8String u8=ToU8String(str);
+
+            return std::string((const char *)u8.c_str());
+        }
+
+        /**
+        * 列出插件目录中的音频插件文件（文件名含 "Audio."，如 CMP.Audio.Opus）并按文件名排序
+        */
+        std::vector<PlugInFileStamp> ScanPlugInFiles(const OSString &path)
+        {
+            namespace fs=std::filesystem;
+
+            std::vector<PlugInFileStamp> files;
+
+            std::error_code ec;
+            fs::directory_iterator it(fs::path(path.c_str()),ec),end;
+
+            for(;!ec&&it!=end;it.increment(ec))
+            {
+                std::error_code entry_ec;
+
+                if(!it->is_regular_file(entry_ec))continue;
+
+                const std::string file=ToUTF8(OSString(it->path().filename().c_str()));
+
+                if(file.find("Audio.")==std::string::npos)continue;
+
+                PlugInFileStamp stamp;
+
+                stamp.file=file;
+                stamp.size=it->file_size(entry_ec);
+                stamp.mtime=int64(it->last_write_time(entry_ec).time_since_epoch().count());
+
+                if(!entry_ec)
+                    files.push_back(stamp);
+            }
+
+            std::sort(files.begin(),files.end(),[](const PlugInFileStamp &a,const PlugInFileStamp &b){return a.file<b.file;});
+
+            return files;
+        }
+
+        /**
+        * 按命名约定找到插件名对应的文件：去掉扩展名后以 "Audio.<name>" 结尾
+        */
+        const PlugInFileStamp *FindPlugInFile(const std::vector<PlugInFileStamp> &files,const std::string &name)
+        {
+            const std::string suffix="Audio."+name;
+
+            for(const PlugInFileStamp &stamp:files)
+            {
+                const size_t dot=stamp.file.rfind('.');
+                const std::string stem=(dot==std::string::npos||dot<suffix.size())?stamp.file:stamp.file.substr(0,dot);
+
+                if(stem.size()>=suffix.size()
+                 &&stem.compare(stem.size()-suffix.size(),suffix.size(),suffix)==0)
+                    return &stamp;
+            }
+
+            return nullptr;
+        }
 
         /**
-         * 通过扫描并探测音频插件,依据插件上报的 FileExtensions 能力建立"扩展名→插件名"映射。
-         * 仅在首次需要时构建,之后直接复用缓存。
-         */
+        * 清单格式（UTF-8 文本，一行一个插件）：
+        *   version=1
+        *   plugin=名称|文件名|字节数|修改时间|扩展名,扩展名
+        */
+        bool LoadPlugInManifest(const OSString &filename,std::vector<PlugInManifestRecord> &records)
+        {
+            std::ifstream in(std::filesystem::path(filename.c_str()));
+
+            if(!in)return(false);
+
+            std::string line;
+            bool version_ok=false;
+
+            while(std::getline(in,line))
+            {
+                if(!line.empty()&&line.back()=='\r')
+                    line.pop_back();
+
+                if(line.empty()||line[0]=='#')continue;
+
+                if(line.compare(0,8,"version=")==0)
+                {
+                    version_ok=(std::atoi(line.c_str()+8)==AUDIO_PLUGIN_MANIFEST_VERSION);
+                    continue;
+                }
+
+                if(line.compare(0,7,"plugin=")!=0)continue;
+
+                std::vector<std::string> fields;
+                std::stringstream ss(line.substr(7));
+                std::string field;
+
+                while(std::getline(ss,field,'|'))
+                    fields.push_back(field);
+
+                if(fields.size()<4||fields[0].empty())
+                    return(false);
+
+                PlugInManifestRecord record;
+
+                record.name=fields[0];
+                record.stamp.file=fields[1];
+                record.stamp.size=std::strtoull(fields[2].c_str(),nullptr,10);
+                record.stamp.mtime=std::strtoll(fields[3].c_str(),nullptr,10);
+
+                if(fields.size()>4)
+                {
+                    std::stringstream es(fields[4]);
+                    std::string ext;
+
+                    while(std::getline(es,ext,','))
+                        if(!ext.empty())
+                            record.extensions.push_back(ext);
+                }
+
+                records.push_back(record);
+            }
+
+            return version_ok;
+        }
+
+        void SavePlugInManifest(const OSString &filename,const std::vector<PlugInManifestRecord> &records)
+        {
+            namespace fs=std::filesystem;
+
+            const fs::path target(filename.c_str());
+            const fs::path temp=GetUniqueTempFilename(target);     // 并发启动的进程各写各的临时文件
+
+            {
+                std::ofstream out(temp,std::ios::trunc);
+
+                if(!out)return;
+
+                out<<"# CMAudio audio plug-in manifest (generated)\n";
+                out<<"version="<<AUDIO_PLUGIN_MANIFEST_VERSION<<"\n";
+
+                for(const PlugInManifestRecord &record:records)
+                {
+                    out<<"plugin="<<record.name<<'|'<<record.stamp.file<<'|'<<record.stamp.size<<'|'<<record.stamp.mtime<<'|';
+
+                    for(size_t i=0;i<record.extensions.size();i++)
+                        out<<(i?",":"")<<record.extensions[i];
+
+                    out<<"\n";
+                }
+            }
+
+            std::error_code ec;
+
+            fs::rename(temp,target,ec);         // 原子替换，并发启动的进程不会读到半个清单
+
+            if(ec)
+                fs::remove(temp,ec);
+        }
+
+        /**
+        * 用清单建立映射：全部插件文件都有指纹一致的记录时成功；只有插件被删除时去掉对应记录
+        * @param changed 返回清单是否需要重写
+        */
+        bool BuildFromManifest(const std::vector<PlugInFileStamp> &files,std::vector<PlugInManifestRecord> &records,bool *changed)
+        {
+            *changed=false;
+
+            for(const PlugInManifestRecord &record:records)     // 有插件未能对应到文件，无法判断是否变化
+                if(record.stamp.file.empty())
+                    return(false);
+
+            for(const PlugInFileStamp &stamp:files)             // 新增或改动的插件文件：需要重新探测
+            {
+                bool found=false;
+
+                for(const PlugInManifestRecord &record:records)
+                    if(record.stamp.file==stamp.file
+                     &&record.stamp.size==stamp.size
+                     &&record.stamp.mtime==stamp.mtime)
+                    {
+                        found=true;
+                        break;
+                    }
+
+                if(!found)
+                    return(false);
+            }
+
+            // 文件已不存在的插件：直接去掉（无需加载任何插件）
+            const auto removed=std::remove_if(records.begin(),records.end(),[&files](const PlugInManifestRecord &record)
+            {
+                for(const PlugInFileStamp &stamp:files)
+                    if(stamp.file==record.stamp.file)
+                        return false;
+
+                return true;
+            });
+
+            if(removed!=records.end())
+            {
+                records.erase(removed,records.end());
+                *changed=true;
+            }
+
+            for(const PlugInManifestRecord &record:records)
+                for(const std::string &ext:record.extensions)
+                    audio_ext_map.Add(AnsiString(ext.c_str()).ToLowerCase(),ToOSString(record.name));
+
+            return(true);
+        }
+
+        /**
+        * 建立"扩展名→插件名"映射，仅在首次需要时构建，之后直接复用缓存。
+        * 启用清单且插件文件未变化时由清单构建，不加载插件；否则扫描并探测全部音频插件，
+        * 依据插件上报的 FileExtensions 能力建立映射（启用清单时随后写入清单）。
+        */
         void BuildAudioExtensionMap()
         {
+            ThreadMutexLock lock_guard(&audio_ext_map_lock);
+
             if(audio_ext_map_built)return;
             audio_ext_map_built=true;
 
+            const bool use_manifest=!plugin_manifest_filename.IsEmpty();
+
+            std::vector<PlugInFileStamp> files;
+
+            if(use_manifest)
+            {
+                files=ScanPlugInFiles(plugin_manifest_path);
+
+                std::vector<PlugInManifestRecord> records;
+                bool changed;
+
+                if(!files.empty()
+                 &&LoadPlugInManifest(plugin_manifest_filename,records)
+                 &&BuildFromManifest(files,records,&changed))
+                {
+                    if(changed)
+                        SavePlugInManifest(plugin_manifest_filename,records);
+
+                    return;
+                }
+
+                audio_ext_map.Clear();
+            }
+
             ManagedArray<PlugInInfo> infos;
             audio_plug_in.ScanAndProbe(infos);
 
+            std::vector<PlugInManifestRecord> records;
+
             const int count=infos.GetCount();
             for(int i=0;i<count;i++)
             {
                 const PlugInInfo *info=infos[i];
                 if(!info)continue;
 
+                PlugInManifestRecord record;
+
+                record.name=ToUTF8(info->name);
+
                 const int ec=info->extensions.GetCount();
                 for(int e=0;e<ec;e++)
                 {
@@ -39,11 +326,51 @@ namespace hgl::audio
                     if(ext.IsEmpty())continue;
 
                     audio_ext_map.Add(ext.ToLowerCase(),info->name);
+                    record.extensions.push_back(ext.c_str());
                 }
+
+                if(!use_manifest)continue;
+
+                const PlugInFileStamp *stamp=FindPlugInFile(files,record.name);
+
+                if(stamp)
+                    record.stamp=*stamp;
+                else
+                    record.stamp={std::string(),0,0};           // 对应不到文件：下次比对时视为变化，重新探测
+
+                records.push_back(record);
             }
+
+            if(use_manifest)
+                SavePlugInManifest(plugin_manifest_filename,records);
         }
     }
 
+    bool SetAudioPlugInManifest(const os_char *manifest_filename,const os_char *plugin_path)
+    {
+        if(!manifest_filename||!(*manifest_filename))
+            return(false);
+
+        ThreadMutexLock lock_guard(&audio_ext_map_lock);
+
+        if(audio_ext_map_built)
+            return(false);
+
+        plugin_manifest_filename=manifest_filename;
+
+        if(plugin_path&&*plugin_path)
+        {
+            plugin_manifest_path=plugin_path;
+        }
+        else
+        {
+            filesystem::GetCurrentPath(plugin_manifest_path);
+            plugin_manifest_path=filesystem::JoinPathWithFilename(plugin_manifest_path,OS_TEXT("Plug-Ins"));
+        }
+
+        return(true);
+    }
+
     const OSString *GetAudioPluginNameByExtension(const char *ext_name)
     {
         if(!ext_name||!(*ext_name))return nullptr;
@@ -87,6 +414,292 @@ namespace hgl::audio
         return pi->GetInterface(5,acpi);
     }
 
+    bool GetAudioSeekInterface(const OSString &name,AudioSeekPlugInInterface *asi)
+    {
+        if(!asi)
+            return(false);
+
+        PlugIn *pi=audio_plug_in.LoadPlugin(name);
+
+        if(!pi)
+            return(false);
+
+        return pi->GetInterface(6,asi);
+    }
+
+    bool GetAudioStreamInterface(const OSString &name,AudioStreamPlugInInterface *asi)
+    {
+        if(!asi)
+            return(false);
+
+        PlugIn *pi=audio_plug_in.LoadPlugin(name);
+
+        if(!pi)
+            return(false);
+
+        return pi->GetInterface(7,asi);
+    }
+
+    bool MapAudioFile(const os_char *filename,MappedFile **mapped_file,ALbyte **data,int *size)
+    {
+        MappedFile *mf=new MappedFile;
+
+        if(!mf->Open(filename)||mf->GetSize()>uint64(INT_MAX))
+        {
+            delete mf;
+            return(false);
+        }
+
+        *mapped_file=mf;
+        *data=(ALbyte *)mf->GetData();          //插件只读
+        *size=int(mf->GetSize());
+        return(true);
+    }
+
+    bool ReadAudioFile(const os_char *filename,ALbyte **data,int *size)
+    {
+        io::OpenFileInputStream file_stream(filename);
+
+        if(!file_stream)return(false);
+
+        const int64 file_size=file_stream->Available();
+
+        if(file_size<=0||file_size>INT_MAX)return(false);
+
+        ALbyte *memory=new ALbyte[file_size];
+
+        if(file_stream->Read(memory,file_size)!=file_size)
+        {
+            delete[] memory;
+            return(false);
+        }
+
+        *data=memory;
+        *size=int(file_size);
+        return(true);
+    }
+
+    bool CreateAudioDecoder(const os_char *plugin_name,bool want_float,AudioPlugInInterface **decoder,AudioFloatPlugInInterface **float_decoder,AudioSeekPlugInInterface **seeker)
+    {
+        AudioPlugInInterface *api=new AudioPlugInInterface;
+        AudioFloatPlugInInterface *afpi=want_float?new AudioFloatPlugInInterface{}:nullptr;
+
+        if(!GetAudioInterface(plugin_name,api,afpi)||!api->Open)
+        {
+            delete api;
+            delete afpi;
+
+            *decoder=nullptr;
+            *float_decoder=nullptr;
+            *seeker=nullptr;
+            return(false);
+        }
+
+        if(afpi&&!afpi->Read)                   //插件没有浮点流式读取
+            SAFE_CLEAR(afpi);
+
+        AudioSeekPlugInInterface *asi=new AudioSeekPlugInInterface;
+
+        if(!GetAudioSeekInterface(plugin_name,asi))             //定位为可选能力
+            SAFE_CLEAR(asi);
+
+        *decoder=api;
+        *float_decoder=afpi;
+        *seeker=asi;
+        return(true);
+    }
+
+    ALenum GetFloatDecodeFormat(ALenum format)
+    {
+        AudioDataInfo info;
+
+        if(!FromOpenALFormat(format,info)||info.channels>2)
+            return(0);
+
+        info.bits_per_sample=32;
+        info.is_float=true;
+
+        return ToOpenALFormat(info);
+    }
+
+    uint ReadAudioDecoder(AudioPlugInInterface *decoder,AudioFloatPlugInInterface *float_decoder,void *audio_ptr,char *data,uint size)
+    {
+        if(!decoder||!audio_ptr)return(0);
+
+        uint total=0;
+
+        while(total<size)                       //插件单次可能只返回一部分，读满才能准确定位接续点
+        {
+            const uint n=float_decoder?float_decoder->Read(audio_ptr,(float *)(data+total),size-total)
+                                      :decoder->Read(audio_ptr,data+total,size-total);
+
+            if(!n)break;
+
+            total+=n;
+        }
+
+        return(total);
+    }
+
+    AudioReadAheadStream::AudioReadAheadStream(io::InputStream *is,bool own)
+    {
+        stream=is;
+        owned=own;
+
+        buffer.resize(READ_AHEAD_SIZE);
+        buffer_start=stream?stream->Tell():0;
+        buffer_length=0;
+        buffer_offset=0;
+
+        stream_size=stream?stream->GetSize():-1;
+
+        if(buffer_start<0)buffer_start=0;
+    }
+
+    AudioReadAheadStream::~AudioReadAheadStream()
+    {
+        if(owned)
+            delete stream;
+    }
+
+    bool AudioReadAheadStream::CanSeek()const
+    {
+        return stream&&stream->CanSeek();
+    }
+
+    /**
+    * 从 position 开始重新填充预读缓冲区
+    */
+    bool AudioReadAheadStream::Fill(int64 position)
+    {
+        if(position!=buffer_start+buffer_length)            //不连续：需要流定位
+        {
+            if(!CanSeek())
+                return(false);
+
+            if(stream->Seek(position,io::SeekOrigin::Begin)!=position)
+                return(false);
+        }
+
+        const int64 got=stream->Read(buffer.data(),READ_AHEAD_SIZE);
+
+        buffer_start=position;
+        buffer_length=(got>0)?got:0;
+        buffer_offset=0;
+
+        return(buffer_length>0);
+    }
+
+    size_t AudioReadAheadStream::Read(void *data,size_t size)
+    {
+        if(!stream||!data||size==0)
+            return(0);
+
+        char *out=(char *)data;
+        size_t total=0;
+
+        while(total<size)
+        {
+            if(buffer_offset>=buffer_length)
+            {
+                const int64 position=buffer_start+buffer_offset;
+
+                // 大块读取直接读入目标，不经预读缓冲
+                if(size-total>=READ_AHEAD_SIZE&&position==buffer_start+buffer_length)
+                {
+                    const int64 got=stream->Read(out+total,int64(size-total));
+
+                    if(got<=0)break;
+
+                    total+=size_t(got);
+                    buffer_start=position+got;
+                    buffer_length=0;
+                    buffer_offset=0;
+                    continue;
+                }
+
+                if(!Fill(position))
+                    break;
+            }
+
+            const size_t n=(size_t)std::min<int64>(buffer_length-buffer_offset,int64(size-total));
+
+            memcpy(out+total,buffer.data()+buffer_offset,n);
+
+            buffer_offset+=n;
+            total+=n;
+        }
+
+        return total;
+    }
+
+    int AudioReadAheadStream::Seek(int64 offset,int whence)
+    {
+        if(!CanSeek())
+            return(-1);             //解码器据此按不可定位流处理
+
+        int64 target;
+
+        if(whence==SEEK_SET)target=offset;else
+        if(whence==SEEK_CUR)target=Tell()+offset;else
+        if(whence==SEEK_END)
+        {
+            if(stream_size<0)return(-1);
+
+            target=stream_size+offset;
+        }
+        else
+            return(-1);
+
+        if(target<0)
+            return(-1);
+
+        if(target>=buffer_start&&target<=buffer_start+buffer_length)     //缓冲区内定位，不触发 IO
+        {
+            buffer_offset=target-buffer_start;
+            return(0);
+        }
+
+        // 延迟到下一次 Read 再真正读取
+        if(stream->Seek(target,io::SeekOrigin::Begin)!=target)
+            return(-1);
+
+        buffer_start=target;
+        buffer_length=0;
+        buffer_offset=0;
+        return(0);
+    }
+
+    namespace
+    {
+        size_t AL_APIENTRY ReadAheadRead(void *user,void *buffer,size_t size)
+        {
+            return ((AudioReadAheadStream *)user)->Read(buffer,size);
+        }
+
+        int AL_APIENTRY ReadAheadSeek(void *user,int64 offset,int whence)
+        {
+            return ((AudioReadAheadStream *)user)->Seek(offset,whence);
+        }
+
+        int64 AL_APIENTRY ReadAheadTell(void *user)
+        {
+            return ((AudioReadAheadStream *)user)->Tell();
+        }
+    }//namespace
+
+    const AudioStreamCallbacks *AudioReadAheadStream::GetCallbacks()
+    {
+        static const AudioStreamCallbacks callbacks=
+        {
+            ReadAheadRead,
+            ReadAheadSeek,
+            ReadAheadTell
+        };
+
+        return &callbacks;
+    }
+
     bool GetAudioMidiInterface(const OSString &name,AudioMidiConfigInterface *amci)
     {
         PlugIn *pi=audio_plug_in.LoadPlugin(name);
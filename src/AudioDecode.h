@@ -4,6 +4,13 @@
 #include<hgl/audio/OpenAL.h>
 #include<hgl/audio/AudioFileType.h>
 #include<hgl/type/String.h>
+#include<vector>
+#include<filesystem>
+
+namespace hgl::io
+{
+    class InputStream;
+}//namespace hgl::io
 
 namespace hgl::audio
 {
@@ -13,6 +20,8 @@ namespace hgl::audio
     using openal::ALsizei;
     using openal::ALvoid;
 
+    class MappedFile;
+
     struct AudioPlugInInterface
     {
         void    (AL_APIENTRY *Load      )(ALbyte *,ALsizei,ALenum *,ALvoid **,ALsizei *,ALsizei *,ALboolean *);
@@ -102,13 +111,119 @@ namespace hgl::audio
         void    (AL_APIENTRY *CloseDecoder     )(void *dec);                                                  ///< 关闭解码器
     };//struct AudioCodecPlugInInterface
 
+    /**
+    * 音频解码定位接口（ver=6，可选能力）
+    *
+    * 作用于解码接口（ver=2/3）Open 返回的流句柄，以 PCM 帧（每声道一个采样）为单位定位。
+    * 不支持定位的插件 GetInterface(6) 返回 false，此时只能 Restart 回到开头。
+    */
+    struct AudioSeekPlugInInterface
+    {
+        bool    (AL_APIENTRY *SeekPCM   )(void *,int64 frame);      ///< 定位到第 frame 帧，超出长度时定位到结尾
+        int64   (AL_APIENTRY *TellPCM   )(void *);                  ///< 下一次 Read 将输出的帧位置，失败返回 -1
+    };//struct AudioSeekPlugInInterface
+
+    /**
+    * 外部数据源回调（供 ver=7 OpenStream 增量读取压缩数据）
+    * Seek/Tell 可为 nullptr 或返回 -1，此时插件按不可定位流处理（不能 Seek，总时长未知）
+    */
+    struct AudioStreamCallbacks
+    {
+        size_t  (AL_APIENTRY *Read      )(void *user,void *buffer,size_t size);     ///< 返回实际读取字节数，0 为结束
+        int     (AL_APIENTRY *Seek      )(void *user,int64 offset,int whence);      ///< whence 同 SEEK_SET/SEEK_CUR/SEEK_END，成功返回 0
+        int64   (AL_APIENTRY *Tell      )(void *user);                              ///< 当前字节位置，失败返回 -1
+    };//struct AudioStreamCallbacks
+
+    /**
+    * 音频流式打开接口（ver=7，可选能力）
+    *
+    * 与 ver=2 的 Open 相同，但不要求整个文件位于内存：解码器通过回调按需读取。
+    * 返回的流句柄与 Open 相同，继续使用 ver=2 Close/Read/Restart、ver=3 Read、ver=6 Seek。
+    * 回调与 user 在 Close 前必须保持有效。
+    */
+    struct AudioStreamPlugInInterface
+    {
+        void *  (AL_APIENTRY *OpenStream)(const AudioStreamCallbacks *,void *user,ALenum *,ALsizei *,double *);
+    };//struct AudioStreamPlugInInterface
+
+    /**
+    * 带预读缓冲的 InputStream 数据源，向解码插件提供 AudioStreamCallbacks
+    * 以 READ_AHEAD_SIZE 为单位从流中读取，缓冲区内的小步读取/定位不触发 IO
+    */
+    class AudioReadAheadStream
+    {
+        io::InputStream *stream;
+        bool owned;                                 ///< 是否由本对象删除 stream
+
+        std::vector<char> buffer;
+        int64 buffer_start;                         ///< buffer[0] 对应的流位置
+        int64 buffer_length;                        ///< buffer 中有效字节数
+        int64 buffer_offset;                        ///< 当前读取位置（相对 buffer_start）
+
+        int64 stream_size;                          ///< 流总长度（未知为 -1）
+
+        bool Fill(int64 position);
+
+    public:
+
+        static constexpr uint READ_AHEAD_SIZE=64*1024;
+
+        AudioReadAheadStream(io::InputStream *,bool owned);
+        ~AudioReadAheadStream();
+
+        AudioReadAheadStream(const AudioReadAheadStream &)=delete;
+        AudioReadAheadStream &operator=(const AudioReadAheadStream &)=delete;
+
+        size_t  Read(void *,size_t);
+        int     Seek(int64,int);
+        int64   Tell()const{return buffer_start+buffer_offset;}
+        bool    CanSeek()const;
+
+        static const AudioStreamCallbacks *GetCallbacks();      ///< user 参数为 AudioReadAheadStream *
+    };//class AudioReadAheadStream
+
     bool GetAudioInterface(const OSString &,AudioPlugInInterface *,AudioFloatPlugInInterface *);
     bool GetAudioCodecInterface(const OSString &,AudioCodecPlugInInterface *);
+    bool GetAudioSeekInterface(const OSString &,AudioSeekPlugInInterface *);
+    bool GetAudioStreamInterface(const OSString &,AudioStreamPlugInInterface *);
     bool GetAudioMidiInterface(const OSString &,AudioMidiConfigInterface *);
     bool GetAudioMidiChannelInterface(const OSString &,AudioMidiChannelInterface *);
 
     const OSString *GetAudioPluginNameByExtension(const char *ext_name);   ///<动态：按文件扩展名查找音频解码插件(基于插件 FileExtensions 能力)
 
+    /**
+    * AudioPlayer 与接续流（AudioChainStream）共用的数据源打开/解码步骤（实现见 AudioDecode.cpp）
+    */
+
+    /**
+    * 以只读内存映射打开整个音频文件（插件只读访问，WAV 可原地流式输出）
+    * @param mapped_file 成功时返回映射，data 指向其中，释放映射即释放数据
+    */
+    bool MapAudioFile(const os_char *filename,MappedFile **mapped_file,ALbyte **data,int *size);
+
+    /**
+    * 把整个音频文件读入 new[] 分配的内存（映射失败时的回退）
+    */
+    bool ReadAudioFile(const os_char *filename,ALbyte **data,int *size);
+
+    /**
+    * 取得解码插件接口（均为 new 分配，失败时全部为 nullptr）
+    * @param want_float 是否需要浮点读取接口，插件不支持时 float_decoder 为 nullptr
+    * @param seeker 插件不支持定位时为 nullptr
+    */
+    bool CreateAudioDecoder(const os_char *plugin_name,bool want_float,AudioPlugInInterface **decoder,AudioFloatPlugInInterface **float_decoder,AudioSeekPlugInInterface **seeker);
+
+    /**
+    * 插件输出格式对应的 float32 格式（浮点读取只支持单/双声道），不支持返回 0
+    */
+    ALenum GetFloatDecodeFormat(ALenum format);
+
+    /**
+    * 从已打开的解码器尽量读满 size 字节（插件单次可能只返回一部分），返回实际字节数，0 为结束
+    * @param float_decoder 非空时按 float32 读取
+    */
+    uint ReadAudioDecoder(AudioPlugInInterface *decoder,AudioFloatPlugInInterface *float_decoder,void *audio_ptr,char *data,uint size);
+
     /**
     * 解码结果（后台线程产出，主线程上传）
     * 持有插件解码得到的 PCM 数据与插件接口（用于释放）
@@ -123,8 +238,10 @@ namespace hgl::audio
         ALsizei size=0;                         ///< 数据字节数
         ALsizei freq=0;                         ///< 采样率
         double duration=0;                      ///< 可播放时长(秒)
+        MappedFile *mapped=nullptr;             ///< 非空表示 data 指向磁盘缓存文件的只读映射（不可原地修改）
+        bool host_owned=false;                  ///< data 由本模块 new char[] 分配（并行分段解码），Release 时 delete[]
 
-        void Release();                         ///< 释放插件解码数据
+        void Release();                         ///< 释放插件解码数据（或解除缓存映射）
     };//struct DecodedAudio
 
     /**
@@ -132,9 +249,10 @@ namespace hgl::audio
     * @param file_type 音频文件类型
     * @param memory 文件数据内存
     * @param memory_size 文件数据字节数
+    * @param allow_parallel 是否允许长 Vorbis/Opus 文件多线程分段解码（AudioLoadPool 工作线程已并行，传 false 避免超额订阅）
     * @return 解码结果（new 分配），失败返回 nullptr；调用方负责 Release+delete，或交给 UploadDecoded
     */
-    DecodedAudio *DecodeAudio(AudioFileType file_type, void *memory, int memory_size);
+    DecodedAudio *DecodeAudio(AudioFileType file_type, void *memory, int memory_size, bool allow_parallel=true);
 
     /**
     * 上传解码结果到 OpenAL buffer（需 current OpenAL context，应在主线程调用）
@@ -144,5 +262,37 @@ namespace hgl::audio
     * @return 是否上传成功
     */
     bool UploadDecoded(uint buffer_id, DecodedAudio *decoded);
+
+    /**
+    * 并行分段解码（实现见 AudioParallelDecode.cpp）
+    * 文件足够长且插件支持 Open/Read/Close + SeekPCM/TellPCM 时，多线程分段解码到 result（host_owned），
+    * 条件不满足或任一段失败时返回 false，result 不变，由调用方继续顺序解码
+    * @param preroll_seconds 除第一段外，各段从段首之前这么长的位置开始解码并丢弃（Opus 用 AUDIO_PARALLEL_DECODE_OPUS_PREROLL_SECONDS）
+    */
+    bool DecodeAudioParallel(const os_char *plugin_name,DecodedAudio *result,void *memory,int memory_size,bool use_float,double preroll_seconds=0);
+
+    /**
+    * 解码结果磁盘缓存键（实现见 AudioDecodeCache.cpp）
+    */
+    struct AudioDecodeCacheKey
+    {
+        uint64 source_hash;                     ///< 源数据内容哈希（FNV-1a 64）
+        uint64 source_size;                     ///< 源数据字节数
+        uint64 settings_hash;                   ///< 插件名/版本 + 浮点输出与否 + 外部设置
+    };//struct AudioDecodeCacheKey
+
+    /**
+    * 计算缓存键，缓存未启用或该格式不需要缓存（WAV）时返回 false
+    */
+    bool MakeAudioDecodeCacheKey(AudioFileType file_type,const os_char *plugin_name,const void *memory,int memory_size,bool use_float,AudioDecodeCacheKey *key);
+
+    bool LoadAudioDecodeCache(const AudioDecodeCacheKey &key,DecodedAudio *decoded);      ///< 命中时填写 format/size/freq/duration，data 指向映射内存
+    void StoreAudioDecodeCache(const AudioDecodeCacheKey &key,const DecodedAudio *decoded); ///< 写入失败仅记录日志
+
+    /**
+    * 同目录下的唯一临时文件名（"<filename>.<16 位十六进制>.tmp"，实现见 AudioDecodeCache.cpp）
+    * 写完后改名为 filename 即原子替换，多进程/多线程同时写同一文件不会互相覆盖
+    */
+    std::filesystem::path GetUniqueTempFilename(const std::filesystem::path &filename);
 }//namespace hgl::audio
 #endif//HGL_AUDIO_DECODE_INCLUDE
@@ -0,0 +1,474 @@
+﻿#include<hgl/audio/AudioDecodeCache.h>
+#include<hgl/util/hash/FNV1a.h>
+#include<hgl/thread/ThreadMutex.h>
+#include<hgl/log/Log.h>
+#include"AudioDecode.h"
+#include"MappedWAV.h"
+#include<filesystem>
+#include<fstream>
+#include<algorithm>
+#include<vector>
+#include<atomic>
+#include<chrono>
+#include<thread>
+#include<cstdio>
+#include<cstring>
+#include<random>
+
+namespace hgl::audio
+{
+    namespace
+    {
+        namespace fs=std::filesystem;
+
+        constexpr uint32 DECODE_CACHE_MAGIC         =0x43444D43;    ///< "CMDC"
+        constexpr uint32 DECODE_CACHE_VERSION       =1;
+        constexpr uint64 DECODE_CACHE_DATA_OFFSET   =64;            ///< PCM 起始偏移（对齐到 64 字节）
+
+        constexpr auto DECODE_CACHE_TEMP_MAX_AGE=std::chrono::minutes(10);  ///< 超过此时间的临时文件视为写入中途退出的残留
+
+        /**
+        * 缓存文件头，其后（DECODE_CACHE_DATA_OFFSET 处）为 PCM 数据
+        * 保存完整的键，文件名哈希碰撞时不会误用
+        */
+        struct DecodeCacheFileHeader
+        {
+            uint32 magic;
+            uint32 version;
+            uint64 source_hash;
+            uint64 source_size;
+            uint64 settings_hash;
+            uint32 format;
+            uint32 freq;
+            uint64 data_size;
+        };//struct DecodeCacheFileHeader
+
+        static_assert(sizeof(DecodeCacheFileHeader)<=DECODE_CACHE_DATA_OFFSET,"DecodeCacheFileHeader layout");
+
+        struct DecodeCacheState
+        {
+            ThreadMutex lock;
+
+            bool enabled=false;
+            fs::path dir;
+            uint64 max_bytes=0;
+            uint64 external_hash=0;             ///< SetAudioDecodeCacheSettingsKey() 的哈希
+
+            AudioDecodeCacheStats stats{};
+        };//struct DecodeCacheState
+
+        DecodeCacheState &GetState()
+        {
+            static DecodeCacheState state;
+
+            return state;
+        }
+
+        std::atomic<uint64> temp_counter{0};
+        const uint64 temp_process_seed=((uint64)std::random_device{}()<<32)^std::random_device{}();     ///< 每个进程不同（静态变量地址在 ASLR 关闭时各进程相同）
+
+        template<typename T> uint64 HashValue(uint64 hash,const T &value)
+        {
+            return hgl::hash::FNV1aAppendBytes(hash,&value,sizeof(T));
+        }
+
+        fs::path GetCacheFilename(const fs::path &dir,const AudioDecodeCacheKey &key)
+        {
+            uint64 hash=hgl::hash::FNV1aInit<uint64>();
+
+            hash=HashValue(hash,key.source_hash);
+            hash=HashValue(hash,key.source_size);
+            hash=HashValue(hash,key.settings_hash);
+
+            char name[32];
+
+            std::snprintf(name,sizeof(name),"%016llx.pcm",(unsigned long long)hash);
+
+            return dir/name;
+        }
+
+        /**
+        * 扫描缓存目录：删除残留的临时文件；总大小超出上限时按修改时间从最久未用的开始删除
+        * 只做文件操作，调用时不持锁
+        * @return 清理后的缓存文件总字节数
+        */
+        uint64 TrimCacheDirectory(const fs::path &dir,uint64 max_bytes,uint64 *evicted)
+        {
+            struct CacheFile
+            {
+                fs::path path;
+                fs::file_time_type time;
+                uint64 size;
+            };
+
+            std::vector<CacheFile> files;
+            uint64 total=0;
+
+            std::error_code ec;
+            const fs::file_time_type now=fs::file_time_type::clock::now();
+
+            fs::directory_iterator it(dir,ec),end;
+
+            for(;!ec&&it!=end;it.increment(ec))
+            {
+                std::error_code entry_ec;
+
+                if(!it->is_regular_file(entry_ec))continue;
+
+                const fs::path &path=it->path();
+                const fs::file_time_type time=it->last_write_time(entry_ec);
+
+                if(entry_ec)continue;
+
+                if(path.extension()==".tmp")
+                {
+                    if(now-time>DECODE_CACHE_TEMP_MAX_AGE)
+                        fs::remove(path,entry_ec);
+
+                    continue;
+                }
+
+                if(path.extension()!=".pcm")continue;
+
+                const uint64 size=it->file_size(entry_ec);
+
+                if(entry_ec)continue;
+
+                files.push_back({path,time,size});
+                total+=size;
+            }
+
+            if(total<=max_bytes)
+                return total;
+
+            std::sort(files.begin(),files.end(),[](const CacheFile &a,const CacheFile &b){return a.time<b.time;});
+
+            for(const CacheFile &file:files)
+            {
+                if(total<=max_bytes)break;
+
+                std::error_code remove_ec;
+
+                if(fs::remove(file.path,remove_ec))     // 其它进程正在映射的文件在 Windows 上删除失败，跳过
+                {
+                    total-=file.size;
+                    ++(*evicted);
+                }
+            }
+
+            return total;
+        }
+    }//namespace
+
+    /**
+    * 混入本进程随机种子、时间、线程与计数，同目录保证改名是原子的
+    */
+    fs::path GetUniqueTempFilename(const fs::path &filename)
+    {
+        uint64 hash=hgl::hash::FNV1aInit<uint64>();
+
+        hash=HashValue(hash,temp_process_seed);
+        hash=HashValue(hash,std::chrono::steady_clock::now().time_since_epoch().count());
+        hash=HashValue(hash,std::hash<std::thread::id>()(std::this_thread::get_id()));
+        hash=HashValue(hash,temp_counter.fetch_add(1));
+
+        char suffix[32];
+
+        std::snprintf(suffix,sizeof(suffix),".%016llx.tmp",(unsigned long long)hash);
+
+        fs::path temp=filename;
+
+        temp+=suffix;
+        return temp;
+    }
+
+    bool EnableAudioDecodeCache(const os_char *path,uint64 max_bytes)
+    {
+        if(!path||!(*path)||max_bytes==0)
+            return(false);
+
+        const fs::path dir(path);
+
+        std::error_code ec;
+
+        fs::create_directories(dir,ec);
+
+        if(!fs::is_directory(dir,ec))
+        {
+            GLogError(OS_TEXT("AudioDecodeCache: 无法创建缓存目录 ")+OSString(path));
+            return(false);
+        }
+
+        uint64 evicted=0;
+        const uint64 total=TrimCacheDirectory(dir,max_bytes,&evicted);
+
+        DecodeCacheState &state=GetState();
+
+        ThreadMutexLock lock_guard(&state.lock);
+
+        state.enabled=true;
+        state.dir=dir;
+        state.max_bytes=max_bytes;
+        state.stats.cache_bytes=total;
+        state.stats.eviction_count+=evicted;
+
+        return(true);
+    }
+
+    void DisableAudioDecodeCache()
+    {
+        DecodeCacheState &state=GetState();
+
+        ThreadMutexLock lock_guard(&state.lock);
+
+        state.enabled=false;
+    }
+
+    bool IsAudioDecodeCacheEnabled()
+    {
+        DecodeCacheState &state=GetState();
+
+        ThreadMutexLock lock_guard(&state.lock);
+
+        return state.enabled;
+    }
+
+    void SetAudioDecodeCacheSettingsKey(const char *key)
+    {
+        const uint64 hash=(key&&*key)?hgl::hash::FNV1aAppendBytes(hgl::hash::FNV1aInit<uint64>(),key,std::strlen(key)):0;
+
+        DecodeCacheState &state=GetState();
+
+        ThreadMutexLock lock_guard(&state.lock);
+
+        state.external_hash=hash;
+    }
+
+    void TrimAudioDecodeCache()
+    {
+        DecodeCacheState &state=GetState();
+
+        fs::path dir;
+        uint64 max_bytes;
+
+        {
+            ThreadMutexLock lock_guard(&state.lock);
+
+            if(!state.enabled)return;
+
+            dir=state.dir;
+            max_bytes=state.max_bytes;
+        }
+
+        uint64 evicted=0;
+        const uint64 total=TrimCacheDirectory(dir,max_bytes,&evicted);
+
+        ThreadMutexLock lock_guard(&state.lock);
+
+        state.stats.cache_bytes=total;
+        state.stats.eviction_count+=evicted;
+    }
+
+    AudioDecodeCacheStats GetAudioDecodeCacheStats()
+    {
+        DecodeCacheState &state=GetState();
+
+        ThreadMutexLock lock_guard(&state.lock);
+
+        return state.stats;
+    }
+
+    bool MakeAudioDecodeCacheKey(AudioFileType file_type,const os_char *plugin_name,const void *memory,int memory_size,bool use_float,AudioDecodeCacheKey *key)
+    {
+        if(!key||!plugin_name||!memory||memory_size<=0)
+            return(false);
+
+        if(file_type==AudioFileType::Wav)           // 已是 PCM，解析开销远小于读缓存
+            return(false);
+
+        uint64 external_hash;
+
+        {
+            DecodeCacheState &state=GetState();
+
+            ThreadMutexLock lock_guard(&state.lock);
+
+            if(!state.enabled)
+                return(false);
+
+            external_hash=state.external_hash;
+        }
+
+        const OSString name(plugin_name);
+
+        uint64 settings=hgl::hash::FNV1aInit<uint64>();
+
+        settings=hgl::hash::FNV1aAppendBytes(settings,name.c_str(),name.Length()*sizeof(os_char));
+
+        // 解码插件接口没有版本信息，以插件名区分；MIDI 配置接口可查询合成器版本
+        if(file_type==AudioFileType::MIDI)
+        {
+            AudioMidiConfigInterface midi_config{};
+
+            if(GetAudioMidiInterface(name,&midi_config)&&midi_config.GetVersionString)
+            {
+                const char *version=midi_config.GetVersionString();
+
+                if(version)
+                    settings=hgl::hash::FNV1aAppendBytes(settings,version,std::strlen(version));
+            }
+        }
+
+        settings=HashValue(settings,uint8(use_float?1:0));
+        settings=HashValue(settings,external_hash);
+
+        key->source_hash=hgl::hash::FNV1aAppendBytes(hgl::hash::FNV1aInit<uint64>(),memory,size_t(memory_size));
+        key->source_size=uint64(memory_size);
+        key->settings_hash=settings;
+
+        return(true);
+    }
+
+    bool LoadAudioDecodeCache(const AudioDecodeCacheKey &key,DecodedAudio *decoded)
+    {
+        if(!decoded)return(false);
+
+        DecodeCacheState &state=GetState();
+
+        fs::path filename;
+
+        {
+            ThreadMutexLock lock_guard(&state.lock);
+
+            if(!state.enabled)return(false);
+
+            filename=GetCacheFilename(state.dir,key);
+        }
+
+        MappedFile *mapped=new MappedFile;
+
+        bool hit=mapped->Open(filename.c_str(),true);
+
+        const DecodeCacheFileHeader *header=(const DecodeCacheFileHeader *)mapped->GetData();
+
+        if(hit)
+        {
+            hit=mapped->GetSize()>=DECODE_CACHE_DATA_OFFSET
+              &&header->magic==DECODE_CACHE_MAGIC
+              &&header->version==DECODE_CACHE_VERSION
+              &&header->source_hash==key.source_hash
+              &&header->source_size==key.source_size
+              &&header->settings_hash==key.settings_hash
+              &&header->format!=0
+              &&header->data_size>0
+              &&header->data_size<=0x7FFFFFFF
+              &&header->data_size<=mapped->GetSize()-DECODE_CACHE_DATA_OFFSET;
+        }
+
+        if(!hit)
+        {
+            delete mapped;
+
+            ThreadMutexLock lock_guard(&state.lock);
+
+            ++state.stats.miss_count;
+            return(false);
+        }
+
+        decoded->format  =ALenum(header->format);
+        decoded->data    =(char *)mapped->GetData()+DECODE_CACHE_DATA_OFFSET;
+        decoded->size    =ALsizei(header->data_size);
+        decoded->freq    =ALsizei(header->freq);
+        decoded->duration=openal::AudioDataTime(decoded->size,decoded->format,decoded->freq);
+        decoded->mapped  =mapped;
+
+        std::error_code ec;
+
+        fs::last_write_time(filename,fs::file_time_type::clock::now(),ec);     // 刷新 LRU 时间
+
+        ThreadMutexLock lock_guard(&state.lock);
+
+        ++state.stats.hit_count;
+        return(true);
+    }
+
+    void StoreAudioDecodeCache(const AudioDecodeCacheKey &key,const DecodedAudio *decoded)
+    {
+        if(!decoded||!decoded->data||decoded->size<=0||decoded->mapped)
+            return;
+
+        DecodeCacheState &state=GetState();
+
+        fs::path filename;
+
+        {
+            ThreadMutexLock lock_guard(&state.lock);
+
+            if(!state.enabled)return;
+
+            filename=GetCacheFilename(state.dir,key);
+        }
+
+        const fs::path temp=GetUniqueTempFilename(filename);
+
+        DecodeCacheFileHeader header;
+
+        std::memset(&header,0,sizeof(header));
+
+        header.magic        =DECODE_CACHE_MAGIC;
+        header.version      =DECODE_CACHE_VERSION;
+        header.source_hash  =key.source_hash;
+        header.source_size  =key.source_size;
+        header.settings_hash=key.settings_hash;
+        header.format       =uint32(decoded->format);
+        header.freq         =uint32(decoded->freq);
+        header.data_size    =uint64(decoded->size);
+
+        char head[DECODE_CACHE_DATA_OFFSET]={};
+
+        std::memcpy(head,&header,sizeof(header));
+
+        std::error_code ec;
+
+        {
+            std::ofstream out(temp,std::ios::binary|std::ios::trunc);
+
+            if(out)
+            {
+                out.write(head,sizeof(head));
+                out.write((const char *)decoded->data,decoded->size);
+                out.close();
+            }
+
+            if(!out)
+            {
+                GLogError(OS_TEXT("AudioDecodeCache: 写入缓存文件失败 ")+OSString(temp.c_str()));
+                fs::remove(temp,ec);
+                return;
+            }
+        }
+
+        // 原子替换：其它进程要么看到旧文件，要么看到完整的新文件；目标正被映射（Windows）时放弃本次写入
+        fs::rename(temp,filename,ec);
+
+        if(ec)
+        {
+            fs::remove(temp,ec);
+            return;
+        }
+
+        bool over_budget;
+
+        {
+            ThreadMutexLock lock_guard(&state.lock);
+
+            ++state.stats.store_count;
+            state.stats.cache_bytes+=DECODE_CACHE_DATA_OFFSET+uint64(decoded->size);
+
+            over_budget=state.stats.cache_bytes>state.max_bytes;
+        }
+
+        if(over_budget)
+            TrimAudioDecodeCache();
+    }
+}//namespace hgl::audio
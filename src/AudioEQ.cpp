@@ -1,9 +1,16 @@
 ﻿#include<hgl/audio/AudioEQ.h>
+#include<hgl/audio/SampleConvert.h>
 
 #include<cstdint>
+#include<vector>
 
 namespace hgl::audio
 {
+    namespace
+    {
+        constexpr uint EQ_CHUNK_SAMPLES = 4096;     ///< 整数格式每次转换的采样数（栈上缓冲，按整帧截取）
+    }
+
     bool ApplyEQToPCM(void *data, uint size, const AudioDataInfo &info, ParametricEQ &eq)
     {
         if(!data || size == 0)
@@ -45,31 +52,46 @@ namespace hgl::audio
             return true;
         }
 
-        if(bits == 16)
-        {
-            int16_t *p = (int16_t*)data;
+        // OpenAL 的 8 位 PCM 是无符号数（128=静音），转换内核按有符号 int8 解释，这里不处理
+        if(bits == 8 || !IsSampleFormatSupported(info))
+            return false;       // 其它格式不支持
 
-            for(uint ch = 0; ch < channels; ch++)
-            {
-                eq.Reset();
+        // 整数格式：按固定大小分块转 float（共享 SIMD 内核）→ 逐声道 EQ → 钳位量化回原格式
+        // 每个声道独立滤波、独立 Reset，滤波状态跨块保持：首声道用 eq 本身，其余声道各用一份副本
+        if(channels > EQ_CHUNK_SAMPLES)
+            return false;
 
-                for(uint i = ch; i < sample_count; i += channels)
-                {
-                    const float x = p[i] / 32768.0f;
+        eq.Reset();
 
-                    float y = eq.Process(x);
+        std::vector<ParametricEQ> channel_eq(channels - 1, eq);
 
-                    if(y > 1.0f)      y = 1.0f;
-                    else if(y < -1.0f) y = -1.0f;
+        float scratch[EQ_CHUNK_SAMPLES];
 
-                    p[i] = (int16_t)(y * 32767.0f);
-                }
+        const uint chunk_frames = EQ_CHUNK_SAMPLES / channels;
+        const uint frame_count  = sample_count / channels;
+
+        char *p = (char *)data;
+
+        for(uint frame = 0; frame < frame_count; frame += chunk_frames)
+        {
+            const uint frames = (frame_count - frame < chunk_frames) ? frame_count - frame : chunk_frames;
+            const uint count  = frames * channels;
+
+            char *chunk = p + (size_t)frame * channels * bytes_per_sample;
+
+            SampleToFloat(chunk, scratch, count, info);
+
+            for(uint ch = 0; ch < channels; ch++)
+            {
+                ParametricEQ &e = ch ? channel_eq[ch - 1] : eq;
+
+                for(uint i = ch; i < count; i += channels)
+                    scratch[i] = e.Process(scratch[i]);
             }
 
-            return true;
+            FloatToSample(scratch, chunk, count, info);
         }
 
-        // 其它格式（8bit/int24 等）不支持
-        return false;
+        return true;
     }
 }//namespace hgl::audio
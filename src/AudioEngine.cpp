@@ -14,6 +14,9 @@ namespace hgl::audio
         ui     =master.CreateChild("UI");
 
         asset_manager=new AudioAssetManager;
+
+        asset_upload_ms=2.0;
+        asset_upload_bytes=2*1024*1024;
     }
 
     AudioEngine::~AudioEngine()
@@ -37,9 +40,9 @@ namespace hgl::audio
         if(asset_manager)asset_manager->Release(filename);
     }
 
-    bool AudioEngine::AcquireAsync(const os_char *filename)
+    bool AudioEngine::AcquireAsync(const os_char *filename,int priority)
     {
-        return asset_manager?asset_manager->AcquireAsync(filename):false;
+        return asset_manager?asset_manager->AcquireAsync(filename,priority):false;
     }
 
     void AudioEngine::AddWorld(SpatialAudioWorld *world)
@@ -61,9 +64,9 @@ namespace hgl::audio
     {
         const double now=(ct!=0)?ct:GetTimeSec();
 
-        // 1. 资源管理：上传已完成解码的异步缓冲
+        // 1. 资源管理：按预算上传已完成解码的异步缓冲（剩余顺延到下一帧）
         if(asset_manager)
-            asset_manager->Update();
+            asset_manager->Update(asset_upload_ms,asset_upload_bytes);
 
         // 2. 总线树：驱动 Duck 平滑过渡
         master.Update(now);
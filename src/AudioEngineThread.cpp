@@ -1,4 +1,7 @@
 ﻿#include<hgl/audio/AudioEngineThread.h>
+#include<hgl/audio/AudioStreamVoicePool.h>
+#include<hgl/audio/AudioAssetManager.h>
+#include<hgl/audio/AudioBuffer.h>
 #include<hgl/audio/OpenAL.h>
 #include<hgl/time/Time.h>
 
@@ -13,6 +16,10 @@ namespace hgl::audio
         busy=false;
         running=false;
         frame_interval=0.01;
+
+        voice_count=AUDIO_ENGINE_DEFAULT_VOICES;
+        stream_voice_count=AUDIO_ENGINE_DEFAULT_STREAM_VOICES;
+        stream_pool=nullptr;
     }
 
     AudioEngineThread::~AudioEngineThread()
@@ -27,6 +34,31 @@ namespace hgl::audio
         if(!openal::InitOpenAL(nullptr,"null",false,false))
             return(false);
 
+        // 音源池一次创建好，Play 时只取空闲音源（OpenAL 音源创建开销大，且播放路径上不做分配）
+        voices.reserve(voice_count);
+        free_voices.reserve(voice_count);
+
+        for(uint i=0;i<voice_count;i++)
+        {
+            AudioSource *source=new AudioSource;
+
+            if(!source->Create())                       // 后端音源数不足，按实际创建数运行
+            {
+                delete source;
+                break;
+            }
+
+            voices.push_back(source);
+        }
+
+        for(int i=int(voices.size())-1;i>=0;i--)
+            free_voices.push_back(i);
+
+        if(stream_voice_count>0)
+            stream_pool=new AudioStreamVoicePool(engine.GetAssetManager(),stream_voice_count);
+
+        instances.reserve(voices.size()+stream_voice_count);
+
         processed=0;
         running=true;
 
@@ -37,6 +69,21 @@ namespace hgl::audio
     {
         running=false;
 
+        for(const ActiveInstance &inst : instances)
+            StopInstance(inst);
+
+        instances.clear();
+
+        UnloadAllCues();
+
+        SAFE_CLEAR(stream_pool);
+
+        for(AudioSource *source : voices)
+            delete source;
+
+        voices.clear();
+        free_voices.clear();
+
         openal::CloseOpenAL();
     }
 
@@ -45,9 +92,12 @@ namespace hgl::audio
         // 1. 批量消费事件（一次清空，帧内一致）
         ConsumeEvents();
 
-        // 2. 驱动引擎
+        // 2. 驱动引擎与流式音源
         engine.Update(GetTimeSec());
 
+        if(stream_pool)
+            stream_pool->Update();
+
         // 3. 回传处理（如引擎侧有需要主动上报的状态）
         FlushResults();
 
@@ -94,85 +144,8 @@ namespace hgl::audio
         switch(AudioEventType(ev.type))
         {
             case AudioEventType::Play:
-            {
-                // 1. 查 Cue 定义
-                const SoundEventConfig *cfg=cues.GetEventByHash(ev.cue_id);
-
-                if(!cfg)
-                {
-                    if(transport)
-                    {
-                        AudioEventResult r(AudioEventResultType::Error,0,1,ev.seq);   // error_code=1 未知 Cue
-                        transport->PostResult(r);
-                    }
-                    break;
-                }
-
-                // 2. 选文件：sequence 优先（轮播），否则 files 随机
-                const OSString *file=nullptr;
-
-                if(cfg->sequence.GetCount()>0)
-                    file=cfg->SequenceFile((int)(seq_counter++));
-                else
-                    file=cfg->RandomFile();
-
-                if(!file)
-                {
-                    if(transport)
-                    {
-                        AudioEventResult r(AudioEventResultType::Error,0,2,ev.seq);   // error_code=2 无文件
-                        transport->PostResult(r);
-                    }
-                    break;
-                }
-
-                // 3. 创建播放器实例（引擎线程内，OpenAL context 归属本线程）
-                AudioPlayer *player=new AudioPlayer;
-
-                if(!player->Load(file->c_str()))
-                {
-                    delete player;
-
-                    if(transport)
-                    {
-                        AudioEventResult r(AudioEventResultType::Error,0,3,ev.seq);   // error_code=3 加载失败
-                        transport->PostResult(r);
-                    }
-                    break;
-                }
-
-                // 4. 应用 Cue 配置：随机增益/音高、循环、总线
-                player->SetGain(cfg->RandomGain());
-                player->SetPitch(cfg->RandomPitch());
-
-                // 注意：Play(bool loop=true) 默认循环（BGM 设计），必须把 Cue 的 loop 传进去，
-                // 否则 SetLoop(cfg->loop) 会被 Play() 内部覆盖
-                player->Play(cfg->loop);
-
-                switch(cfg->bus_type)
-                {
-                    case AudioBusType::Master:  player->SetBus(engine.GetMaster());  break;
-                    case AudioBusType::Music:   player->SetBus(engine.GetMusic());   break;
-                    case AudioBusType::Ambient: player->SetBus(engine.GetAmbient());break;
-                    case AudioBusType::UI:      player->SetBus(engine.GetUI());      break;
-                    case AudioBusType::SFX:
-                    default:                    player->SetBus(engine.GetSFX());    break;
-                }
-
-                player->Play();
-
-                // 5. 登记实例
-                const uint32 inst=next_instance++;
-
-                instances.push_back({inst,OSString(),player,cfg->loop});
-
-                if(transport)
-                {
-                    AudioEventResult r(AudioEventResultType::PlayStarted,inst,0,ev.seq);
-                    transport->PostResult(r);
-                }
+                PlayCue(ev);
                 break;
-            }
 
             case AudioEventType::Stop:
             {
@@ -181,15 +154,8 @@ namespace hgl::audio
                 {
                     if(it->instance_id==ev.instance_id)
                     {
-                        it->player->Stop();
-                        it->player->WaitExit(1.0);
-                        delete it->player;
-
-                        if(transport)
-                        {
-                            AudioEventResult r(AudioEventResultType::Stopped,it->instance_id,0,ev.seq);
-                            transport->PostResult(r);
-                        }
+                        StopInstance(*it);
+                        PostResult(AudioEventResultType::Stopped,it->instance_id,0,ev.seq);
 
                         instances.erase(it);
                         break;
@@ -210,7 +176,9 @@ namespace hgl::audio
 
                     // 参数映射：遍历该 Cue 的 rtpc 表，匹配参数名哈希
                     // 简化：实例未记 cue 名，用事件里的 cue_id 直接匹配 Cue 的 rtpc 表
-                    if(!cfg)
+                    AudioSource *source=GetSource(inst);
+
+                    if(!cfg||!source)
                         break;
 
                     for(const RTPCConfig &r : cfg->rtpc)
@@ -219,8 +187,8 @@ namespace hgl::audio
 
                         switch(r.target)
                         {
-                            case RTPCTarget::Pitch:   inst.player->SetPitch(mapped);break;
-                            case RTPCTarget::Gain:    inst.player->SetGain(mapped); break;
+                            case RTPCTarget::Pitch:   source->SetPitch(mapped);break;
+                            case RTPCTarget::Gain:    source->SetGain(mapped); break;
                             case RTPCTarget::Lowpass:
                             case RTPCTarget::Pan:
                             default: break;
@@ -270,48 +238,289 @@ namespace hgl::audio
             }
 
             case AudioEventType::PauseAll:
-                for(ActiveInstance &inst : instances)
-                    inst.player->Pause();
+                for(const ActiveInstance &inst : instances)
+                {
+                    AudioSource *source=GetSource(inst);
+
+                    if(source)
+                        source->Pause();
+                }
                 break;
 
             case AudioEventType::ResumeAll:
-                for(ActiveInstance &inst : instances)
-                    inst.player->Resume();
+                for(const ActiveInstance &inst : instances)
+                {
+                    AudioSource *source=GetSource(inst);
+
+                    if(source)
+                        source->Resume();
+                }
+                break;
+
+            case AudioEventType::LoadCue:
+            {
+                const SoundEventConfig *cfg=cues.GetEventByHash(ev.cue_id);
+
+                if(!cfg)
+                {
+                    PostResult(AudioEventResultType::Error,0,1,ev.seq);                 // error_code=1 未知 Cue
+                    break;
+                }
+
+                LoadCue(ev.cue_id,cfg);
+                PostResult(AudioEventResultType::LoadComplete,0,0,ev.seq);
+                break;
+            }
+
+            case AudioEventType::UnloadCue:
+                UnloadCue(ev.cue_id);
                 break;
 
             default:
-                // LoadCue/UnloadCue：T5 之后接入 Cue 包管理
                 break;
         }
     }
 
-    void AudioEngineThread::FlushResults()
+    void AudioEngineThread::PostResult(AudioEventResultType type,uint32 instance_id,uint32 error_code,uint32 seq)
     {
-        // 播完检测：非循环实例播放结束 → PlayFinished + 清理
-        for(auto it=instances.begin();it!=instances.end();)
+        if(!transport)
+            return;
+
+        AudioEventResult r(type,instance_id,error_code,seq);
+        transport->PostResult(r);
+    }
+
+    AudioSource *AudioEngineThread::GetSource(const ActiveInstance &inst)
+    {
+        if(inst.stream)
+            return stream_pool?stream_pool->GetSource(inst.voice):nullptr;
+
+        return voices[inst.voice];
+    }
+
+    void AudioEngineThread::StopInstance(const ActiveInstance &inst)
+    {
+        if(inst.stream)
         {
-            AudioPlayer *p=it->player;
+            if(stream_pool)
+                stream_pool->Stop(inst.voice);
+
+            return;
+        }
 
-            // 播完判定（双条件，null/无声后端 AL_STOPPED 不可靠）：
-            // 1) 播放线程已退出（play_state==None，数据读尽）
-            // 2) 播放时间已到总时长（数据已全部喂入 buffer 队列）
-            const double played=p->GetPlayTime();
-            const double total=p->GetTotalTime();
+        AudioSource *source=voices[inst.voice];
 
-            const bool finished=!it->loop
-                                &&(p->GetPlayState()==PlayState::None
-                                   ||(total>0.0&&played>=total-0.05));
+        source->Stop();
+        source->Unlink();
 
-            if(finished)
+        free_voices.push_back(inst.voice);
+    }
+
+    AudioEngineThread::CueAssets *AudioEngineThread::LoadCue(uint32 cue_id,const SoundEventConfig *cfg)
+    {
+        auto it=cue_assets.find(cue_id);
+
+        if(it!=cue_assets.end())
+            return &it->second;
+
+        // 有轮播用 sequence，否则用 files，与 PlayCue 的选文件规则一致
+        const OSStringList &list=cfg->sequence.GetCount()>0?cfg->sequence:cfg->files;
+        const int count=list.GetCount();
+
+        CueAssets &assets=cue_assets[cue_id];
+        AudioAssetManager *am=engine.GetAssetManager();
+
+        if(cfg->stream)
+        {
+            assets.compressed.resize(count,nullptr);
+
+            for(int i=0;i<count;i++)
+                assets.compressed[i]=am->AcquireCompressed(list.GetString(i).c_str());
+        }
+        else
+        {
+            assets.buffers.resize(count,nullptr);
+
+            for(int i=0;i<count;i++)
+                assets.buffers[i]=am->Acquire(list.GetString(i).c_str());
+        }
+
+        return &assets;
+    }
+
+    void AudioEngineThread::UnloadCue(uint32 cue_id)
+    {
+        auto it=cue_assets.find(cue_id);
+
+        if(it==cue_assets.end())
+            return;
+
+        // 先停掉仍在使用这些资源的实例，再释放引用
+        for(auto inst=instances.begin();inst!=instances.end();)
+        {
+            if(inst->cue_id==cue_id)
+            {
+                StopInstance(*inst);
+                PostResult(AudioEventResultType::Stopped,inst->instance_id,0,0);
+
+                inst=instances.erase(inst);
+            }
+            else
             {
-                if(transport)
+                ++inst;
+            }
+        }
+
+        AudioAssetManager *am=engine.GetAssetManager();
+
+        for(AudioBuffer *buf : it->second.buffers)
+            if(buf)
+                am->Release(buf);
+
+        for(AudioCompressedData *cd : it->second.compressed)
+            if(cd)
+                am->ReleaseCompressed(cd);
+
+        cue_assets.erase(it);
+    }
+
+    void AudioEngineThread::UnloadAllCues()
+    {
+        while(!cue_assets.empty())
+            UnloadCue(cue_assets.begin()->first);
+    }
+
+    void AudioEngineThread::PlayCue(const AudioEvent &ev)
+    {
+        // 1. 查 Cue 定义
+        const SoundEventConfig *cfg=cues.GetEventByHash(ev.cue_id);
+
+        if(!cfg)
+        {
+            PostResult(AudioEventResultType::Error,0,1,ev.seq);                         // error_code=1 未知 Cue
+            return;
+        }
+
+        // 2. 选文件：sequence 优先（轮播），否则 files 随机
+        int index;
+
+        if(cfg->sequence.GetCount()>0)
+            index=int(seq_counter++%uint32(cfg->sequence.GetCount()));
+        else
+            index=cfg->RandomFileIndex();
+
+        if(index<0)
+        {
+            PostResult(AudioEventResultType::Error,0,2,ev.seq);                         // error_code=2 无文件
+            return;
+        }
+
+        // 3. 取常驻资源：LoadCue 过或播放过的 Cue 直接命中，首次播放在此同步加载
+        //    （Cue 表在运行中被改动时，下标可能超出已取得的资源数，按加载失败处理）
+        CueAssets *assets=LoadCue(ev.cue_id,cfg);
+
+        int voice=-1;
+
+        if(cfg->stream)
+        {
+            if(uint(index)>=assets->compressed.size()||!assets->compressed[index])
+            {
+                PostResult(AudioEventResultType::Error,0,3,ev.seq);                     // error_code=3 加载失败
+                return;
+            }
+
+            // 压缩数据已由本线程持有引用，流式池再次取得时命中缓存，不读文件
+            if(stream_pool)
+                voice=stream_pool->Play(assets->compressed[index]->name.c_str(),cfg->RandomGain(),cfg->loop);
+
+            if(voice<0)
+            {
+                PostResult(AudioEventResultType::Error,0,4,ev.seq);                     // error_code=4 无可用音源
+                return;
+            }
+        }
+        else
+        {
+            if(uint(index)>=assets->buffers.size()||!assets->buffers[index])
+            {
+                PostResult(AudioEventResultType::Error,0,3,ev.seq);                     // error_code=3 加载失败
+                return;
+            }
+
+            // 无空闲音源：抢占最早开始的非循环实例
+            if(free_voices.empty())
+            {
+                for(auto it=instances.begin();it!=instances.end();++it)
+                {
+                    if(it->stream||it->loop)
+                        continue;
+
+                    StopInstance(*it);
+                    PostResult(AudioEventResultType::Stopped,it->instance_id,0,ev.seq);
+
+                    instances.erase(it);
+                    break;
+                }
+
+                if(free_voices.empty())
                 {
-                    AudioEventResult r(AudioEventResultType::PlayFinished,it->instance_id,0,0);
-                    transport->PostResult(r);
+                    PostResult(AudioEventResultType::Error,0,4,ev.seq);                 // error_code=4 无可用音源
+                    return;
                 }
+            }
+
+            voice=free_voices.back();
+
+            AudioSource *source=voices[voice];
+
+            if(!source->Link(assets->buffers[index]))
+            {
+                PostResult(AudioEventResultType::Error,0,3,ev.seq);
+                return;
+            }
+
+            free_voices.pop_back();
+
+            source->SetGain(cfg->RandomGain());
+        }
+
+        // 4. 应用 Cue 配置：随机音高、总线、循环
+        const ActiveInstance inst={next_instance++,ev.cue_id,voice,cfg->stream,cfg->loop};
+
+        AudioSource *source=GetSource(inst);
+
+        source->SetPitch(cfg->RandomPitch());
+        source->SetBus(GetBus(cfg->bus_type));
+
+        if(!cfg->stream&&!source->Play(cfg->loop))
+        {
+            StopInstance(inst);
+            PostResult(AudioEventResultType::Error,0,3,ev.seq);
+            return;
+        }
+
+        // 5. 登记实例（容量已预留，不分配）
+        instances.push_back(inst);
+
+        PostResult(AudioEventResultType::PlayStarted,inst.instance_id,0,ev.seq);
+    }
+
+    void AudioEngineThread::FlushResults()
+    {
+        // 播完检测：非循环实例播放结束 → PlayFinished + 归还音源
+        for(auto it=instances.begin();it!=instances.end();)
+        {
+            // 常驻音源：整段 buffer 播完后状态转为 AL_STOPPED
+            // 流式音源：数据解码完且排队缓冲播完后由 stream_pool->Update() 回收
+            const bool finished=!it->loop
+                                &&(it->stream?!stream_pool->IsPlaying(it->voice)
+                                             :voices[it->voice]->IsStopped());
+
+            if(finished)
+            {
+                PostResult(AudioEventResultType::PlayFinished,it->instance_id,0,0);
 
-                p->WaitExit(1.0);
-                delete p;
+                StopInstance(*it);
                 it=instances.erase(it);
             }
             else
@@ -1,22 +1,71 @@
 ﻿#include<hgl/audio/AudioMixer.h>
 #include<hgl/audio/OpenAL.h>
+#include<hgl/audio/SampleConvert.h>
 #include<hgl/type/Smart.h>
 #include<math.h>
 #include<string.h>
 #include<cstdint>
 #include<cmath>
+#include<atomic>
+#include<thread>
 #include<samplerate.h>
-#include<random>
 
 using namespace openal;
 
 namespace hgl::audio
 {
+    namespace
+    {
+        constexpr uint PARALLEL_MIN_CHUNK_FRAMES = 16384;     ///< 并行累加时每段最少帧数，过小则线程开销得不偿失
+
+        /**
+         * fork-join 并行：调用线程与 worker_count-1 个工作线程按原子计数领取任务 [0,job_count)
+         * 工作线程创建失败时剩余任务由已有线程（至少调用线程）完成
+         * @param func 任务函数 func(job_index,worker_index)，worker_index ∈ [0,worker_count)
+         */
+        template<typename F>
+        void ParallelFor(uint worker_count, uint job_count, F &&func)
+        {
+            std::atomic<uint> next(0);
+
+            auto worker = [&](uint worker_index)
+            {
+                for(uint job = next.fetch_add(1); job < job_count; job = next.fetch_add(1))
+                    func(job, worker_index);
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(worker_count > 1 ? worker_count - 1 : 0);
+
+            for(uint i = 1; i < worker_count; i++)
+            {
+                try
+                {
+                    threads.emplace_back(worker, i);
+                }
+                catch(...)
+                {
+                    break;
+                }
+            }
+
+            worker(0);
+
+            for(std::thread &t:threads)
+                t.join();
+        }
+    }//namespace
+
         AudioMixer::AudioMixer()
             : pool_buffer(OS_TEXT("AudioMixer::pool_buffer")),
-              temp_buffer(OS_TEXT("AudioMixer::temp_buffer"))
+              temp_buffer(OS_TEXT("AudioMixer::temp_buffer")),
+              block_buffer(OS_TEXT("AudioMixer::block_buffer")),
+              track_buffer(OS_TEXT("AudioMixer::track_buffer"))
         {
             has_common_info = false;
+            streaming = false;
+            stream_frame_count = 0;
+            stream_position = 0;
             output_format.channels = 1;      // 默认单声道
             output_format.bits_per_sample = 16; // 默认输出int16
             output_format.is_float = false;
@@ -24,169 +73,51 @@ namespace hgl::audio
 
         AudioMixer::~AudioMixer()
         {
+            ReleaseStreams();
             ClearTracks();
             // 内存池自动释放
         }
 
         /**
          * 将整数采样转换为浮点 (-1.0 到 1.0)
-         * 使用内存池避免频繁分配
+         * 使用内存池避免频繁分配，转换走共享 SIMD 内核
          */
-        void AudioMixer::ConvertToFloat(const void* input, uint inputSize, float** output, uint* outputCount, const AudioDataInfo& info)
+        void AudioMixer::ConvertToFloat(const void* input, uint inputSize, float** output, uint* outputCount, const AudioDataInfo& info, AudioMemoryPool<float>& pool)
         {
             uint bytesPerSample = info.bits_per_sample / 8;
             *outputCount = inputSize / bytesPerSample;
 
-            // 使用临时缓冲区
-            temp_buffer.Ensure(*outputCount);
-            *output = temp_buffer.Get();
+            // 使用调用方指定的缓冲池（串行为 temp_buffer，并行为各工作线程独占的池）
+            pool.Ensure(*outputCount);
+            *output = pool.Get();
 
-            if(info.is_float && info.bits_per_sample == 32)
-            {
-                // 已经是float，直接复制
-                const float* samples = (const float*)input;
-                memcpy(*output, samples, (*outputCount) * sizeof(float));
-            }
-            else if(info.bits_per_sample == 32)
-            {
-                const int32_t* samples = (const int32_t*)input;
-                for(uint i = 0; i < *outputCount; i++)
-                {
-                    // 转换为 -1.0 到 1.0 范围
-                    (*output)[i] = samples[i] / 2147483648.0f;
-                }
-            }
-            else if(info.bits_per_sample == 16)
-            {
-                const int16_t* samples = (const int16_t*)input;
-                for(uint i = 0; i < *outputCount; i++)
-                {
-                    // 转换为 -1.0 到 1.0 范围
-                    (*output)[i] = samples[i] / 32768.0f;
-                }
-            }
-            else if(info.bits_per_sample == 8)
-            {
-                const int8_t* samples = (const int8_t*)input;
-                for(uint i = 0; i < *outputCount; i++)
-                {
-                    // 转换为 -1.0 到 1.0 范围
-                    (*output)[i] = samples[i] / 128.0f;
-                }
-            }
+            SampleToFloat(input, *output, *outputCount, info);
         }
 
         /**
-         * 将浮点采样转换为整数格式
-         */
-        /**
-         * 生成TPDF抖动噪声 (Triangular Probability Density Function)
-         * TPDF使用两个均匀分布的随机数相加，产生三角形分布
-         * 这种分布在听觉上比单个均匀分布更自然
+         * 将浮点采样转换为目标格式（分配输出缓冲，调用方以 delete[] (char*) 释放）
          */
-        float AudioMixer::GenerateTPDFDither()
+        void AudioMixer::ConvertFromFloat(const float* input, uint sampleCount, void** output, uint* outputSize, const AudioDataInfo& outputInfo)
         {
-            // 高质量随机源（Mersenne Twister），替代低质量 C rand()
-            // 注：rand() 在 MSVC 上 RAND_MAX=32767，仅 15bit 精度且 LCG 有相关性
-            static thread_local std::mt19937 rng(std::random_device{}());
-            static thread_local std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-
-            // 两个独立均匀分布相加得到三角形分布 (TPDF)
-            const float r1 = dist(rng);
-            const float r2 = dist(rng);
-            return (r1 + r2) * 0.5f;
+            *outputSize = sampleCount * (outputInfo.bits_per_sample / 8);
+            *output = new char[*outputSize];
+
+            if(config.use_dither && !outputInfo.is_float && outputInfo.bits_per_sample == 16)
+                LogInfo(OS_TEXT("Applying TPDF dither for float32->int16 conversion"));
+
+            ConvertFromFloatTo(input, sampleCount, *output, outputInfo);
         }
 
         /**
-         * 将浮点采样转换为目标格式
-         * 支持float32/int32/int16/int8输出，int16转换时可选择使用TPDF抖动
+         * 将浮点采样转换为目标格式，写入调用方缓冲区
+         * 支持float32/int32/int24/int16/int8输出，int16转换时可选择使用TPDF抖动
          */
-        void AudioMixer::ConvertFromFloat(const float* input, uint sampleCount, void** output, uint* outputSize, const AudioDataInfo& outputInfo)
+        void AudioMixer::ConvertFromFloatTo(const float* input, uint sampleCount, void* output, const AudioDataInfo& outputInfo)
         {
-            if(outputInfo.is_float && outputInfo.bits_per_sample == 32)
-            {
-                // 输出float32
-                *outputSize = sampleCount * sizeof(float);
-                *output = new float[sampleCount];
-                memcpy(*output, input, *outputSize);
-            }
-            else if(outputInfo.bits_per_sample == 32)
-            {
-                // 输出int32
-                *outputSize = sampleCount * sizeof(int32_t);
-                int32_t* samples = new int32_t[sampleCount];
-                *output = samples;
-
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    // 钳位到 -1.0 到 1.0
-                    float sample = input[i];
-                    if(sample > 1.0f) sample = 1.0f;
-                    if(sample < -1.0f) sample = -1.0f;
-
-                    samples[i] = (int32_t)((double)sample * 2147483647.0);
-                }
-            }
-            else if(outputInfo.bits_per_sample == 16)
-            {
-                // 输出int16
-                *outputSize = sampleCount * sizeof(int16_t);
-                int16_t* samples = new int16_t[sampleCount];
-                *output = samples;
-
-                if(config.use_dither)
-                {
-                    // 使用TPDF抖动
-                    LogInfo(OS_TEXT("Applying TPDF dither for float32->int16 conversion"));
-
-                    for(uint i = 0; i < sampleCount; i++)
-                    {
-                        // 钳位到 -1.0 到 1.0
-                        float sample = input[i];
-                        if(sample > 1.0f) sample = 1.0f;
-                        if(sample < -1.0f) sample = -1.0f;
-
-                        // 添加TPDF抖动噪声（抖动幅度约为1 LSB）
-                        float dither = GenerateTPDFDither() / 32768.0f;
-                        sample += dither;
-
-                        // 转换为int16
-                        samples[i] = (int16_t)(sample * 32767.0f);
-                    }
-                }
-                else
-                {
-                    // 不使用抖动，直接转换
-                    for(uint i = 0; i < sampleCount; i++)
-                    {
-                        // 钳位到 -1.0 到 1.0
-                        float sample = input[i];
-                        if(sample > 1.0f) sample = 1.0f;
-                        if(sample < -1.0f) sample = -1.0f;
-
-                        // 转换为int16
-                        samples[i] = (int16_t)(sample * 32767.0f);
-                    }
-                }
-            }
-            else if(outputInfo.bits_per_sample == 8)
-            {
-                // 输出int8
-                *outputSize = sampleCount * sizeof(int8_t);
-                int8_t* samples = new int8_t[sampleCount];
-                *output = samples;
-
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    // 钳位到 -1.0 到 1.0
-                    float sample = input[i];
-                    if(sample > 1.0f) sample = 1.0f;
-                    if(sample < -1.0f) sample = -1.0f;
-
-                    // 转换为int8
-                    samples[i] = (int8_t)(sample * 127.0f);
-                }
-            }
+            if(config.use_dither && !outputInfo.is_float && outputInfo.bits_per_sample == 16)
+                FloatToInt16Dither(input, (int16_t*)output, sampleCount, dither);
+            else
+                FloatToSample(input, output, sampleCount, outputInfo);
         }
 
         /**
@@ -213,12 +144,10 @@ namespace hgl::audio
             }
             else
             {
-                if(common_info.sample_rate != info.sample_rate ||
-                   common_info.channels != info.channels ||
-                   common_info.bits_per_sample != info.bits_per_sample ||
-                   common_info.is_float != info.is_float)
+                // 采样率与位深在渲染时逐音源转换，只要求声道数一致
+                if(common_info.channels != info.channels)
                 {
-                    LogError(OS_TEXT("Source audio format/sample rate mismatch; unify before mixing"));
+                    LogError(OS_TEXT("Source audio channel count mismatch; unify before mixing"));
                     return -1;
                 }
             }
@@ -229,6 +158,10 @@ namespace hgl::audio
             source.data_size = info.data_size;
 
             sources.Add(source);
+
+            // 音源数据为借用指针，新增音源时保守地作废全部演绎缓存（流式混音引用缓存，一并结束）
+            ReleaseStreams();
+            renditions.clear();
             return sources.GetCount() - 1;
         }
 
@@ -253,7 +186,9 @@ namespace hgl::audio
          */
         void AudioMixer::ClearSources()
         {
+            ReleaseStreams();
             sources.Clear();
+            renditions.clear();
             has_common_info = false;
         }
 
@@ -282,38 +217,58 @@ namespace hgl::audio
         }
 
         /**
-         * 应用音调变化(简单的线性插值重采样) - float版本
-         * 按帧处理，逐声道线性插值
+         * 规整音调值
          */
-        void AudioMixer::ApplyPitchShift(const float* input, uint inputFrameCount, uint channels,
-                                         float** output, uint* outputFrameCount, float pitch)
+        float AudioMixer::NormalizePitch(float pitch)
         {
-            if(channels == 0)
-                channels = 1;
-
             if(pitch < MinPitch || pitch > MaxPitch)
-                pitch = DefaultPitch;
+                return DefaultPitch;
 
-            // 如果音调不变，直接复制
             if(fabs(pitch - DefaultPitch) < 0.001f)
+                return DefaultPitch;
+
+            return pitch;
+        }
+
+        /**
+         * 计算合并重采样比率
+         */
+        double AudioMixer::GetRenderRatio(uint src_rate, uint dst_rate, float pitch)
+        {
+            pitch = NormalizePitch(pitch);
+
+            if(src_rate == dst_rate || src_rate == 0 || dst_rate == 0)
+                return pitch == DefaultPitch ? 1.0 : 1.0 / static_cast<double>(pitch);
+
+            // libsamplerate 比率 = 输出帧数 / 输入帧数
+            return static_cast<double>(dst_rate) / static_cast<double>(src_rate) / static_cast<double>(pitch);
+        }
+
+        /**
+         * 重采样(libsamplerate) - float版本
+         * 按帧处理，结果写入调用方提供的 vector（由演绎缓存持有）
+         */
+        void AudioMixer::ApplyResample(const float* input, uint inputFrameCount, uint channels,
+                                       std::vector<float>& output, uint* outputFrameCount, double ratio)
+        {
+            if(channels == 0)
+                channels = 1;
+
+            // 比率为 1（同采样率且音调不变），直接复制
+            if(ratio == 1.0)
             {
                 *outputFrameCount = inputFrameCount;
-                *output = new float[inputFrameCount * channels];
-                memcpy(*output, input, inputFrameCount * channels * sizeof(float));
+                output.assign(input, input + inputFrameCount * channels);
                 return;
             }
 
-            // libsamplerate 重采样比率 = 输出帧数 / 输入帧数 = 1/pitch
-            // pitch>1 升调(变快/变短)，pitch<1 降调(变慢/变长)
-            const double ratio = 1.0 / static_cast<double>(pitch);
-
             // 输出帧数向上取整，确保缓冲充足
             *outputFrameCount = static_cast<uint>(std::ceil(static_cast<double>(inputFrameCount) * ratio));
-            *output = new float[*outputFrameCount * channels];
+            output.resize(*outputFrameCount * channels);
 
             SRC_DATA data;
             data.data_in = input;
-            data.data_out = *output;
+            data.data_out = output.data();
             data.input_frames = static_cast<long>(inputFrameCount);
             data.output_frames = static_cast<long>(*outputFrameCount);
             data.end_of_input = 1;
@@ -324,15 +279,218 @@ namespace hgl::audio
             if(result != 0)
             {
                 // 理论上对合法输入不会失败，回退为原样复制保证安全
-                LogError(OS_TEXT("libsamplerate pitch shift failed"));
-                delete[] *output;
+                LogError(OS_TEXT("libsamplerate resample failed"));
                 *outputFrameCount = inputFrameCount;
-                *output = new float[inputFrameCount * channels];
-                memcpy(*output, input, inputFrameCount * channels * sizeof(float));
+                output.assign(input, input + inputFrameCount * channels);
                 return;
             }
 
             *outputFrameCount = static_cast<uint>(data.output_frames_gen);
+            output.resize(*outputFrameCount * channels);
+        }
+
+        /**
+         * 演绎缓存键：音源索引 + 输出采样率 + 规整后 pitch 的位模式
+         */
+        AudioMixer::RenditionKey AudioMixer::MakeRenditionKey(uint source_index, uint sample_rate, float pitch)
+        {
+            pitch = NormalizePitch(pitch);
+
+            RenditionKey key;
+            key.source_index = source_index;
+            key.sample_rate = sample_rate;
+            memcpy(&key.pitch_bits, &pitch, sizeof(key.pitch_bits));
+
+            return key;
+        }
+
+        /**
+         * 取得演绎数据（缓存未命中时生成）
+         */
+        const AudioMixer::Rendition* AudioMixer::GetRendition(uint source_index, uint sample_rate, float pitch)
+        {
+            if(source_index >= (uint)sources.GetCount())
+                return nullptr;
+
+            const RenditionKey key = MakeRenditionKey(source_index, sample_rate, pitch);
+
+            auto it = renditions.find(key);
+            if(it != renditions.end())
+                return &it->second;
+
+            Rendition& r = renditions[key];
+            BuildRendition(source_index, sample_rate, pitch, temp_buffer, r);
+
+            return &r;
+        }
+
+        /**
+         * 生成演绎数据
+         */
+        void AudioMixer::BuildRendition(uint source_index, uint sample_rate, float pitch, AudioMemoryPool<float>& scratch, Rendition& r)
+        {
+            const SourceAudio& source = sources[source_index];
+            const uint channels = common_info.channels ? common_info.channels : 1;
+
+            // 将源数据转换为float（使用调用方的转换缓冲）
+            float* sourceFloat = nullptr;
+            uint sourceFloatCount = 0;
+            ConvertToFloat(source.data, source.data_size, &sourceFloat, &sourceFloatCount, source.info, scratch);
+
+            // 采样率转换与变调合并为一次重采样，不产生中间副本
+            const double ratio = GetRenderRatio(source.info.sample_rate, sample_rate, pitch);
+
+            ApplyResample(sourceFloat, sourceFloatCount / channels, channels, r.samples, &r.frame_count, ratio);
+        }
+
+        /**
+         * 计算实际线程数
+         */
+        uint AudioMixer::GetWorkerCount(uint jobs) const
+        {
+            uint count = config.thread_count;
+
+            if(count == 0)
+            {
+                count = std::thread::hardware_concurrency();
+                if(count == 0)
+                    count = 1;
+            }
+
+            if(count > jobs)
+                count = jobs;
+
+            return count ? count : 1;
+        }
+
+        /**
+         * 为全部轨道准备演绎数据
+         * 缓存的 std::map 只在串行阶段插入（节点地址稳定），并行阶段各线程只写各自的 Rendition
+         */
+        bool AudioMixer::PrepareRenditions()
+        {
+            struct RenditionJob
+            {
+                uint source_index;
+                float pitch;
+                Rendition* target;
+            };
+
+            const uint mixRate = GetMixSampleRate();
+
+            std::vector<RenditionJob> jobs;
+
+            track_renditions.clear();
+            track_renditions.reserve(tracks.GetCount());
+
+            for(auto track:tracks)
+            {
+                if(track.source_index >= (uint)sources.GetCount())
+                {
+                    LogError(OS_TEXT("Track source index out of range"));
+                    RETURN_FALSE;
+                }
+
+                const float pitch = NormalizePitch(track.pitch);
+                const RenditionKey key = MakeRenditionKey(track.source_index, mixRate, pitch);
+
+                auto it = renditions.find(key);
+                if(it == renditions.end())
+                {
+                    it = renditions.emplace(key, Rendition()).first;
+                    jobs.push_back({track.source_index, pitch, &it->second});
+                }
+
+                track_renditions.push_back(&it->second);
+            }
+
+            if(jobs.empty())
+                return(true);
+
+            const uint workers = GetWorkerCount((uint)jobs.size());
+
+            if(workers <= 1)
+            {
+                for(const RenditionJob& job:jobs)
+                    BuildRendition(job.source_index, mixRate, job.pitch, temp_buffer, *job.target);
+
+                return(true);
+            }
+
+            while(worker_buffers.size() < workers)
+                worker_buffers.push_back(std::make_unique<AudioMemoryPool<float>>(OS_TEXT("AudioMixer::worker_buffer")));
+
+            LogInfo(OS_TEXT("Rendering ") + OSString::numberOf((int)jobs.size()) +
+                    OS_TEXT(" source renditions on ") + OSString::numberOf((int)workers) + OS_TEXT(" threads"));
+
+            ParallelFor(workers, (uint)jobs.size(), [&](uint index, uint worker)
+            {
+                const RenditionJob& job = jobs[index];
+                BuildRendition(job.source_index, mixRate, job.pitch, *worker_buffers[worker], *job.target);
+            });
+
+            return(true);
+        }
+
+        /**
+         * 将所有轨道累加到 [beginSample,endSample) 区间
+         */
+        void AudioMixer::AccumulateTracks(float* mixBuffer, uint beginSample, uint endSample, uint outputSampleCount, uint channels, uint sampleRate)
+        {
+            if(endSample > outputSampleCount)
+                endSample = outputSampleCount;
+
+            for(int t = 0; t < tracks.GetCount(); t++)
+            {
+                const MixingTrack& track = tracks[t];
+                const Rendition* rendition = track_renditions[t];
+
+                const float* pitchShiftedData = rendition->samples.data();
+                const uint pitchShiftedSampleCount = rendition->frame_count * channels;
+                const float gain = track.volume * config.master_volume;
+
+                // 计算起始采样位置
+                const uint startFrame = (uint)(track.time_offset * sampleRate);
+                const uint startSample = startFrame * channels;
+
+                // 与本区间求交
+                uint begin = startSample > beginSample ? startSample : beginSample;
+                uint end = startSample + pitchShiftedSampleCount;
+                if(end > endSample)
+                    end = endSample;
+
+                // 混合到输出 (float混音，无需担心溢出)
+                for(uint i = begin; i < end; i++)
+                {
+                    // 应用音量并混合 - float混音非常简单
+                    mixBuffer[i] += pitchShiftedData[i - startSample] * gain;
+                }
+            }
+        }
+
+        /**
+         * 渲染单个音源（不缓存变调结果）
+         */
+        bool AudioMixer::RenderSource(uint source_index, float pitch, std::vector<float>& output, uint* frame_count)
+        {
+            if(!frame_count)
+                return(false);
+
+            if(source_index >= (uint)sources.GetCount())
+            {
+                LogError(OS_TEXT("Render source index out of range"));
+                RETURN_FALSE;
+            }
+
+            // 音源原采样率的 float 数据作为输入，采样率转换与变调一次完成
+            const uint sourceRate = sources[source_index].info.sample_rate;
+            const Rendition* base = GetRendition(source_index, sourceRate, DefaultPitch);
+
+            const uint channels = common_info.channels ? common_info.channels : 1;
+
+            ApplyResample(base->samples.data(), base->frame_count, channels, output, frame_count,
+                          GetRenderRatio(sourceRate, GetMixSampleRate(), pitch));
+            return(true);
         }
 
         /**
@@ -360,6 +518,36 @@ namespace hgl::audio
             }
         }
 
+        /**
+         * 计算混音总时长
+         */
+        bool AudioMixer::ComputeMixLength(float* loopLength)
+        {
+            *loopLength = 0.0f;
+            for(auto track:tracks)
+            {
+                if(track.source_index >= (uint)sources.GetCount())
+                {
+                    LogError(OS_TEXT("Track source index out of range"));
+                    RETURN_FALSE;
+                }
+
+                const SourceAudio& source = sources[track.source_index];
+                uint channels = source.info.channels;
+                if(channels == 0) channels = 1;
+
+                uint bytesPerSample = source.info.bits_per_sample / 8;
+                uint sourceFrameCount = (source.data_size / bytesPerSample) / channels;
+                float sourceDuration = (float)sourceFrameCount / source.info.sample_rate;
+                float trackEnd = track.time_offset + sourceDuration / track.pitch;
+
+                if(trackEnd > *loopLength)
+                    *loopLength = trackEnd;
+            }
+
+            return(true);
+        }
+
         /**
          * 执行混音 - 完全使用float内部处理，使用内存池避免频繁分配
          */
@@ -386,33 +574,15 @@ namespace hgl::audio
             // 如果没有指定循环长度，计算所有轨道的最大时间
             if(loopLength <= 0.0f)
             {
-                loopLength = 0.0f;
-                for(auto track:tracks)
-                {
-                    if(track.source_index >= (uint)sources.GetCount())
-                    {
-                        LogError(OS_TEXT("Track source index out of range"));
-                        RETURN_FALSE;
-                    }
-
-                    const SourceAudio& source = sources[track.source_index];
-                    uint channels = source.info.channels;
-                    if(channels == 0) channels = 1;
-
-                    uint bytesPerSample = source.info.bits_per_sample / 8;
-                    uint sourceFrameCount = (source.data_size / bytesPerSample) / channels;
-                    float sourceDuration = (float)sourceFrameCount / source.info.sample_rate;
-                    float trackEnd = track.time_offset + sourceDuration / track.pitch;
-
-                    if(trackEnd > loopLength)
-                        loopLength = trackEnd;
-                }
+                if(!ComputeMixLength(&loopLength))
+                    RETURN_FALSE;
             }
 
             const uint channels = common_info.channels ? common_info.channels : 1;
+            const uint mixRate = GetMixSampleRate();
 
             // 计算输出帧数与采样数
-            uint outputFrameCount = (uint)(loopLength * common_info.sample_rate);
+            uint outputFrameCount = (uint)(loopLength * mixRate);
             uint outputSampleCount = outputFrameCount * channels;
 
             // 确保缓冲区足够大
@@ -420,7 +590,7 @@ namespace hgl::audio
 
             LogInfo(OS_TEXT("Mixing ") + OSString::numberOf(tracks.GetCount()) +
                     OS_TEXT(" tracks, output duration: ") + OSString::floatOf(loopLength,3) +
-                    OS_TEXT(" seconds, output sample rate: ") + OSString::numberOf((int)common_info.sample_rate) +
+                    OS_TEXT(" seconds, output sample rate: ") + OSString::numberOf((int)mixRate) +
                     OS_TEXT(", output channels: ") + OSString::numberOf((int)channels) +
                     OS_TEXT(", output format: ") + (common_info.is_float ? OS_TEXT("float32") : OS_TEXT("int")) +
                     OS_TEXT(", pool buffer size: ") + OSString::numberOf((int)pool_buffer.GetSize()) + OS_TEXT(" samples"));
@@ -429,49 +599,33 @@ namespace hgl::audio
             float* mixBuffer = pool_buffer.Get();
             memset(mixBuffer, 0, outputSampleCount * sizeof(float));
 
-            // 为每个轨道应用变换并混音
-            for(auto track:tracks)
-            {
-                if(track.source_index >= (uint)sources.GetCount())
-                {
-                    LogError(OS_TEXT("Track source index out of range"));
-                    RETURN_FALSE;
-                }
-
-                const SourceAudio& source = sources[track.source_index];
-
-                // 将源数据转换为float（使用临时缓冲区）
-                float* sourceFloat = nullptr;
-                uint sourceFloatCount = 0;
-                ConvertToFloat(source.data, source.data_size, &sourceFloat, &sourceFloatCount, source.info);
-
-                // 应用音调变化（按帧处理）
-                uint sourceFrameCount = sourceFloatCount / channels;
-                float* pitchShiftedData = nullptr;
-                uint pitchShiftedFrameCount = 0;
-                ApplyPitchShift(sourceFloat, sourceFrameCount, channels,
-                              &pitchShiftedData, &pitchShiftedFrameCount, track.pitch);
+            // 取得各轨道 (source,pitch) 演绎数据：相同组合的轨道与后续 Mix() 直接复用，未命中的可并行生成
+            if(!PrepareRenditions())
+                RETURN_FALSE;
 
-                uint pitchShiftedSampleCount = pitchShiftedFrameCount * channels;
+            // 按输出区间切分累加：每个采样仍按轨道顺序相加，与串行结果逐位一致
+            const uint chunkCount = outputFrameCount / PARALLEL_MIN_CHUNK_FRAMES;
+            const uint workers = GetWorkerCount(chunkCount);
 
-                // 计算起始采样位置
-                uint startFrame = (uint)(track.time_offset * common_info.sample_rate);
-                uint startSample = startFrame * channels;
+            if(workers <= 1)
+            {
+                AccumulateTracks(mixBuffer, 0, outputSampleCount, outputSampleCount, channels, mixRate);
+            }
+            else
+            {
+                const uint chunkSamples = ((outputFrameCount + chunkCount - 1) / chunkCount) * channels;
 
-                // 混合到输出 (float混音，无需担心溢出)
-                for(uint i = 0; i < pitchShiftedSampleCount && (startSample + i) < outputSampleCount; i++)
+                ParallelFor(workers, chunkCount, [&](uint chunk, uint)
                 {
-                    // 应用音量并混合 - float混音非常简单
-                    mixBuffer[startSample + i] += pitchShiftedData[i] * track.volume * config.master_volume;
-                }
-
-                delete[] pitchShiftedData;
+                    const uint begin = chunk * chunkSamples;
+                    AccumulateTracks(mixBuffer, begin, begin + chunkSamples, outputSampleCount, channels, mixRate);
+                });
             }
 
             // 应用参数化 EQ（P2：在削波/归一化之前，EQ 改变峰值后由削波兜底）
             if(eq.GetBandCount() > 0)
             {
-                eq.SetSampleRate((float)common_info.sample_rate);
+                eq.SetSampleRate((float)mixRate);
                 eq.Reset();
                 eq.Process(mixBuffer, outputSampleCount);
                 LogInfo(OS_TEXT("Applying parametric EQ (") + OSString::numberOf(eq.GetBandCount()) + OS_TEXT(" bands)"));
@@ -528,4 +682,230 @@ namespace hgl::audio
             return(true);
         }
 
+        /**
+         * 释放流式混音状态
+         */
+        void AudioMixer::ReleaseStreams()
+        {
+            for(TrackStream& ts:streams)
+            {
+                if(ts.src)
+                    src_delete(ts.src);
+            }
+
+            streams.clear();
+            streaming = false;
+            stream_frame_count = 0;
+            stream_position = 0;
+        }
+
+        /**
+         * 开始流式混音
+         */
+        bool AudioMixer::BeginMix(float loopLength)
+        {
+            ReleaseStreams();
+
+            if(sources.GetCount() == 0)
+            {
+                LogError(OS_TEXT("No source audio data"));
+                RETURN_FALSE;
+            }
+
+            if(tracks.GetCount() == 0)
+            {
+                LogError(OS_TEXT("No mixing tracks"));
+                RETURN_FALSE;
+            }
+
+            if(!has_common_info)
+            {
+                LogError(OS_TEXT("No common audio format info"));
+                RETURN_FALSE;
+            }
+
+            const uint channels = common_info.channels ? common_info.channels : 1;
+            const uint mixRate = GetMixSampleRate();
+
+            if(!output_format.is_float && output_format.channels != channels)
+            {
+                LogError(OS_TEXT("Output format channel count must match source channel count"));
+                RETURN_FALSE;
+            }
+
+            if(loopLength <= 0.0f)
+            {
+                if(!ComputeMixLength(&loopLength))
+                    RETURN_FALSE;
+            }
+
+            streams.reserve(tracks.GetCount());
+
+            for(auto track:tracks)
+            {
+                if(track.source_index >= (uint)sources.GetCount())
+                {
+                    LogError(OS_TEXT("Track source index out of range"));
+                    ReleaseStreams();
+                    RETURN_FALSE;
+                }
+
+                TrackStream ts;
+
+                // 音源原始 float 数据走演绎缓存，采样率转换+变调在 MixBlock 中一次流式完成
+                const uint sourceRate = sources[track.source_index].info.sample_rate;
+
+                ts.base = GetRendition(track.source_index, sourceRate, DefaultPitch);
+                ts.start_frame = (uint)(track.time_offset * mixRate);
+                ts.gain = track.volume * config.master_volume;
+                ts.ratio = GetRenderRatio(sourceRate, mixRate, track.pitch);
+
+                if(ts.ratio != 1.0)
+                {
+                    int error = 0;
+
+                    ts.src = src_new(SRC_SINC_MEDIUM_QUALITY, static_cast<int>(channels), &error);
+
+                    if(!ts.src)
+                    {
+                        LogError(OS_TEXT("libsamplerate src_new failed"));
+                        ReleaseStreams();
+                        RETURN_FALSE;
+                    }
+                }
+
+                streams.push_back(ts);
+            }
+
+            // EQ 状态跨块保持，只在开始时复位
+            if(eq.GetBandCount() > 0)
+            {
+                eq.SetSampleRate((float)mixRate);
+                eq.Reset();
+            }
+
+            if(config.normalize && !config.use_soft_clipper)
+                LogInfo(OS_TEXT("Peak normalization is not available in streaming mix, samples beyond [-1,1] will be hard clipped"));
+
+            stream_frame_count = (uint)(loopLength * mixRate);
+            stream_position = 0;
+            streaming = true;
+
+            LogInfo(OS_TEXT("Begin streaming mix of ") + OSString::numberOf(tracks.GetCount()) +
+                    OS_TEXT(" tracks, duration: ") + OSString::floatOf(loopLength,3) + OS_TEXT(" seconds"));
+
+            return(true);
+        }
+
+        /**
+         * 流式渲染单个轨道的下一段
+         */
+        uint AudioMixer::RenderTrackBlock(TrackStream& ts, float* output, uint frames, uint channels)
+        {
+            const uint total = ts.base->frame_count;
+
+            if(!ts.src)
+            {
+                // 原始音调：直接拷贝
+                uint count = total - ts.read_frame;
+                if(count > frames)
+                    count = frames;
+
+                memcpy(output, ts.base->samples.data() + (size_t)ts.read_frame * channels, (size_t)count * channels * sizeof(float));
+                ts.read_frame += count;
+
+                if(ts.read_frame >= total)
+                    ts.finished = true;
+
+                return count;
+            }
+
+            uint generated = 0;
+
+            while(generated < frames)
+            {
+                SRC_DATA data;
+                data.data_in = ts.base->samples.data() + (size_t)ts.read_frame * channels;
+                data.data_out = output + (size_t)generated * channels;
+                data.input_frames = static_cast<long>(total - ts.read_frame);
+                data.output_frames = static_cast<long>(frames - generated);
+                data.end_of_input = 1;          // 剩余输入一次性提供，SRC 内部保留滤波状态
+                data.src_ratio = ts.ratio;
+
+                const int result = src_process(ts.src, &data);
+                if(result != 0)
+                {
+                    LogError(OS_TEXT("libsamplerate streaming resample failed"));
+                    ts.finished = true;
+                    break;
+                }
+
+                ts.read_frame += static_cast<uint>(data.input_frames_used);
+                generated += static_cast<uint>(data.output_frames_gen);
+
+                if(data.output_frames_gen == 0)
+                {
+                    // 输入耗尽且尾部已冲刷完毕
+                    ts.finished = true;
+                    break;
+                }
+            }
+
+            return generated;
+        }
+
+        /**
+         * 渲染下一块
+         */
+        uint AudioMixer::MixBlock(void* dst, uint frames)
+        {
+            if(!streaming || !dst || frames == 0)
+                return 0;
+
+            if(stream_position >= stream_frame_count)
+                return 0;
+
+            if(frames > stream_frame_count - stream_position)
+                frames = stream_frame_count - stream_position;
+
+            const uint channels = common_info.channels ? common_info.channels : 1;
+            const uint sampleCount = frames * channels;
+            const uint blockEnd = stream_position + frames;
+
+            block_buffer.Ensure(sampleCount);
+            track_buffer.Ensure(sampleCount);
+
+            float* mixBuffer = block_buffer.Get();
+            memset(mixBuffer, 0, sampleCount * sizeof(float));
+
+            for(TrackStream& ts:streams)
+            {
+                if(ts.finished || ts.start_frame >= blockEnd)
+                    continue;
+
+                // 轨道在本块中间开始时，从对应偏移处写入
+                const uint offset = ts.start_frame > stream_position ? ts.start_frame - stream_position : 0;
+
+                const uint got = RenderTrackBlock(ts, track_buffer.Get(), frames - offset, channels);
+
+                const float* trackData = track_buffer.Get();
+                float* out = mixBuffer + (size_t)offset * channels;
+                const uint count = got * channels;
+
+                for(uint i = 0; i < count; i++)
+                    out[i] += trackData[i] * ts.gain;
+            }
+
+            if(eq.GetBandCount() > 0)
+                eq.Process(mixBuffer, sampleCount);
+
+            if(config.use_soft_clipper)
+                ApplySoftClipping(mixBuffer, sampleCount);
+
+            ConvertFromFloatTo(mixBuffer, sampleCount, dst, output_format);
+
+            stream_position = blockEnd;
+            return frames;
+        }
+
 }//namespace hgl::audio
@@ -1,8 +1,10 @@
 #include<hgl/audio/AudioMixerScene.h>
+#include<hgl/audio/SampleConvert.h>
 #include<string.h>
 #include<algorithm>
 #include<vector>
 #include<cstdint>
+#include<cmath>
 
 using namespace openal;
 
@@ -47,17 +49,6 @@ namespace hgl::audio
             return dist(rng);
         }
 
-        bool AudioMixerScene::HasAnyEffects() const
-        {
-            for(auto& [sourceName, srcConfig] : sources)
-            {
-                if((srcConfig.filter_config.enable && srcConfig.filter_config.filter_type != AudioFilterType::None) || srcConfig.reverb.enable)
-                    return true;
-            }
-
-            return false;
-        }
-
         AudioFilterConfig AudioMixerScene::BuildRandomFilterConfig(const AudioMixerSourceConfig& config)
         {
             AudioFilterConfig filter = config.filter_config;
@@ -195,72 +186,88 @@ namespace hgl::audio
         }
 
 
-        bool AudioMixerScene::ConvertFloatToOutput(const float* input, uint sampleCount, void** outputData, uint* outputSize)
+        /**
+         * 估算简易混响的尾音帧数：反馈衰减到 -60dB 所需的延迟次数 × 延迟长度
+         */
+        uint AudioMixerScene::GetReverbTailFrames(uint sample_rate, const AudioMixerSourceConfig::SimpleReverbConfig& config)
         {
-            if(!input || !outputData || !outputSize)
-                return(false);
+            if(!config.enable || sample_rate == 0)
+                return 0;
 
-            const AudioDataInfo &outInfo = output_format;
+            float delay_ms = std::clamp(config.delay_ms, 1.0f, 200.0f);
+            float feedback = std::clamp(config.feedback, 0.0f, 0.95f);
 
-            if(outInfo.is_float && outInfo.bits_per_sample == 32)
+            uint delay_frames = (uint)(delay_ms * (float)sample_rate / 1000.0f);
+
+            uint repeats = 1;
+            if(feedback > 0.0f)
+                repeats += (uint)std::ceil(std::log(0.001f) / std::log(feedback));
+
+            return delay_frames * repeats;
+        }
+
+        /**
+         * 对整个场景应用全局混音配置（主音量 + 软削波/归一化），只在最后执行一次
+         */
+        void AudioMixerScene::ApplyGlobalConfig(float* samples, uint count)
+        {
+            if(global_config.master_volume != 1.0f)
             {
-                *outputData = (void*)input;
-                *outputSize = sampleCount * sizeof(float);
-                return(true);
+                for(uint i = 0; i < count; i++)
+                    samples[i] *= global_config.master_volume;
             }
 
-            if(outInfo.bits_per_sample == 32)
+            if(global_config.use_soft_clipper)
             {
-                uint totalSize = sampleCount * sizeof(int32_t);
-                temp_buffer.Ensure(totalSize);
-                int32_t* output = (int32_t*)temp_buffer.Get();
-
-                for(uint i = 0; i < sampleCount; i++)
+                for(uint i = 0; i < count; i++)
+                    samples[i] = tanhf(samples[i]);
+            }
+            else if(global_config.normalize)
+            {
+                float peak = 0.0f;
+                for(uint i = 0; i < count; i++)
                 {
-                    float sample = std::clamp(input[i], -1.0f, 1.0f);
-                    output[i] = (int32_t)((double)sample * 2147483647.0);
+                    float abs_sample = fabsf(samples[i]);
+                    if(abs_sample > peak)
+                        peak = abs_sample;
                 }
 
-                *outputData = output;
-                *outputSize = totalSize;
-                return(true);
+                if(peak > 1.0f)
+                {
+                    float normFactor = 1.0f / peak;
+                    LogInfo(OS_TEXT("Normalizing scene, peak: ") + OSString::floatOf(peak,3));
+
+                    for(uint i = 0; i < count; i++)
+                        samples[i] *= normFactor;
+                }
             }
+        }
 
-            if(outInfo.bits_per_sample == 16)
-            {
-                uint totalSize = sampleCount * sizeof(int16_t);
-                temp_buffer.Ensure(totalSize);
-                int16_t* output = (int16_t*)temp_buffer.Get();
+        bool AudioMixerScene::ConvertFloatToOutput(const float* input, uint sampleCount, void** outputData, uint* outputSize)
+        {
+            if(!input || !outputData || !outputSize)
+                return(false);
 
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    float sample = std::clamp(input[i], -1.0f, 1.0f);
-                    output[i] = (int16_t)(sample * 32767.0f);
-                }
+            const AudioDataInfo &outInfo = output_format;
 
-                *outputData = output;
-                *outputSize = totalSize;
+            if(outInfo.is_float && outInfo.bits_per_sample == 32)
+            {
+                *outputData = (void*)input;
+                *outputSize = sampleCount * sizeof(float);
                 return(true);
             }
 
-            if(outInfo.bits_per_sample == 8)
-            {
-                uint totalSize = sampleCount * sizeof(int8_t);
-                temp_buffer.Ensure(totalSize);
-                int8_t* output = (int8_t*)temp_buffer.Get();
+            if(!IsSampleFormatSupported(outInfo))
+                return(false);
 
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    float sample = std::clamp(input[i], -1.0f, 1.0f);
-                    output[i] = (int8_t)(sample * 127.0f);
-                }
+            uint totalSize = sampleCount * (outInfo.bits_per_sample / 8);
+            temp_buffer.Ensure(totalSize);
 
-                *outputData = output;
-                *outputSize = totalSize;
-                return(true);
-            }
+            FloatToSample(input, temp_buffer.Get(), sampleCount, outInfo);
 
-            return(false);
+            *outputData = temp_buffer.Get();
+            *outputSize = totalSize;
+            return(true);
         }
 
         /**
@@ -289,15 +296,11 @@ namespace hgl::audio
             }
             else
             {
-                // 验证格式一致性
-                if(config.info.sample_rate != source_format.sample_rate ||
-                   config.info.channels != source_format.channels ||
-                   config.info.bits_per_sample != source_format.bits_per_sample ||
-                   config.info.is_float != source_format.is_float)
+                // 采样率/位深由实例渲染器逐音源转换，只验证声道数一致
+                if(config.info.channels != source_format.channels)
                 {
                     LogError(OS_TEXT("Format mismatch for: ") + name +
-                            OS_TEXT(". All sources must have sample_rate=") + OSString::numberOf((int)source_format.sample_rate) +
-                            OS_TEXT(", channels=") + OSString::numberOf((int)source_format.channels));
+                            OS_TEXT(". All sources must have channels=") + OSString::numberOf((int)source_format.channels));
                     return;
                 }
             }
@@ -359,25 +362,29 @@ namespace hgl::audio
                 RETURN_FALSE;
             }
 
-            if(output_format.sample_rate != sourceInfo.sample_rate)
+            if(output_format.sample_rate == 0)
             {
-                LogError(OS_TEXT("Output sample rate must match source sample rate for AudioMixer"));
+                LogError(OS_TEXT("Invalid output sample rate"));
                 RETURN_FALSE;
             }
 
-            bool mix_in_float = outInfo.is_float || HasAnyEffects();
+            // 实例直接渲染到输出采样率：采样率转换与随机变调合并为一次重采样
+            {
+                AudioDataInfo renderInfo = outInfo;
+                renderInfo.is_float = true;
+                renderInfo.bits_per_sample = 32;
+                renderer.SetOutputFormat(renderInfo);
+            }
 
-            uint bytesPerSample = mix_in_float ? sizeof(float) : (outInfo.bits_per_sample / 8);
-            uint bytesPerFrame = bytesPerSample * channels;
             uint totalFrames = (uint)(duration * output_format.sample_rate);
             uint totalSamples = totalFrames * channels;
-            uint totalSize = totalFrames * bytesPerFrame;
+            uint totalSize = totalSamples * sizeof(float);
 
-            // 使用内存池分配输出缓冲区
+            // 场景始终以 float 累加，各实例只写入自身时间跨度，最后统一归一化/转换一次
             pool_buffer.Ensure(totalSize);
 
-            char* outputBuffer = pool_buffer.Get();
-            memset(outputBuffer, 0, totalSize);
+            float* sceneSamples = (float*)pool_buffer.Get();
+            memset(sceneSamples, 0, totalSize);
 
             LogInfo(OS_TEXT("Using pool buffer: size=") + OSString::numberOf((int)pool_buffer.GetSize()) +
                    OS_TEXT(" bytes, required=") + OSString::numberOf((int)totalSize) + OS_TEXT(" bytes"));
@@ -385,6 +392,17 @@ namespace hgl::audio
             // 为每个音源生成实例并混音
             for(auto& [sourceName, srcConfig] : sources)
             {
+                // 每个音源只转换一次 float，各实例在此基础上变调
+                renderer.ClearSources();
+                int source_index = renderer.AddSourceAudio(srcConfig.info, srcConfig.data);
+                if(source_index < 0)
+                {
+                    LogError(OS_TEXT("Failed to add source audio for scene renderer"));
+                    RETURN_FALSE;
+                }
+
+                const bool has_effects = (srcConfig.filter_config.enable && srcConfig.filter_config.filter_type != AudioFilterType::None) || srcConfig.reverb.enable;
+
                 // 确定生成数量
                 uint count = RandomUInt(srcConfig.min_count, srcConfig.max_count);
 
@@ -392,29 +410,10 @@ namespace hgl::audio
                        OS_TEXT(", generating ") + OSString::numberOf((int)count) +
                        OS_TEXT(" instances"));
 
-                // 为每个实例创建混音器
                 float currentTimeOffset = 0.0f;
 
                 for(uint i = 0; i < count; i++)
                 {
-                    AudioMixer instanceMixer;
-                    int source_index = instanceMixer.AddSourceAudio(srcConfig.info, srcConfig.data);
-                    if(source_index < 0)
-                    {
-                        LogError(OS_TEXT("Failed to add source audio for mixer instance"));
-                        RETURN_FALSE;
-                    }
-                    // 浮点混音时，AudioMixer::Mix 会直接透传按源声道数交织的 float 缓冲，
-                    // 输出格式声明的声道数被忽略，因此 float32 仅作为占位符。
-                    AudioDataInfo instanceOutputFormat = output_format;
-                    if(mix_in_float)
-                    {
-                        instanceOutputFormat.channels = srcConfig.info.channels;
-                        instanceOutputFormat.bits_per_sample = 32;
-                        instanceOutputFormat.is_float = true;
-                    }
-                    instanceMixer.SetOutputFormat(instanceOutputFormat);
-
                     // 生成随机时间偏移
                     if(i == 0)
                     {
@@ -436,125 +435,61 @@ namespace hgl::audio
                     float volume = RandomFloat(srcConfig.min_volume, srcConfig.max_volume);
                     float pitch = RandomFloat(srcConfig.min_pitch, srcConfig.max_pitch);
 
-                    // 添加单个轨道
-                    instanceMixer.AddTrack((uint)source_index, currentTimeOffset, volume, pitch);
+                    const uint startFrame = (uint)(currentTimeOffset * output_format.sample_rate);
+                    if(startFrame >= totalFrames)
+                        continue;
 
-                    // 混音到临时缓冲区(使用temp buffer避免频繁分配)
-                    void* instanceData = nullptr;
-                    uint instanceSize = 0;
+                    uint instanceFrames = 0;
+                    if(!renderer.RenderSource((uint)source_index, pitch, instance_buffer, &instanceFrames))
+                        RETURN_FALSE;
 
-                    if(instanceMixer.Mix(&instanceData, &instanceSize, duration))
-                    {
-                        // 确保临时缓冲区足够大以容纳实例数据
-                        temp_buffer.Ensure(instanceSize);
+                    // 实例跨度 = 自身时长（+混响尾音），截断到场景末尾
+                    uint spanFrames = instanceFrames;
 
-                        // 复制到临时缓冲区(这样可以让AudioMixer内部复用它的池)
-                        memcpy(temp_buffer.Get(), instanceData, instanceSize);
+                    if(has_effects)
+                    {
+                        AudioFilterConfig filter = BuildRandomFilterConfig(srcConfig);
 
-                        if(mix_in_float)
-                        {
-                            float* instanceSamples = (float*)temp_buffer.Get();
-                            uint instanceSampleCount = instanceSize / sizeof(float);
-                            uint outputSampleCount = totalSize / sizeof(float);
-                            uint sampleCount = std::min(instanceSampleCount, outputSampleCount);
-
-                            if((srcConfig.filter_config.enable && srcConfig.filter_config.filter_type != AudioFilterType::None) || srcConfig.reverb.enable)
-                            {
-                                AudioFilterConfig filter = BuildRandomFilterConfig(srcConfig);
-
-                                AudioMixerSourceConfig::SimpleReverbConfig reverb = srcConfig.reverb;
-                                if(reverb.enable)
-                                {
-                                    if(reverb.delay_ms_rand != 0.0f)
-                                        reverb.delay_ms = std::clamp(reverb.delay_ms + RandomFloat(-reverb.delay_ms_rand, reverb.delay_ms_rand), 1.0f, 200.0f);
-                                    if(reverb.feedback_rand != 0.0f)
-                                        reverb.feedback = std::clamp(reverb.feedback + RandomFloat(-reverb.feedback_rand, reverb.feedback_rand), 0.0f, 0.95f);
-                                    if(reverb.mix_rand != 0.0f)
-                                        reverb.mix = std::clamp(reverb.mix + RandomFloat(-reverb.mix_rand, reverb.mix_rand), 0.0f, 1.0f);
-                                }
-
-                                ApplyFilter(instanceSamples, sampleCount, channels, filter);
-                                ApplySimpleReverb(instanceSamples, sampleCount, channels, output_format.sample_rate, reverb);
-                            }
-
-                            float* outputSamples = (float*)outputBuffer;
-                            for(uint s = 0; s < sampleCount; s++)
-                            {
-                                outputSamples[s] += instanceSamples[s];
-                            }
-                        }
-                        else if(outInfo.bits_per_sample == 16)
-                        {
-                            int16_t* outputSamples = (int16_t*)outputBuffer;
-                            const int16_t* instanceSamples = (const int16_t*)temp_buffer.Get();
-                            uint outputSampleCount = totalSize / sizeof(int16_t);
-                            uint instanceSampleCount = instanceSize / sizeof(int16_t);
-                            uint sampleCount = std::min(instanceSampleCount, outputSampleCount);
-
-                            for(uint s = 0; s < sampleCount; s++)
-                            {
-                                int32_t mixed = outputSamples[s] + instanceSamples[s];
-
-                                // 限幅
-                                if(mixed > 32767) mixed = 32767;
-                                if(mixed < -32768) mixed = -32768;
-
-                                outputSamples[s] = (int16_t)mixed;
-                            }
-                        }
-                        else if(outInfo.bits_per_sample == 8)
-                        {
-                            int8_t* outputSamples = (int8_t*)outputBuffer;
-                            const int8_t* instanceSamples = (const int8_t*)temp_buffer.Get();
-                            uint outputSampleCount = totalSize / sizeof(int8_t);
-                            uint instanceSampleCount = instanceSize / sizeof(int8_t);
-                            uint sampleCount = std::min(instanceSampleCount, outputSampleCount);
-
-                            for(uint s = 0; s < sampleCount; s++)
-                            {
-                                int16_t mixed = outputSamples[s] + instanceSamples[s];
-
-                                // 限幅
-                                if(mixed > 127) mixed = 127;
-                                if(mixed < -128) mixed = -128;
-
-                                outputSamples[s] = (int8_t)mixed;
-                            }
-                        }
-                        else if(outInfo.bits_per_sample == 32)
+                        AudioMixerSourceConfig::SimpleReverbConfig reverb = srcConfig.reverb;
+                        if(reverb.enable)
                         {
-                            int32_t* outputSamples = (int32_t*)outputBuffer;
-                            const int32_t* instanceSamples = (const int32_t*)temp_buffer.Get();
-                            uint outputSampleCount = totalSize / sizeof(int32_t);
-                            uint instanceSampleCount = instanceSize / sizeof(int32_t);
-                            uint sampleCount = std::min(instanceSampleCount, outputSampleCount);
-
-                            for(uint s = 0; s < sampleCount; s++)
-                            {
-                                int64_t mixed = (int64_t)outputSamples[s] + instanceSamples[s];
-
-                                // 限幅
-                                if(mixed > 2147483647LL) mixed = 2147483647LL;
-                                if(mixed < -2147483648LL) mixed = -2147483648LL;
-
-                                outputSamples[s] = (int32_t)mixed;
-                            }
+                            if(reverb.delay_ms_rand != 0.0f)
+                                reverb.delay_ms = std::clamp(reverb.delay_ms + RandomFloat(-reverb.delay_ms_rand, reverb.delay_ms_rand), 1.0f, 200.0f);
+                            if(reverb.feedback_rand != 0.0f)
+                                reverb.feedback = std::clamp(reverb.feedback + RandomFloat(-reverb.feedback_rand, reverb.feedback_rand), 0.0f, 0.95f);
+                            if(reverb.mix_rand != 0.0f)
+                                reverb.mix = std::clamp(reverb.mix + RandomFloat(-reverb.mix_rand, reverb.mix_rand), 0.0f, 1.0f);
                         }
+
+                        spanFrames += GetReverbTailFrames(output_format.sample_rate, reverb);
+                        spanFrames = std::min(spanFrames, totalFrames - startFrame);
+
+                        // 尾音区补零，供混响衰减（RenderSource 输出恰为 instanceFrames 帧）
+                        if(spanFrames > instanceFrames)
+                            instance_buffer.resize((size_t)spanFrames * channels, 0.0f);
+
+                        ApplyFilter(instance_buffer.data(), spanFrames * channels, channels, filter);
+                        ApplySimpleReverb(instance_buffer.data(), spanFrames * channels, channels, output_format.sample_rate, reverb);
                     }
+                    else
+                    {
+                        spanFrames = std::min(spanFrames, totalFrames - startFrame);
+                    }
+
+                    // 按音量直接累加到场景缓冲的对应跨度
+                    const float* instanceSamples = instance_buffer.data();
+                    float* dst = sceneSamples + (size_t)startFrame * channels;
+                    const uint spanSamples = spanFrames * channels;
+
+                    for(uint s = 0; s < spanSamples; s++)
+                        dst[s] += instanceSamples[s] * volume;
                 }
             }
 
-            if(mix_in_float)
-            {
-                float* mixSamples = (float*)outputBuffer;
-                if(!ConvertFloatToOutput(mixSamples, totalSamples, outputData, outputSize))
-                    RETURN_FALSE;
-            }
-            else
-            {
-                *outputData = outputBuffer;
-                *outputSize = totalSize;
-            }
+            ApplyGlobalConfig(sceneSamples, totalSamples);
+
+            if(!ConvertFloatToOutput(sceneSamples, totalSamples, outputData, outputSize))
+                RETURN_FALSE;
 
             LogInfo(OS_TEXT("Scene generation completed successfully"));
             return(true);
@@ -0,0 +1,253 @@
+﻿#include<hgl/audio/AudioParallelDecode.h>
+#include<hgl/log/Log.h>
+#include"AudioDecode.h"
+#include<atomic>
+#include<thread>
+#include<vector>
+#include<new>
+#include<climits>
+
+namespace hgl::audio
+{
+    namespace
+    {
+        constexpr uint PARALLEL_DECODE_READ_BYTES=256*1024;     ///< 每次 Read 的最大字节数（按帧对齐）
+
+        std::atomic<uint>   parallel_segments{0};
+        std::atomic<double> parallel_min_seconds{AUDIO_PARALLEL_DECODE_MIN_SECONDS};
+
+        /**
+        * 分段解码任务：同一份压缩数据，各段独立句柄，写入同一块输出缓冲的不同区间
+        */
+        struct ParallelDecodeJob
+        {
+            const DecodedAudio *plugin;
+            AudioSeekPlugInInterface seek;
+
+            ALbyte *memory;
+            ALsizei memory_size;
+            bool use_float;
+
+            char *output;
+            uint frame_bytes;
+            int64 preroll_frames;           ///< 段首之前额外解码并丢弃的帧数（让解码器状态收敛）
+
+            std::atomic<bool> failed{false};
+
+            /**
+            * 读取并丢弃 frames 帧
+            */
+            bool Skip(void *handle,int64 frames)
+            {
+                const uint chunk=(PARALLEL_DECODE_READ_BYTES/frame_bytes)*frame_bytes;
+                std::vector<char> scratch(chunk);
+
+                uint64 remain=uint64(frames)*frame_bytes;
+
+                while(remain>0)
+                {
+                    const uint want=remain>chunk?chunk:uint(remain);
+                    const uint got=use_float?plugin->decode_float.Read(handle,(float *)scratch.data(),want)
+                                            :plugin->decode.Read(handle,scratch.data(),want);
+
+                    if(got==0||got>want)
+                        return(false);
+
+                    remain-=got;
+                }
+
+                return(true);
+            }
+
+            /**
+            * 解码 [start,end) 帧到 output 的对应位置，必须恰好得到 end-start 帧
+            */
+            void DecodeRange(int64 start,int64 end)
+            {
+                ALenum format;
+                ALsizei rate;
+                double time;
+
+                void *handle=plugin->decode.Open(memory,memory_size,&format,&rate,&time);
+
+                if(!handle)
+                {
+                    failed=true;
+                    return;
+                }
+
+                // 两个库的 PCM 定位都精确到采样，定位后以 TellPCM 再确认
+                // Vorbis 定位后解码器状态与顺序解码相同；Opus 定位只做 80ms 预滚，段首仍有明显误差，
+                // 因此再提前 preroll_frames 开始解码并丢弃，之后只剩极小的残差
+                const int64 preroll=start<preroll_frames?start:preroll_frames;
+                const int64 seek_to=start-preroll;
+
+                if(seek_to>0&&!seek.SeekPCM(handle,seek_to))
+                    failed=true;
+                else
+                if(seek.TellPCM(handle)!=seek_to)
+                    failed=true;
+                else
+                if(preroll>0&&!Skip(handle,preroll))
+                    failed=true;
+
+                char *dst=output+start*frame_bytes;
+                uint64 remain=uint64(end-start)*frame_bytes;
+                const uint chunk=(PARALLEL_DECODE_READ_BYTES/frame_bytes)*frame_bytes;
+
+                while(remain>0&&!failed)
+                {
+                    const uint want=remain>chunk?chunk:uint(remain);
+                    const uint got=use_float?plugin->decode_float.Read(handle,(float *)dst,want)
+                                            :plugin->decode.Read(handle,dst,want);
+
+                    if(got==0||got>want)
+                        break;
+
+                    dst+=got;
+                    remain-=got;
+                }
+
+                plugin->decode.Close(handle);
+
+                if(remain>0)                // 数据提前结束或解码出错：整体回退到顺序解码
+                    failed=true;
+            }
+        };//struct ParallelDecodeJob
+    }//namespace
+
+    void SetParallelDecodeSegments(uint count)
+    {
+        parallel_segments=count;
+    }
+
+    uint GetParallelDecodeSegments()
+    {
+        const uint count=parallel_segments;
+
+        if(count>0)
+            return count;
+
+        const uint cores=std::thread::hardware_concurrency();
+
+        if(cores<2)return 1;
+
+        return cores<AUDIO_PARALLEL_DECODE_MAX_SEGMENTS?cores:AUDIO_PARALLEL_DECODE_MAX_SEGMENTS;
+    }
+
+    void SetParallelDecodeMinSeconds(double seconds)
+    {
+        parallel_min_seconds=seconds<0?0:seconds;
+    }
+
+    double GetParallelDecodeMinSeconds()
+    {
+        return parallel_min_seconds;
+    }
+
+    bool DecodeAudioParallel(const os_char *plugin_name,DecodedAudio *result,void *memory,int memory_size,bool use_float,double preroll_seconds)
+    {
+        const uint max_segments=GetParallelDecodeSegments();
+
+        if(max_segments<2)return(false);
+
+        if(!result->decode.Open||!result->decode.Close)return(false);
+        if(use_float?!result->decode_float.Read:!result->decode.Read)return(false);
+
+        ParallelDecodeJob job;
+
+        if(!GetAudioSeekInterface(plugin_name,&job.seek)||!job.seek.SeekPCM||!job.seek.TellPCM)
+            return(false);
+
+        job.plugin      =result;
+        job.memory      =(ALbyte *)memory;
+        job.memory_size =memory_size;
+        job.use_float   =use_float;
+
+        // 先用一个句柄取得格式与精确总帧数（SeekPCM 超出长度时停在结尾）
+        ALenum format=0;
+        ALsizei rate=0;
+        double total_time=0;
+        int64 total_frames=-1;
+
+        {
+            void *probe=result->decode.Open(job.memory,memory_size,&format,&rate,&total_time);
+
+            if(!probe)return(false);
+
+            if(rate>0&&total_time>=GetParallelDecodeMinSeconds()&&job.seek.SeekPCM(probe,INT64_MAX))
+                total_frames=job.seek.TellPCM(probe);
+
+            result->decode.Close(probe);
+        }
+
+        if(total_frames<=0)
+            return(false);
+
+        AudioDataInfo info;
+
+        if(!openal::FromOpenALFormat(format,info))
+            return(false);
+
+        if(use_float)               // Open 返回 16 位格式，浮点 Read 输出同声道数的 float32
+        {
+            info.bits_per_sample=32;
+            info.is_float=true;
+            format=openal::ToOpenALFormat(info);
+
+            if(!format)return(false);
+        }
+
+        job.frame_bytes=info.channels*info.bits_per_sample/8;
+        job.preroll_frames=int64(preroll_seconds*rate);
+
+        if(job.frame_bytes==0)
+            return(false);
+
+        const uint64 total_bytes=uint64(total_frames)*job.frame_bytes;
+
+        if(total_bytes>INT_MAX)     // ALsizei 容纳不下
+            return(false);
+
+        uint segments=uint(total_frames/int64(rate*AUDIO_PARALLEL_DECODE_SEGMENT_SECONDS));
+
+        if(segments>max_segments)segments=max_segments;
+        if(segments<2)return(false);
+
+        job.output=new(std::nothrow) char[total_bytes];
+
+        if(!job.output)
+            return(false);
+
+        {
+            std::vector<std::thread> workers;
+
+            workers.reserve(segments-1);
+
+            for(uint i=1;i<segments;i++)
+                workers.emplace_back(&ParallelDecodeJob::DecodeRange,&job,total_frames*i/segments,total_frames*(i+1)/segments);
+
+            job.DecodeRange(0,total_frames/segments);           // 第一段在当前线程解码
+
+            for(std::thread &t:workers)
+                t.join();
+        }
+
+        if(job.failed)
+        {
+            delete[] job.output;
+
+            GLogInfo(OS_TEXT("Parallel decode failed, fallback to sequential decode: ")+OSString(plugin_name));
+            return(false);
+        }
+
+        result->use_float   =use_float;
+        result->host_owned  =true;
+        result->format      =format;
+        result->data        =job.output;
+        result->size        =ALsizei(total_bytes);
+        result->freq        =rate;
+
+        return(true);
+    }
+}//namespace hgl::audio
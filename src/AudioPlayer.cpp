@@ -1,10 +1,20 @@
 ﻿#include<hgl/audio/AudioPlayer.h>
 #include<hgl/audio/CaptureSource.h>
+#include<hgl/audio/AudioAssetManager.h>
 #include<hgl/log/Log.h>
 #include<hgl/plugin/PlugIn.h>
 #include<hgl/io/MemoryInputStream.h>
 #include<hgl/io/FileInputStream.h>
+#include<hgl/audio/AudioCrossfade.h>
+#include<hgl/audio/SampleConvert.h>
 #include"AudioDecode.h"
+#include"AudioChainStream.h"
+#include"MappedWAV.h"
+
+#include<climits>
+#include<cmath>
+#include<cstring>
+#include<utility>
 
 using namespace openal;
 
@@ -29,11 +39,15 @@ namespace hgl::audio
 
         audio_data=nullptr;
         audio_data_size=0;
+        mapped_file=nullptr;
+        input_stream=nullptr;
 
         audio_buffer=nullptr;
         audio_buffer_size=0;
 
         decoder=nullptr;
+        float_decoder=nullptr;
+        seeker=nullptr;
 
         play_state=PlayState::None;
 
@@ -44,13 +58,45 @@ namespace hgl::audio
 
         loop=false;             // atom<bool> 默认构造不初始化，必须显式置位（否则 Execute 的 if(loop) 读垃圾值循环播放）
 
+        buffer_count=AUDIO_PLAYER_DEFAULT_BUFFERS;
+        buffer_time=AUDIO_PLAYER_DEFAULT_BUFFER_TIME;
+        refill_mode=AudioRefillMode::Event;
+
+        preroll_data=nullptr;
+        preroll_count=0;
+        preroll_on_load=false;
+
+        ResetStartStats();
+
+        next_stream=nullptr;
+        decode_frame=0;
+        next_start_frame=-1;
+        next_decode_frame=0;
+        fade_frames=0;
+        fade_pos=0;
+        fading=false;
+        next_block=nullptr;
+        mix_buffer=nullptr;
+        transition_count=0;
+
+        render_block=0;
+        played_block=0;
+        handoff_block=-1;
+        handoff_base=0;
+        handoff_total_time=0;
+        chained=false;
+
+        source_id=0;
+
         if(!audiosource.Create())return;
 
         audiosource.SetLoop(false);
 
         source_id=audiosource.GetIndex();
 
-        alGenBuffers(3,al_buffers);
+        alGenBuffers(AUDIO_PLAYER_MAX_BUFFERS,al_buffers);
+
+        RegisterSourceEvents(source_id);            //设备不支持 AL_SOFT_events 时回退为轮询
     }
 
     AudioPlayer::AudioPlayer()
@@ -82,15 +128,28 @@ namespace hgl::audio
 
     AudioPlayer::~AudioPlayer()
     {
-        SAFE_CLEAR(decoder);
+        Stop();                             //先退出服务/播放线程，返回后服务不再访问本对象
 
-        if(!audio_data&&!realtime_source)return;
+        UnregisterSourceEvents();
 
-        Clear();
+        if(HasSource())
+        {
+            Clear();                        //先经解码器关闭流句柄，再释放插件接口
 
-        alDeleteBuffers(3,al_buffers);
+            alDeleteBuffers(AUDIO_PLAYER_MAX_BUFFERS,al_buffers);
 
-        SAFE_CLEAR_ARRAY(audio_buffer);
+            SAFE_CLEAR_ARRAY(audio_buffer);
+        }
+
+        SAFE_CLEAR_ARRAY(preroll_data);
+
+        ClearNext();
+        SAFE_CLEAR_ARRAY(next_block);
+        SAFE_CLEAR_ARRAY(mix_buffer);
+
+        SAFE_CLEAR(decoder);
+        SAFE_CLEAR(float_decoder);
+        SAFE_CLEAR(seeker);
     }
 
     bool AudioPlayer::Load(AudioFileType aft)
@@ -99,13 +158,12 @@ namespace hgl::audio
 
         if(!plugin_name)return(false);
 
-        decoder=new AudioPlugInInterface;
+        SAFE_CLEAR(decoder);
+        SAFE_CLEAR(float_decoder);
+        SAFE_CLEAR(seeker);
 
-        if (!GetAudioInterface(plugin_name, decoder, nullptr))
+        if(!CreateAudioDecoder(plugin_name,IsSupportFloatAudioData(),&decoder,&float_decoder,&seeker))     //不支持定位时只能从头播放
         {
-            delete decoder;
-            decoder=nullptr;
-
             LogError(OS_TEXT("无法加载音频解码插件：")+OSString(plugin_name));
             return(false);
         }
@@ -113,26 +171,212 @@ namespace hgl::audio
         {
             double open_total_time=0;
 
-            audio_ptr=decoder->Open(audio_data,audio_data_size,&al_format,&sample_rate,&open_total_time);
+            if(input_stream)
+            {
+                AudioStreamPlugInInterface stream_api;
+
+                if(!GetAudioStreamInterface(plugin_name,&stream_api))
+                {
+                    LogError(OS_TEXT("音频解码插件不支持流式读取：")+OSString(plugin_name));
+                    return(false);
+                }
 
-            total_time=open_total_time;
+                audio_ptr=stream_api.OpenStream(AudioReadAheadStream::GetCallbacks(),input_stream,&al_format,&sample_rate,&open_total_time);
+            }
+            else
+                audio_ptr=decoder->Open(audio_data,audio_data_size,&al_format,&sample_rate,&open_total_time);
+
+            if(!audio_ptr)
+            {
+                LogError(OS_TEXT("音频解码插件无法打开数据：")+OSString(plugin_name));
+                return(false);
+            }
 
-            audio_buffer_size=(AudioTime(al_format,sample_rate)+9)/10;        // 1/10 秒
+            total_time=open_total_time;
 
-            if(audio_buffer)
-                delete[] audio_buffer;
+            // 插件有浮点流式读取时直接解码为 float 上传，省去 int16 量化/反量化（保留 EQ 等后处理的余量）
+            if(float_decoder)
+            {
+                const ALenum float_format=GetFloatDecodeFormat(al_format);
 
-            audio_buffer=new char[audio_buffer_size];
+                if(float_format)
+                    al_format=float_format;
+                else
+                    SAFE_CLEAR(float_decoder);
+            }
 
-            wait_time=0.1;
+            InitStreamBuffer();
 
-            if(wait_time>total_time.load()/3.0f)
-                wait_time=total_time.load()/10.0f;
+            if(preroll_on_load)
+                PrerollBuffers();
 
             return(true);
         }
     }
 
+    void AudioPlayer::InitStreamBuffer()
+    {
+        const int frame_bytes=AudioTime(al_format,1);
+
+        audio_buffer_size=int(std::ceil(AudioTime(al_format,sample_rate)*buffer_time));
+        audio_buffer_size-=audio_buffer_size%frame_bytes;             // 对齐到整帧
+
+        if(audio_buffer_size<frame_bytes)
+            audio_buffer_size=frame_bytes;
+
+        SAFE_CLEAR_ARRAY(audio_buffer);
+
+        audio_buffer=new char[audio_buffer_size];
+
+        SAFE_CLEAR_ARRAY(preroll_data);     //缓冲区长度变化，预解码数据作废
+        preroll_count=0;
+
+        SAFE_CLEAR_ARRAY(next_block);
+        SAFE_CLEAR_ARRAY(mix_buffer);
+
+        if(next_stream)
+            InitChainBuffer();
+
+        wait_time=buffer_time;
+
+        if(total_time.load()>0&&wait_time>total_time.load()/3.0f)        //不可定位的流时长未知(0)
+            wait_time=total_time.load()/10.0f;
+    }
+
+    /**
+    * 设置轮转缓冲区数量与每个缓冲区时长
+    * @param count 缓冲区数量（2 到 AUDIO_PLAYER_MAX_BUFFERS）
+    * @param seconds 每个缓冲区时长（秒，不小于 AUDIO_PLAYER_MIN_BUFFER_TIME）
+    * @return 是否设置成功，播放/暂停中返回 false
+    */
+    bool AudioPlayer::SetStreamBuffers(uint count,double seconds)
+    {
+        if(count<2||count>AUDIO_PLAYER_MAX_BUFFERS)return(false);
+        if(seconds<AUDIO_PLAYER_MIN_BUFFER_TIME)return(false);
+
+        bool result=false;
+
+        lock.Lock();
+
+        const PlayState state=play_state.load();
+
+        if(state!=PlayState::Play&&state!=PlayState::Pause)
+        {
+            if(count!=buffer_count)
+            {
+                SAFE_CLEAR_ARRAY(preroll_data);     //预解码区按 buffer_count 分配，数量变化后重新分配
+                preroll_count=0;
+            }
+
+            buffer_count=count;
+            buffer_time=seconds;
+
+            if(decoder&&audio_ptr)                  //已加载：按新时长重新分配（实时源的缓冲区大小由帧长决定）
+            {
+                InitStreamBuffer();
+
+                if(preroll_on_load)
+                    PrerollBuffers();
+            }
+
+            result=true;
+        }
+
+        lock.Unlock();
+
+        return(result);
+    }
+
+    /**
+    * 从头解码前 buffer_count 个缓冲区到内存，解码器停在这些数据之后
+    * 只解码不上传，因此可以在没有绑定 OpenAL context 的加载线程中执行
+    */
+    bool AudioPlayer::PrerollBuffers()
+    {
+        preroll_count=0;
+
+        if(realtime_source||!decoder||!audio_ptr||audio_buffer_size<=0)
+            return(false);
+
+        SeekDecoder(0);
+
+        if(!preroll_data)
+            preroll_data=new char[size_t(audio_buffer_size)*buffer_count];
+
+        while(preroll_count<buffer_count)
+        {
+            const uint size=RenderBlock(preroll_data+size_t(audio_buffer_size)*preroll_count);
+
+            if(!size)break;
+
+            preroll_sizes[preroll_count++]=size;
+            ++render_block;
+        }
+
+        return(preroll_count>0);
+    }
+
+    uint AudioPlayer::UploadPreroll()
+    {
+        uint count=0;
+
+        while(count<preroll_count)
+        {
+            alBufferData(al_buffers[count],al_format,preroll_data+size_t(audio_buffer_size)*count,preroll_sizes[count],sample_rate);
+
+            if(alLastError())break;
+
+            ++count;
+        }
+
+        preroll_count=0;
+        return(count);
+    }
+
+    bool AudioPlayer::Preroll()
+    {
+        if(!HasSource())return(false);
+
+        bool result=false;
+
+        lock.Lock();
+
+        const PlayState state=play_state.load();
+
+        if(state!=PlayState::Play&&state!=PlayState::Pause)
+            result=PrerollBuffers();
+
+        lock.Unlock();
+
+        return(result);
+    }
+
+    AudioPlayerStartStats AudioPlayer::GetStartStats()
+    {
+        lock.Lock();
+        const AudioPlayerStartStats stats=start_stats;
+        lock.Unlock();
+
+        return(stats);
+    }
+
+    void AudioPlayer::ResetStartStats()
+    {
+        lock.Lock();
+        start_stats={};
+        lock.Unlock();
+    }
+
+    void AudioPlayer::SetRefillMode(AudioRefillMode mode)
+    {
+        refill_mode=mode;
+
+        if(mode==AudioRefillMode::Event)
+            RegisterSourceEvents(source_id);
+        else
+            UnregisterSourceEvents();
+    }
+
     /**
     * 从流中加载音频数据,仅支持OGG
     * @param stream 要加载数据的流
@@ -185,9 +429,69 @@ namespace hgl::audio
             return(false);
         }
 
-        io::OpenFileInputStream file_stream(filename);
+        Clear();
+
+        // 内存映射文件：解码插件直接从映射读取（WAV 原地流式输出），不再整文件复制到内存
+        if(MapAudioFile(filename,&mapped_file,&audio_data,&audio_data_size))
+        {
+            if(Load(aft))
+                return(true);
+
+            Clear();
+        }
 
-        return(Load(file_stream,file_stream->Available(),aft));
+        if(!ReadAudioFile(filename,&audio_data,&audio_data_size))
+            return(false);
+
+        return Load(aft);
+    }
+
+    /**
+    * 按加载模式加载一个音频文件
+    * @param filename 音频文件名称
+    * @param aft 音频文件类型
+    * @param mode Full/Compressed=整文件映射后按需解码；Stream=打开文件流边读边解码（插件不支持时回退到Full）
+    * @return 是否加载成功
+    */
+    bool AudioPlayer::Load(const os_char *filename,AudioFileType aft,AudioLoadMode mode)
+    {
+        if(mode!=AudioLoadMode::Stream)
+            return Load(filename,aft);
+
+        if(!alGenBuffers)return(false);
+        if(!filename||!(*filename))return(false);
+
+        if(!RangeCheck(aft))
+            aft=CheckAudioFileType(filename);
+
+        io::FileInputStream *fis=new io::FileInputStream;
+
+        if(!fis->Open(filename))
+            delete fis;
+        else
+        if(LoadStream(fis,aft,true))
+            return(true);
+
+        return Load(filename,aft);          //WAV 等不支持回调读取的格式走内存映射
+    }
+
+    bool AudioPlayer::LoadStream(InputStream *stream,AudioFileType aft,bool owned)
+    {
+        if(!alGenBuffers||!stream||!RangeCheck(aft))
+        {
+            if(owned)delete stream;
+            return(false);
+        }
+
+        Clear();
+
+        input_stream=new AudioReadAheadStream(stream,owned);
+
+        if(Load(aft))
+            return(true);
+
+        Clear();                            //同时释放 input_stream（及 owned 的 stream）
+        return(false);
     }
 
     bool AudioPlayer::LoadCapture(uint sr,uint frame_ms,bool use_mock)
@@ -226,14 +530,32 @@ namespace hgl::audio
         if(decoder&&audio_ptr)
             decoder->Close(audio_ptr);
 
-        SAFE_CLEAR_ARRAY(audio_data);
+        SAFE_CLEAR(input_stream);           //解码器关闭后才能释放数据源
+
+        if(mapped_file)
+        {
+            SAFE_CLEAR(mapped_file);
+            audio_data=nullptr;
+        }
+        else
+            SAFE_CLEAR_ARRAY(audio_data);
+
         SAFE_CLEAR_ARRAY(audio_buffer);
+        SAFE_CLEAR_ARRAY(preroll_data);
+        preroll_count=0;
+
+        ClearNext();
+        SAFE_CLEAR_ARRAY(next_block);
+        SAFE_CLEAR_ARRAY(mix_buffer);
 
         audio_ptr=nullptr;
 
         total_time=0;
         realtime_source=false;
 
+        handoff_block=-1;
+        chained=false;
+
         SAFE_CLEAR(capture);
     }
 
@@ -253,6 +575,321 @@ namespace hgl::audio
         lock.Unlock();
     }
 
+    uint AudioPlayer::DecodeBlock(char *data,uint size)
+    {
+        const uint total=ReadAudioDecoder(decoder,float_decoder,audio_ptr,data,size);
+
+        decode_frame+=total/AudioTime(al_format,1);
+        return(total);
+    }
+
+    /**
+    * 输出一个缓冲区长度的数据
+    * 有下一文件时按帧拆分：淡化开始前只解码当前文件，淡化中两路混合，当前文件结束或淡化完成时在该帧切换，
+    * 块内剩余部分继续由新的当前文件填充，因此接续点没有静音也没有重复
+    */
+    uint AudioPlayer::RenderBlock(char *data)
+    {
+        if(!next_stream)
+            return DecodeBlock(data,audio_buffer_size);
+
+        const uint frame_bytes=AudioTime(al_format,1);
+        const uint block_frames=audio_buffer_size/frame_bytes;
+
+        uint done=0;
+
+        while(done<block_frames&&next_stream)
+        {
+            char *dst=data+size_t(done)*frame_bytes;
+            uint want=block_frames-done;
+
+            if(!fading)
+            {
+                if(next_start_frame>=0)
+                {
+                    if(decode_frame>=next_start_frame)
+                    {
+                        fading=true;
+                        fade_pos=0;
+                        continue;
+                    }
+
+                    if(next_start_frame-decode_frame<int64(want))
+                        want=uint(next_start_frame-decode_frame);
+                }
+
+                const uint got=DecodeBlock(dst,want*frame_bytes)/frame_bytes;
+
+                done+=got;
+
+                if(got<want)                //当前文件结束：在最后一个采样之后接续
+                    ChainNext(done);
+            }
+            else
+            {
+                if(fade_frames-fade_pos<want)
+                    want=fade_frames-fade_pos;
+
+                RenderCrossfade(dst,want);
+
+                done+=want;
+                fade_pos+=want;
+
+                if(fade_pos>=fade_frames)
+                    ChainNext(done);
+            }
+        }
+
+        if(done<block_frames)
+            done+=DecodeBlock(data+size_t(done)*frame_bytes,(block_frames-done)*frame_bytes)/frame_bytes;
+
+        return done*frame_bytes;
+    }
+
+    void AudioPlayer::RenderCrossfade(char *data,uint frames)
+    {
+        AudioDataInfo info;
+
+        FromOpenALFormat(al_format,info);
+
+        const uint bytes=frames*AudioTime(al_format,1);
+        const uint samples=frames*info.channels;
+
+        const uint from=DecodeBlock(data,bytes);
+        const uint to=next_stream->Read(next_block,bytes);
+
+        if(from<bytes)memset(data+from,0,bytes-from);           //任一方提前结束按静音混合
+        if(to<bytes)memset(next_block+to,0,bytes-to);
+
+        next_decode_frame+=to/AudioTime(al_format,1);
+
+        // 第 i 帧位置 (fade_pos+i+1)/fade_frames，淡化最后一帧正好全部是下一文件
+        const float step=1.0f/float(fade_frames);
+        const float start=float(fade_pos+1)*step;
+
+        if(info.is_float)
+        {
+            CrossfadeEqualPower((const float *)data,(const float *)next_block,(float *)data,frames,info.channels,start,step);
+        }
+        else
+        {
+            float *from_float=mix_buffer;
+            float *to_float=mix_buffer+audio_buffer_size/(info.bits_per_sample/8);
+
+            SampleToFloat(data,from_float,samples,info);
+            SampleToFloat(next_block,to_float,samples,info);
+
+            CrossfadeEqualPower(from_float,to_float,from_float,frames,info.channels,start,step);
+
+            FloatToSample(from_float,data,samples,info);
+        }
+    }
+
+    /**
+    * 下一文件成为当前文件：交换两组数据源，原来的当前文件随即关闭
+    * 此时切换点之前还有已排队的缓冲区未播放，播放计数与总时长要等含切换点的缓冲区播完后才改为新文件的（见 UpdateBuffer）
+    * @param block_frame 切换点在当前输出块中的帧位置，块内此后的数据来自新文件
+    */
+    void AudioPlayer::ChainNext(uint block_frame)
+    {
+        AudioChainStream *ns=next_stream;
+
+        std::swap(audio_data,       ns->audio_data);
+        std::swap(audio_data_size,  ns->audio_data_size);
+        std::swap(mapped_file,      ns->mapped_file);
+        std::swap(input_stream,     ns->input_stream);
+        std::swap(audio_ptr,        ns->audio_ptr);
+        std::swap(decoder,          ns->decoder);
+        std::swap(float_decoder,    ns->float_decoder);
+        std::swap(seeker,           ns->seeker);
+
+        decode_frame=fading?next_decode_frame:0;
+
+        // 尚有未生效的切换（文件短于排队长度）时以最后一次为准
+        handoff_block=render_block;
+        handoff_base=(decode_frame-int64(block_frame))*AudioTime(al_format,1);
+        handoff_total_time=ns->total_time;
+
+        next_stream=nullptr;
+        delete ns;                          //关闭原当前文件
+
+        next_start_frame=-1;
+        next_decode_frame=0;
+        fade_frames=0;
+        fade_pos=0;
+        fading=false;
+
+        ++transition_count;
+    }
+
+    void AudioPlayer::ApplyHandoff()
+    {
+        total_time=handoff_total_time;
+        handoff_block=-1;
+        chained=true;
+    }
+
+    void AudioPlayer::ClearNext()
+    {
+        SAFE_CLEAR(next_stream);
+
+        next_start_frame=-1;
+        next_decode_frame=0;
+        fade_frames=0;
+        fade_pos=0;
+        fading=false;
+    }
+
+    void AudioPlayer::InitChainBuffer()
+    {
+        if(!next_block)
+            next_block=new char[audio_buffer_size];
+
+        if(!mix_buffer)
+        {
+            AudioDataInfo info;
+
+            if(FromOpenALFormat(al_format,info)&&!info.is_float)
+                mix_buffer=new float[size_t(audio_buffer_size/(info.bits_per_sample/8))*2];
+        }
+    }
+
+    /**
+    * 设置下一文件（调用方持有 lock）
+    * @param ns 已打开的下一文件（成功时接管）
+    * @param seconds 交叉淡化时长（秒）
+    * @param immediate true=从当前解码位置开始淡化，false=在当前文件结尾前淡化/接续
+    */
+    bool AudioPlayer::SetNext(AudioChainStream *ns,double seconds,bool immediate)
+    {
+        if(!HasSource()||realtime_source||!decoder||!audio_ptr)
+            return(false);
+
+        if(fading)
+            return(false);
+
+        AudioDataInfo info;
+
+        if(ns->al_format!=al_format||ns->sample_rate!=sample_rate
+         ||!FromOpenALFormat(al_format,info)||!IsSampleFormatSupported(info))
+        {
+            LogError(OS_TEXT("接续的音频格式与当前播放的不同，无法在同一音源中接续。"));
+            return(false);
+        }
+
+        int64 frames=seconds>0?int64(seconds*sample_rate+0.5):0;
+
+        if(ns->total_time>0&&frames>int64(ns->total_time*sample_rate))
+            frames=int64(ns->total_time*sample_rate);
+
+        int64 start=-1;
+
+        if(immediate)
+        {
+            if(frames<1)frames=1;
+
+            start=decode_frame;
+        }
+        else
+        if(frames>0&&total_time.load()>0)
+        {
+            const int64 end=int64(total_time.load()*sample_rate+0.5);
+
+            if(frames>end)frames=end;
+
+            start=end-frames;
+
+            if(start<decode_frame)              //已经过了淡化起点：从当前位置开始，淡化相应缩短
+            {
+                frames-=decode_frame-start;
+                start=decode_frame;
+            }
+        }
+
+        if(start<0||frames<=0||frames>int64(UINT_MAX))       //无缝接续
+        {
+            start=-1;
+            frames=0;
+        }
+
+        // OpenAL 的 8 位 PCM 是无符号数（128=静音），转换内核按有符号 int8 解释，不能混合；无缝接续不混合，不受影响
+        if(frames>0&&info.bits_per_sample==8)
+        {
+            LogError(OS_TEXT("8 位音频不支持交叉淡化。"));
+            return(false);
+        }
+
+        ClearNext();
+
+        next_stream=ns;
+        next_start_frame=start;
+        fade_frames=uint(frames);
+
+        InitChainBuffer();
+
+        return(true);
+    }
+
+    bool AudioPlayer::QueueNext(const os_char *filename,double crossfade,AudioFileType aft)
+    {
+        if(!HasSource())return(false);
+
+        AudioChainStream *ns=new AudioChainStream;
+
+        if(!ns->Open(filename,aft,float_decoder!=nullptr))         //IO 与插件打开不占用播放器锁
+        {
+            delete ns;
+            return(false);
+        }
+
+        lock.Lock();
+        const bool result=SetNext(ns,crossfade,false);
+        lock.Unlock();
+
+        if(!result)
+            delete ns;
+
+        return(result);
+    }
+
+    bool AudioPlayer::CrossfadeTo(const os_char *filename,double seconds,AudioFileType aft)
+    {
+        if(!HasSource())return(false);
+
+        AudioChainStream *ns=new AudioChainStream;
+
+        if(!ns->Open(filename,aft,float_decoder!=nullptr))
+        {
+            delete ns;
+            return(false);
+        }
+
+        lock.Lock();
+        const bool result=SetNext(ns,seconds,true);
+        lock.Unlock();
+
+        if(!result)
+            delete ns;
+
+        return(result);
+    }
+
+    bool AudioPlayer::HasNext()
+    {
+        lock.Lock();
+        const bool result=(next_stream!=nullptr);
+        lock.Unlock();
+
+        return(result);
+    }
+
+    void AudioPlayer::CancelNext()
+    {
+        lock.Lock();
+        ClearNext();
+        lock.Unlock();
+    }
+
     bool AudioPlayer::ReadData(ALuint n)
     {
         if(realtime_source)
@@ -275,12 +912,12 @@ namespace hgl::audio
 
         if(!decoder)return(false);
 
-        uint size;
-
-        size=decoder->Read(audio_ptr,audio_buffer,audio_buffer_size);
+        const uint size=RenderBlock(audio_buffer);
 
         if(size)
         {
+            ++render_block;
+
             alBufferData(n,al_format,audio_buffer,size,sample_rate);
 
             if(alLastError())return(false);
@@ -291,38 +928,104 @@ namespace hgl::audio
         return(false);
     }
 
-    bool AudioPlayer::Playback()
+    /**
+    * 将解码器定位到指定时间，并按实际到达的位置设置播放数据计数
+    * @param seconds 目标时间(秒)，<=0或插件不支持定位时回到开头
+    * @return 实际定位到的时间(秒)
+    */
+    double AudioPlayer::SeekDecoder(double seconds)
     {
-        if(!audio_data&&!realtime_source)return(false);
+        audio_buffer_count=0;
+        decode_frame=0;
+        render_block=0;
+
+        if(handoff_block>=0)                //定位的是已切换到的新文件，切换立即生效
+            ApplyHandoff();
+
+        if(fading)                          //淡化中的两路位置无法一起定位，取消淡化
+            ClearNext();
+
+        if(seconds<=0||!seeker||sample_rate<=0)
+        {
+            decoder->Restart(audio_ptr);
+            return(0);
+        }
+
+        const int64 frame=int64(seconds*sample_rate);
+
+        if(!seeker->SeekPCM(audio_ptr,frame))
+        {
+            LogError(OS_TEXT("音频解码定位失败，从头播放。frame: ")+OSString::numberOf(frame));
+
+            decoder->Restart(audio_ptr);
+            return(0);
+        }
+
+        int64 pos=seeker->TellPCM(audio_ptr);
+
+        if(pos<0)pos=frame;
+
+        audio_buffer_count=uint(pos*AudioTime(al_format,1));        // AudioTime(format,1)即每帧字节数
+        decode_frame=pos;
+
+        return double(pos)/double(sample_rate);
+    }
+
+    /**
+    * 重新填充缓冲区并开始播放
+    * @param start_offset 起始时间(秒)
+    * @param paused 填充后保持暂停（暂停中跳转用）
+    */
+    bool AudioPlayer::Playback(double start_offset,bool paused)
+    {
+        if(!HasSource())return(false);
         if(!decoder&&!realtime_source)return(false);
 
         alSourceStop(source_id);
         ClearBuffer();
 
+        uint count=0;
+
+        played_block=0;
+
         if(realtime_source)
+        {
             capture->Start();               // 重新开始采集
+            audio_buffer_count=0;
+            start_offset=0;
+        }
         else
-            decoder->Restart(audio_ptr);
-
-        int count=0;
-
-        audio_buffer_count=0;
-
-        if(ReadData(al_buffers[0]))
+        if(start_offset<=0&&preroll_count>0)        //从头播放且已预解码：解码器已在预解码数据之后，只需上传
         {
-            count++;
+            audio_buffer_count=0;
+            start_offset=0;
 
-            if(ReadData(al_buffers[1]))                //以免有些音效太短，在这里直接失败
-                count++;
+            count=UploadPreroll();
+        }
+        else
+        {
+            preroll_count=0;                        //解码器将被重新定位
+            start_offset=SeekDecoder(start_offset);
+        }
 
-            if(ReadData(al_buffers[2]))                //以免有些音效太短，在这里直接失败
-                count++;
+        while(count<buffer_count&&ReadData(al_buffers[count]))     //以免有些音效太短，读不满时只排队已读到的
+            ++count;
 
+        if(count>0)
+        {
             alSourceQueueBuffers(source_id,count,al_buffers);
-            alSourcePlay(source_id);
-            start_time=GetTimeSec();
+            start_time=GetTimeSec()-start_offset;           // 淡入淡出按文件内时间计算
+
+            if(paused)
+            {
+                play_state=PlayState::Pause;
+            }
+            else
+            {
+                alSourcePlay(source_id);
+                play_state=PlayState::Play;
+            }
 
-            play_state=PlayState::Play;
             return(true);
         }
         else
@@ -339,40 +1042,98 @@ namespace hgl::audio
     */
     void AudioPlayer::Play(bool _loop)
     {
-        if(!audio_data&&!realtime_source)return;
+        PlayFrom(0,_loop);
+    }
+
+    /**
+    * 从指定时间开始播放（解码插件不支持定位时从头播放）
+    * @param start_offset 起始时间(秒)
+    * @param _loop 是否循环播放（循环时回到开头）
+    */
+    void AudioPlayer::PlayFrom(double start_offset,bool _loop)
+    {
+        if(!HasSource())return;
+
+        const PreciseTime call_time=GetTimeSec();
 
         lock.Lock();
 
         loop=_loop;
 
         if(play_state.load()==PlayState::None||play_state.load()==PlayState::Pause)      //未启动线程
-            Start();
+            StartService();
+
+        const bool use_preroll=!realtime_source&&start_offset<=0&&preroll_count>0;
+
+        if(Playback(start_offset))          //Execute执行有检测Lock，所以不必担心该操作会引起线程冲突
+        {
+            const double latency=GetTimeSec()-call_time;
+
+            ++start_stats.start_count;
 
-        Playback();            //Execute执行有检测Lock，所以不必担心该操作会引起线程冲突
+            if(use_preroll)
+                ++start_stats.preroll_count;
+
+            start_stats.last_latency=latency;
+            start_stats.total_latency+=latency;
+
+            if(latency>start_stats.max_latency)
+                start_stats.max_latency=latency;
+        }
 
         lock.Unlock();
     }
 
     /**
-    * 停止播放
+    * 跳转到指定时间，丢弃已排队的缓冲区并从新位置重新填充
+    * 暂停中跳转仍保持暂停；未在播放时返回false（请使用PlayFrom）
+    * @param seconds 目标时间(秒)
+    * @return 是否跳转成功
     */
-    void AudioPlayer::Stop()
+    bool AudioPlayer::Seek(double seconds)
     {
-        if(!audio_data&&!realtime_source)return;
+        if(realtime_source||!HasSource()||!decoder||!seeker)return(false);
+
+        bool result=false;
+
+        lock.Lock();
+
+        const PlayState state=play_state.load();
 
-        bool thread_is_live=true;
+        if(state==PlayState::Play||state==PlayState::Pause)
+        {
+            result=Playback(seconds,state==PlayState::Pause);
+
+            if(!result&&state==PlayState::Pause)        //暂停中播放线程已退出，回到未播放状态以便重新Play
+                play_state=PlayState::None;
+        }
+
+        lock.Unlock();
+
+        return(result);
+    }
 
+    /**
+    * 停止播放
+    */
+    void AudioPlayer::Stop()
+    {
         lock.Lock();
 
-        if(Thread::IsLive())
+        const bool thread_is_live=Thread::IsLive();
+
+        if(IsStreamAttached()||thread_is_live)
             play_state=PlayState::Exit;
-        else
-            thread_is_live=false;
 
         lock.Unlock();
 
+        DetachStreamService();              //仍在服务中时由服务线程停止音源、清空队列后移除；返回后服务不再访问本对象
+
         if(thread_is_live)
+        {
+            SignalStreamEvent();            //打断等待中的 WaitRefill
             Thread::WaitExit();
+        }
 
         play_state=PlayState::None;
     }
@@ -382,13 +1143,17 @@ namespace hgl::audio
     */
     void AudioPlayer::Pause()
     {
-        if(!audio_data&&!realtime_source)return;
+        if(!HasSource())return;
 
         lock.Lock();
 
         if(play_state.load()==PlayState::Play)
+        {
             play_state=PlayState::Pause;
 
+            WakeStreamService();
+        }
+
         lock.Unlock();
     }
 
@@ -397,7 +1162,7 @@ namespace hgl::audio
     */
     void AudioPlayer::Resume()
     {
-        if(!audio_data&&!realtime_source)return;
+        if(!HasSource())return;
 
         lock.Lock();
 
@@ -405,7 +1170,7 @@ namespace hgl::audio
         {
             play_state=PlayState::Play;
 
-            Thread::Start();
+            StartService();
         }
 
         lock.Unlock();
@@ -414,7 +1179,6 @@ namespace hgl::audio
     bool AudioPlayer::UpdateBuffer()
     {
         int processed=0;
-        bool active=true;
 
         alGetSourcei(source_id,AL_BUFFERS_PROCESSED,&processed);        //取得处理结束的缓冲区数量
 
@@ -422,9 +1186,24 @@ namespace hgl::audio
 
         const PreciseTime cur_time=GetTimeSec();
 
+        if(processed>int(buffer_count))processed=buffer_count;
+
+        played_block+=processed;
+
+        if(handoff_block>=0&&played_block>handoff_block)       //含切换点的缓冲区已播完：播放计数与淡入淡出改按新文件内的位置
+        {
+            audio_buffer_count=uint(handoff_base+int64(audio_buffer_size)*(played_block-handoff_block));
+
+            ApplyHandoff();
+
+            start_time=cur_time-AudioDataTime(audio_buffer_count,al_format,sample_rate);
+        }
+        else
+            audio_buffer_count+=audio_buffer_size*processed;
+
         if(!realtime_source&&(fade_in_time>0||fade_out_time>0))
         {
-            const float factor=FadeFactor(cur_time-start_time,fade_in_time,fade_out_time,total_time.load());
+            const float factor=FadeFactor(cur_time-start_time,chained?0.0:fade_in_time,fade_out_time,total_time.load());
 
             audiosource.SetGain(float(factor*gain));
         }
@@ -446,27 +1225,23 @@ namespace hgl::audio
             }
         }
 
-        while(processed--)
-        {
-            ALuint buffer;
+        ALuint buffers[AUDIO_PLAYER_MAX_BUFFERS];
 
-            audio_buffer_count+=audio_buffer_size;
+        alSourceUnqueueBuffers(source_id,processed,buffers);   //一次解除全部已处理完成的缓冲区
+        alLastError();
 
-            alSourceUnqueueBuffers(source_id,1,&buffer);       //解除一个已处理完成的缓冲区
-            alLastError();
+        int filled=0;
 
-            active=ReadData(buffer);                        //解码数据到这个缓冲区
+        while(filled<processed&&ReadData(buffers[filled]))     //解码数据到这些缓冲区
+            ++filled;
 
-            if(active)
-            {
-                alSourceQueueBuffers(source_id,1,&buffer);     //重新将这个缓冲区加入队列
-                alLastError();
-            }
-            else
-                return(false);
+        if(filled>0)
+        {
+            alSourceQueueBuffers(source_id,filled,buffers);    //一次重新加入队列
+            alLastError();
         }
 
-        return(true);
+        return(filled==processed);
     }
 
     void AudioPlayer::ClearBuffer()
@@ -489,76 +1264,158 @@ namespace hgl::audio
         return hgl::Thread::ProcStartThread();
     }
 
-    bool AudioPlayer::Execute()
+    /**
+    * 按播放状态处理一次：补充缓冲区、循环/结束、暂停、退出（调用方持有 lock）
+    * @return 是否需要继续处理，false 表示本次播放结束（播完/暂停/退出）
+    */
+    bool AudioPlayer::UpdatePlayState()
     {
-        if(!audio_data&&!realtime_source)return(false);
-
-        while(true)
+        if(play_state.load()==PlayState::Play)    //被要求播放
         {
-            lock.Lock();
-
-            if(play_state.load()==PlayState::Play)    //被要求播放
+            if(!UpdateBuffer())
             {
-                if(!UpdateBuffer())
+                if(loop)        //被要求循环播放
                 {
-                    if(loop)        //被要求循环播放
-                    {
-                        if(GetSourceState()!=AL_STOPPED)               //等它放完
-                            Playback();
-                    }
-                    else
-                    {
-                        if(realtime_source)
-                        {
-                            // 实时源暂无数据：继续等待（不退出线程）
-                            lock.Unlock();
-
-                            SleepSecond(wait_time);
-
-                            continue;
-                        }
-
-                        //退出
-                        lock.Unlock();
-
-                        play_state=PlayState::None;
-                        return(false);
-                    }
+                    if(GetSourceState()!=AL_STOPPED)               //等它放完
+                        Playback();
                 }
                 else
                 {
-                    if(GetSourceState()!=AL_PLAYING)
-                        alSourcePlay(source_id);
+                    if(realtime_source)                         // 实时源暂无数据：继续等待（不退出）
+                        return(true);
+
+                    //退出
+                    play_state=PlayState::None;
+                    return(false);
                 }
             }
             else
-            if(play_state.load()==PlayState::Pause)        //被要求暂停
             {
-                alSourcePause(source_id);
-
-                lock.Unlock();
-                return(false);
+                if(GetSourceState()!=AL_PLAYING)
+                    alSourcePlay(source_id);
             }
-            else
-            if(play_state.load()==PlayState::Exit)      //被要求退出
-            {
-                alSourceStop(source_id);
-                alSourcei(source_id,AL_BUFFER,0);
-                ClearBuffer();
+        }
+        else
+        if(play_state.load()==PlayState::Pause)        //被要求暂停
+        {
+            alSourcePause(source_id);
+            return(false);
+        }
+        else
+        if(play_state.load()==PlayState::Exit)      //被要求退出
+        {
+            alSourceStop(source_id);
+            alSourcei(source_id,AL_BUFFER,0);
+            ClearBuffer();
+            return(false);
+        }
+
+        return(true);
+    }
+
+    bool AudioPlayer::Execute()
+    {
+        if(!HasSource())return(false);
 
-                lock.Unlock();
+        while(true)
+        {
+            lock.Lock();
+
+            const bool active=UpdatePlayState();
+
+            lock.Unlock();
+
+            if(!active)
                 return(false);
-            }
 
+            WaitRefill();               //以让线程空出CPU时间片
+        }
+    }
+
+    void AudioPlayer::WaitRefill()
+    {
+        if(!IsSourceEventsRegistered()||realtime_source)       //实时源需按帧长轮询捕获数据
+        {
+            SleepSecond(wait_time);
+            return;
+        }
+
+        // 缓冲区播完/暂停/停止时立即被唤醒，超时只是兜底（事件丢失时不至于断流）
+        PreciseTime timeout=buffer_time*buffer_count/2;
+
+        if(timeout<wait_time)
+            timeout=wait_time;
+
+        WaitStreamEvent(timeout);
+    }
+
+    void AudioPlayer::StartService()
+    {
+        if(!AttachStreamService())
+            Start();
+    }
+
+    bool AudioPlayer::ServiceStream()
+    {
+        lock.Lock();
+
+        const bool active=HasSource()&&UpdatePlayState();
+
+        lock.Unlock();
+
+        return(active);
+    }
+
+    bool AudioPlayer::GetStreamTiming(PreciseTime &refill,PreciseTime &underrun)
+    {
+        refill=0;
+        underrun=0;
+
+        lock.Lock();
+
+        if(play_state.load()!=PlayState::Play)      //暂停/退出请求尽快处理
+        {
             lock.Unlock();
+            return(false);
+        }
 
-            SleepSecond(wait_time);      //以让线程空出CPU时间片
+        int queued=0;
+        int processed=0;
+        int offset=0;
+
+        alGetSourcei(source_id,AL_BUFFERS_QUEUED,&queued);
+        alGetSourcei(source_id,AL_BUFFERS_PROCESSED,&processed);
+        alGetSourcei(source_id,AL_BYTE_OFFSET,&offset);         //相对队列中第一个缓冲区
+
+        const double bytes_per_second=AudioTime(al_format,sample_rate);
+
+        lock.Unlock();
+
+        refill=wait_time;
+
+        if(bytes_per_second<=0||audio_buffer_size<=0)
+            return(false);
+
+        const double left=double(queued)*audio_buffer_size-offset;
+
+        underrun=left>0?left/bytes_per_second:0;
+
+        if(processed>0)
+            refill=0;
+        else
+        {
+            const double current=audio_buffer_size-offset;              //当前缓冲区剩余
+
+            if(current>0&&current/bytes_per_second<refill)
+                refill=current/bytes_per_second;
         }
+
+        return(true);
     }
 
     PreciseTime AudioPlayer::GetPlayTime()
     {
-        if(!audio_data&&!realtime_source)return(0);
+        if(!HasSource())return(0);
 
         uint base;
         int off;
@@ -582,7 +1439,7 @@ namespace hgl::audio
     */
     void AudioPlayer::AutoGain(float target_gain,PreciseTime adjust_time,const PreciseTime cur_time)
     {
-        if(!audio_data&&!realtime_source)return;
+        if(!HasSource())return;
 
         lock.Lock();
             gain_ramp.Start(cur_time,GetGain(),target_gain,adjust_time);
@@ -1,4 +1,6 @@
 #include<hgl/audio/AudioResampler.h>
+#include<hgl/audio/SampleConvert.h>
+#include<hgl/audio/PolyphaseResampler.h>
 #include<hgl/log/Log.h>
 #include<hgl/type/String.h>
 #include<hgl/type/StdString.h>
@@ -11,99 +13,6 @@ namespace hgl::audio
 {
     namespace
     {
-        void ConvertToFloat(const void* input, uint inputSize, float* output, uint sampleCount, const AudioDataInfo& info)
-        {
-            if(info.is_float && info.bits_per_sample == 32)
-            {
-                memcpy(output, input, sampleCount * sizeof(float));
-                return;
-            }
-
-            if(info.bits_per_sample == 32)
-            {
-                const int32_t* samples = static_cast<const int32_t*>(input);
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    output[i] = samples[i] / 2147483648.0f;
-                }
-                return;
-            }
-
-            if(info.bits_per_sample == 16)
-            {
-                const int16_t* samples = static_cast<const int16_t*>(input);
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    output[i] = samples[i] / 32768.0f;
-                }
-                return;
-            }
-
-            if(info.bits_per_sample == 8)
-            {
-                const int8_t* samples = static_cast<const int8_t*>(input);
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    output[i] = samples[i] / 128.0f;
-                }
-            }
-        }
-
-        void ConvertFromFloat(const float* input, uint sampleCount, const AudioDataInfo& info, void** output, uint* outputSize)
-        {
-            const uint bytesPerSample = info.bits_per_sample / 8;
-            *outputSize = sampleCount * bytesPerSample;
-            uint8_t* data = new uint8_t[*outputSize];
-
-            if(info.is_float && info.bits_per_sample == 32)
-            {
-                memcpy(data, input, *outputSize);
-                *output = data;
-                return;
-            }
-
-            if(info.bits_per_sample == 32)
-            {
-                int32_t* dst = reinterpret_cast<int32_t*>(data);
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    float sample = input[i];
-                    if(sample > 1.0f) sample = 1.0f;
-                    if(sample < -1.0f) sample = -1.0f;
-                    dst[i] = static_cast<int32_t>(static_cast<double>(sample) * 2147483647.0);
-                }
-                *output = data;
-                return;
-            }
-
-            if(info.bits_per_sample == 16)
-            {
-                int16_t* dst = reinterpret_cast<int16_t*>(data);
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    float sample = input[i];
-                    if(sample > 1.0f) sample = 1.0f;
-                    if(sample < -1.0f) sample = -1.0f;
-                    dst[i] = static_cast<int16_t>(sample * 32767.0f);
-                }
-                *output = data;
-                return;
-            }
-
-            if(info.bits_per_sample == 8)
-            {
-                int8_t* dst = reinterpret_cast<int8_t*>(data);
-                for(uint i = 0; i < sampleCount; i++)
-                {
-                    float sample = input[i];
-                    if(sample > 1.0f) sample = 1.0f;
-                    if(sample < -1.0f) sample = -1.0f;
-                    dst[i] = static_cast<int8_t>(sample * 127.0f);
-                }
-                *output = data;
-            }
-        }
-
         int ToLibSampleRateQuality(ResampleQuality quality)
         {
             switch(quality)
@@ -146,6 +55,12 @@ namespace hgl::audio
             outInfo.is_float = inputInfoRef.is_float;
         }
 
+        if(!IsSampleFormatSupported(inputInfoRef) || !IsSampleFormatSupported(outInfo))
+        {
+            GLogError(OS_TEXT("Unsupported sample format for resampling"));
+            return false;
+        }
+
         if(inputInfoRef.channels != outInfo.channels)
         {
             GLogError(OS_TEXT("Input and output channel counts must match for resampling"));
@@ -166,15 +81,71 @@ namespace hgl::audio
 
         const uint inputFrameCount = inputSampleCount / channels;
 
+        // Same rate: no filtering, copy (or only convert the sample format)
+        if(inputInfoRef.sample_rate == outputSampleRate)
+        {
+            const uint outputBytesPerSample = outInfo.bits_per_sample / 8;
+
+            *outputSize = inputSampleCount * outputBytesPerSample;
+            uint8_t* outputBytes = new uint8_t[*outputSize];
+
+            if(inputInfoRef.bits_per_sample == outInfo.bits_per_sample && inputInfoRef.is_float == outInfo.is_float)
+            {
+                memcpy(outputBytes, inputData, *outputSize);
+            }
+            else
+            {
+                float* samples = new float[inputSampleCount];
+                SampleToFloat(inputData, samples, inputSampleCount, inputInfoRef);
+                FloatToSample(samples, outputBytes, inputSampleCount, outInfo);
+                delete[] samples;
+            }
+
+            *outputData = outputBytes;
+            return true;
+        }
+
         const double ratio = static_cast<double>(outputSampleRate) / static_cast<double>(inputInfoRef.sample_rate);
         const uint outputFrameCount = static_cast<uint>(std::ceil(inputFrameCount * ratio));
         if(outputFrameCount == 0)
             return false;
 
-        const uint outputSampleCount = outputFrameCount * channels;
-
         float* inputFloat = new float[inputSampleCount];
-        ConvertToFloat(inputData, inputSize, inputFloat, inputSampleCount, inputInfoRef);
+        SampleToFloat(inputData, inputFloat, inputSampleCount, inputInfoRef);
+
+        // Small rational ratios (44100/48000/22050/16000/32000...) use the cached polyphase filter banks,
+        // ratios whose filter bank would exceed the size limits fall through to libsamplerate sinc
+        uint up = 0, down = 0;
+        if(IsPolyphaseResampleSupported(inputInfoRef.sample_rate, outputSampleRate, quality)
+         &&GetPolyphaseRatio(inputInfoRef.sample_rate, outputSampleRate, &up, &down))
+        {
+            const auto bank = AcquirePolyphaseFilterBank(up, down, quality);
+
+            if(bank)
+            {
+                float* outputFloat = new float[(size_t)GetPolyphaseOutputFrames(*bank, inputFrameCount) * channels];
+                const uint generatedFrames = PolyphaseResample(*bank, inputFloat, inputFrameCount, channels, outputFloat);
+
+                delete[] inputFloat;
+
+                if(generatedFrames == 0)
+                {
+                    delete[] outputFloat;
+                    return false;
+                }
+
+                const uint generated = generatedFrames * channels;
+                *outputSize = generated * (outInfo.bits_per_sample / 8);
+                uint8_t* outputBytes = new uint8_t[*outputSize];
+                FloatToSample(outputFloat, outputBytes, generated, outInfo);
+                *outputData = outputBytes;
+                delete[] outputFloat;
+
+                return true;
+            }
+        }
+
+        const uint outputSampleCount = outputFrameCount * channels;
 
         float* outputFloat = new float[outputSampleCount];
 
@@ -208,7 +179,10 @@ namespace hgl::audio
         delete[] inputFloat;
 
         const uint generated = generatedFrames * channels;
-        ConvertFromFloat(outputFloat, generated, outInfo, outputData, outputSize);
+        *outputSize = generated * (outInfo.bits_per_sample / 8);
+        uint8_t* outputBytes = new uint8_t[*outputSize];
+        FloatToSample(outputFloat, outputBytes, generated, outInfo);
+        *outputData = outputBytes;
         delete[] outputFloat;
 
         return true;
@@ -225,4 +199,209 @@ namespace hgl::audio
     {
         return Resample(inputData, inputSize, inputInfo, outputSampleRate, outputInfo, quality, outputData, outputSize);
     }
+
+    StreamResampler::StreamResampler()
+        : input_buffer(OS_TEXT("StreamResampler::input_buffer")),
+          output_buffer(OS_TEXT("StreamResampler::output_buffer"))
+    {
+        state = nullptr;
+        channels = 0;
+        quality = ResampleQuality::SincMedium;
+        ratio = 1.0;
+        last_ratio = 1.0;
+    }
+
+    StreamResampler::~StreamResampler()
+    {
+        Close();
+    }
+
+    bool StreamResampler::Init(uint ch, double r, ResampleQuality q)
+    {
+        Close();
+
+        if(ch == 0 || !src_is_valid_ratio(r))
+        {
+            GLogError(OS_TEXT("Invalid channel count or ratio for stream resampler"));
+            return false;
+        }
+
+        int error = 0;
+        state = src_new(ToLibSampleRateQuality(q), static_cast<int>(ch), &error);
+        if(!state)
+        {
+            GLogError(OS_TEXT("libsamplerate src_new failed"));
+            GLogError(ToOSString(std::string(src_strerror(error))));
+            return false;
+        }
+
+        channels = ch;
+        quality = q;
+        ratio = r;
+        last_ratio = r;
+        return true;
+    }
+
+    bool StreamResampler::Init(uint ch, uint input_rate, uint output_rate, ResampleQuality q)
+    {
+        if(input_rate == 0 || output_rate == 0)
+            return false;
+
+        return Init(ch, static_cast<double>(output_rate) / static_cast<double>(input_rate), q);
+    }
+
+    void StreamResampler::Close()
+    {
+        if(state)
+        {
+            src_delete(state);
+            state = nullptr;
+        }
+
+        channels = 0;
+    }
+
+    bool StreamResampler::Reset()
+    {
+        if(!state)
+            return false;
+
+        last_ratio = ratio;
+        return src_reset(state) == 0;
+    }
+
+    bool StreamResampler::SetRatio(double new_ratio, bool step)
+    {
+        if(!state || !src_is_valid_ratio(new_ratio))
+            return false;
+
+        if(step)
+        {
+            if(src_set_ratio(state, new_ratio) != 0)
+                return false;
+
+            last_ratio = new_ratio;
+        }
+
+        ratio = new_ratio;
+        return true;
+    }
+
+    bool StreamResampler::SetRates(uint input_rate, uint output_rate, bool step)
+    {
+        if(input_rate == 0 || output_rate == 0)
+            return false;
+
+        return SetRatio(static_cast<double>(output_rate) / static_cast<double>(input_rate), step);
+    }
+
+    uint StreamResampler::GetMaxOutputFrames(uint input_frames) const
+    {
+        // during a ramp the effective ratio lies between the previous and the new ratio
+        const double r = ratio > last_ratio ? ratio : last_ratio;
+
+        return static_cast<uint>(std::ceil(static_cast<double>(input_frames) * r)) + 1;
+    }
+
+    bool StreamResampler::Process(const float *input, uint input_frames,
+                                  float *output, uint output_frames,
+                                  uint *input_used, uint *output_generated,
+                                  bool end_of_input)
+    {
+        if(!input_used || !output_generated)
+            return false;
+
+        *input_used = 0;
+        *output_generated = 0;
+
+        if(!state || !output || (input_frames && !input))
+            return false;
+
+        SRC_DATA data;
+        data.data_in = input;
+        data.data_out = output;
+        data.input_frames = static_cast<long>(input_frames);
+        data.output_frames = static_cast<long>(output_frames);
+        data.end_of_input = end_of_input ? 1 : 0;
+        data.src_ratio = ratio;
+
+        const int result = src_process(state, &data);
+        if(result != 0)
+        {
+            GLogError(OS_TEXT("libsamplerate src_process failed"));
+            GLogError(ToOSString(std::string(src_strerror(result))));
+            return false;
+        }
+
+        last_ratio = ratio;
+
+        *input_used = static_cast<uint>(data.input_frames_used);
+        *output_generated = static_cast<uint>(data.output_frames_gen);
+        return true;
+    }
+
+    bool StreamResampler::Process(const int16_t *input, uint input_frames,
+                                  int16_t *output, uint output_frames,
+                                  uint *input_used, uint *output_generated,
+                                  bool end_of_input)
+    {
+        AudioDataInfo info;
+        info.channels = channels;
+        info.bits_per_sample = 16;
+        info.is_float = false;
+
+        return Process(input, info, input_frames, output, info, output_frames, input_used, output_generated, end_of_input);
+    }
+
+    bool StreamResampler::Process(const void *input, const AudioDataInfo &input_info, uint input_frames,
+                                  void *output, const AudioDataInfo &output_info, uint output_frames,
+                                  uint *input_used, uint *output_generated,
+                                  bool end_of_input)
+    {
+        if(!input_used || !output_generated)
+            return false;
+
+        *input_used = 0;
+        *output_generated = 0;
+
+        if(!state || !output || (input_frames && !input))
+            return false;
+
+        if(input_info.channels != channels || output_info.channels != channels)
+        {
+            GLogError(OS_TEXT("Channel count does not match stream resampler"));
+            return false;
+        }
+
+        if(!IsSampleFormatSupported(input_info) || !IsSampleFormatSupported(output_info))
+        {
+            GLogError(OS_TEXT("Unsupported sample format for resampling"));
+            return false;
+        }
+
+        // float32 passes straight through; other formats use the pooled scratch (grows only when chunks get larger)
+        const float *in_float = static_cast<const float *>(input);
+        float *out_float = static_cast<float *>(output);
+
+        if(!input_info.is_float && input_frames > 0)
+        {
+            input_buffer.Ensure(input_frames * channels);
+            SampleToFloat(input, input_buffer.Get(), input_frames * channels, input_info);
+            in_float = input_buffer.Get();
+        }
+
+        if(!output_info.is_float)
+        {
+            output_buffer.Ensure(output_frames * channels);
+            out_float = output_buffer.Get();
+        }
+
+        if(!Process(in_float, input_frames, out_float, output_frames, input_used, output_generated, end_of_input))
+            return false;
+
+        if(!output_info.is_float && *output_generated > 0)
+            FloatToSample(out_float, output, *output_generated * channels, output_info);
+
+        return true;
+    }
 }
@@ -0,0 +1,502 @@
+﻿#include<hgl/audio/AudioStreamService.h>
+#include<hgl/audio/OpenAL.h>
+#include<hgl/thread/Thread.h>
+#include<hgl/thread/ThreadMutex.h>
+#include<hgl/log/Log.h>
+#include<vector>
+#include<thread>
+#include<unordered_map>
+#include<chrono>
+
+namespace hgl::audio
+{
+    class AudioStreamService;
+
+    void OnAudioSourceEvent(uint source);
+
+    class AudioStreamWorker:public Thread
+    {
+        AudioStreamService *service;
+
+    public:
+
+        AudioStreamWorker(AudioStreamService *s):service(s){}
+
+        bool DeletedAfterExit()const override{return false;}
+
+        bool ProcStartThread()override
+        {
+            // OpenAL current context 是 per-thread：每个服务线程只需绑定一次
+            openal::alcSetDefaultContext();
+
+            return hgl::Thread::ProcStartThread();
+        }
+
+        bool Execute() override;
+    };//class AudioStreamWorker
+
+    class AudioStreamService
+    {
+        struct StreamVoice
+        {
+            AudioStreamClient *client;
+            PreciseTime next_service;           ///< 最早处理时间（有缓冲区播完）
+            PreciseTime deadline;               ///< 预计断流时间
+            bool playing;                       ///< deadline 是否有效
+            bool wake;                          ///< 被要求立即处理（处理期间被唤醒时，处理完仍立即再处理一次）
+            bool attach;                        ///< 处理期间被重新加入（Play/Resume），本次返回 false 也不移除
+            bool busy;                          ///< 正被某个服务线程处理（此时不会被移除）
+        };
+
+        std::vector<StreamVoice *> voices;
+        ThreadMutex lock;                       // 保护 voices 与统计
+
+        std::vector<AudioStreamWorker *> workers;
+
+        std::mutex wake_mutex;                  // 空闲服务线程在此等待，Add/Wake 时唤醒
+        std::condition_variable wake_cond;
+        bool wake_pending;
+
+        std::mutex idle_mutex;                  // Remove 在此等待，每处理完一次客户时唤醒
+        std::condition_variable idle_cond;
+        uint64 idle_serial;                     // 已处理完的次数
+
+        uint64 service_count;
+        uint64 late_count;
+
+        StreamVoice *Find(AudioStreamClient *client)
+        {
+            for(StreamVoice *v:voices)
+                if(v->client==client)
+                    return v;
+
+            return nullptr;
+        }
+
+    public:
+
+        void NotifyWorker()
+        {
+            {
+                std::lock_guard<std::mutex> wake_guard(wake_mutex);
+                wake_pending=true;
+            }
+
+            wake_cond.notify_one();
+        }
+
+        AudioStreamService(uint worker_count):wake_pending(false),idle_serial(0),service_count(0),late_count(0)
+        {
+            workers.reserve(worker_count);
+
+            for(uint i=0;i<worker_count;i++)
+            {
+                AudioStreamWorker *worker=new AudioStreamWorker(this);
+
+                worker->Start();
+                workers.push_back(worker);
+            }
+        }
+
+        ~AudioStreamService()
+        {
+            for(AudioStreamWorker *worker:workers)
+            {
+                worker->WaitExit();
+                delete worker;
+            }
+
+            for(StreamVoice *v:voices)          // StopAll 之后不应再有残留
+                delete v;
+        }
+
+        /**
+        * 加入服务，已加入时改为立即处理
+        */
+        void Add(AudioStreamClient *client)
+        {
+            lock.Lock();
+
+            StreamVoice *v=Find(client);
+
+            if(!v)
+            {
+                v=new StreamVoice;
+
+                v->client=client;
+                v->deadline=0;
+                v->playing=false;
+                v->busy=false;
+
+                voices.push_back(v);
+
+                client->stream_registered=true;
+            }
+
+            v->next_service=0;
+            v->wake=true;
+            v->attach=true;
+
+            lock.Unlock();
+
+            NotifyWorker();
+        }
+
+        void Wake(AudioStreamClient *client)
+        {
+            bool found=false;
+
+            lock.Lock();
+
+            StreamVoice *v=Find(client);
+
+            if(v)
+            {
+                v->next_service=0;
+                v->wake=true;
+                found=true;
+            }
+
+            lock.Unlock();
+
+            if(found)
+                NotifyWorker();
+        }
+
+        /**
+        * 等待服务线程处理完客户的退出状态并将其移除（客户须已进入退出状态）
+        */
+        void Remove(AudioStreamClient *client)
+        {
+            while(true)
+            {
+                uint64 serial;
+
+                {
+                    std::lock_guard<std::mutex> idle_guard(idle_mutex);
+                    serial=idle_serial;             // 须在查找之前取得，之后完成的处理必然使其改变
+                }
+
+                lock.Lock();
+
+                StreamVoice *v=Find(client);
+
+                if(v)
+                {
+                    v->next_service=0;
+                    v->wake=true;
+                }
+
+                lock.Unlock();
+
+                if(!v)
+                    return;
+
+                NotifyWorker();
+
+                std::unique_lock<std::mutex> idle_guard(idle_mutex);
+
+                idle_cond.wait(idle_guard,[this,serial]{return idle_serial!=serial;});
+            }
+        }
+
+        /**
+        * 停止所有由服务驱动的客户
+        */
+        void StopAll()
+        {
+            std::vector<AudioStreamClient *> clients;
+
+            lock.Lock();
+
+            for(StreamVoice *v:voices)
+                clients.push_back(v->client);
+
+            lock.Unlock();
+
+            for(AudioStreamClient *client:clients)
+                client->Stop();
+        }
+
+        void GetStats(AudioStreamServiceStats &stats)
+        {
+            ThreadMutexLock lock_guard(&lock);
+
+            stats.worker_count=(uint)workers.size();
+            stats.voice_count=(uint)voices.size();
+            stats.service_count=service_count;
+            stats.late_count=late_count;
+        }
+
+        /**
+        * 服务线程主体：在已到处理时间的客户中取距离断流最近的一个处理一次
+        */
+        bool Process()
+        {
+            StreamVoice *voice=nullptr;
+            PreciseTime sleep_time=AUDIO_STREAM_SERVICE_MAX_SLEEP;
+
+            lock.Lock();
+
+            const PreciseTime now=GetTimeSec();
+
+            for(StreamVoice *v:voices)
+            {
+                if(v->busy)continue;
+
+                if(v->next_service>now)
+                {
+                    if(v->next_service-now<sleep_time)
+                        sleep_time=v->next_service-now;
+
+                    continue;
+                }
+
+                if(!voice||v->deadline<voice->deadline)
+                    voice=v;
+            }
+
+            if(voice)
+            {
+                voice->busy=true;
+                voice->wake=false;
+                voice->attach=false;
+
+                if(voice->playing&&now>voice->deadline)
+                    ++late_count;
+            }
+
+            lock.Unlock();
+
+            if(!voice)
+            {
+                // 等到最近的预计处理时间，或被 Add/Wake（含音源事件）提前唤醒；退出由 WaitExit 检测
+                std::unique_lock<std::mutex> wake_guard(wake_mutex);
+
+                wake_cond.wait_for(wake_guard,std::chrono::duration<double>(sleep_time),[this]{return wake_pending;});
+                wake_pending=false;
+
+                return true;
+            }
+
+            AudioStreamClient *client=voice->client;
+
+            const bool keep=client->ServiceStream();
+
+            PreciseTime refill=0;
+            PreciseTime underrun=0;
+            bool playing=false;
+
+            if(keep)
+                playing=client->GetStreamTiming(refill,underrun);
+
+            lock.Lock();
+
+            const PreciseTime done=GetTimeSec();
+
+            ++service_count;
+
+            voice->busy=false;
+
+            // 本次播放结束（播完/暂停/停止）且处理期间没有重新加入：移除，之后由 Play/Resume 重新加入
+            // 返回 false 后客户可能已在 Stop 中等待移除、随即被删除，这里只按 keep 与自己的状态判断，不再访问 client
+            if(!keep&&!voice->attach)
+            {
+                for(auto it=voices.begin();it!=voices.end();++it)
+                    if(*it==voice)
+                    {
+                        voices.erase(it);
+                        break;
+                    }
+
+                client->stream_registered=false;    // 只写服务自己拥有的标记；Stop 在移除前会一直等待，此时对象仍有效
+                delete voice;
+            }
+            else
+            {
+                if(!voice->wake)                            // 处理期间被唤醒时保持立即处理
+                    voice->next_service=done+refill;
+
+                voice->deadline=done+underrun;
+                voice->playing=playing;
+            }
+
+            lock.Unlock();
+
+            {
+                std::lock_guard<std::mutex> idle_guard(idle_mutex);
+                ++idle_serial;
+            }
+
+            idle_cond.notify_all();
+
+            return true;
+        }
+    };//class AudioStreamService
+
+    bool AudioStreamWorker::Execute()
+    {
+        return service->Process();
+    }
+
+    namespace
+    {
+        ThreadMutex service_lock;                   // 保护 active_service 指针
+        AudioStreamService *active_service=nullptr;
+
+        uint GetDefaultStreamWorkerCount()
+        {
+            uint count=std::thread::hardware_concurrency()/2;
+
+            if(count<1)count=1;
+
+            return count>AUDIO_STREAM_SERVICE_MAX_WORKERS?AUDIO_STREAM_SERVICE_MAX_WORKERS:count;
+        }
+    }//namespace
+
+    bool AudioStreamClient::AttachStreamService()
+    {
+        ThreadMutexLock lock_guard(&service_lock);
+
+        if(!active_service)
+            return(false);
+
+        stream_service=active_service;
+
+        stream_service->Add(this);
+        return(true);
+    }
+
+    void AudioStreamClient::WakeStreamService()
+    {
+        if(stream_registered&&stream_service)
+            stream_service->Wake(this);
+        else
+            SignalStreamEvent();                    // 自己的线程模式：打断 WaitStreamEvent
+    }
+
+    void AudioStreamClient::DetachStreamService()
+    {
+        if(stream_registered&&stream_service)      // 服务停止前会移除全部客户，未在列表中时 stream_service 可能已删除
+            stream_service->Remove(this);
+    }
+
+    namespace
+    {
+        ThreadMutex event_lock;                     // 保护 event_clients，回调持有期间注销会等待
+        std::unordered_map<uint,AudioStreamClient *> event_clients;
+    }//namespace
+
+    void OnAudioSourceEvent(uint source)
+    {
+        ThreadMutexLock lock_guard(&event_lock);
+
+        auto it=event_clients.find(source);
+
+        if(it!=event_clients.end())
+            it->second->OnStreamEvent();
+    }
+
+    void AudioStreamClient::OnStreamEvent()
+    {
+        WakeStreamService();
+    }
+
+    bool AudioStreamClient::RegisterSourceEvents(uint source)
+    {
+        if(!source||!openal::IsSupportSourceEvents())
+            return(false);
+
+        // 事件回调在创建 context 时已安装（ALEvents.cpp CheckSourceEvents），这里只登记音源
+
+        UnregisterSourceEvents();
+
+        ThreadMutexLock lock_guard(&event_lock);
+
+        event_clients[source]=this;
+        event_source=source;
+
+        return(true);
+    }
+
+    void AudioStreamClient::UnregisterSourceEvents()
+    {
+        if(!event_source)
+            return;
+
+        ThreadMutexLock lock_guard(&event_lock);
+
+        event_clients.erase(event_source);
+        event_source=0;
+    }
+
+    void AudioStreamClient::WaitStreamEvent(PreciseTime timeout)
+    {
+        std::unique_lock<std::mutex> event_guard(event_mutex);
+
+        event_cond.wait_for(event_guard,std::chrono::duration<double>(timeout),[this]{return event_signaled;});
+        event_signaled=false;
+    }
+
+    void AudioStreamClient::SignalStreamEvent()
+    {
+        {
+            std::lock_guard<std::mutex> event_guard(event_mutex);
+            event_signaled=true;
+        }
+
+        event_cond.notify_one();
+    }
+
+    bool StartAudioStreamService(uint worker_count)
+    {
+        ThreadMutexLock lock_guard(&service_lock);
+
+        if(active_service)
+            return(false);
+
+        if(worker_count==0)
+            worker_count=GetDefaultStreamWorkerCount();
+
+        active_service=new AudioStreamService(worker_count);
+
+        GLogInfo(OS_TEXT("Audio stream service started, workers: ")+OSString::numberOf(worker_count));
+        return(true);
+    }
+
+    void StopAudioStreamService()
+    {
+        AudioStreamService *service;
+
+        service_lock.Lock();
+        service=active_service;
+        active_service=nullptr;                     // 之后的 Play 回到各自线程
+        service_lock.Unlock();
+
+        if(!service)
+            return;
+
+        service->StopAll();
+
+        delete service;
+    }
+
+    bool IsAudioStreamServiceRunning()
+    {
+        ThreadMutexLock lock_guard(&service_lock);
+
+        return active_service!=nullptr;
+    }
+
+    AudioStreamServiceStats GetAudioStreamServiceStats()
+    {
+        AudioStreamServiceStats stats{};
+
+        ThreadMutexLock lock_guard(&service_lock);
+
+        if(active_service)
+            active_service->GetStats(stats);
+
+        return stats;
+    }
+}//namespace hgl::audio
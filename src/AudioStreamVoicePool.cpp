@@ -0,0 +1,281 @@
+﻿#include<hgl/audio/AudioStreamVoicePool.h>
+#include<hgl/audio/AudioAssetManager.h>
+#include<hgl/log/Log.h>
+#include"AudioDecode.h"
+
+using namespace openal;
+
+namespace hgl::audio
+{
+    const os_char *GetAudioDecodeName(const AudioFileType aft);
+
+    AudioStreamVoicePool::Voice::Voice()
+    {
+        source.Create();
+        alGenBuffers(AUDIO_STREAM_VOICE_BUFFERS,buffers);
+
+        data=nullptr;
+        decoder=nullptr;
+        stream=nullptr;
+        format=0;
+        rate=0;
+        chunk_size=0;
+        loop=false;
+        ended=false;
+    }
+
+    AudioStreamVoicePool::Voice::~Voice()
+    {
+        alDeleteBuffers(AUDIO_STREAM_VOICE_BUFFERS,buffers);
+
+        SAFE_CLEAR(decoder);
+    }
+
+    AudioStreamVoicePool::AudioStreamVoicePool(AudioAssetManager *am,uint voice_count,double buffer_seconds)
+        :decode_buffer(OS_TEXT("StreamVoiceDecode"))
+    {
+        manager=am;
+        buffer_time=(buffer_seconds>0)?buffer_seconds:0.1;
+        bus=nullptr;
+
+        if(!alGenSources)
+        {
+            GLogError(OS_TEXT("AudioStreamVoicePool: OpenAL 还未初始化!"));
+            return;
+        }
+
+        voices.reserve(voice_count);
+
+        for(uint i=0;i<voice_count;i++)
+            voices.push_back(new Voice);
+    }
+
+    AudioStreamVoicePool::~AudioStreamVoicePool()
+    {
+        StopAll();
+
+        for(Voice *v:voices)
+            delete v;
+    }
+
+    /**
+    * 解码一块数据到指定缓冲区，循环播放时到结尾自动回到开头
+    * @return 是否填充了数据（false=已到结尾）
+    */
+    bool AudioStreamVoicePool::Fill(Voice *v,ALuint buffer)
+    {
+        if(v->ended)return(false);
+
+        char *pcm=decode_buffer.Get();
+
+        uint size=v->decoder->Read(v->stream,pcm,v->chunk_size);
+
+        if(size==0&&v->loop)
+        {
+            v->decoder->Restart(v->stream);
+            size=v->decoder->Read(v->stream,pcm,v->chunk_size);
+        }
+
+        if(size==0)
+        {
+            v->ended=true;
+            return(false);
+        }
+
+        alBufferData(buffer,v->format,pcm,size,v->rate);
+
+        return !alLastError();
+    }
+
+    /**
+    * 停止音源、卸下全部缓冲区、关闭解码流并释放压缩数据引用，音源回到空闲状态
+    */
+    void AudioStreamVoicePool::Finish(Voice *v)
+    {
+        if(!v->data)return;
+
+        const ALuint sid=v->source.GetIndex();
+
+        alSourceStop(sid);
+        alSourcei(sid,AL_BUFFER,0);                 // 卸下全部已排队缓冲区（停止状态下允许）
+
+        if(v->stream)
+            v->decoder->Close(v->stream);
+
+        v->stream=nullptr;
+
+        manager->ReleaseCompressed(v->data);
+        v->data=nullptr;
+    }
+
+    int AudioStreamVoicePool::Play(const os_char *filename,float gain,bool loop)
+    {
+        if(!manager||!filename||!(*filename))return(-1);
+
+        int index=-1;
+
+        for(uint i=0;i<voices.size();i++)
+            if(!voices[i]->data)
+            {
+                index=int(i);
+                break;
+            }
+
+        if(index<0)return(-1);                      // 无空闲音源
+
+        AudioCompressedData *cd=manager->AcquireCompressed(filename);
+
+        if(!cd)return(-1);
+
+        Voice *v=voices[index];
+
+        const os_char *plugin_name=GetAudioDecodeName(cd->file_type);
+
+        if(!v->decoder)
+            v->decoder=new AudioPlugInInterface;
+
+        double total_time=0;
+
+        if(!plugin_name
+         ||!GetAudioInterface(plugin_name,v->decoder,nullptr)
+         ||!v->decoder->Open
+         ||!(v->stream=v->decoder->Open((ALbyte *)cd->data,(ALsizei)cd->size,&v->format,&v->rate,&total_time)))
+        {
+            GLogError(OS_TEXT("AudioStreamVoicePool: 无法解码 ")+cd->name);
+
+            manager->ReleaseCompressed(cd);
+            return(-1);
+        }
+
+        v->data=cd;
+        v->loop=loop;
+        v->ended=false;
+
+        const uint frame_bytes=AudioTime(v->format,1);
+
+        v->chunk_size=uint(AudioTime(v->format,v->rate)*buffer_time);
+        v->chunk_size-=v->chunk_size%frame_bytes;
+
+        if(v->chunk_size<frame_bytes)
+            v->chunk_size=frame_bytes;
+
+        decode_buffer.Ensure(v->chunk_size);
+
+        uint count=0;
+
+        while(count<AUDIO_STREAM_VOICE_BUFFERS&&Fill(v,v->buffers[count]))
+            ++count;
+
+        if(count==0)
+        {
+            Finish(v);
+            return(-1);
+        }
+
+        const ALuint sid=v->source.GetIndex();
+
+        alSourceQueueBuffers(sid,count,v->buffers);
+
+        v->source.SetGain(gain);
+        alSourcePlay(sid);
+
+        return(index);
+    }
+
+    void AudioStreamVoicePool::Stop(int voice)
+    {
+        if(voice<0||voice>=int(voices.size()))return;
+
+        Finish(voices[voice]);
+    }
+
+    void AudioStreamVoicePool::StopAll()
+    {
+        for(Voice *v:voices)
+            Finish(v);
+    }
+
+    bool AudioStreamVoicePool::IsPlaying(int voice)const
+    {
+        if(voice<0||voice>=int(voices.size()))return(false);
+
+        return voices[voice]->data!=nullptr;
+    }
+
+    AudioSource *AudioStreamVoicePool::GetSource(int voice)
+    {
+        if(voice<0||voice>=int(voices.size()))return(nullptr);
+
+        return &(voices[voice]->source);
+    }
+
+    int AudioStreamVoicePool::Update()
+    {
+        int active=0;
+
+        for(Voice *v:voices)
+        {
+            if(!v->data)continue;
+
+            const ALuint sid=v->source.GetIndex();
+
+            int processed=0;
+
+            alGetSourcei(sid,AL_BUFFERS_PROCESSED,&processed);
+
+            while(processed-->0)
+            {
+                ALuint buffer;
+
+                alSourceUnqueueBuffers(sid,1,&buffer);
+
+                if(Fill(v,buffer))
+                    alSourceQueueBuffers(sid,1,&buffer);
+            }
+
+            int state=0;
+
+            alGetSourcei(sid,AL_SOURCE_STATE,&state);
+
+            if(state!=AL_PLAYING)
+            {
+                int queued=0;
+
+                alGetSourcei(sid,AL_BUFFERS_QUEUED,&queued);
+
+                if(queued>0&&state!=AL_PAUSED)      // 补充不及时导致欠载停止：继续播放剩余缓冲
+                {
+                    alSourcePlay(sid);
+                }
+                else if(queued<=0)                  // 全部播完
+                {
+                    Finish(v);
+                    continue;
+                }
+            }
+
+            ++active;
+        }
+
+        return(active);
+    }
+
+    uint AudioStreamVoicePool::GetActiveCount()const
+    {
+        uint count=0;
+
+        for(const Voice *v:voices)
+            if(v->data)
+                ++count;
+
+        return count;
+    }
+
+    void AudioStreamVoicePool::SetBus(AudioBus *b)
+    {
+        bus=b;
+
+        for(Voice *v:voices)
+            v->source.SetBus(b);
+    }
+}//namespace hgl::audio
@@ -62,6 +62,8 @@ namespace hgl::audio
 
     MIDIPlayer::~MIDIPlayer()
     {
+        Stop();                             //先退出服务/播放线程，返回后服务不再访问本对象，才能释放解码器
+
         SAFE_CLEAR(decoder);
 
         if(!audio_data)return;
@@ -293,7 +295,7 @@ namespace hgl::audio
         loop=_loop;
 
         if(play_state.load()==MIDIPlayState::None||play_state.load()==MIDIPlayState::Pause)
-            Start();
+            StartService();
 
         Playback();
 
@@ -305,19 +307,17 @@ namespace hgl::audio
     */
     void MIDIPlayer::Stop()
     {
-        if(!audio_data)return;
-
-        bool thread_is_live=true;
-
         lock.Lock();
 
-        if(Thread::IsLive())
+        const bool thread_is_live=Thread::IsLive();
+
+        if(IsStreamAttached()||thread_is_live)
             play_state=MIDIPlayState::Exit;
-        else
-            thread_is_live=false;
 
         lock.Unlock();
 
+        DetachStreamService();              //仍在服务中时由服务线程停止音源、清空队列后移除；返回后服务不再访问本对象
+
         if(thread_is_live)
             Thread::WaitExit();
 
@@ -334,8 +334,12 @@ namespace hgl::audio
         lock.Lock();
 
         if(play_state.load()==MIDIPlayState::Play)
+        {
             play_state=MIDIPlayState::Pause;
 
+            WakeStreamService();
+        }
+
         lock.Unlock();
     }
 
@@ -352,7 +356,7 @@ namespace hgl::audio
         {
             play_state=MIDIPlayState::Play;
 
-            Thread::Start();
+            StartService();
         }
 
         lock.Unlock();
@@ -373,29 +377,89 @@ namespace hgl::audio
     bool MIDIPlayer::UpdateBuffer()
     {
         int processed=0;
-        bool active=true;
 
         alGetSourcei(source_id,AL_BUFFERS_PROCESSED,&processed);
 
-        while(processed--)
+        if(processed<=0)return(true);
+        if(processed>3)processed=3;
+
+        ALuint buffers[3];
+
+        alSourceUnqueueBuffers(source_id,processed,buffers);   //一次解除全部已处理完成的缓冲区
+
+        int filled=0;
+
+        while(filled<processed&&ReadData(buffers[filled]))
+            ++filled;
+
+        if(filled>0)
+            alSourceQueueBuffers(source_id,filled,buffers);    //一次重新加入队列
+
+        audio_buffer_count+=processed;
+
+        return(filled==processed);
+    }
+
+    /**
+    * 按播放状态处理一次（调用方持有 lock）
+    * @return 是否需要继续处理，false 表示本次播放结束（播完/退出）
+    */
+    bool MIDIPlayer::UpdatePlayState()
+    {
+        if(play_state.load()==MIDIPlayState::Exit)
         {
-            ALuint n;
+            alSourceStop(source_id);
+            ClearBuffer();
+            return(false);
+        }
 
-            alSourceUnqueueBuffers(source_id,1,&n);
+        if(play_state.load()==MIDIPlayState::Pause)
+        {
+            alSourcePause(source_id);
+            return(true);
+        }
 
-            if(!ReadData(n))
+        if(play_state.load()==MIDIPlayState::Play)
+        {
+            if(!UpdateBuffer())
             {
-                active=false;
+                if(loop.load())
+                {
+                    Playback();
+                }
+                else
+                {
+                    play_state=MIDIPlayState::Exit;
+                    return(false);
+                }
             }
-            else
+
+            // 处理自动增益
+            if(gain_ramp.active)
             {
-                alSourceQueueBuffers(source_id,1,&n);
+                const double cur_time=GetTimeSec();
+                float g;
+
+                if(!gain_ramp.Evaluate(cur_time,g))
+                {
+                    audiosource.SetGain(gain_ramp.end_gain);
+                }
+                else
+                {
+                    audiosource.SetGain(g);
+                }
             }
 
-            ++audio_buffer_count;
+            // 处理淡入淡出
+            if(fade_in_time>0||fade_out_time>0)
+            {
+                const double cur_pos=GetPlayTime();
+
+                audiosource.SetGain(float(FadeFactor(cur_pos,fade_in_time,fade_out_time,total_time.load())*gain));
+            }
         }
 
-        return active;
+        return(true);
     }
 
     bool MIDIPlayer::Execute()
@@ -404,69 +468,79 @@ namespace hgl::audio
         {
             lock.Lock();
 
-            if(play_state.load()==MIDIPlayState::Exit)
-            {
-                alSourceStop(source_id);
-                ClearBuffer();
+            const bool active=UpdatePlayState();
 
-                lock.Unlock();
+            lock.Unlock();
+
+            if(!active)
                 return(false);
-            }
 
-            if(play_state.load()==MIDIPlayState::Pause)
-            {
-                alSourcePause(source_id);
+            SleepSecond(wait_time);
+        }
 
-                lock.Unlock();
+        return(true);
+    }
 
-                SleepSecond(wait_time);
-                continue;
-            }
+    void MIDIPlayer::StartService()
+    {
+        if(!AttachStreamService())
+            Start();
+    }
 
-            if(play_state.load()==MIDIPlayState::Play)
-            {
-                if(!UpdateBuffer())
-                {
-                    if(loop.load())
-                    {
-                        Playback();
-                    }
-                    else
-                    {
-                        play_state=MIDIPlayState::Exit;
-                        lock.Unlock();
-                        return(false);
-                    }
-                }
+    bool MIDIPlayer::ServiceStream()
+    {
+        lock.Lock();
 
-                // 处理自动增益
-                if(gain_ramp.active)
-                {
-                    const double cur_time=GetTimeSec();
-                    float g;
-
-                    if(!gain_ramp.Evaluate(cur_time,g))
-                    {
-                        audiosource.SetGain(gain_ramp.end_gain);
-                    }
-                    else
-                    {
-                        audiosource.SetGain(g);
-                    }
-                }
+        const bool active=audio_data&&UpdatePlayState();
 
-                // 处理淡入淡出
-                if(fade_in_time>0||fade_out_time>0)
-                {
-                    const double cur_pos=GetPlayTime();
+        lock.Unlock();
 
-                    audiosource.SetGain(float(FadeFactor(cur_pos,fade_in_time,fade_out_time,total_time.load())*gain));
-                }
-            }
+        return(active);
+    }
+
+    bool MIDIPlayer::GetStreamTiming(PreciseTime &refill,PreciseTime &underrun)
+    {
+        refill=wait_time;
+        underrun=0;
+
+        lock.Lock();
+
+        if(play_state.load()!=MIDIPlayState::Play)      //暂停中按原轮询间隔处理，退出请求尽快处理
+        {
+            if(play_state.load()!=MIDIPlayState::Pause)
+                refill=0;
 
             lock.Unlock();
+            return(false);
+        }
 
-            SleepSecond(wait_time);
+        int queued=0;
+        int processed=0;
+        int offset=0;
+
+        alGetSourcei(source_id,AL_BUFFERS_QUEUED,&queued);
+        alGetSourcei(source_id,AL_BUFFERS_PROCESSED,&processed);
+        alGetSourcei(source_id,AL_BYTE_OFFSET,&offset);         //相对队列中第一个缓冲区
+
+        const double bytes_per_second=AudioTime(al_format,sample_rate);
+
+        lock.Unlock();
+
+        if(bytes_per_second<=0||audio_buffer_size<=0)
+            return(false);
+
+        const double left=double(queued)*audio_buffer_size-offset;
+
+        underrun=left>0?left/bytes_per_second:0;
+
+        if(processed>0)
+            refill=0;
+        else
+        {
+            const double current=audio_buffer_size-offset;              //当前缓冲区剩余
+
+            if(current>0&&current/bytes_per_second<refill)
+                refill=current/bytes_per_second;
         }
 
         return(true);
@@ -0,0 +1,153 @@
+﻿#include"MappedWAV.h"
+#include<hgl/audio/WAVParser.h>
+#include<cstring>
+
+#if HGL_OS == HGL_OS_Windows
+    #include<windows.h>
+#else
+    #include<sys/mman.h>
+    #include<sys/stat.h>
+    #include<fcntl.h>
+    #include<unistd.h>
+#endif//HGL_OS == HGL_OS_Windows
+
+namespace hgl::audio
+{
+    MappedFile::MappedFile()
+    {
+        data=nullptr;
+        size=0;
+
+#if HGL_OS == HGL_OS_Windows
+        file_handle=INVALID_HANDLE_VALUE;
+        map_handle=nullptr;
+#endif//HGL_OS == HGL_OS_Windows
+    }
+
+#if HGL_OS == HGL_OS_Windows
+    bool MappedFile::Open(const os_char *filename,bool sequential)
+    {
+        Close();
+
+        if(!filename||!(*filename))
+            return(false);
+
+        file_handle=CreateFileW(filename,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,
+                                sequential?FILE_FLAG_SEQUENTIAL_SCAN:FILE_ATTRIBUTE_NORMAL,nullptr);
+
+        if(file_handle==INVALID_HANDLE_VALUE)
+            return(false);
+
+        LARGE_INTEGER file_size;
+
+        if(!GetFileSizeEx(file_handle,&file_size)||file_size.QuadPart<=0)
+        {
+            Close();
+            return(false);
+        }
+
+        map_handle=CreateFileMappingW(file_handle,nullptr,PAGE_READONLY,0,0,nullptr);
+
+        if(!map_handle)
+        {
+            Close();
+            return(false);
+        }
+
+        data=MapViewOfFile(map_handle,FILE_MAP_READ,0,0,0);
+
+        if(!data)
+        {
+            Close();
+            return(false);
+        }
+
+        size=uint64(file_size.QuadPart);
+        return(true);
+    }
+
+    void MappedFile::Close()
+    {
+        if(data)
+            UnmapViewOfFile(data);
+
+        if(map_handle)
+            CloseHandle(map_handle);
+
+        if(file_handle!=INVALID_HANDLE_VALUE)
+            CloseHandle(file_handle);
+
+        data=nullptr;
+        size=0;
+        map_handle=nullptr;
+        file_handle=INVALID_HANDLE_VALUE;
+    }
+#else
+    bool MappedFile::Open(const os_char *filename,bool sequential)
+    {
+        Close();
+
+        if(!filename||!(*filename))
+            return(false);
+
+        const int fd=open(filename,O_RDONLY);
+
+        if(fd<0)
+            return(false);
+
+        struct stat st;
+
+        if(fstat(fd,&st)!=0||st.st_size<=0)
+        {
+            close(fd);
+            return(false);
+        }
+
+        void *ptr=mmap(nullptr,size_t(st.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+
+        close(fd);                  //映射建立后即可关闭文件描述符
+
+        if(ptr==MAP_FAILED)
+            return(false);
+
+        if(sequential)
+            madvise(ptr,size_t(st.st_size),MADV_SEQUENTIAL);
+
+        data=ptr;
+        size=uint64(st.st_size);
+        return(true);
+    }
+
+    void MappedFile::Close()
+    {
+        if(data)
+            munmap(data,size_t(size));
+
+        data=nullptr;
+        size=0;
+    }
+#endif//HGL_OS == HGL_OS_Windows
+
+    bool ParseWAVData(const void *data,uint64 size,WAVDataView &view)
+    {
+        view=WAVDataView();
+        view.pcm=nullptr;
+
+        RIFFWAVEInfo info;
+
+        if(!ParseRIFFWAVE(data,size,info))
+            return(false);
+
+        if(info.pcm_size>0xFFFFFFFFu)
+            return(false);
+
+        view.info.sample_rate       =info.sample_rate;
+        view.info.channels          =info.channels;
+        view.info.bits_per_sample   =info.bits;
+        view.info.is_float          =info.is_float;
+        view.info.data_size         =uint(info.pcm_size);
+        view.pcm                    =info.pcm;
+
+        return(true);
+    }
+}//namespace hgl::audio
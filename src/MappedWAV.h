@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include<hgl/CoreType.h>
+#include<hgl/platform/Platform.h>
+#include<hgl/audio/AudioMixerTypes.h>
+
+namespace hgl::audio
+{
+    /**
+    * 只读内存映射文件（Windows: CreateFileMapping/MapViewOfFile，其它平台: mmap）
+    *
+    * 文件内容按需由系统分页载入，不额外分配内存；映射在 Close()/析构前一直有效。
+    */
+    class MappedFile
+    {
+        void *data;
+        uint64 size;
+
+#if HGL_OS == HGL_OS_Windows
+        void *file_handle;
+        void *map_handle;
+#endif//HGL_OS == HGL_OS_Windows
+
+    public:
+
+        MappedFile();
+        ~MappedFile(){Close();}
+
+        MappedFile(const MappedFile &)=delete;
+        MappedFile &operator=(const MappedFile &)=delete;
+
+        /**
+        * 映射整个文件
+        * @param filename 文件名
+        * @param sequential 是否提示系统按顺序预读（整段上传/流式播放时使用）
+        */
+        bool Open(const os_char *filename,bool sequential=true);
+        void Close();
+
+        bool        IsOpen()const{return data!=nullptr;}
+        const void *GetData()const{return data;}
+        uint64      GetSize()const{return size;}
+    };//class MappedFile
+
+    /**
+    * 原地解析得到的 WAV PCM 数据
+    */
+    struct WAVDataView
+    {
+        AudioDataInfo info;         ///< 采样率/声道/位深(8/16/24/32)/是否浮点，data_size 为 PCM 字节数（已截到整帧）
+        const void *pcm;            ///< 指向 data 块（即指向传入的文件内存，不复制）
+    };//struct WAVDataView
+
+    /**
+    * 原地解析 RIFF/WAVE 文件的 fmt / data 块（解析规则见 hgl/audio/WAVParser.h，与 WAV 解码插件相同）
+    * @param data 文件数据
+    * @param size 文件字节数
+    * @param view 解析结果
+    * @return 是否为支持的 WAV 格式
+    */
+    bool ParseWAVData(const void *data,uint64 size,WAVDataView &view);
+}//namespace hgl::audio
@@ -26,17 +26,20 @@ namespace openal
     static bool AudioFloat32            =false;         //是否支持float 32数据
     static bool AudioEFX                =false;         //EFX是否可用
     static bool AudioXRAM               =false;         //X-RAM是否可用
+    static bool AudioSourceEvents       =false;         //AL_SOFT_events是否可用
 
     bool LoadALCFunc(ExternalModule *);
     bool LoadALFunc(ExternalModule *);
 
     bool CheckXRAM(ALCdevice_struct *);
     bool CheckEFX(ALCdevice_struct *);
+    bool CheckSourceEvents();
 
     void ClearAL();
     void ClearALC();
     void ClearXRAM();
     void ClearEFX();
+    void ClearSourceEvents();
 
     bool FromOpenALFormat(ALenum format,hgl::audio::AudioDataInfo &info)
     {
@@ -478,6 +481,8 @@ namespace openal
 
         InitOpenALExt();
 
+        AudioSourceEvents=CheckSourceEvents();
+
         GLogInfo(OS_TEXT("Inited OpenAL."));
         return(AL_TRUE);
     }
@@ -511,6 +516,9 @@ namespace openal
         ClearALC();
         ClearXRAM();
         ClearEFX();
+        ClearSourceEvents();
+
+        AudioSourceEvents=false;
     }
 
     /**
@@ -720,6 +728,14 @@ namespace openal
     {
         return AudioFloat32;
     }
+
+    /**
+     * 是否支持音源事件回调(AL_SOFT_events)
+     */
+    bool IsSupportSourceEvents()
+    {
+        return AudioSourceEvents;
+    }
     //--------------------------------------------------------------------------------------------------
     const u8char *alGetErrorInfo(const char *filename,const int line)
     {
@@ -769,6 +785,9 @@ namespace openal
         GLogInfo(AudioEFX?    u8"                    EFX: Supported"
                          :    u8"                    EFX: No");
 
+        GLogInfo(AudioSourceEvents?u8"          Source events: Supported"
+                                  :u8"          Source events: No");
+
         if(AudioXRAM)
         {
             int size;
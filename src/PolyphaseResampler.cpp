@@ -0,0 +1,377 @@
+﻿#include<hgl/audio/PolyphaseResampler.h>
+#include<hgl/audio/SampleConvert.h>
+#include<hgl/thread/ThreadMutex.h>
+#include<map>
+#include<tuple>
+#include<cmath>
+
+#if defined(_M_X64)||defined(__x86_64__)||defined(_M_IX86)||defined(__i386__)
+    #define HGL_POLYPHASE_X86
+    #include<immintrin.h>
+#elif defined(__ARM_NEON)||defined(__ARM_NEON__)||defined(_M_ARM64)
+    #define HGL_POLYPHASE_NEON
+    #include<arm_neon.h>
+#endif
+
+// 与 SampleConvert.cpp 相同：GCC/Clang 按函数开启指令集
+#if defined(__GNUC__)||defined(__clang__)
+    #define HGL_TARGET_SSE2 __attribute__((target("sse2")))
+    #define HGL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define HGL_TARGET_SSE2
+    #define HGL_TARGET_AVX2
+#endif
+
+namespace hgl::audio
+{
+    namespace
+    {
+        constexpr double PP_PI=3.141592653589793238462643383279502884;
+
+        /**
+        * 各品质的原型滤波器参数（以较低一侧采样率计）
+        * 通带与 libsamplerate 对应的 SRC_SINC_* 转换器一致（约 80%/90%/97% Nyquist），阻带边界在 Nyquist
+        */
+        struct PolyphaseDesign
+        {
+            double passband;            ///< 通带边界（占 Nyquist 的比例）
+            double stopband_db;         ///< 阻带衰减
+        };
+
+        PolyphaseDesign GetDesign(ResampleQuality quality)
+        {
+            switch(quality)
+            {
+                case ResampleQuality::SincFastest:  return {0.80,97.0};
+                case ResampleQuality::SincBest:     return {0.97,130.0};
+                case ResampleQuality::SincMedium:
+                default:                            return {0.90,110.0};
+            }
+        }
+
+        uint GCD(uint a,uint b)
+        {
+            while(b)
+            {
+                const uint t=a%b;
+                a=b;
+                b=t;
+            }
+
+            return a;
+        }
+
+        double BesselI0(double x)                   ///<第一类零阶修正贝塞尔函数（级数展开）
+        {
+            double sum=1.0;
+            double term=1.0;
+            const double half=x*0.5;
+
+            for(int k=1;k<64;k++)
+            {
+                term*=(half/k)*(half/k);
+                sum+=term;
+
+                if(term<sum*1e-12)
+                    break;
+            }
+
+            return sum;
+        }
+
+        /**
+        * 原型滤波器每相位的系数个数（未补齐）
+        */
+        uint64 GetPrototypeTaps(uint up,uint down,ResampleQuality quality)
+        {
+            const PolyphaseDesign design=GetDesign(quality);
+            const uint larger=up>down?up:down;
+
+            // Kaiser 公式：N = (A-7.95)/(14.36×Δf)，Δf 为通带边界到 Nyquist 的过渡带宽（以较低采样率归一化）
+            const double transition=(1.0-design.passband)*0.5;
+            const uint design_taps=(uint)std::ceil((design.stopband_db-7.95)/(14.36*transition));
+
+            // 下采样时截止频率按 L/M 降低，保持同样的过渡带宽需要按比例增加系数
+            return (uint64)std::ceil((double)design_taps*larger/up);
+        }
+
+        bool IsFilterBankWithinLimits(uint up,uint down,ResampleQuality quality)
+        {
+            const uint64 taps=(GetPrototypeTaps(up,down,quality)+7)&~uint64(7);
+
+            return taps<=POLYPHASE_MAX_TAPS
+                 &&taps*up<=POLYPHASE_MAX_COEFFICIENTS;
+        }
+
+        std::shared_ptr<const PolyphaseFilterBank> CreateFilterBank(uint up,uint down,ResampleQuality quality)
+        {
+            const PolyphaseDesign design=GetDesign(quality);
+            const uint larger=up>down?up:down;
+            const double transition=(1.0-design.passband)*0.5;
+            const uint real_taps=(uint)GetPrototypeTaps(up,down,quality);
+
+            // -6dB 点放在过渡带中央，阻带从 Nyquist 开始
+            const double cutoff=(0.5-transition*0.5)/larger;                    ///<上采样域归一化截止频率（周期/采样）
+            const double beta=0.1102*(design.stopband_db-8.7);
+
+            const uint length=up*real_taps;
+            const uint center=length/2;
+
+            std::vector<double> proto(length);
+            double sum=0;
+
+            const double i0_beta=BesselI0(beta);
+
+            for(uint j=0;j<length;j++)
+            {
+                const double x=(double)j-(double)center;
+                const double arg=2.0*cutoff*x;
+                const double sinc=(x==0)?1.0:std::sin(PP_PI*arg)/(PP_PI*arg);
+
+                double r=x/(double)center;
+                if(r<-1.0)r=-1.0;
+                if(r> 1.0)r= 1.0;
+
+                const double window=BesselI0(beta*std::sqrt(1.0-r*r))/i0_beta;
+
+                proto[j]=2.0*cutoff*sinc*window;
+                sum+=proto[j];
+            }
+
+            // 上采样插零后增益为 1/L，整体归一化到 L 使各相位直流增益约为 1
+            const double scale=(double)up/sum;
+
+            auto bank=std::make_shared<PolyphaseFilterBank>();
+
+            bank->up=up;
+            bank->down=down;
+            bank->quality=quality;
+            bank->taps=(real_taps+7)&~7u;
+            bank->center=center;
+            bank->coefficients.assign((size_t)up*bank->taps,0.0f);
+
+            // 相位 p 的第 k 个系数 h[p+k×L] 作用于输入 x[base-k]，反序存放为 [taps-1-k]，前部补 0
+            for(uint p=0;p<up;p++)
+            {
+                float *row=bank->coefficients.data()+(size_t)p*bank->taps;
+
+                for(uint k=0;k<real_taps;k++)
+                {
+                    const uint j=p+k*up;
+
+                    if(j<length)
+                        row[bank->taps-1-k]=(float)(proto[j]*scale);
+                }
+            }
+
+            return bank;
+        }
+
+        //--------------------------------------------------------------------------------------------------
+        // 点积内核（count 为 8 的倍数）
+        //--------------------------------------------------------------------------------------------------
+
+        float DotScalar(const float *a,const float *b,uint count)
+        {
+            float sum=0;
+
+            for(uint i=0;i<count;i++)
+                sum+=a[i]*b[i];
+
+            return sum;
+        }
+
+#ifdef HGL_POLYPHASE_X86
+        HGL_TARGET_SSE2 float DotSSE2(const float *a,const float *b,uint count)
+        {
+            __m128 acc0=_mm_setzero_ps();
+            __m128 acc1=_mm_setzero_ps();
+
+            for(uint i=0;i<count;i+=8)
+            {
+                acc0=_mm_add_ps(acc0,_mm_mul_ps(_mm_loadu_ps(a+i),  _mm_loadu_ps(b+i)));
+                acc1=_mm_add_ps(acc1,_mm_mul_ps(_mm_loadu_ps(a+i+4),_mm_loadu_ps(b+i+4)));
+            }
+
+            acc0=_mm_add_ps(acc0,acc1);
+            acc0=_mm_add_ps(acc0,_mm_movehl_ps(acc0,acc0));
+            acc0=_mm_add_ss(acc0,_mm_shuffle_ps(acc0,acc0,1));
+
+            return _mm_cvtss_f32(acc0);
+        }
+
+        HGL_TARGET_AVX2 float DotAVX2(const float *a,const float *b,uint count)
+        {
+            __m256 acc=_mm256_setzero_ps();
+
+            for(uint i=0;i<count;i+=8)
+                acc=_mm256_add_ps(acc,_mm256_mul_ps(_mm256_loadu_ps(a+i),_mm256_loadu_ps(b+i)));
+
+            __m128 v=_mm_add_ps(_mm256_castps256_ps128(acc),_mm256_extractf128_ps(acc,1));
+            v=_mm_add_ps(v,_mm_movehl_ps(v,v));
+            v=_mm_add_ss(v,_mm_shuffle_ps(v,v,1));
+
+            return _mm_cvtss_f32(v);
+        }
+#endif//HGL_POLYPHASE_X86
+
+#ifdef HGL_POLYPHASE_NEON
+        float DotNEON(const float *a,const float *b,uint count)
+        {
+            float32x4_t acc0=vdupq_n_f32(0);
+            float32x4_t acc1=vdupq_n_f32(0);
+
+            for(uint i=0;i<count;i+=8)
+            {
+                acc0=vmlaq_f32(acc0,vld1q_f32(a+i),  vld1q_f32(b+i));
+                acc1=vmlaq_f32(acc1,vld1q_f32(a+i+4),vld1q_f32(b+i+4));
+            }
+
+            acc0=vaddq_f32(acc0,acc1);
+
+            const float32x2_t sum=vadd_f32(vget_low_f32(acc0),vget_high_f32(acc0));
+
+            return vget_lane_f32(vpadd_f32(sum,sum),0);
+        }
+#endif//HGL_POLYPHASE_NEON
+
+        using DotFunc=float(*)(const float *,const float *,uint);
+
+        DotFunc GetDotKernel()
+        {
+            switch(GetSampleConvertPath())                  // 与采样格式转换共用 CPU 检测/强制路径
+            {
+#ifdef HGL_POLYPHASE_X86
+                case SampleConvertPath::SSE2:   return DotSSE2;
+                case SampleConvertPath::AVX2:   return DotAVX2;
+#endif//HGL_POLYPHASE_X86
+#ifdef HGL_POLYPHASE_NEON
+                case SampleConvertPath::NEON:   return DotNEON;
+#endif//HGL_POLYPHASE_NEON
+                default:                        return DotScalar;
+            }
+        }
+    }//namespace
+
+    bool GetPolyphaseRatio(uint input_rate,uint output_rate,uint *up,uint *down)
+    {
+        if(input_rate==0||output_rate==0)
+            return(false);
+
+        const uint g=GCD(input_rate,output_rate);
+        const uint l=output_rate/g;
+        const uint m=input_rate/g;
+
+        if(l>POLYPHASE_MAX_UP||m>POLYPHASE_MAX_DOWN)
+            return(false);
+
+        if(up)*up=l;
+        if(down)*down=m;
+        return(true);
+    }
+
+    bool IsPolyphaseResampleSupported(uint input_rate,uint output_rate,ResampleQuality quality)
+    {
+        if(quality==ResampleQuality::Linear)
+            return(false);
+
+        uint up,down;
+
+        if(!GetPolyphaseRatio(input_rate,output_rate,&up,&down))
+            return(false);
+
+        return IsFilterBankWithinLimits(up,down,quality);
+    }
+
+    std::shared_ptr<const PolyphaseFilterBank> AcquirePolyphaseFilterBank(uint up,uint down,ResampleQuality quality)
+    {
+        if(up==0||down==0||up>POLYPHASE_MAX_UP||down>POLYPHASE_MAX_DOWN)
+            return nullptr;
+
+        if(!IsFilterBankWithinLimits(up,down,quality))
+            return nullptr;
+
+        struct CacheEntry
+        {
+            std::shared_ptr<const PolyphaseFilterBank> bank;
+            uint64 last_use;
+        };
+
+        static ThreadMutex cache_lock;
+        static std::map<std::tuple<uint,uint,int>,CacheEntry> cache;
+        static uint64 use_counter=0;
+
+        const auto key=std::make_tuple(up,down,(int)quality);
+
+        ThreadMutexLock lock_guard(&cache_lock);
+
+        auto it=cache.find(key);
+
+        if(it!=cache.end())
+        {
+            it->second.last_use=++use_counter;
+            return it->second.bank;
+        }
+
+        // 淘汰最久未使用的一组；调用者手里的 shared_ptr 仍然有效
+        if(cache.size()>=POLYPHASE_CACHE_CAPACITY)
+        {
+            auto oldest=cache.begin();
+
+            for(auto cur=cache.begin();cur!=cache.end();++cur)
+                if(cur->second.last_use<oldest->second.last_use)
+                    oldest=cur;
+
+            cache.erase(oldest);
+        }
+
+        auto bank=CreateFilterBank(up,down,quality);
+
+        GLogInfo(OS_TEXT("Polyphase filter bank created: L=")+OSString::numberOf(up)+
+                 OS_TEXT(", M=")+OSString::numberOf(down)+
+                 OS_TEXT(", taps=")+OSString::numberOf(bank->taps));
+
+        cache.emplace(key,CacheEntry{bank,++use_counter});
+        return bank;
+    }
+
+    uint GetPolyphaseOutputFrames(const PolyphaseFilterBank &bank,uint input_frames)
+    {
+        return (uint)(((uint64)input_frames*bank.up+bank.down-1)/bank.down);
+    }
+
+    uint PolyphaseResample(const PolyphaseFilterBank &bank,const float *input,uint input_frames,uint channels,float *output)
+    {
+        if(!input||!output||input_frames==0||channels==0)
+            return 0;
+
+        const uint taps=bank.taps;
+        const uint output_frames=GetPolyphaseOutputFrames(bank,input_frames);
+        const DotFunc dot=GetDotKernel();
+
+        // 单声道平面缓冲，前后各补 taps 个 0，点积直接读取连续内存
+        std::vector<float> planar((size_t)input_frames+taps*2,0.0f);
+
+        for(uint ch=0;ch<channels;ch++)
+        {
+            float *dst=planar.data()+taps;
+
+            for(uint i=0;i<input_frames;i++)
+                dst[i]=input[(size_t)i*channels+ch];
+
+            // 输出第 n 帧对应上采样域位置 q=n×M+center，相位 q%L，最新输入 x[q/L]
+            uint64 q=bank.center;
+
+            for(uint n=0;n<output_frames;n++,q+=bank.down)
+            {
+                const uint64 base=q/bank.up;
+                const uint phase=(uint)(q-base*bank.up);
+
+                // 读取 x[base-taps+1 .. base]，平面缓冲中偏移 +taps
+                output[(size_t)n*channels+ch]=dot(bank.GetPhase(phase),planar.data()+base+1,taps);
+            }
+        }
+
+        return output_frames;
+    }
+}//namespace hgl::audio
@@ -0,0 +1,781 @@
+﻿#include<hgl/audio/SampleConvert.h>
+#include<atomic>
+#include<cstring>
+
+#if defined(_M_X64)||defined(__x86_64__)||defined(_M_IX86)||defined(__i386__)
+    #define HGL_SAMPLE_CONVERT_X86
+    #include<immintrin.h>
+    #ifdef _MSC_VER
+        #include<intrin.h>
+    #endif
+#elif defined(__ARM_NEON)||defined(__ARM_NEON__)||defined(_M_ARM64)
+    #define HGL_SAMPLE_CONVERT_NEON
+    #include<arm_neon.h>
+#endif
+
+// GCC/Clang 需要按函数开启指令集（整个库不依赖 -mavx2 编译选项），MSVC 可直接使用内建函数
+#if defined(__GNUC__)||defined(__clang__)
+    #define HGL_TARGET_SSE2 __attribute__((target("sse2")))
+    #define HGL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define HGL_TARGET_SSE2
+    #define HGL_TARGET_AVX2
+#endif
+
+namespace hgl::audio
+{
+    namespace
+    {
+        constexpr float INV_128         =1.0f/128.0f;
+        constexpr float INV_32768       =1.0f/32768.0f;
+        constexpr float INV_8388608     =1.0f/8388608.0f;
+        constexpr float INV_2147483648  =1.0f/2147483648.0f;
+
+        inline float Clamp1(float s)
+        {
+            if(s>1.0f)s=1.0f;
+            if(s<-1.0f)s=-1.0f;
+            return s;
+        }
+
+        inline uint32_t XorShift32(uint32_t &x)
+        {
+            x^=x<<13;
+            x^=x>>17;
+            x^=x<<5;
+            return x;
+        }
+
+        inline float UniformFromBits(uint32_t x)                    ///<[-1,1) 均匀分布
+        {
+            return (float)(int32_t)x*INV_2147483648;
+        }
+
+        //--------------------------------------------------------------------------------------------------
+        // 标量内核（各 SIMD 内核的尾部也复用这里，保证逐位一致）
+        //--------------------------------------------------------------------------------------------------
+
+        void S8ToFloatScalar(const int8_t *in,float *out,uint count)
+        {
+            for(uint i=0;i<count;i++)
+                out[i]=in[i]*INV_128;
+        }
+
+        void S16ToFloatScalar(const int16_t *in,float *out,uint count)
+        {
+            for(uint i=0;i<count;i++)
+                out[i]=in[i]*INV_32768;
+        }
+
+        void S32ToFloatScalar(const int32_t *in,float *out,uint count)
+        {
+            for(uint i=0;i<count;i++)
+                out[i]=(float)in[i]*INV_2147483648;
+        }
+
+        void FloatToS8Scalar(const float *in,int8_t *out,uint count)
+        {
+            for(uint i=0;i<count;i++)
+                out[i]=(int8_t)(Clamp1(in[i])*127.0f);
+        }
+
+        void FloatToS16Scalar(const float *in,int16_t *out,uint count)
+        {
+            for(uint i=0;i<count;i++)
+                out[i]=(int16_t)(Clamp1(in[i])*32767.0f);
+        }
+
+        void FloatToS32Scalar(const float *in,int32_t *out,uint count)
+        {
+            for(uint i=0;i<count;i++)
+                out[i]=(int32_t)((double)Clamp1(in[i])*2147483647.0);
+        }
+
+        void S24ToFloat(const uint8_t *in,float *out,uint count)
+        {
+            for(uint i=0;i<count;i++,in+=3)
+            {
+                const int32_t v=(int32_t)((uint32_t)in[0]<<8|(uint32_t)in[1]<<16|(uint32_t)in[2]<<24)>>8;
+
+                out[i]=(float)v*INV_8388608;
+            }
+        }
+
+        void FloatToS24(const float *in,uint8_t *out,uint count)
+        {
+            for(uint i=0;i<count;i++,out+=3)
+            {
+                const int32_t v=(int32_t)(Clamp1(in[i])*8388607.0f);
+
+                out[0]=(uint8_t)(v);
+                out[1]=(uint8_t)(v>>8);
+                out[2]=(uint8_t)(v>>16);
+            }
+        }
+
+        /**
+        * 第 i 个采样使用第 i%8 路 xorshift，两个均匀分布相加得到 TPDF
+        */
+        void DitherScalar(uint32_t *state,float *out,uint count,float scale)
+        {
+            const float k=0.5f*scale;
+
+            for(uint i=0;i<count;i++)
+            {
+                uint32_t &s=state[i&7];
+
+                const float r1=UniformFromBits(XorShift32(s));
+                const float r2=UniformFromBits(XorShift32(s));
+
+                out[i]=(r1+r2)*k;
+            }
+        }
+
+#ifdef HGL_SAMPLE_CONVERT_X86
+        //--------------------------------------------------------------------------------------------------
+        // SSE2
+        //--------------------------------------------------------------------------------------------------
+
+        HGL_TARGET_SSE2 void S8ToFloatSSE2(const int8_t *in,float *out,uint count)
+        {
+            const __m128 k=_mm_set1_ps(INV_128);
+            uint i=0;
+
+            for(;i+16<=count;i+=16)
+            {
+                const __m128i v =_mm_loadu_si128((const __m128i *)(in+i));
+                const __m128i lo=_mm_unpacklo_epi8(v,v);
+                const __m128i hi=_mm_unpackhi_epi8(v,v);
+
+                _mm_storeu_ps(out+i,   _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo,lo),24)),k));
+                _mm_storeu_ps(out+i+4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo,lo),24)),k));
+                _mm_storeu_ps(out+i+8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi,hi),24)),k));
+                _mm_storeu_ps(out+i+12,_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi,hi),24)),k));
+            }
+
+            S8ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_SSE2 void S16ToFloatSSE2(const int16_t *in,float *out,uint count)
+        {
+            const __m128 k=_mm_set1_ps(INV_32768);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                const __m128i v=_mm_loadu_si128((const __m128i *)(in+i));
+
+                _mm_storeu_ps(out+i,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v,v),16)),k));
+                _mm_storeu_ps(out+i+4,_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v,v),16)),k));
+            }
+
+            S16ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_SSE2 void S32ToFloatSSE2(const int32_t *in,float *out,uint count)
+        {
+            const __m128 k=_mm_set1_ps(INV_2147483648);
+            uint i=0;
+
+            for(;i+4<=count;i+=4)
+                _mm_storeu_ps(out+i,_mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(in+i))),k));
+
+            S32ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_SSE2 inline __m128i ClampScaleSSE2(const float *in,__m128 scale)
+        {
+            const __m128 lo=_mm_set1_ps(-1.0f);
+            const __m128 hi=_mm_set1_ps( 1.0f);
+
+            return _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in),lo),hi),scale));
+        }
+
+        HGL_TARGET_SSE2 void FloatToS8SSE2(const float *in,int8_t *out,uint count)
+        {
+            const __m128 k=_mm_set1_ps(127.0f);
+            uint i=0;
+
+            for(;i+16<=count;i+=16)
+            {
+                const __m128i a=_mm_packs_epi32(ClampScaleSSE2(in+i,  k),ClampScaleSSE2(in+i+4, k));
+                const __m128i b=_mm_packs_epi32(ClampScaleSSE2(in+i+8,k),ClampScaleSSE2(in+i+12,k));
+
+                _mm_storeu_si128((__m128i *)(out+i),_mm_packs_epi16(a,b));
+            }
+
+            FloatToS8Scalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_SSE2 void FloatToS16SSE2(const float *in,int16_t *out,uint count)
+        {
+            const __m128 k=_mm_set1_ps(32767.0f);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+                _mm_storeu_si128((__m128i *)(out+i),_mm_packs_epi32(ClampScaleSSE2(in+i,k),ClampScaleSSE2(in+i+4,k)));
+
+            FloatToS16Scalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_SSE2 void FloatToS32SSE2(const float *in,int32_t *out,uint count)
+        {
+            const __m128 lo=_mm_set1_ps(-1.0f);
+            const __m128 hi=_mm_set1_ps( 1.0f);
+            const __m128d k=_mm_set1_pd(2147483647.0);
+            uint i=0;
+
+            // int32 满幅超出 float 精度，与标量一致走 double 乘法
+            for(;i+4<=count;i+=4)
+            {
+                const __m128 v=_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in+i),lo),hi);
+
+                const __m128i a=_mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(v),k));
+                const __m128i b=_mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(v,v)),k));
+
+                _mm_storeu_si128((__m128i *)(out+i),_mm_unpacklo_epi64(a,b));
+            }
+
+            FloatToS32Scalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_SSE2 inline __m128i XorShiftSSE2(__m128i x)
+        {
+            x=_mm_xor_si128(x,_mm_slli_epi32(x,13));
+            x=_mm_xor_si128(x,_mm_srli_epi32(x,17));
+            x=_mm_xor_si128(x,_mm_slli_epi32(x,5));
+            return x;
+        }
+
+        HGL_TARGET_SSE2 void DitherSSE2(uint32_t *state,float *out,uint count,float scale)
+        {
+            const __m128 u=_mm_set1_ps(INV_2147483648);
+            const __m128 k=_mm_set1_ps(0.5f*scale);
+
+            __m128i a=_mm_loadu_si128((const __m128i *)state);
+            __m128i b=_mm_loadu_si128((const __m128i *)(state+4));
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                a=XorShiftSSE2(a);  const __m128 a1=_mm_mul_ps(_mm_cvtepi32_ps(a),u);
+                a=XorShiftSSE2(a);  const __m128 a2=_mm_mul_ps(_mm_cvtepi32_ps(a),u);
+                b=XorShiftSSE2(b);  const __m128 b1=_mm_mul_ps(_mm_cvtepi32_ps(b),u);
+                b=XorShiftSSE2(b);  const __m128 b2=_mm_mul_ps(_mm_cvtepi32_ps(b),u);
+
+                _mm_storeu_ps(out+i,  _mm_mul_ps(_mm_add_ps(a1,a2),k));
+                _mm_storeu_ps(out+i+4,_mm_mul_ps(_mm_add_ps(b1,b2),k));
+            }
+
+            _mm_storeu_si128((__m128i *)state,a);
+            _mm_storeu_si128((__m128i *)(state+4),b);
+
+            DitherScalar(state,out+i,count-i,scale);
+        }
+
+        //--------------------------------------------------------------------------------------------------
+        // AVX2
+        //--------------------------------------------------------------------------------------------------
+
+        HGL_TARGET_AVX2 void S8ToFloatAVX2(const int8_t *in,float *out,uint count)
+        {
+            const __m256 k=_mm256_set1_ps(INV_128);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+                _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(in+i)))),k));
+
+            S8ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_AVX2 void S16ToFloatAVX2(const int16_t *in,float *out,uint count)
+        {
+            const __m256 k=_mm256_set1_ps(INV_32768);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+                _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(in+i)))),k));
+
+            S16ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_AVX2 void S32ToFloatAVX2(const int32_t *in,float *out,uint count)
+        {
+            const __m256 k=_mm256_set1_ps(INV_2147483648);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+                _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(in+i))),k));
+
+            S32ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_AVX2 inline __m256i ClampScaleAVX2(const float *in,__m256 scale)
+        {
+            const __m256 lo=_mm256_set1_ps(-1.0f);
+            const __m256 hi=_mm256_set1_ps( 1.0f);
+
+            return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in),lo),hi),scale));
+        }
+
+        /**
+        * 两组 8×int32 饱和打包为按顺序排列的 16×int16（packs 在 128 位通道内交错，需要 permute 还原顺序）
+        */
+        HGL_TARGET_AVX2 inline __m256i Pack16AVX2(__m256i a,__m256i b)
+        {
+            return _mm256_permute4x64_epi64(_mm256_packs_epi32(a,b),0xD8);
+        }
+
+        HGL_TARGET_AVX2 void FloatToS8AVX2(const float *in,int8_t *out,uint count)
+        {
+            const __m256 k=_mm256_set1_ps(127.0f);
+            uint i=0;
+
+            for(;i+16<=count;i+=16)
+            {
+                const __m256i w=Pack16AVX2(ClampScaleAVX2(in+i,k),ClampScaleAVX2(in+i+8,k));
+
+                _mm_storeu_si128((__m128i *)(out+i),_mm_packs_epi16(_mm256_castsi256_si128(w),_mm256_extracti128_si256(w,1)));
+            }
+
+            FloatToS8Scalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_AVX2 void FloatToS16AVX2(const float *in,int16_t *out,uint count)
+        {
+            const __m256 k=_mm256_set1_ps(32767.0f);
+            uint i=0;
+
+            for(;i+16<=count;i+=16)
+                _mm256_storeu_si256((__m256i *)(out+i),Pack16AVX2(ClampScaleAVX2(in+i,k),ClampScaleAVX2(in+i+8,k)));
+
+            FloatToS16Scalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_AVX2 void FloatToS32AVX2(const float *in,int32_t *out,uint count)
+        {
+            const __m256 lo=_mm256_set1_ps(-1.0f);
+            const __m256 hi=_mm256_set1_ps( 1.0f);
+            const __m256d k=_mm256_set1_pd(2147483647.0);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                const __m256 v=_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in+i),lo),hi);
+
+                const __m128i a=_mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)),k));
+                const __m128i b=_mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(v,1)),k));
+
+                _mm256_storeu_si256((__m256i *)(out+i),_mm256_inserti128_si256(_mm256_castsi128_si256(a),b,1));
+            }
+
+            FloatToS32Scalar(in+i,out+i,count-i);
+        }
+
+        HGL_TARGET_AVX2 inline __m256i XorShiftAVX2(__m256i x)
+        {
+            x=_mm256_xor_si256(x,_mm256_slli_epi32(x,13));
+            x=_mm256_xor_si256(x,_mm256_srli_epi32(x,17));
+            x=_mm256_xor_si256(x,_mm256_slli_epi32(x,5));
+            return x;
+        }
+
+        HGL_TARGET_AVX2 void DitherAVX2(uint32_t *state,float *out,uint count,float scale)
+        {
+            const __m256 u=_mm256_set1_ps(INV_2147483648);
+            const __m256 k=_mm256_set1_ps(0.5f*scale);
+
+            __m256i s=_mm256_loadu_si256((const __m256i *)state);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                s=XorShiftAVX2(s);  const __m256 r1=_mm256_mul_ps(_mm256_cvtepi32_ps(s),u);
+                s=XorShiftAVX2(s);  const __m256 r2=_mm256_mul_ps(_mm256_cvtepi32_ps(s),u);
+
+                _mm256_storeu_ps(out+i,_mm256_mul_ps(_mm256_add_ps(r1,r2),k));
+            }
+
+            _mm256_storeu_si256((__m256i *)state,s);
+
+            DitherScalar(state,out+i,count-i,scale);
+        }
+
+        bool CPUSupportsAVX2()
+        {
+    #if defined(_MSC_VER)&&!defined(__clang__)
+            int regs[4];
+
+            __cpuid(regs,1);
+
+            const bool osxsave=(regs[2]&(1<<27))!=0;
+            const bool avx    =(regs[2]&(1<<28))!=0;
+
+            if(!osxsave||!avx)
+                return false;
+
+            if((_xgetbv(0)&6)!=6)           // 操作系统需保存 YMM 寄存器
+                return false;
+
+            __cpuidex(regs,7,0);
+
+            return (regs[1]&(1<<5))!=0;
+    #else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+    #endif
+        }
+
+        bool CPUSupportsSSE2()
+        {
+    #if defined(_M_X64)||defined(__x86_64__)
+            return true;                    // x86-64 基线即包含 SSE2
+    #elif defined(_MSC_VER)&&!defined(__clang__)
+            int regs[4];
+            __cpuid(regs,1);
+            return (regs[3]&(1<<26))!=0;
+    #else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+    #endif
+        }
+#endif//HGL_SAMPLE_CONVERT_X86
+
+#ifdef HGL_SAMPLE_CONVERT_NEON
+        //--------------------------------------------------------------------------------------------------
+        // NEON（int32 输出需 double 精度，保持标量）
+        //--------------------------------------------------------------------------------------------------
+
+        void S8ToFloatNEON(const int8_t *in,float *out,uint count)
+        {
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                const int16x8_t v=vmovl_s8(vld1_s8(in+i));
+
+                vst1q_f32(out+i,  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), INV_128));
+                vst1q_f32(out+i+4,vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))),INV_128));
+            }
+
+            S8ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        void S16ToFloatNEON(const int16_t *in,float *out,uint count)
+        {
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                const int16x8_t v=vld1q_s16(in+i);
+
+                vst1q_f32(out+i,  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), INV_32768));
+                vst1q_f32(out+i+4,vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))),INV_32768));
+            }
+
+            S16ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        void S32ToFloatNEON(const int32_t *in,float *out,uint count)
+        {
+            uint i=0;
+
+            for(;i+4<=count;i+=4)
+                vst1q_f32(out+i,vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(in+i)),INV_2147483648));
+
+            S32ToFloatScalar(in+i,out+i,count-i);
+        }
+
+        inline int32x4_t ClampScaleNEON(const float *in,float scale)
+        {
+            const float32x4_t v=vminq_f32(vmaxq_f32(vld1q_f32(in),vdupq_n_f32(-1.0f)),vdupq_n_f32(1.0f));
+
+            return vcvtq_s32_f32(vmulq_n_f32(v,scale));             // 向零截断，与标量强转一致
+        }
+
+        void FloatToS8NEON(const float *in,int8_t *out,uint count)
+        {
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                const int16x8_t w=vcombine_s16(vqmovn_s32(ClampScaleNEON(in+i,127.0f)),vqmovn_s32(ClampScaleNEON(in+i+4,127.0f)));
+
+                vst1_s8(out+i,vqmovn_s16(w));
+            }
+
+            FloatToS8Scalar(in+i,out+i,count-i);
+        }
+
+        void FloatToS16NEON(const float *in,int16_t *out,uint count)
+        {
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+                vst1q_s16(out+i,vcombine_s16(vqmovn_s32(ClampScaleNEON(in+i,32767.0f)),vqmovn_s32(ClampScaleNEON(in+i+4,32767.0f))));
+
+            FloatToS16Scalar(in+i,out+i,count-i);
+        }
+
+        inline uint32x4_t XorShiftNEON(uint32x4_t x)
+        {
+            x=veorq_u32(x,vshlq_n_u32(x,13));
+            x=veorq_u32(x,vshrq_n_u32(x,17));
+            x=veorq_u32(x,vshlq_n_u32(x,5));
+            return x;
+        }
+
+        void DitherNEON(uint32_t *state,float *out,uint count,float scale)
+        {
+            const float k=0.5f*scale;
+
+            uint32x4_t a=vld1q_u32(state);
+            uint32x4_t b=vld1q_u32(state+4);
+            uint i=0;
+
+            for(;i+8<=count;i+=8)
+            {
+                a=XorShiftNEON(a);  const float32x4_t a1=vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(a)),INV_2147483648);
+                a=XorShiftNEON(a);  const float32x4_t a2=vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(a)),INV_2147483648);
+                b=XorShiftNEON(b);  const float32x4_t b1=vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(b)),INV_2147483648);
+                b=XorShiftNEON(b);  const float32x4_t b2=vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(b)),INV_2147483648);
+
+                vst1q_f32(out+i,  vmulq_n_f32(vaddq_f32(a1,a2),k));
+                vst1q_f32(out+i+4,vmulq_n_f32(vaddq_f32(b1,b2),k));
+            }
+
+            vst1q_u32(state,a);
+            vst1q_u32(state+4,b);
+
+            DitherScalar(state,out+i,count-i,scale);
+        }
+#endif//HGL_SAMPLE_CONVERT_NEON
+
+        //--------------------------------------------------------------------------------------------------
+        // 运行时分派
+        //--------------------------------------------------------------------------------------------------
+
+        struct ConvertKernels
+        {
+            void (*s8_to_f)(const int8_t *,float *,uint);
+            void (*s16_to_f)(const int16_t *,float *,uint);
+            void (*s32_to_f)(const int32_t *,float *,uint);
+            void (*f_to_s8)(const float *,int8_t *,uint);
+            void (*f_to_s16)(const float *,int16_t *,uint);
+            void (*f_to_s32)(const float *,int32_t *,uint);
+            void (*dither)(uint32_t *,float *,uint,float);
+        };
+
+        constexpr ConvertKernels scalar_kernels={S8ToFloatScalar,S16ToFloatScalar,S32ToFloatScalar,
+                                                 FloatToS8Scalar,FloatToS16Scalar,FloatToS32Scalar,
+                                                 DitherScalar};
+
+#ifdef HGL_SAMPLE_CONVERT_X86
+        constexpr ConvertKernels sse2_kernels={S8ToFloatSSE2,S16ToFloatSSE2,S32ToFloatSSE2,
+                                               FloatToS8SSE2,FloatToS16SSE2,FloatToS32SSE2,
+                                               DitherSSE2};
+
+        constexpr ConvertKernels avx2_kernels={S8ToFloatAVX2,S16ToFloatAVX2,S32ToFloatAVX2,
+                                               FloatToS8AVX2,FloatToS16AVX2,FloatToS32AVX2,
+                                               DitherAVX2};
+#endif//HGL_SAMPLE_CONVERT_X86
+
+#ifdef HGL_SAMPLE_CONVERT_NEON
+        constexpr ConvertKernels neon_kernels={S8ToFloatNEON,S16ToFloatNEON,S32ToFloatNEON,
+                                               FloatToS8NEON,FloatToS16NEON,FloatToS32Scalar,
+                                               DitherNEON};
+#endif//HGL_SAMPLE_CONVERT_NEON
+
+        bool IsPathSupported(SampleConvertPath path)
+        {
+            switch(path)
+            {
+                case SampleConvertPath::Scalar: return true;
+#ifdef HGL_SAMPLE_CONVERT_X86
+                case SampleConvertPath::SSE2:   return CPUSupportsSSE2();
+                case SampleConvertPath::AVX2:   return CPUSupportsAVX2();
+#endif//HGL_SAMPLE_CONVERT_X86
+#ifdef HGL_SAMPLE_CONVERT_NEON
+                case SampleConvertPath::NEON:   return true;
+#endif//HGL_SAMPLE_CONVERT_NEON
+                default:                        return false;
+            }
+        }
+
+        const ConvertKernels *GetKernelsByPath(SampleConvertPath path)
+        {
+            switch(path)
+            {
+#ifdef HGL_SAMPLE_CONVERT_X86
+                case SampleConvertPath::SSE2:   return &sse2_kernels;
+                case SampleConvertPath::AVX2:   return &avx2_kernels;
+#endif//HGL_SAMPLE_CONVERT_X86
+#ifdef HGL_SAMPLE_CONVERT_NEON
+                case SampleConvertPath::NEON:   return &neon_kernels;
+#endif//HGL_SAMPLE_CONVERT_NEON
+                default:                        return &scalar_kernels;
+            }
+        }
+
+        SampleConvertPath DetectBestPath()
+        {
+            if(IsPathSupported(SampleConvertPath::AVX2))return SampleConvertPath::AVX2;
+            if(IsPathSupported(SampleConvertPath::SSE2))return SampleConvertPath::SSE2;
+            if(IsPathSupported(SampleConvertPath::NEON))return SampleConvertPath::NEON;
+
+            return SampleConvertPath::Scalar;
+        }
+
+        std::atomic<int> current_path{-1};                  ///<-1=尚未检测
+
+        const ConvertKernels *GetKernels()
+        {
+            int path=current_path.load(std::memory_order_relaxed);
+
+            if(path<0)
+            {
+                path=(int)DetectBestPath();
+                current_path.store(path,std::memory_order_relaxed);
+            }
+
+            return GetKernelsByPath((SampleConvertPath)path);
+        }
+    }//namespace
+
+    SampleConvertPath GetSampleConvertPath()
+    {
+        GetKernels();
+
+        return (SampleConvertPath)current_path.load(std::memory_order_relaxed);
+    }
+
+    bool SetSampleConvertPath(SampleConvertPath path)
+    {
+        if(!IsPathSupported(path))
+            return(false);
+
+        current_path.store((int)path,std::memory_order_relaxed);
+        return(true);
+    }
+
+    const os_char *GetSampleConvertPathName(SampleConvertPath path)
+    {
+        switch(path)
+        {
+            case SampleConvertPath::SSE2:   return OS_TEXT("SSE2");
+            case SampleConvertPath::AVX2:   return OS_TEXT("AVX2");
+            case SampleConvertPath::NEON:   return OS_TEXT("NEON");
+            default:                        return OS_TEXT("Scalar");
+        }
+    }
+
+    bool IsSampleFormatSupported(const AudioDataInfo &info)
+    {
+        if(info.is_float)
+            return info.bits_per_sample==32;
+
+        return info.bits_per_sample==8
+             ||info.bits_per_sample==16
+             ||info.bits_per_sample==24
+             ||info.bits_per_sample==32;
+    }
+
+    void SampleToFloat(const void *input,float *output,uint count,const AudioDataInfo &info)
+    {
+        if(!input||!output||count==0)
+            return;
+
+        if(info.is_float)
+        {
+            if(info.bits_per_sample==32)
+                memcpy(output,input,count*sizeof(float));
+
+            return;
+        }
+
+        const ConvertKernels *k=GetKernels();
+
+        switch(info.bits_per_sample)
+        {
+            case 8:  k->s8_to_f ((const int8_t  *)input,output,count);break;
+            case 16: k->s16_to_f((const int16_t *)input,output,count);break;
+            case 24: S24ToFloat ((const uint8_t *)input,output,count);break;
+            case 32: k->s32_to_f((const int32_t *)input,output,count);break;
+            default: break;
+        }
+    }
+
+    void FloatToSample(const float *input,void *output,uint count,const AudioDataInfo &info)
+    {
+        if(!input||!output||count==0)
+            return;
+
+        if(info.is_float)
+        {
+            if(info.bits_per_sample==32&&input!=output)
+                memcpy(output,input,count*sizeof(float));
+
+            return;
+        }
+
+        const ConvertKernels *k=GetKernels();
+
+        switch(info.bits_per_sample)
+        {
+            case 8:  k->f_to_s8 (input,(int8_t  *)output,count);break;
+            case 16: k->f_to_s16(input,(int16_t *)output,count);break;
+            case 24: FloatToS24 (input,(uint8_t *)output,count);break;
+            case 32: k->f_to_s32(input,(int32_t *)output,count);break;
+            default: break;
+        }
+    }
+
+    void TPDFDither::Seed(uint32_t seed)
+    {
+        // splitmix32 展开 8 路初始状态，xorshift 状态不可为 0
+        for(int i=0;i<8;i++)
+        {
+            uint32_t z=(seed+=0x9E3779B9u);
+
+            z=(z^(z>>16))*0x85EBCA6Bu;
+            z=(z^(z>>13))*0xC2B2AE35u;
+            z^=z>>16;
+
+            state[i]=z?z:0x6D2B79F5u;
+        }
+    }
+
+    void TPDFDither::Generate(float *output,uint count,float scale)
+    {
+        if(!output||count==0)
+            return;
+
+        GetKernels()->dither(state,output,count,scale);
+    }
+
+    void FloatToInt16Dither(const float *input,int16_t *output,uint count,TPDFDither &dither)
+    {
+        if(!input||!output||count==0)
+            return;
+
+        constexpr uint BLOCK=256;
+
+        float block[BLOCK];
+
+        const ConvertKernels *k=GetKernels();
+
+        for(uint pos=0;pos<count;pos+=BLOCK)
+        {
+            const uint n=(count-pos<BLOCK)?count-pos:BLOCK;
+
+            // 抖动幅度约为 1 LSB
+            k->dither(dither.state,block,n,INV_32768);
+
+            for(uint i=0;i<n;i++)
+                block[i]+=Clamp1(input[pos+i]);
+
+            // 加噪后再次钳位并量化
+            k->f_to_s16(block,output+pos,n);
+        }
+    }
+}//namespace hgl::audio
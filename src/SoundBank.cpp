@@ -0,0 +1,173 @@
+﻿#include<hgl/audio/SoundBank.h>
+#include<hgl/util/hash/FNV1a.h>
+#include<hgl/utf.h>
+#include<hgl/log/Log.h>
+#include"MappedWAV.h"
+#include<cstring>
+
+namespace hgl::audio
+{
+    uint64 SoundBankNameHash(const char *u8_name)
+    {
+        if(!u8_name)
+            return(0);
+
+        uint64 hash=hgl::hash::FNV1aInit<uint64>();
+        hash=hgl::hash::FNV1aAppendBytes(hash,u8_name,std::strlen(u8_name));
+
+        return(hash);
+    }
+
+    uint64 SoundBankNameHash(const OSString &name)
+    {
+        const U8String u=ToU8String(name);
+
+        return SoundBankNameHash(reinterpret_cast<const char *>(u.c_str()));
+    }
+
+    AudioFileType ToAudioFileType(SoundBankPayload payload)
+    {
+        switch(payload)
+        {
+            case SoundBankPayload::Vorbis:  return AudioFileType::Vorbis;
+            case SoundBankPayload::Opus:    return AudioFileType::Opus;
+            default:                        return AudioFileType::None;
+        }
+    }
+
+    SoundBank::SoundBank()
+    {
+        mapped=nullptr;
+        header=nullptr;
+        entries=nullptr;
+        names=nullptr;
+        names_size=0;
+    }
+
+    SoundBank::~SoundBank()
+    {
+        Close();
+    }
+
+    void SoundBank::Close()
+    {
+        SAFE_CLEAR(mapped);
+
+        header=nullptr;
+        entries=nullptr;
+        names=nullptr;
+        names_size=0;
+
+        filename.Clear();
+    }
+
+    bool SoundBank::Open(const os_char *fn)
+    {
+        Close();
+
+        if(!fn||!(*fn))
+            return(false);
+
+        mapped=new MappedFile;
+
+        if(!mapped->Open(fn,false))                 // 按名随机访问，不提示顺序预读
+        {
+            GLogError(OS_TEXT("SoundBank: 无法映射文件 ")+OSString(fn));
+            SAFE_CLEAR(mapped);
+            return(false);
+        }
+
+        const uint8 *base=(const uint8 *)mapped->GetData();
+        const uint64 file_size=mapped->GetSize();
+
+        const SoundBankHeader *hdr=(const SoundBankHeader *)base;
+
+        if(file_size<sizeof(SoundBankHeader)
+         ||hdr->magic!=SOUND_BANK_MAGIC
+         ||hdr->version!=SOUND_BANK_VERSION)
+        {
+            GLogError(OS_TEXT("SoundBank: 不是有效的声音包 ")+OSString(fn));
+            SAFE_CLEAR(mapped);
+            return(false);
+        }
+
+        const uint64 index_size=uint64(hdr->entry_count)*sizeof(SoundBankEntry);
+
+        if(hdr->index_offset%alignof(SoundBankEntry)!=0
+         ||hdr->index_offset>file_size
+         ||index_size>file_size-hdr->index_offset)
+        {
+            GLogError(OS_TEXT("SoundBank: 索引越界 ")+OSString(fn));
+            SAFE_CLEAR(mapped);
+            return(false);
+        }
+
+        const SoundBankEntry *list=(const SoundBankEntry *)(base+hdr->index_offset);
+
+        for(uint32 i=0;i<hdr->entry_count;i++)
+        {
+            const SoundBankEntry &e=list[i];
+
+            if(e.offset>file_size||e.size>file_size-e.offset
+             ||(i>0&&list[i-1].name_hash>=e.name_hash))         // 须严格升序（重名哈希在构建时已拒绝）
+            {
+                GLogError(OS_TEXT("SoundBank: 索引项无效 #")+OSString::numberOf(i)+OS_TEXT(" ")+OSString(fn));
+                SAFE_CLEAR(mapped);
+                return(false);
+            }
+        }
+
+        if(hdr->names_offset>0&&hdr->names_offset<file_size)
+        {
+            names=(const char *)(base+hdr->names_offset);
+            names_size=file_size-hdr->names_offset;
+        }
+
+        header=hdr;
+        entries=list;
+        filename=fn;
+
+        return(true);
+    }
+
+    const SoundBankEntry *SoundBank::Find(uint64 name_hash)const
+    {
+        if(!header)
+            return(nullptr);
+
+        uint32 left=0;
+        uint32 right=header->entry_count;
+
+        while(left<right)
+        {
+            const uint32 mid=left+(right-left)/2;
+            const uint64 h=entries[mid].name_hash;
+
+            if(h==name_hash)
+                return entries+mid;
+
+            if(h<name_hash)
+                left=mid+1;
+            else
+                right=mid;
+        }
+
+        return(nullptr);
+    }
+
+    const void *SoundBank::GetPayload(const SoundBankEntry *entry)const
+    {
+        if(!header||!entry)
+            return(nullptr);
+
+        return (const uint8 *)mapped->GetData()+entry->offset;
+    }
+
+    const char *SoundBank::GetName(const SoundBankEntry *entry)const
+    {
+        if(!names||!entry||entry->name_offset>=names_size)
+            return(nullptr);
+
+        return names+entry->name_offset;
+    }
+}//namespace hgl::audio
@@ -80,14 +80,23 @@ namespace hgl::audio
         return dist(GetRNG());
     }
 
-    const OSString *SoundEventConfig::RandomFile()const
+    int SoundEventConfig::RandomFileIndex()const
     {
         const int count=files.GetCount();
 
-        if(count<=0)return nullptr;
-        if(count==1)return &files.GetString(0);
+        if(count<=0)return -1;
+        if(count==1)return 0;
 
         std::uniform_int_distribution<int> dist(0,count-1);
-        return &files.GetString(dist(GetRNG()));
+        return dist(GetRNG());
+    }
+
+    const OSString *SoundEventConfig::RandomFile()const
+    {
+        const int index=RandomFileIndex();
+
+        if(index<0)return nullptr;
+
+        return &files.GetString(index);
     }
 }//namespace hgl::audio
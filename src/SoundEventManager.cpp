@@ -343,6 +343,7 @@ namespace hgl::audio
             else if(key=="max_distance")    current_config.max_distance=ParseFloat(value);
             else if(key=="rolloff_factor")  current_config.rolloff_factor=ParseFloat(value);
             else if(key=="loop")            current_config.loop=ParseBool(value);
+            else if(key=="stream")          current_config.stream=ParseBool(value);
             else if(key=="bus")             current_config.bus_type=AudioBusTypeFromString(Unquote(value).c_str());
         }
 